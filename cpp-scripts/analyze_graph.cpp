@@ -42,6 +42,12 @@ int main(int argc, char *const argv[]) {
     opt_desc.add_options()(
             "removeExtraEdges,c", po::bool_switch()->default_value(false),
             "Remove extra edges created because connectivity of object.");
+    opt_desc.add_options()(
+            "traceReducedGraph", po::bool_switch()->default_value(false),
+            "Trace the reduced graph directly from the image, without "
+            "creating a node per voxel. Uses less memory, but clusters of "
+            "adjacent junctions might keep extra edges. Ignored with "
+            "removeExtraEdges.");
     opt_desc.add_options()(
             "mergeThreeConnectedNodes,m",
             po::bool_switch()->default_value(false),
@@ -92,6 +98,11 @@ int main(int argc, char *const argv[]) {
             "exportSerialized", po::bool_switch()->default_value(false),
             "Write serialized graph with the reduced spatial graph. (usable by "
             "SGEXT library). Requires exportReducedGraph_foldername.");
+    opt_desc.add_options()(
+            "exportBinary", po::bool_switch()->default_value(false),
+            "Write binary graph (.sgb) with the reduced spatial graph. Faster "
+            "to read than the serialized graph (usable by SGEXT library). "
+            "Requires exportReducedGraph_foldername.");
     opt_desc.add_options()(
             "exportVtu", po::bool_switch()->default_value(false),
             "Write unstructured grid file representing the reduced graph "
@@ -136,6 +147,7 @@ int main(int argc, char *const argv[]) {
             vm["transformToPhysicalPoints"].as<bool>();
     std::string spacing = vm["spacing"].as<std::string>();
     bool removeExtraEdges = vm["removeExtraEdges"].as<bool>();
+    bool traceReducedGraph = vm["traceReducedGraph"].as<bool>();
     bool mergeThreeConnectedNodes = vm["mergeThreeConnectedNodes"].as<bool>();
     bool mergeFourConnectedNodes = vm["mergeFourConnectedNodes"].as<bool>();
     bool mergeTwoThreeConnectedNodes =
@@ -161,6 +173,7 @@ int main(int argc, char *const argv[]) {
     bool exportVtu = vm["exportVtu"].as<bool>();
     bool exportVtuWithEdgePoints = vm["exportVtuWithEdgePoints"].as<bool>();
     bool exportGraphviz = vm["exportGraphviz"].as<bool>();
+    bool exportBinary = vm["exportBinary"].as<bool>();
 
 #ifdef SG_MODULE_VISUALIZE_ENABLED
     bool visualize = vm["visualize"].as<bool>();
@@ -188,5 +201,7 @@ int main(int argc, char *const argv[]) {
         ignoreEdgesToEndNodes,
         ignoreEdgesShorterThan,
         verbose,
-        visualize);
+        visualize,
+        exportBinary,
+        traceReducedGraph);
 }
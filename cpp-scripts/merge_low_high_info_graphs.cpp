@@ -60,6 +60,7 @@ void export_graph_merge_low_high_info(
         const std::string & folder_path,
         const fs::path &output_filename_path,
         bool useSerialized,
+        bool useBinary,
         bool verbose,
         const std::string &graph_title) {
 
@@ -69,7 +70,16 @@ void export_graph_merge_low_high_info(
                                  output_folder_path.string());
     }
 
-    if (!useSerialized) {
+    if (useBinary) {
+        fs::path output_full_path =
+                output_folder_path /
+                fs::path(output_filename_path.string() + ".sgb");
+        SG::write_binary_sg(output_full_path.string(), output_g);
+        if (verbose) {
+            std::cout << graph_title + ": graph (binary) output stored in: "
+                      << output_full_path.string() << std::endl;
+        }
+    } else if (!useSerialized) {
         fs::path output_full_path =
                 output_folder_path /
                 fs::path(output_filename_path.string() + ".dot");
@@ -102,14 +112,20 @@ int main(int argc, char *const argv[]) {
                            po::bool_switch()->default_value(false),
                            "Use stored serialized graphs. If off, it will "
                            "require .dot graphviz files.");
+    opt_desc.add_options()("useBinary,b",
+                           po::bool_switch()->default_value(false),
+                           "Use binary graphs (.sgb), faster to read and "
+                           "write. Takes precedence over --useSerialized.");
     opt_desc.add_options()(
             "exportExtendedLowInfoGraph,e", po::value<string>()->required(),
-            "Write .dot file with the extended low info spatial graph or "
-            ".txt file if --useSerialized is on.");
+            "Write .dot file with the extended low info spatial graph, "
+            ".txt file if --useSerialized is on, or .sgb file if "
+            "--useBinary is on.");
     opt_desc.add_options()(
             "exportMergedGraph,o", po::value<string>()->required(),
-            "Write .dot file with the final graph (with pensinsulas added) or "
-            ".txt file if --useSerialized is on.");
+            "Write .dot file with the final graph (with pensinsulas added), "
+            ".txt file if --useSerialized is on, or .sgb file if "
+            "--useBinary is on.");
     opt_desc.add_options()(
             "computePeninsulas,p", po::bool_switch()->default_value(false),
             "Perform the full analysis adding isolated components with "
@@ -150,6 +166,7 @@ int main(int argc, char *const argv[]) {
             vm.count("exportExtendedLowInfoGraph"));
     bool exportMergedGraph = static_cast<bool>(vm.count("exportMergedGraph"));
     bool useSerialized = vm["useSerialized"].as<bool>();
+    bool useBinary = vm["useBinary"].as<bool>();
     bool computePeninsulas = vm["computePeninsulas"].as<bool>();
 
 #ifdef VISUALIZE
@@ -164,7 +181,10 @@ int main(int argc, char *const argv[]) {
 
     SG::GraphType g0;     // lowGraph
     SG::GraphType g1;     // highGraph
-    if (!useSerialized) { // read graphviz
+    if (useBinary) {
+        g0 = SG::read_binary_sg(filenameLow);
+        g1 = SG::read_binary_sg(filenameHigh);
+    } else if (!useSerialized) { // read graphviz
         SG::read_graphviz_sg(filenameLow, g0);
         SG::read_graphviz_sg(filenameHigh, g1);
     } else {
@@ -243,7 +263,8 @@ int main(int argc, char *const argv[]) {
                 vm["exportExtendedLowInfoGraph"].as<string>();
         export_graph_merge_low_high_info(
                 extended_g, exportExtendedLowInfoGraph_filename,
-                output_file_path_extended, useSerialized, verbose, "Extended");
+                output_file_path_extended, useSerialized, useBinary, verbose,
+                "Extended");
     }
 
 #ifdef VISUALIZE
@@ -287,7 +308,7 @@ int main(int argc, char *const argv[]) {
                 vm["exportMergedGraph"].as<string>();
         export_graph_merge_low_high_info(merged_g, exportMergedGraph_filename,
                                          output_file_path_merged, useSerialized,
-                                         verbose, "Merged");
+                                         useBinary, verbose, "Merged");
     }
 
 #ifdef VISUALIZE
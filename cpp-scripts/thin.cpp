@@ -19,6 +19,7 @@
  * *******************************************************************/
 
 #include <iostream>
+#include <vector>
 
 // NeighborhoodTables.h contains strings with full-paths of the system where
 // DGtal was originally built or installed. So it cannot be used when DGtal
@@ -60,8 +61,12 @@ int main(int argc, char* const argv[]) {
                          po::value<std::string>()->default_value("white"),
                          "foreground color in binary image. [black|white]");
   opt_desc.add_options()(
-      "persistence,p", po::value<int>()->default_value(0),
-      "persistence value, implies use of persistence algorithm if p>=1");
+      "persistence,p",
+      po::value<std::vector<int>>()->multitoken()->default_value(
+        std::vector<int>{0}, "0"),
+      "persistence value, implies use of persistence algorithm if p>=1. "
+      "Multiple values (-p 0 2 4) write one image per value, "
+      "sharing the common passes of the thinning.");
   opt_desc.add_options()("profile", po::bool_switch()->default_value(false),
                          "profile algorithm");
   opt_desc.add_options()("verbose,v", po::bool_switch()->default_value(false),
@@ -82,6 +87,17 @@ int main(int argc, char* const argv[]) {
       "tables_folder,l", po::value<std::string>()->default_value(tables_folder_default),
       "Folder where the DGtal look-up-tables are located. "
       "For example simplicity_table26_6.zlib");
+  opt_desc.add_options()(
+      "engine", po::value<std::string>()->default_value("asymmetric"),
+      "thinning engine. Valid: asymmetric, parallel. "
+      "parallel removes simple voxels by subfields in multiple threads, "
+      "--select and the distance map are not used. "
+      "parallel stores one bit per voxel, use it for large volumes, "
+      "asymmetric stores a DGtal::VoxelComplex, tens of bytes per voxel.");
+  opt_desc.add_options()(
+      "num_threads,j", po::value<size_t>()->default_value(0),
+      "number of threads for --engine=parallel, 0 to use all the hardware "
+      "threads.");
 
   po::variables_map vm;
   try {
@@ -100,10 +116,12 @@ int main(int argc, char* const argv[]) {
   std::string filename = vm["input"].as<std::string>();
   const bool verbose = vm["verbose"].as<bool>();
   const bool profile = vm["profile"].as<bool>();
-  int persistence = vm["persistence"].as<int>();
-  if(static_cast<bool>(vm.count("persistence")) && persistence < 0) {
-    throw po::validation_error(po::validation_error::invalid_option_value,
-                               "persistence");
+  const auto persistences = vm["persistence"].as<std::vector<int>>();
+  for(const auto & persistence : persistences) {
+    if(persistence < 0) {
+      throw po::validation_error(po::validation_error::invalid_option_value,
+                                 "persistence");
+    }
   }
   std::string foreground = vm["foreground"].as<std::string>();
   if(static_cast<bool>(vm.count("foreground")) &&
@@ -128,6 +146,13 @@ int main(int argc, char* const argv[]) {
                                "select");
   }
 
+  const std::string engine_string = vm["engine"].as<std::string>();
+  if(!(engine_string == "asymmetric" || engine_string == "parallel")) {
+    throw po::validation_error(po::validation_error::invalid_option_value,
+                               "engine");
+  }
+  const size_t num_threads = vm["num_threads"].as<size_t>();
+
   bool visualize = vm["visualize"].as<bool>();
 
   const auto exportImageFolder = vm["exportImage"].as<std::string>();
@@ -180,19 +205,21 @@ int main(int argc, char* const argv[]) {
         "tables_folder_path");
   }
 
-  SG::thin_function_io(
+  SG::thin_function_sweep_io(
       filename,
       sk_string,
       select_string,
       exportImageFolder,
       tables_folder,
-      persistence,
+      persistences,
       inputDistanceMapImageFilename,
       foreground,
       exportSDP,
       profile,
       verbose,
-      visualize
+      visualize,
+      engine_string,
+      num_threads
       );
 
   /*-------------- End of parse -----------------------------*/
@@ -146,17 +146,18 @@ int main(int argc, char *const argv[]) {
     reader->Update();
 
     // Read vertex_to_label_map
-    const auto vertex_to_label_map =
-            SG::read_vertex_to_label_map(vertex_to_label_map_filename);
-    // Read edge_to_label_map
-    const auto edge_to_label_map =
+    const auto vertex_labels =
+            SG::read_vertex_labels(vertex_to_label_map_filename);
+    // Read edge_to_label_map, looking up its edges in the graph
+    const auto edge_labels =
             (edge_to_label_map_filename == "max")
-                    ? SG::create_edge_to_label_map_from_vertex_to_label_map_using_max(
-                              graph, vertex_to_label_map)
-                    : SG::read_edge_to_label_map(edge_to_label_map_filename);
+                    ? SG::create_edge_labels_from_vertex_labels_using_max(
+                              graph, vertex_labels)
+                    : SG::read_edge_labels(edge_to_label_map_filename,
+                                           SG::EdgeIndex<SG::GraphType>(graph));
 
     const auto voxelized_image = SG::voxelize_graph(
-            graph, reader->GetOutput(), vertex_to_label_map, edge_to_label_map,
+            graph, reader->GetOutput(), vertex_labels, edge_labels,
             graph_positions_are_in_physical_space);
 
     using WriterType = itk::ImageFileWriter<ImageType>;
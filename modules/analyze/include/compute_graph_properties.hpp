@@ -21,6 +21,7 @@
 #ifndef COMPUTE_GRAPH_PROPERTIES_HPP
 #define COMPUTE_GRAPH_PROPERTIES_HPP
 
+#include "frozen_spatial_graph.hpp"
 #include "spatial_graph.hpp"
 
 namespace SG {
@@ -28,11 +29,17 @@ namespace SG {
 /*
  * Compute degree of all nodes
  *
+ * All the functions computing graph properties accept a GraphType or
+ * a FrozenSpatialGraph, the latter is faster to traverse for large graphs.
+ * Graphs from 2D images (GraphType2D) are also accepted.
+ *
  * @param sg input spatial graph
  *
  * @return vector with degrees
  */
 std::vector<unsigned int> compute_degrees(const SG::GraphAL &sg);
+std::vector<unsigned int> compute_degrees(const SG::FrozenSpatialGraph &sg);
+std::vector<unsigned int> compute_degrees(const SG::GraphType2D &sg);
 
 /**
  * Compute end to end distances of nodes
@@ -48,6 +55,12 @@ std::vector<unsigned int> compute_degrees(const SG::GraphAL &sg);
 std::vector<double> compute_ete_distances(const SG::GraphAL &sg,
                                           const size_t minimum_size_edges = 0,
                                           bool ignore_end_nodes = false);
+std::vector<double> compute_ete_distances(const SG::FrozenSpatialGraph &sg,
+                                          const size_t minimum_size_edges = 0,
+                                          bool ignore_end_nodes = false);
+std::vector<double> compute_ete_distances(const SG::GraphType2D &sg,
+                                          const size_t minimum_size_edges = 0,
+                                          bool ignore_end_nodes = false);
 
 /**
  * Compute contour distances, taking into account every point in the spatial
@@ -62,6 +75,14 @@ std::vector<double> compute_ete_distances(const SG::GraphAL &sg,
 std::vector<double> compute_contour_lengths(const SG::GraphAL &sg,
                                             const size_t minimum_size_edges = 0,
                                             bool ignore_end_nodes = false);
+std::vector<double>
+compute_contour_lengths(const SG::FrozenSpatialGraph &sg,
+                        const size_t minimum_size_edges = 0,
+                        bool ignore_end_nodes = false);
+std::vector<double>
+compute_contour_lengths(const SG::GraphType2D &sg,
+                        const size_t minimum_size_edges = 0,
+                        bool ignore_end_nodes = false);
 
 /**
  * Compute angles between adjacent edges in sg
@@ -80,6 +101,14 @@ std::vector<double> compute_angles(const SG::GraphAL &sg,
                                    const size_t minimum_size_edges = 0,
                                    const bool ignore_parallel_edges = false,
                                    const bool ignore_end_nodes = false);
+std::vector<double> compute_angles(const SG::FrozenSpatialGraph &sg,
+                                   const size_t minimum_size_edges = 0,
+                                   const bool ignore_parallel_edges = false,
+                                   const bool ignore_end_nodes = false);
+std::vector<double> compute_angles(const SG::GraphType2D &sg,
+                                   const size_t minimum_size_edges = 0,
+                                   const bool ignore_parallel_edges = false,
+                                   const bool ignore_end_nodes = false);
 
 /**
  * Compute std::cos of input angles.
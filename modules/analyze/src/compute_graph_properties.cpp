@@ -19,11 +19,15 @@
  * *******************************************************************/
 
 #include "compute_graph_properties.hpp"
+#include "array_utilities_batch.hpp"
 #include "edge_points_utilities.hpp"
 
 namespace SG {
 
-std::vector<unsigned int> compute_degrees(const SG::GraphType &sg) {
+namespace {
+/* Implementations shared by GraphType, GraphType2D and FrozenSpatialGraph */
+template <typename TGraph>
+std::vector<unsigned int> compute_degrees_impl(const TGraph &sg) {
     std::vector<unsigned int> degrees;
     const auto verts = boost::vertices(sg);
     for (auto vi = verts.first; vi != verts.second; ++vi) {
@@ -32,10 +36,14 @@ std::vector<unsigned int> compute_degrees(const SG::GraphType &sg) {
     return degrees;
 }
 
-std::vector<double> compute_ete_distances(const SG::GraphType &sg,
-                                          const size_t minimum_size_edges,
-                                          bool ignore_end_nodes) {
-    std::vector<double> ete_distances;
+template <typename TGraph>
+std::vector<double> compute_ete_distances_impl(const TGraph &sg,
+                                               const size_t minimum_size_edges,
+                                               bool ignore_end_nodes) {
+    // Gather the end points of the edges, and compute all the distances at
+    // once.
+    ArrayUtilities::Array3DBatch sources;
+    ArrayUtilities::Array3DBatch targets;
     const auto edges = boost::edges(sg);
     for (auto ei = edges.first; ei != edges.second; ++ei) {
         const auto &eps = sg[*ei].edge_points;
@@ -50,14 +58,17 @@ std::vector<double> compute_ete_distances(const SG::GraphType &sg,
             continue;
         }
 
-        ete_distances.emplace_back(SG::ete_distance(*ei, sg));
+        sources.push_back(sg[source].pos);
+        targets.push_back(sg[target].pos);
     }
-    return ete_distances;
+    return ArrayUtilities::distances(targets, sources);
 }
 
-std::vector<double> compute_contour_lengths(const SG::GraphType &sg,
-                                            const size_t minimum_size_edges,
-                                            bool ignore_end_nodes) {
+template <typename TGraph>
+std::vector<double>
+compute_contour_lengths_impl(const TGraph &sg,
+                             const size_t minimum_size_edges,
+                             bool ignore_end_nodes) {
     std::vector<double> contour_lengths;
     const auto edges = boost::edges(sg);
     for (auto ei = edges.first; ei != edges.second; ++ei) {
@@ -75,11 +86,14 @@ std::vector<double> compute_contour_lengths(const SG::GraphType &sg,
     return contour_lengths;
 }
 
-std::vector<double> compute_angles(const SG::GraphType &sg,
-                                   const size_t minimum_size_edges,
-                                   const bool ignore_parallel_edges,
-                                   const bool ignore_end_nodes) {
-    std::vector<double> ete_angles;
+template <typename TGraph>
+std::vector<double> compute_angles_impl(const TGraph &sg,
+                                        const size_t minimum_size_edges,
+                                        const bool ignore_parallel_edges,
+                                        const bool ignore_end_nodes) {
+    // Gather the pairs of edge vectors, and compute all the angles at once.
+    ArrayUtilities::Array3DBatch first_edges;
+    ArrayUtilities::Array3DBatch second_edges;
     const auto verts = boost::vertices(sg);
     // From
     // http://www.boost.org/doc/libs/1_66_0/libs/graph/doc/IncidenceGraph.html
@@ -123,14 +137,87 @@ std::vector<double> compute_angles(const SG::GraphType &sg,
                     continue;
                 }
 
-                ete_angles.emplace_back(ArrayUtilities::angle(
-                        ArrayUtilities::minus(sg[target1].pos, sg[source].pos),
-                        ArrayUtilities::minus(sg[target2].pos,
-                                              sg[source].pos)));
+                first_edges.push_back(
+                        ArrayUtilities::minus(sg[target1].pos, sg[source].pos));
+                second_edges.push_back(
+                        ArrayUtilities::minus(sg[target2].pos, sg[source].pos));
             }
         }
     }
-    return ete_angles;
+    return ArrayUtilities::angles(first_edges, second_edges);
+}
+} // namespace
+
+std::vector<unsigned int> compute_degrees(const SG::GraphType &sg) {
+    return compute_degrees_impl(sg);
+}
+std::vector<unsigned int> compute_degrees(const SG::FrozenSpatialGraph &sg) {
+    return compute_degrees_impl(sg);
+}
+std::vector<unsigned int> compute_degrees(const SG::GraphType2D &sg) {
+    return compute_degrees_impl(sg);
+}
+
+std::vector<double> compute_ete_distances(const SG::GraphType &sg,
+                                          const size_t minimum_size_edges,
+                                          bool ignore_end_nodes) {
+    return compute_ete_distances_impl(sg, minimum_size_edges,
+                                      ignore_end_nodes);
+}
+std::vector<double> compute_ete_distances(const SG::FrozenSpatialGraph &sg,
+                                          const size_t minimum_size_edges,
+                                          bool ignore_end_nodes) {
+    return compute_ete_distances_impl(sg, minimum_size_edges,
+                                      ignore_end_nodes);
+}
+std::vector<double> compute_ete_distances(const SG::GraphType2D &sg,
+                                          const size_t minimum_size_edges,
+                                          bool ignore_end_nodes) {
+    return compute_ete_distances_impl(sg, minimum_size_edges,
+                                      ignore_end_nodes);
+}
+
+std::vector<double> compute_contour_lengths(const SG::GraphType &sg,
+                                            const size_t minimum_size_edges,
+                                            bool ignore_end_nodes) {
+    return compute_contour_lengths_impl(sg, minimum_size_edges,
+                                        ignore_end_nodes);
+}
+std::vector<double>
+compute_contour_lengths(const SG::FrozenSpatialGraph &sg,
+                        const size_t minimum_size_edges,
+                        bool ignore_end_nodes) {
+    return compute_contour_lengths_impl(sg, minimum_size_edges,
+                                        ignore_end_nodes);
+}
+std::vector<double>
+compute_contour_lengths(const SG::GraphType2D &sg,
+                        const size_t minimum_size_edges,
+                        bool ignore_end_nodes) {
+    return compute_contour_lengths_impl(sg, minimum_size_edges,
+                                        ignore_end_nodes);
+}
+
+std::vector<double> compute_angles(const SG::GraphType &sg,
+                                   const size_t minimum_size_edges,
+                                   const bool ignore_parallel_edges,
+                                   const bool ignore_end_nodes) {
+    return compute_angles_impl(sg, minimum_size_edges, ignore_parallel_edges,
+                               ignore_end_nodes);
+}
+std::vector<double> compute_angles(const SG::FrozenSpatialGraph &sg,
+                                   const size_t minimum_size_edges,
+                                   const bool ignore_parallel_edges,
+                                   const bool ignore_end_nodes) {
+    return compute_angles_impl(sg, minimum_size_edges, ignore_parallel_edges,
+                               ignore_end_nodes);
+}
+std::vector<double> compute_angles(const SG::GraphType2D &sg,
+                                   const size_t minimum_size_edges,
+                                   const bool ignore_parallel_edges,
+                                   const bool ignore_end_nodes) {
+    return compute_angles_impl(sg, minimum_size_edges, ignore_parallel_edges,
+                               ignore_end_nodes);
 }
 
 std::vector<double> compute_cosines(const std::vector<double> &angles) {
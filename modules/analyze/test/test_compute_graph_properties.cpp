@@ -114,6 +114,51 @@ TEST_F(PlusSymbolFixture, compute_angles_cosines) {
     }
 }
 
+/**
+ * Same as PlusSymbolFixture, but in 2D.
+ */
+struct PlusSymbol2DFixture : public ::testing::Test {
+    using GraphType = SG::GraphType2D;
+    GraphType g;
+    void SetUp() override {
+        this->g = GraphType(5);
+        g[0].pos = {{0, 3}};
+        g[1].pos = {{0, 0}};
+        g[2].pos = {{0, -3}};
+        g[3].pos = {{2, 0}};
+        g[4].pos = {{-2, 0}};
+        SG::SpatialEdge2D se01;
+        se01.edge_points = {{{0, 1}}, {{0, 2}}};
+        boost::add_edge(0, 1, se01, g);
+        SG::SpatialEdge2D se12;
+        se12.edge_points = {{{0, -1}}, {{0, -2}}};
+        boost::add_edge(1, 2, se12, g);
+        SG::SpatialEdge2D se13;
+        se13.edge_points = {{{1, 0}}};
+        boost::add_edge(1, 3, se13, g);
+        SG::SpatialEdge2D se14;
+        se14.edge_points = {{{-1, 0}}};
+        boost::add_edge(1, 4, se14, g);
+    }
+};
+
+TEST_F(PlusSymbol2DFixture, compute_graph_properties) {
+    constexpr auto pi = 3.14159265358979323846;
+    auto angles = SG::compute_angles(g);
+    std::sort(angles.begin(), angles.end());
+    std::vector<double> expected_angles = {pi, pi / 2.0, pi / 2.0,
+                                           pi, pi / 2.0, pi / 2.0};
+    std::sort(expected_angles.begin(), expected_angles.end());
+    EXPECT_EQ(angles, expected_angles);
+
+    auto degrees = SG::compute_degrees(g);
+    EXPECT_EQ(degrees, (std::vector<unsigned int>{1, 4, 1, 1, 1}));
+    auto ete_distances = SG::compute_ete_distances(g);
+    EXPECT_EQ(ete_distances, (std::vector<double>{3, 3, 2, 2}));
+    auto contour_lengths = SG::compute_contour_lengths(g);
+    EXPECT_EQ(contour_lengths, (std::vector<double>{3, 3, 2, 2}));
+}
+
 struct OneEdge : public ::testing::Test {
     using GraphType = SG::GraphAL;
     GraphType g;
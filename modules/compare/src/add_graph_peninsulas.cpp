@@ -24,8 +24,6 @@
 #include "graph_points_locator.hpp"
 #include "spatial_graph_difference.hpp"
 #include "split_edge.hpp"
-#include <boost/graph/connected_components.hpp>
-#include <tuple> // For std::tie
 #include <vtkIdList.h>
 #include <vtkPolyData.h>
 
@@ -57,16 +55,15 @@ AddGraphPeninsulasResult add_graph_peninsulas(
     const size_t diff_graph_index = graphs.size();
 
     // Compute the number of components
-    std::unordered_map<GraphType::vertex_descriptor, int> components_map;
-    size_t num_of_components = boost::connected_components(
-            g_diff, boost::make_assoc_property_map(components_map));
+    const auto components = connected_components_union_find(g_diff);
+    const size_t num_of_components = components.size();
 
     std::vector<size_t> touch_extended_graph_count(num_of_components);
     std::vector<std::vector<IdWithGraphDescriptor>> touching_descriptors(
             num_of_components);
-    for (const auto &comp : components_map) {
-        const auto &vertex_d = comp.first;
-        const auto &component_index = comp.second;
+    for (GraphType::vertex_descriptor vertex_d = 0;
+         vertex_d < components.vertex_component.size(); ++vertex_d) {
+        const auto &component_index = components.vertex_component[vertex_d];
         auto pos = g_diff[vertex_d].pos;
         auto closeIdList = graph_closest_points_by_radius_locator(pos, octree,
                                                                   radius_touch);
@@ -92,9 +89,7 @@ AddGraphPeninsulasResult add_graph_peninsulas(
     // Add islands and peninsulas to the extended graph
     GraphType result_sg = graphs[extended_graph_index];
     // XXX: How we add these components?
-    // - filtered_graph to get iterators to these components.
-    auto filtered_component_graphs =
-            filter_component_graphs(g_diff, num_of_components, components_map);
+    // - the edges of each component are listed in components.
     for (unsigned int comp_graph_index = 0;
          comp_graph_index < num_of_components; ++comp_graph_index) {
         // Only analyze isolated components and peninsulas
@@ -143,15 +138,16 @@ AddGraphPeninsulasResult add_graph_peninsulas(
             // Except if source/target is a touching node, then add no edge
             // but use the existing node in result graph
             // Information about that vertex in: already_added_vertex
-            auto &component_graph = filtered_component_graphs[comp_graph_index];
-            ComponentGraphType::edge_iterator ei, ei_end;
-            std::tie(ei, ei_end) = boost::edges(component_graph);
-            for (; ei != ei_end; ++ei) {
-                auto source = boost::source(*ei, component_graph);
-                auto target = boost::target(*ei, component_graph);
-                auto &source_spatial_node = component_graph[source];
-                auto &target_spatial_node = component_graph[target];
-                auto &component_edge = component_graph[*ei];
+            for (size_t edge_index =
+                         components.edge_offsets[comp_graph_index];
+                 edge_index < components.edge_offsets[comp_graph_index + 1];
+                 ++edge_index) {
+                const auto &ed = components.edges[edge_index];
+                auto source = boost::source(ed, g_diff);
+                auto target = boost::target(ed, g_diff);
+                auto &source_spatial_node = g_diff[source];
+                auto &target_spatial_node = g_diff[target];
+                auto &component_edge = g_diff[ed];
                 const auto &touching_diff_descriptor =
                         touching_descriptors[comp_graph_index][diff_graph_index]
                                 .descriptor;
@@ -21,6 +21,7 @@
 #include "extend_low_info_graph.hpp"
 #include "extend_low_info_graph_visitor.hpp"
 #include <tuple> // For std::tie
+#include <vector>
 
 namespace SG {
 
@@ -48,10 +49,12 @@ GraphType extend_low_info_graph_via_dfs(
     using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
     using vertex_iterator = boost::graph_traits<GraphType>::vertex_iterator;
 
-    using ColorMap = std::map<vertex_descriptor, boost::default_color_type>;
-    ColorMap colorMap;
-    using Color = boost::color_traits<ColorMap::mapped_type>;
-    boost::associative_property_map<ColorMap> propColorMap(colorMap);
+    // vecS graph: the vertex_descriptor is the index in the color vector.
+    using ColorMap = std::vector<boost::default_color_type>;
+    using Color = boost::color_traits<ColorMap::value_type>;
+    ColorMap colorMap(boost::num_vertices(input_sg), Color::white());
+    auto propColorMap = boost::make_iterator_property_map(
+            colorMap.begin(), boost::get(boost::vertex_index, input_sg));
 
     using VertexMap = std::unordered_map<vertex_descriptor, vertex_descriptor>;
     VertexMap vertex_map;
@@ -60,12 +63,6 @@ GraphType extend_low_info_graph_via_dfs(
             result_sg, graphs, idMap, octree, radius, colorMap, vertex_map,
             verbose);
 
-    // Mark as unvisited (white) all the vertices
-    vertex_iterator ui, ui_end;
-    for (std::tie(ui, ui_end) = boost::vertices(input_sg); ui != ui_end; ++ui) {
-        put(propColorMap, *ui, Color::white());
-    }
-
     vertex_iterator vi, vi_end;
     std::tie(vi, vi_end) = boost::vertices(input_sg);
     vertex_descriptor start;
@@ -0,0 +1,106 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef ARENA_SPATIAL_GRAPH_HPP
+#define ARENA_SPATIAL_GRAPH_HPP
+
+#include "point_arena.hpp"
+#include "spatial_graph.hpp"
+#include <boost/container/small_vector.hpp>
+#include <memory>
+
+namespace SG {
+
+/**
+ * Number of points stored inline in ArenaPointContainer, without
+ * allocation. Most edges of a reduced graph obtained from a skeleton are
+ * short.
+ */
+constexpr size_t arena_point_container_inline_size = 4;
+
+/**
+ * Container of edge points with small buffer optimization. Larger edges
+ * take their points from the PointArena of the current scope (or from the
+ * heap if there is no scope).
+ */
+using ArenaPointContainer =
+        boost::container::small_vector<PointType,
+                                       arena_point_container_inline_size,
+                                       ArenaAllocator<PointType>>;
+
+/** SpatialEdge with edge points stored in a PointArena. */
+struct ArenaSpatialEdge {
+    ArenaPointContainer edge_points;
+};
+
+/**
+ * Spatial graph with edge points stored in a PointArena.
+ * Same vertices and edge order than GraphType, see ArenaSpatialGraph to own the arena.
+ */
+using ArenaGraphType = boost::adjacency_list<boost::listS,
+                                             boost::vecS,
+                                             boost::undirectedS,
+                                             SpatialNode,
+                                             ArenaSpatialEdge>;
+
+/**
+ * ArenaGraphType owning the PointArena of its edge points. The graph is
+ * destroyed before the arena, and all the edge points are released at
+ * once.
+ *
+ * Edges added to graph() must be added inside a PointArena::Scope of
+ * arena(), otherwise they allocate from the heap:
+ *
+ *     PointArena::Scope scope(arena_sg.arena());
+ *     boost::add_edge(u, v, arena_sg.graph());
+ *
+ * It is movable but not copyable, use to_spatial_graph to get a copy.
+ */
+class ArenaSpatialGraph {
+  public:
+    explicit ArenaSpatialGraph(
+            const size_t num_vertices = 0,
+            const size_t block_size = PointArena::default_block_size);
+    ArenaSpatialGraph(ArenaSpatialGraph &&) = default;
+    ArenaSpatialGraph &operator=(ArenaSpatialGraph &&) = default;
+    ArenaSpatialGraph(const ArenaSpatialGraph &) = delete;
+    ArenaSpatialGraph &operator=(const ArenaSpatialGraph &) = delete;
+
+    ArenaGraphType &graph() { return *m_graph; }
+    const ArenaGraphType &graph() const { return *m_graph; }
+    PointArena &arena() { return *m_arena; }
+    const PointArena &arena() const { return *m_arena; }
+
+  private:
+    // Declared first, so it is destroyed last.
+    std::unique_ptr<PointArena> m_arena;
+    // adjacency_list has no move constructor, keep it in the heap to move
+    // the graph without copying it.
+    std::unique_ptr<ArenaGraphType> m_graph;
+};
+
+/** Copy the input graph, with the edge points stored in a new arena. */
+ArenaSpatialGraph to_arena_spatial_graph(const GraphType &graph);
+
+/** Copy the arena graph to a GraphType. */
+GraphType to_spatial_graph(const ArenaGraphType &arena_graph);
+
+} // namespace SG
+#endif
@@ -10,6 +10,7 @@
 #ifndef ARRAY_UTILITIES_HPP_
 #define ARRAY_UTILITIES_HPP_
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <numeric>
@@ -193,9 +194,19 @@ inline double distance(const Array3D &lhs, const Array3D &rhs) {
     return norm(minus(lhs, rhs));
 }
 
+/**
+ * Cosine of the angle between lhs and rhs, computed as the normalized
+ * dot product, without going through angle.
+ * It is 1.0 if any of the arrays is null, as angle returns 0 in that case.
+ * @sa cos_directors in array_utilities_batch.hpp for many pairs.
+ */
 inline Array3D::value_type cos_director(const Array3D &lhs,
                                         const Array3D &rhs) {
-    return std::cos(angle(lhs, rhs));
+    const auto norms = norm(lhs) * norm(rhs);
+    if (!(norms > 0.0)) {
+        return 1.0;
+    }
+    return std::min(std::max(dot_product(lhs, rhs) / norms, -1.0), 1.0);
 }
 
 /**
@@ -221,5 +232,67 @@ inline std::string to_string(const Array3D &a, bool comma_separated = false) {
     }
     return ss.str();
 }
+/**
+ * Overloads for 2D arrays, used by the 2D spatial graphs.
+ * The cross_product of two 2D arrays is the z component of the 3D cross
+ * product, the signed area of the parallelogram formed by a,b.
+ */
+using Array2D = std::array<double, 2>;
+
+inline Array2D::value_type cross_product(const Array2D &a, const Array2D &b) {
+    return a[0] * b[1] - a[1] * b[0];
+}
+
+inline Array2D::value_type dot_product(const Array2D &a, const Array2D &b) {
+    return a[0] * b[0] + a[1] * b[1];
+}
+
+inline Array2D::value_type norm(const Array2D &a) {
+    return sqrt(dot_product(a, a));
+}
+
+inline Array2D::value_type angle(const Array2D &a, const Array2D &b) {
+    return std::atan2(std::abs(cross_product(a, b)), dot_product(a, b));
+}
+
+inline Array2D plus(const Array2D &lhs, const Array2D &rhs) {
+    return {{lhs[0] + rhs[0], lhs[1] + rhs[1]}};
+}
+
+inline Array2D minus(const Array2D &lhs, const Array2D &rhs) {
+    return {{lhs[0] - rhs[0], lhs[1] - rhs[1]}};
+}
+
+inline Array2D product_scalar(const Array2D &lhs,
+                              const Array2D::value_type &scalar) {
+    return {{lhs[0] * scalar, lhs[1] * scalar}};
+}
+
+inline double distance(const Array2D &lhs, const Array2D &rhs) {
+    return norm(minus(lhs, rhs));
+}
+
+inline std::string to_string(const Array2D &a, bool comma_separated = false) {
+    std::ostringstream ss;
+    ss << a[0] << (comma_separated ? ", " : " ") << a[1];
+    return ss.str();
+}
+
+/**
+ * Overload for arrays of other coordinate types, i.e. the int32_t points
+ * of the graphs in index space.
+ */
+template <typename T, size_t N>
+inline std::string to_string(const std::array<T, N> &a,
+                             bool comma_separated = false) {
+    std::ostringstream ss;
+    for (size_t i = 0; i < N; ++i) {
+        ss << a[i];
+        if (i != N - 1) {
+            ss << (comma_separated ? ", " : " ");
+        }
+    }
+    return ss.str();
+}
 } // namespace ArrayUtilities
 #endif
@@ -0,0 +1,142 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef ARRAY_UTILITIES_BATCH_HPP
+#define ARRAY_UTILITIES_BATCH_HPP
+
+#include "array_utilities.hpp"
+#include <vector>
+
+namespace ArrayUtilities {
+
+/**
+ * Batch of arrays stored as structure of arrays: one contiguous vector per
+ * coordinate, so the batch kernels below can load several arrays at once.
+ *
+ * Array2D are stored with z = 0, the distances, cos_directors and angles
+ * are the same than the 2D ones.
+ */
+struct Array3DBatch {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+
+    Array3DBatch() = default;
+    explicit Array3DBatch(const size_t n) : x(n), y(n), z(n) {}
+    template <typename TArray>
+    explicit Array3DBatch(const std::vector<TArray> &arrays) {
+        reserve(arrays.size());
+        for (const auto &a : arrays) {
+            push_back(a);
+        }
+    }
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+    void reserve(const size_t n) {
+        x.reserve(n);
+        y.reserve(n);
+        z.reserve(n);
+    }
+    void clear() {
+        x.clear();
+        y.clear();
+        z.clear();
+    }
+    void push_back(const Array3D &a) {
+        x.push_back(a[0]);
+        y.push_back(a[1]);
+        z.push_back(a[2]);
+    }
+    void push_back(const Array2D &a) {
+        x.push_back(a[0]);
+        y.push_back(a[1]);
+        z.push_back(0.0);
+    }
+    Array3D operator[](const size_t i) const { return {{x[i], y[i], z[i]}}; }
+};
+
+/**
+ * Batch kernels over Array3DBatch.
+ *
+ * The element-wise kernels require inputs of the same size, and throw
+ * std::runtime_error otherwise. They use AVX-512 or AVX2 when the library is
+ * compiled for them (see SG_ENABLE_NATIVE_ARCH), and a scalar loop
+ * otherwise. The results are the same than the scalar functions.
+ */
+
+/** Element-wise distance(lhs[i], rhs[i]). */
+std::vector<double> distances(const Array3DBatch &lhs,
+                              const Array3DBatch &rhs);
+
+/** Distance between consecutive points, size() - 1 values. */
+std::vector<double> segment_lengths(const Array3DBatch &points);
+/** Sum of segment_lengths, the length of the polyline. */
+double polyline_length(const Array3DBatch &points);
+
+/**
+ * Element-wise cos_director(lhs[i], rhs[i]): the normalized dot product.
+ * As the angle between a null array and any other is zero, the
+ * cos_director is 1.0 in that case.
+ */
+std::vector<double> cos_directors(const Array3DBatch &lhs,
+                                  const Array3DBatch &rhs);
+
+/** Element-wise angle(lhs[i], rhs[i]) in [0, pi]. */
+std::vector<double> angles(const Array3DBatch &lhs, const Array3DBatch &rhs);
+
+/**
+ * Element-wise minus_with_boundary_condition_periodic: lhs[i] - rhs[i]
+ * with the minimum image convention.
+ */
+Array3DBatch
+minus_with_boundary_condition_periodic(const Array3DBatch &lhs,
+                                       const Array3DBatch &rhs,
+                                       const Array3D &size_box,
+                                       const Array3D &size_box_inverse);
+/** Difference with box of size 1.0 */
+Array3DBatch minus_with_boundary_condition_periodic(const Array3DBatch &lhs,
+                                                    const Array3DBatch &rhs);
+
+/** Element-wise distance_with_boundary_condition_periodic. */
+std::vector<double>
+distances_with_boundary_condition_periodic(const Array3DBatch &lhs,
+                                           const Array3DBatch &rhs,
+                                           const Array3D &size_box,
+                                           const Array3D &size_box_inverse);
+/** Distances with box of size 1.0 */
+std::vector<double>
+distances_with_boundary_condition_periodic(const Array3DBatch &lhs,
+                                           const Array3DBatch &rhs);
+
+/**
+ * Affine transform of each point, in place:
+ * points[i] = translation_after + matrix * (points[i] - translation_before)
+ *
+ * The matrix is row-major, see SG::ImageSpaceTransform for its use to
+ * transform between index and physical space.
+ */
+void affine_transform_in_place(Array3DBatch &points,
+                               const std::array<double, 9> &matrix,
+                               const Array3D &translation_before,
+                               const Array3D &translation_after);
+
+} // namespace ArrayUtilities
+#endif
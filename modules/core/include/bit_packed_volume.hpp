@@ -0,0 +1,217 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef BIT_PACKED_VOLUME_HPP
+#define BIT_PACKED_VOLUME_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace SG {
+
+/**
+ * Dense binary volume with one bit per voxel, covering the box
+ * [begin, begin + size) of an image, usually the bounding box of the
+ * foreground.
+ *
+ * A background voxel is added at each side of the box, and each row (fixed
+ * y and z) is stored in its own 64-bit words, so the 3x3x3 neighborhood of
+ * any voxel of the box is read with a few shifts per row, without bound
+ * checks or hashing.
+ *
+ * Voxels are identified by their bit position in the volume, see
+ * @ref voxel and @ref index. The bit of a neighbor is voxel + offset(dx,
+ * dy, dz).
+ *
+ * It is the storage of parallel_thinning. The asymmetric thinning still
+ * works on a DGtal::VoxelComplex, it needs the cliques of the complex.
+ */
+class BitPackedVolume {
+  public:
+    using IndexType = std::array<size_t, 3>;
+    using SizeType = std::array<size_t, 3>;
+
+    BitPackedVolume() = default;
+    /** Volume with all the voxels of the box in the background. */
+    BitPackedVolume(const IndexType &begin, const SizeType &size);
+
+    const IndexType &begin() const { return m_begin; }
+    const SizeType &size() const { return m_size; }
+    /** Number of voxels of the box. */
+    size_t num_voxels() const { return m_size[0] * m_size[1] * m_size[2]; }
+    /** Number of bytes used by the bits, including the padding. */
+    size_t num_bytes() const { return m_words.size() * sizeof(uint64_t); }
+
+    /** True if the index is inside the box. */
+    bool contains(const IndexType &index) const;
+    /** Bit of the voxel at index, that has to be inside the box. */
+    size_t voxel(const IndexType &index) const {
+        return (index[0] - m_begin[0] + 1) +
+               m_row_bits * ((index[1] - m_begin[1] + 1) +
+                             m_padded_size_y * (index[2] - m_begin[2] + 1));
+    }
+    /** Index of the voxel, inverse of @ref voxel. */
+    IndexType index(const size_t voxel) const;
+    /**
+     * Parity of the coordinates of the voxel: x & 1 | (y & 1) << 1 |
+     * (z & 1) << 2. Voxels with the same parity are not 26-neighbors.
+     */
+    size_t parity(const size_t voxel) const;
+    /** Difference between the bits of a voxel and its (dx, dy, dz) neighbor. */
+    std::ptrdiff_t offset(const int dx, const int dy, const int dz) const {
+        return dx + static_cast<std::ptrdiff_t>(m_row_bits) *
+                            (dy + static_cast<std::ptrdiff_t>(
+                                          m_padded_size_y) *
+                                          dz);
+    }
+
+    bool test(const size_t voxel) const {
+        return (m_words[voxel >> 6] >> (voxel & 63)) & 1;
+    }
+    void set(const size_t voxel) {
+        m_words[voxel >> 6] |= uint64_t(1) << (voxel & 63);
+    }
+    void reset(const size_t voxel) {
+        m_words[voxel >> 6] &= ~(uint64_t(1) << (voxel & 63));
+    }
+    /** Number of voxels in the foreground. */
+    size_t count() const;
+
+    /**
+     * 27-bit code of the 3x3x3 neighborhood of the voxel, including the
+     * voxel itself: the bit (dx + 1) + 3 * (dy + 1) + 9 * (dz + 1) is set if
+     * the neighbor (dx, dy, dz) is in the foreground.
+     * The voxel has to be inside the box.
+     */
+    uint32_t neighborhood(const size_t voxel) const {
+        uint32_t code = 0;
+        size_t row = voxel - m_row_bits - m_row_bits * m_padded_size_y;
+        for (size_t dz = 0; dz < 3; ++dz) {
+            for (size_t dy = 0; dy < 3; ++dy) {
+                code |= three_bits(row + m_row_bits * dy) << (9 * dz + 3 * dy);
+            }
+            row += m_row_bits * m_padded_size_y;
+        }
+        return code;
+    }
+
+    /**
+     * Call func(voxel) for each foreground voxel of the rows
+     * [rows_begin, rows_end), in increasing order of voxel.
+     * Row r has y = r % size[1] and z = r / size[1] (relative to begin).
+     * The words are scanned, so empty space is skipped 64 voxels at a time.
+     */
+    template <typename TFunction>
+    void for_each_in_rows(const size_t rows_begin,
+                          const size_t rows_end,
+                          const TFunction &func) const {
+        for (size_t row = rows_begin; row < rows_end; ++row) {
+            const size_t row_begin = m_row_bits * ((row % m_size[1]) + 1 +
+                                                   m_padded_size_y *
+                                                           ((row / m_size[1]) +
+                                                            1));
+            const size_t first_word = row_begin >> 6;
+            const size_t last_word = first_word + (m_row_bits >> 6);
+            for (size_t w = first_word; w < last_word; ++w) {
+                uint64_t word = m_words[w];
+                while (word != 0) {
+                    func((w << 6) + count_trailing_zeros(word));
+                    word &= word - 1;
+                }
+            }
+        }
+    }
+    /** Number of rows of the box, size[1] * size[2]. */
+    size_t num_rows() const { return m_size[1] * m_size[2]; }
+
+    bool operator==(const BitPackedVolume &other) const {
+        return m_begin == other.m_begin && m_size == other.m_size &&
+               m_words == other.m_words;
+    }
+    bool operator!=(const BitPackedVolume &other) const {
+        return !(*this == other);
+    }
+
+  private:
+    /** Position of the lowest set bit, word must not be zero. */
+    static size_t count_trailing_zeros(const uint64_t word) {
+#if defined(_MSC_VER)
+        unsigned long position;
+        _BitScanForward64(&position, word);
+        return position;
+#else
+        return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+    }
+    /** Bits [bit - 1, bit + 1] in the lowest 3 bits. */
+    uint32_t three_bits(const size_t bit) const {
+        const size_t first = bit - 1;
+        const size_t shift = first & 63;
+        uint64_t bits = m_words[first >> 6] >> shift;
+        if (shift > 61) {
+            // The padding at the end of the row ensures the next word exists.
+            bits |= m_words[(first >> 6) + 1] << (64 - shift);
+        }
+        return static_cast<uint32_t>(bits & 7);
+    }
+
+    IndexType m_begin = {{0, 0, 0}};
+    SizeType m_size = {{0, 0, 0}};
+    /** Bits per row, multiple of 64, with room for the padding voxels. */
+    size_t m_row_bits = 0;
+    size_t m_padded_size_y = 0;
+    std::vector<uint64_t> m_words;
+};
+
+/**
+ * Map the neighborhood codes of @ref BitPackedVolume::neighborhood to the
+ * configurations of a look-up table (for example the DGtal simplicity
+ * tables), with three table accesses.
+ */
+class NeighborhoodConfigurationMap {
+  public:
+    /**
+     * @param neighbor_masks configuration bit of each of the 26 neighbors,
+     * in the order of their code bit, skipping the center (bit 13).
+     * That is, x fastest and z slowest.
+     */
+    explicit NeighborhoodConfigurationMap(
+            const std::array<uint32_t, 26> &neighbor_masks);
+
+    /** Configuration of the neighborhood, the center voxel is ignored. */
+    uint32_t operator()(const uint32_t neighborhood) const {
+        return m_slices[0][neighborhood & 511] |
+               m_slices[1][(neighborhood >> 9) & 511] |
+               m_slices[2][(neighborhood >> 18) & 511];
+    }
+
+  private:
+    /** Configuration of each 3x3 slice (fixed dz) of the neighborhood. */
+    std::array<std::array<uint32_t, 512>, 3> m_slices;
+};
+
+} // namespace SG
+#endif
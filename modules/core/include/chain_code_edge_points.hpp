@@ -0,0 +1,187 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef CHAIN_CODE_EDGE_POINTS_HPP
+#define CHAIN_CODE_EDGE_POINTS_HPP
+
+#include "spatial_graph.hpp"
+#include "transform_to_physical_point.hpp" // for DirectionMatrixType
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Compact storage of edge points that lie in the voxel lattice (index
+ * space), as the ones obtained from raw_graph_from_image and
+ * reduce_spatial_graph_via_dfs before transforming to physical space.
+ *
+ * The first point is stored as an integer index. Each following point is
+ * stored as a 5-bit code of the step to one of its 26 neighbors.
+ * Consecutive points that are not neighbors (or are repeated) are stored
+ * with an escape code plus the integer index of the point, so any
+ * sequence of integer points can be encoded.
+ *
+ * Points are decoded lazily while iterating. Use decode with
+ * origin/spacing/direction to get the points in physical space, see
+ * @ref index_array_to_physical_space_array.
+ */
+class ChainCodeEdgePoints {
+  public:
+    using IndexType = std::array<int32_t, 3>;
+    static constexpr size_t bits_per_code = 5;
+    static constexpr size_t codes_per_word = 64 / bits_per_code;
+    static constexpr uint64_t code_mask = (1u << bits_per_code) - 1;
+    /** Code used for points that are not a 26-neighbor of the previous. */
+    static constexpr uint8_t restart_code = 31;
+
+    /** Forward iterator decoding the points in index space. */
+    class const_iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PointType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const PointType *;
+        using reference = const PointType &;
+
+        const_iterator() = default;
+        reference operator*() const { return m_point; }
+        pointer operator->() const { return &m_point; }
+        const_iterator &operator++();
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const const_iterator &other) const {
+            return m_index == other.m_index;
+        }
+        bool operator!=(const const_iterator &other) const {
+            return !(*this == other);
+        }
+
+      private:
+        friend class ChainCodeEdgePoints;
+        const_iterator(const ChainCodeEdgePoints *chain, const size_t index);
+        void set_point();
+
+        const ChainCodeEdgePoints *m_chain = nullptr;
+        size_t m_index = 0;
+        size_t m_restart_index = 0;
+        IndexType m_current = {{0, 0, 0}};
+        PointType m_point = {{0, 0, 0}};
+    };
+
+    ChainCodeEdgePoints() = default;
+    /**
+     * Encode the input points.
+     * Throws if any coordinate is not an integer that fits in int32_t.
+     */
+    explicit ChainCodeEdgePoints(const PointContainer &edge_points);
+
+    /** True if all the coordinates are integers that fit in int32_t. */
+    static bool is_encodable(const PointContainer &edge_points);
+
+    /** Append a point at the end of the chain. Throws if not encodable. */
+    void push_back(const PointType &point);
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    /** Decode all the points in index space. */
+    PointContainer decode() const;
+    /** Decode all the points, transformed to physical space. */
+    PointContainer decode(const PointType &origin,
+                          const PointType &spacing,
+                          const DirectionMatrixType &direction) const;
+
+    /** Number of bytes used by the encoded points (excluding sizeof). */
+    size_t num_bytes() const {
+        return m_codes.capacity() * sizeof(uint64_t) +
+               m_restarts.capacity() * sizeof(IndexType);
+    }
+
+    bool operator==(const ChainCodeEdgePoints &other) const {
+        return m_size == other.m_size && m_codes == other.m_codes &&
+               m_restarts == other.m_restarts;
+    }
+    bool operator!=(const ChainCodeEdgePoints &other) const {
+        return !(*this == other);
+    }
+
+    /** Code of the step, or restart_code if not a 26-neighbor. */
+    static uint8_t step_to_code(const IndexType &from, const IndexType &to);
+    static IndexType code_to_step(const uint8_t code);
+
+  private:
+    uint8_t code(const size_t code_index) const {
+        return static_cast<uint8_t>(
+                (m_codes[code_index / codes_per_word] >>
+                 (bits_per_code * (code_index % codes_per_word))) &
+                code_mask);
+    }
+    void push_code(const uint8_t code);
+
+    /** Number of points. The number of codes is m_size - 1. */
+    size_t m_size = 0;
+    /** Last point, to encode the next step. */
+    IndexType m_last = {{0, 0, 0}};
+    std::vector<uint64_t> m_codes;
+    /** First point, and the points after each restart_code. */
+    std::vector<IndexType> m_restarts;
+};
+
+/** SpatialEdge with edge points stored as ChainCodeEdgePoints. */
+struct CompactSpatialEdge {
+    ChainCodeEdgePoints edge_points;
+};
+
+/**
+ * Spatial graph in index space with compact edges.
+ * Same vertices and edge order than the GraphType it was created from.
+ */
+using CompactGraphType = boost::adjacency_list<boost::listS,
+                                               boost::vecS,
+                                               boost::undirectedS,
+                                               SpatialNode,
+                                               CompactSpatialEdge>;
+
+/**
+ * Encode the edge points of a graph in index space.
+ * Throws if any edge point is not in the lattice, i.e the graph was
+ * already transformed to physical space.
+ */
+CompactGraphType compact_spatial_graph(const GraphType &graph);
+
+/** Decode the compact graph, the positions are kept in index space. */
+GraphType to_spatial_graph(const CompactGraphType &compact_graph);
+/** Decode the compact graph and transform it to physical space. */
+GraphType to_spatial_graph(const CompactGraphType &compact_graph,
+                           const PointType &origin,
+                           const PointType &spacing,
+                           const DirectionMatrixType &direction);
+
+} // namespace SG
+#endif
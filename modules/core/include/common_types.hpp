@@ -22,11 +22,26 @@
 #define SG_COMMON_TYPES_HPP
 
 #include "array_utilities.hpp"
+#include <array>
+#include <cstddef>
 #include <vector>
 
 namespace SG {
-using PointType = ArrayUtilities::Array3D;
-using PointContainer = std::vector<PointType>;
+/**
+ * Point and container of points with TDimension coordinates of type TScalar.
+ * SGEXT works with double 3D coordinates (PointType), float and int32_t
+ * (voxel index) coordinates are used to reduce memory.
+ * 2D images use 2D points (PointType2D), without a padded z coordinate.
+ */
+template <typename TScalar, size_t TDimension = 3>
+using PointTypeT = std::array<TScalar, TDimension>;
+template <typename TScalar, size_t TDimension = 3>
+using PointContainerT = std::vector<PointTypeT<TScalar, TDimension>>;
+
+using PointType = PointTypeT<double>; // same as ArrayUtilities::Array3D
+using PointContainer = PointContainerT<double>;
+using PointType2D = PointTypeT<double, 2>; // same as ArrayUtilities::Array2D
+using PointContainer2D = PointContainerT<double, 2>;
 /// Help reader to differentiate a point from a vector
 using VectorType = ArrayUtilities::Array3D;
 } // namespace SG
@@ -0,0 +1,170 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef CONVERT_SPATIAL_GRAPH_HPP
+#define CONVERT_SPATIAL_GRAPH_HPP
+
+#include "spatial_graph.hpp"
+#include "transform_to_physical_point.hpp" // for DirectionMatrixType
+#include <cmath>
+#include <type_traits>
+
+namespace SG {
+
+/**
+ * Convert a coordinate, rounding to the nearest integer when converting
+ * from floating point to integer coordinates.
+ */
+template <typename TOutScalar, typename TInScalar>
+inline TOutScalar convert_scalar(const TInScalar &value) {
+    constexpr bool round_value = std::is_integral<TOutScalar>::value &&
+                                 !std::is_integral<TInScalar>::value;
+    return static_cast<TOutScalar>(round_value ? std::round(value) : value);
+}
+
+template <typename TOutScalar, typename TInScalar>
+inline PointTypeT<TOutScalar> convert_point(const PointTypeT<TInScalar> &point) {
+    return {{convert_scalar<TOutScalar>(point[0]),
+             convert_scalar<TOutScalar>(point[1]),
+             convert_scalar<TOutScalar>(point[2])}};
+}
+
+/**
+ * Copy the graph changing the type of the coordinates of nodes and edge
+ * points. Vertices and edges keep the same order.
+ *
+ * Use GraphTypeI32 for graphs in index space (voxel coordinates) and
+ * GraphTypeF when single precision is enough, both reduce the memory of
+ * the graph.
+ *
+ * @tparam TOutScalar coordinate type of the output graph
+ * @tparam TInScalar coordinate type of the input graph
+ * @param input_graph
+ *
+ * @return graph with TOutScalar coordinates
+ */
+template <typename TOutScalar, typename TInScalar>
+GraphTypeT<TOutScalar>
+convert_spatial_graph(const GraphTypeT<TInScalar> &input_graph) {
+    const auto num_vertices = boost::num_vertices(input_graph);
+    GraphTypeT<TOutScalar> output_graph(num_vertices);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        output_graph[v].id = input_graph[v].id;
+        output_graph[v].pos =
+                convert_point<TOutScalar, TInScalar>(input_graph[v].pos);
+    }
+    const auto edges = boost::edges(input_graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        const auto &input_edge_points = input_graph[*ei].edge_points;
+        SpatialEdgeT<TOutScalar> output_edge;
+        output_edge.edge_points.reserve(input_edge_points.size());
+        for (const auto &point : input_edge_points) {
+            output_edge.edge_points.push_back(
+                    convert_point<TOutScalar, TInScalar>(point));
+        }
+        boost::add_edge(boost::source(*ei, input_graph),
+                        boost::target(*ei, input_graph),
+                        std::move(output_edge), output_graph);
+    }
+    return output_graph;
+}
+
+/**
+ * Create a GraphType in physical space from a graph in index space,
+ * i.e. a GraphTypeI32 created from the voxels of an image.
+ * The coordinates are converted and transformed in the same pass, so no
+ * intermediate double graph in index space is created.
+ *
+ * @sa index_array_to_physical_space_array
+ */
+template <typename TInScalar>
+GraphType index_graph_to_physical_space_graph(
+        const GraphTypeT<TInScalar> &index_graph,
+        const PointType &origin,
+        const PointType &spacing,
+        const DirectionMatrixType &direction) {
+    const auto num_vertices = boost::num_vertices(index_graph);
+    GraphType output_graph(num_vertices);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        output_graph[v].id = index_graph[v].id;
+        output_graph[v].pos = index_array_to_physical_space_array(
+                convert_point<double, TInScalar>(index_graph[v].pos), origin,
+                spacing, direction);
+    }
+    const auto edges = boost::edges(index_graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        const auto &input_edge_points = index_graph[*ei].edge_points;
+        SpatialEdge output_edge;
+        output_edge.edge_points.reserve(input_edge_points.size());
+        for (const auto &point : input_edge_points) {
+            output_edge.edge_points.push_back(index_array_to_physical_space_array(
+                    convert_point<double, TInScalar>(point), origin, spacing,
+                    direction));
+        }
+        boost::add_edge(boost::source(*ei, index_graph),
+                        boost::target(*ei, index_graph),
+                        std::move(output_edge), output_graph);
+    }
+    return output_graph;
+}
+
+/**
+ * Place a point in 3D space, points of 2D graphs are placed in the z = 0
+ * plane. Used to export 2D graphs to formats that are always 3D (vtk).
+ */
+inline PointType embed_point_in_3d(const PointType &point) { return point; }
+inline PointType embed_point_in_3d(const PointType2D &point) {
+    return {{point[0], point[1], 0.0}};
+}
+
+/**
+ * Copy a graph from a 2D image into a GraphType in the z = 0 plane.
+ * Vertices and edges keep the same order.
+ * Use it to apply the functions that only accept GraphType (i.e. io,
+ * merge_nodes) to the result of the 2D pipeline.
+ *
+ * @param graph_2d input 2D graph
+ *
+ * @return 3D graph with z = 0
+ */
+GraphType embed_spatial_graph_in_3d(const GraphType2D &graph_2d);
+
+// explicit instantiations in convert_spatial_graph.cpp
+extern template GraphTypeF convert_spatial_graph<float, double>(
+        const GraphType &input_graph);
+extern template GraphTypeI32 convert_spatial_graph<int32_t, double>(
+        const GraphType &input_graph);
+extern template GraphType convert_spatial_graph<double, float>(
+        const GraphTypeF &input_graph);
+extern template GraphType convert_spatial_graph<double, int32_t>(
+        const GraphTypeI32 &input_graph);
+extern template GraphType index_graph_to_physical_space_graph<int32_t>(
+        const GraphTypeI32 &index_graph,
+        const PointType &origin,
+        const PointType &spacing,
+        const DirectionMatrixType &direction);
+extern template GraphType index_graph_to_physical_space_graph<float>(
+        const GraphTypeF &index_graph,
+        const PointType &origin,
+        const PointType &spacing,
+        const DirectionMatrixType &direction);
+
+} // namespace SG
+#endif
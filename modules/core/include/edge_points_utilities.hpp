@@ -21,6 +21,7 @@
 #ifndef EDGE_POINTS_UTILITIES_HPP
 #define EDGE_POINTS_UTILITIES_HPP
 
+#include "frozen_spatial_graph.hpp"
 #include "spatial_edge.hpp"
 #include "spatial_graph.hpp"
 
@@ -37,6 +38,10 @@ namespace SG {
  */
 double ete_distance(const GraphType::edge_descriptor &edge_desc,
                     const GraphType &sg);
+double ete_distance(const FrozenSpatialGraph::edge_descriptor &edge_desc,
+                    const FrozenSpatialGraph &sg);
+double ete_distance(const GraphType2D::edge_descriptor &edge_desc,
+                    const GraphType2D &sg);
 
 /** Compute the length between the first edge point and the last.
  * It sums the distance between every pair of consecutive points.
@@ -53,6 +58,8 @@ double ete_distance(const GraphType::edge_descriptor &edge_desc,
  * @return the length between first and last edge_points
  */
 double edge_points_length(const SpatialEdge &se);
+double edge_points_length(const FrozenSpatialEdge &se);
+double edge_points_length(const SpatialEdge2D &se);
 
 /**
  * Compute the contour length of the edge points, including the distance to the
@@ -74,6 +81,10 @@ double edge_points_length(const SpatialEdge &se);
  */
 double contour_length(const GraphType::edge_descriptor &edge_desc,
                       const GraphType &sg);
+double contour_length(const FrozenSpatialGraph::edge_descriptor &edge_desc,
+                      const FrozenSpatialGraph &sg);
+double contour_length(const GraphType2D::edge_descriptor &edge_desc,
+                      const GraphType2D &sg);
 
 /**
  * Insert point in the input container.
@@ -23,8 +23,12 @@
 
 #include "bounding_box.hpp"
 #include "hash_edge_descriptor.hpp"
+#include "parallel_for.hpp"
 #include "spatial_graph.hpp"
 #include <boost/graph/filtered_graph.hpp>
+#include <atomic>
+#include <cstdint>
+#include <vector>
 
 // Create a filtered_graph type, use keep tag
 // Create bool function for edges and vertices to filter. Return true if in
@@ -75,9 +79,84 @@ FilteredGraphType
 filter_by_sets_no_copy(const EdgeDescriptorUnorderedSet &remove_edges,
                        const VertexDescriptorUnorderedSet &remove_nodes,
                        const GraphType &g);
+/**
+ * Return a copy of the graph without the input vertices and edges, in
+ * O(V + E).
+ * The edges of the removed vertices are removed as well.
+ * @sa compact_graph to get the new descriptor of each vertex.
+ *
+ * @param num_threads threads used to select the remaining edges,
+ * 0 to use all the hardware threads.
+ */
 GraphType filter_by_sets(const EdgeDescriptorUnorderedSet &remove_edges,
                          const VertexDescriptorUnorderedSet &remove_nodes,
-                         const GraphType &g);
+                         const GraphType &g,
+                         const size_t num_threads = 0);
+
+/**
+ * New vertex_descriptor of each vertex of a graph after removing the flagged
+ * vertices, the remaining vertices keep their relative order.
+ * Removed vertices are mapped to GraphType::null_vertex().
+ *
+ * @param remove_vertices flag per vertex, non-zero to remove it.
+ *
+ * @return new vertex_descriptor of each vertex
+ */
+std::vector<GraphType::vertex_descriptor>
+compact_vertex_map(const std::vector<uint8_t> &remove_vertices);
+
+/**
+ * Graph after removing vertices and edges, @sa compact_graph.
+ */
+struct CompactedGraph {
+    GraphType graph;
+    /** Vertex in graph of each vertex of the input graph, or
+     * GraphType::null_vertex() if it was removed. */
+    std::vector<GraphType::vertex_descriptor> vertex_map;
+};
+
+/**
+ * Return a copy of the graph without the input vertices and edges, in
+ * O(V + E).
+ *
+ * The edges of the removed vertices are removed as well.
+ * The remaining vertices and edges keep their relative order.
+ * Removing vertices from a vecS graph one by one is O(V) each, collect them
+ * and remove them at once with this instead.
+ *
+ * @param g input spatial graph
+ * @param remove_edges edges to remove
+ * @param remove_nodes vertices to remove
+ * @param num_threads threads used to select the remaining edges,
+ * 0 to use all the hardware threads.
+ *
+ * @return compacted graph and the old to new vertex map
+ */
+CompactedGraph compact_graph(const GraphType &g,
+                             const EdgeDescriptorUnorderedSet &remove_edges,
+                             const VertexDescriptorUnorderedSet &remove_nodes,
+                             const size_t num_threads = 0);
+
+/**
+ * Remove the input vertices and edges from the graph, in O(V + E).
+ * Same than @ref compact_graph, but the spatial nodes and edges are moved
+ * instead of copied. All descriptors of g are invalidated.
+ *
+ * @return old to new vertex map
+ */
+std::vector<GraphType::vertex_descriptor>
+compact_graph_in_place(GraphType &g,
+                       const EdgeDescriptorUnorderedSet &remove_edges,
+                       const VertexDescriptorUnorderedSet &remove_nodes,
+                       const size_t num_threads = 0);
+
+/**
+ * Vertices with degree 0, for example the nodes left by
+ * merge_three_connected_nodes when inPlace is false.
+ * Use it with @ref compact_graph to remove them:
+ * compact_graph(g, {}, degree_zero_vertices(g)).
+ */
+VertexDescriptorUnorderedSet degree_zero_vertices(const GraphType &g);
 
 /**
  * Return all the different components of the input graph as a vector
@@ -101,6 +180,124 @@ std::vector<ComponentGraphType> filter_component_graphs(
         const std::unordered_map<GraphType::vertex_descriptor, int>
                 &components_map);
 
+/**
+ * Connected components of a graph, stored as compact lists of vertices and
+ * edges per component.
+ *
+ * Components are numbered in the order of their lowest vertex, the same
+ * numbering than boost::connected_components.
+ * The vertices of component c are:
+ * vertices[vertex_offsets[c]], ..., vertices[vertex_offsets[c + 1] - 1]
+ * in increasing order, and its edges are stored in the same way in edges,
+ * in the order of boost::edges of the graph.
+ *
+ * Edge descriptors are only valid while the graph is not modified.
+ *
+ * @sa connected_components_union_find
+ */
+struct GraphComponents {
+    using vertex_descriptor = GraphType::vertex_descriptor;
+    using edge_descriptor = GraphType::edge_descriptor;
+    /** Component of each vertex. */
+    std::vector<size_t> vertex_component;
+    /** Index of each vertex in the list of vertices of its component,
+     * it is also its vertex_descriptor in @ref copy_component_graph. */
+    std::vector<size_t> vertex_local_index;
+    std::vector<size_t> vertex_offsets;
+    std::vector<vertex_descriptor> vertices;
+    std::vector<size_t> edge_offsets;
+    std::vector<edge_descriptor> edges;
+
+    /** Number of components. */
+    size_t size() const {
+        return vertex_offsets.empty() ? 0 : vertex_offsets.size() - 1;
+    }
+    bool empty() const { return size() == 0; }
+    size_t num_vertices(const size_t component) const {
+        return vertex_offsets[component + 1] - vertex_offsets[component];
+    }
+    size_t num_edges(const size_t component) const {
+        return edge_offsets[component + 1] - edge_offsets[component];
+    }
+};
+
+/**
+ * Label the connected components of the graph with a union-find over its
+ * edges, processed in parallel.
+ *
+ * Faster than boost::connected_components and @ref filter_component_graphs
+ * for big graphs, and the vertices and edges of each component can be
+ * traversed without visiting the rest of the graph.
+ *
+ * @param inputGraph input spatial graph
+ * @param num_threads 0 to use all the hardware threads.
+ *
+ * @return components of the graph
+ */
+GraphComponents connected_components_union_find(const GraphType &inputGraph,
+                                                const size_t num_threads = 0);
+
+/**
+ * Create a new graph holding the component of the input graph.
+ *
+ * The vertices are copied in increasing order, the vertex v of inputGraph
+ * is the vertex components.vertex_local_index[v] of the new graph.
+ *
+ * @param inputGraph input spatial graph
+ * @param components from @ref connected_components_union_find
+ * @param component index of the component to copy
+ *
+ * @return component graph
+ */
+GraphType copy_component_graph(const GraphType &inputGraph,
+                               const GraphComponents &components,
+                               const size_t component);
+/**
+ * Create a new graph for each component of the input graph, in parallel.
+ * @sa copy_component_graph
+ *
+ * @param inputGraph input spatial graph
+ * @param components from @ref connected_components_union_find
+ * @param num_threads 0 to use all the hardware threads.
+ *
+ * @return vector of component graphs, indexed by component
+ */
+std::vector<GraphType>
+copy_component_graphs(const GraphType &inputGraph,
+                      const GraphComponents &components,
+                      const size_t num_threads = 0);
+
+/**
+ * Call func(component) for each component, concurrently.
+ *
+ * Components are handed to the threads one by one as they finish the
+ * previous one, a single big component does not delay the rest.
+ * func must be safe to call concurrently for different components.
+ *
+ * @param components from @ref connected_components_union_find
+ * @param func callable with signature void(size_t component)
+ * @param num_threads 0 to use all the hardware threads.
+ */
+template <typename TFunction>
+void for_each_component(const GraphComponents &components,
+                        TFunction &&func,
+                        const size_t num_threads = 0) {
+    const size_t num_components = components.size();
+    const size_t num_workers =
+            std::min(default_num_threads(num_threads), num_components);
+    std::atomic<size_t> next_component(0);
+    parallel_for_chunks(
+            num_workers,
+            [&func, &next_component, num_components](size_t, size_t) {
+                for (size_t component = next_component++;
+                     component < num_components;
+                     component = next_component++) {
+                    func(component);
+                }
+            },
+            num_workers, 1);
+}
+
 /**
  * Create a new graph holding the largest component of the input graph.
  *
@@ -0,0 +1,425 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef FROZEN_SPATIAL_GRAPH_HPP
+#define FROZEN_SPATIAL_GRAPH_HPP
+
+#include "spatial_graph.hpp"
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <array>
+#include <limits>
+#include <iostream>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Read-only view of the edge points of one edge in a FrozenSpatialGraph.
+ *
+ * It exposes the subset of the std::vector interface used by the algorithms
+ * that read SpatialEdge::edge_points: size, empty, operator[], front, back
+ * and iterators. The points live in the pooled buffer of the graph, so the
+ * view is only valid while the graph is alive.
+ */
+class EdgePointsView {
+  public:
+    using value_type = PointType;
+    using size_type = std::size_t;
+    using const_reference = const PointType &;
+    using reference = const_reference;
+    using const_iterator = const PointType *;
+    using iterator = const_iterator;
+
+    EdgePointsView() = default;
+    EdgePointsView(const PointType *first, const PointType *last)
+            : m_first(first), m_last(last) {}
+
+    const_iterator begin() const { return m_first; }
+    const_iterator end() const { return m_last; }
+    const_iterator cbegin() const { return m_first; }
+    const_iterator cend() const { return m_last; }
+    size_type size() const { return static_cast<size_type>(m_last - m_first); }
+    bool empty() const { return m_first == m_last; }
+    const_reference operator[](const size_type index) const {
+        return m_first[index];
+    }
+    const_reference front() const { return *m_first; }
+    const_reference back() const { return *(m_last - 1); }
+    const PointType *data() const { return m_first; }
+    /** Copy the points into a regular container, i.e to modify them. */
+    PointContainer to_container() const {
+        return PointContainer(m_first, m_last);
+    }
+
+  private:
+    const PointType *m_first = nullptr;
+    const PointType *m_last = nullptr;
+};
+
+/**
+ * Vertex bundle of FrozenSpatialGraph. It is assembled on access from the
+ * structure-of-arrays storage of the graph, so it is returned by value.
+ * Same members than SpatialNode.
+ */
+struct FrozenSpatialNode {
+    size_t id;
+    PointType pos;
+};
+
+/**
+ * Edge bundle of FrozenSpatialGraph, returned by value.
+ * Same members than SpatialEdge, but edge_points is a read-only view.
+ */
+struct FrozenSpatialEdge {
+    EdgePointsView edge_points;
+};
+
+namespace detail {
+/**
+ * Edge descriptor of FrozenSpatialGraph.
+ * m_source and m_target follow the naming of boost edge descriptors, so
+ * @ref edge_hash works with it. m_index is the stable position of the edge in
+ * [0, num_edges), that can be used to index external containers.
+ */
+struct frozen_edge_descriptor {
+    size_t m_source = 0;
+    size_t m_target = 0;
+    size_t m_index = 0;
+};
+inline bool operator==(const frozen_edge_descriptor &lhs,
+                       const frozen_edge_descriptor &rhs) {
+    return lhs.m_index == rhs.m_index;
+}
+inline bool operator!=(const frozen_edge_descriptor &lhs,
+                       const frozen_edge_descriptor &rhs) {
+    return lhs.m_index != rhs.m_index;
+}
+inline bool operator<(const frozen_edge_descriptor &lhs,
+                      const frozen_edge_descriptor &rhs) {
+    return lhs.m_index < rhs.m_index;
+}
+inline std::ostream &operator<<(std::ostream &os,
+                                const frozen_edge_descriptor &e) {
+    os << "(" << e.m_source << "," << e.m_target << ")";
+    return os;
+}
+} // namespace detail
+
+/**
+ * Immutable spatial graph, built once from a GraphType, and optimized for
+ * read-mostly analysis (analyze, compare, tree).
+ *
+ * - Adjacency is stored in CSR form: one contiguous array of out-edges with
+ *   per-vertex offsets. The order of the out-edges of each vertex is the same
+ *   than in the input graph, so traversals (BFS, DFS, dijkstra) visit the
+ *   graph in the same order and give the same results.
+ * - Node positions are stored as structure of arrays (x, y and z).
+ * - All the edge points of all the edges are pooled in one buffer, each edge
+ *   holds an offset into it.
+ *
+ * It models the BGL concepts: VertexListGraph, EdgeListGraph, IncidenceGraph
+ * and AdjacencyGraph (undirected, allowing parallel edges and self-loops).
+ * The vertex_index is the identity, the edge index is stored in the edge
+ * descriptor.
+ *
+ * Bundled properties are accessed with operator[] as in GraphType,
+ * sg[v].pos and sg[e].edge_points, but returned by value and read-only.
+ *
+ * Algorithms working on a FrozenSpatialGraph: compute_graph_properties,
+ * compute_shortest_path, contour_length, tree_generation...
+ */
+class FrozenSpatialGraph {
+  public:
+    using vertex_descriptor = size_t;
+    using edge_descriptor = detail::frozen_edge_descriptor;
+    using vertices_size_type = size_t;
+    using edges_size_type = size_t;
+    using degree_size_type = size_t;
+    using directed_category = boost::undirected_tag;
+    using edge_parallel_category = boost::allow_parallel_edge_tag;
+    struct traversal_category : public virtual boost::incidence_graph_tag,
+                                public virtual boost::adjacency_graph_tag,
+                                public virtual boost::vertex_list_graph_tag,
+                                public virtual boost::edge_list_graph_tag {};
+    using vertex_bundled = FrozenSpatialNode;
+    using edge_bundled = FrozenSpatialEdge;
+    using graph_bundled = boost::no_property;
+
+    /** CSR entry: one per incident edge of a vertex. */
+    struct OutEdge {
+        vertex_descriptor target;
+        size_t edge_index;
+    };
+
+    struct make_out_edge {
+        vertex_descriptor source = 0;
+        edge_descriptor operator()(const OutEdge &out_edge) const {
+            return edge_descriptor{source, out_edge.target,
+                                   out_edge.edge_index};
+        }
+    };
+    struct make_adjacent_vertex {
+        vertex_descriptor operator()(const OutEdge &out_edge) const {
+            return out_edge.target;
+        }
+    };
+    struct make_edge {
+        const FrozenSpatialGraph *graph = nullptr;
+        edge_descriptor operator()(const size_t edge_index) const {
+            return edge_descriptor{graph->m_sources[edge_index],
+                                   graph->m_targets[edge_index], edge_index};
+        }
+    };
+
+    using vertex_iterator = boost::counting_iterator<vertex_descriptor>;
+    using out_edge_iterator = boost::transform_iterator<make_out_edge,
+                                                        const OutEdge *,
+                                                        edge_descriptor,
+                                                        edge_descriptor>;
+    using adjacency_iterator =
+            boost::transform_iterator<make_adjacent_vertex,
+                                      const OutEdge *,
+                                      vertex_descriptor,
+                                      vertex_descriptor>;
+    using edge_iterator =
+            boost::transform_iterator<make_edge,
+                                      boost::counting_iterator<size_t>,
+                                      edge_descriptor,
+                                      edge_descriptor>;
+
+    FrozenSpatialGraph() = default;
+    /**
+     * Build the frozen graph from a spatial graph.
+     * Edge indices follow the order of boost::edges(graph).
+     */
+    explicit FrozenSpatialGraph(const GraphType &graph);
+
+    static vertex_descriptor null_vertex() {
+        return std::numeric_limits<vertex_descriptor>::max();
+    }
+
+    size_t num_vertices() const { return m_ids.size(); }
+    size_t num_edges() const { return m_sources.size(); }
+    size_t num_edge_points() const { return m_edge_points.size(); }
+
+    FrozenSpatialNode operator[](const vertex_descriptor v) const {
+        return FrozenSpatialNode{
+                m_ids[v],
+                PointType{{m_positions[0][v], m_positions[1][v],
+                           m_positions[2][v]}}};
+    }
+    FrozenSpatialEdge operator[](const edge_descriptor &e) const {
+        return FrozenSpatialEdge{edge_points(e.m_index)};
+    }
+
+    EdgePointsView edge_points(const size_t edge_index) const {
+        const auto *first = m_edge_points.data();
+        return EdgePointsView(first + m_edge_point_offsets[edge_index],
+                              first + m_edge_point_offsets[edge_index + 1]);
+    }
+
+    std::pair<out_edge_iterator, out_edge_iterator>
+    out_edges(const vertex_descriptor v) const {
+        const auto *first = m_out_edges.data();
+        make_out_edge make{v};
+        return std::make_pair(
+                out_edge_iterator(first + m_out_offsets[v], make),
+                out_edge_iterator(first + m_out_offsets[v + 1], make));
+    }
+    std::pair<adjacency_iterator, adjacency_iterator>
+    adjacent_vertices(const vertex_descriptor v) const {
+        const auto *first = m_out_edges.data();
+        return std::make_pair(
+                adjacency_iterator(first + m_out_offsets[v]),
+                adjacency_iterator(first + m_out_offsets[v + 1]));
+    }
+    size_t out_degree(const vertex_descriptor v) const {
+        return m_out_offsets[v + 1] - m_out_offsets[v];
+    }
+
+    /**
+     * Return the first edge between u and v (if any), following the out-edge
+     * order of u. Same semantics than boost::edge on GraphType.
+     */
+    std::pair<edge_descriptor, bool> edge(const vertex_descriptor u,
+                                          const vertex_descriptor v) const {
+        const auto *first = m_out_edges.data() + m_out_offsets[u];
+        const auto *last = m_out_edges.data() + m_out_offsets[u + 1];
+        for (; first != last; ++first) {
+            if (first->target == v) {
+                return std::make_pair(
+                        edge_descriptor{u, v, first->edge_index}, true);
+            }
+        }
+        return std::make_pair(edge_descriptor{u, v, num_edges()}, false);
+    }
+
+    /** Structure of arrays holding the positions of the nodes.
+     * @param dimension 0, 1, or 2 (x, y or z) */
+    const std::vector<double> &positions(const size_t dimension) const {
+        return m_positions[dimension];
+    }
+    /** Pooled buffer with the points of all the edges. */
+    const PointContainer &edge_points_buffer() const { return m_edge_points; }
+    /** Offsets of each edge in the pooled buffer (size: num_edges + 1). */
+    const std::vector<size_t> &edge_points_offsets() const {
+        return m_edge_point_offsets;
+    }
+
+    /**
+     * Create a regular (mutable) spatial graph from the frozen graph.
+     * Vertices keep their index, edges are added following their index.
+     */
+    GraphType to_spatial_graph() const;
+
+  private:
+    std::vector<size_t> m_ids;
+    std::array<std::vector<double>, 3> m_positions;
+    std::vector<vertex_descriptor> m_sources;
+    std::vector<vertex_descriptor> m_targets;
+    std::vector<size_t> m_edge_point_offsets;
+    PointContainer m_edge_points;
+    std::vector<size_t> m_out_offsets;
+    std::vector<OutEdge> m_out_edges;
+};
+
+/* BGL interface. Also brought to namespace boost below, to allow calls like
+ * boost::out_edges(v, frozen_graph) used across SGEXT. */
+inline std::pair<FrozenSpatialGraph::vertex_iterator,
+                 FrozenSpatialGraph::vertex_iterator>
+vertices(const FrozenSpatialGraph &g) {
+    return std::make_pair(FrozenSpatialGraph::vertex_iterator(0),
+                          FrozenSpatialGraph::vertex_iterator(g.num_vertices()));
+}
+inline std::pair<FrozenSpatialGraph::edge_iterator,
+                 FrozenSpatialGraph::edge_iterator>
+edges(const FrozenSpatialGraph &g) {
+    FrozenSpatialGraph::make_edge make{&g};
+    return std::make_pair(
+            FrozenSpatialGraph::edge_iterator(
+                    boost::counting_iterator<size_t>(0), make),
+            FrozenSpatialGraph::edge_iterator(
+                    boost::counting_iterator<size_t>(g.num_edges()), make));
+}
+inline size_t num_vertices(const FrozenSpatialGraph &g) {
+    return g.num_vertices();
+}
+inline size_t num_edges(const FrozenSpatialGraph &g) { return g.num_edges(); }
+inline std::pair<FrozenSpatialGraph::out_edge_iterator,
+                 FrozenSpatialGraph::out_edge_iterator>
+out_edges(const FrozenSpatialGraph::vertex_descriptor v,
+          const FrozenSpatialGraph &g) {
+    return g.out_edges(v);
+}
+inline std::pair<FrozenSpatialGraph::adjacency_iterator,
+                 FrozenSpatialGraph::adjacency_iterator>
+adjacent_vertices(const FrozenSpatialGraph::vertex_descriptor v,
+                  const FrozenSpatialGraph &g) {
+    return g.adjacent_vertices(v);
+}
+inline size_t out_degree(const FrozenSpatialGraph::vertex_descriptor v,
+                         const FrozenSpatialGraph &g) {
+    return g.out_degree(v);
+}
+/** Undirected graph: degree == out_degree (self-loops count twice). */
+inline size_t degree(const FrozenSpatialGraph::vertex_descriptor v,
+                     const FrozenSpatialGraph &g) {
+    return g.out_degree(v);
+}
+inline FrozenSpatialGraph::vertex_descriptor
+source(const FrozenSpatialGraph::edge_descriptor &e,
+       const FrozenSpatialGraph & /*g*/) {
+    return e.m_source;
+}
+inline FrozenSpatialGraph::vertex_descriptor
+target(const FrozenSpatialGraph::edge_descriptor &e,
+       const FrozenSpatialGraph & /*g*/) {
+    return e.m_target;
+}
+inline std::pair<FrozenSpatialGraph::edge_descriptor, bool>
+edge(const FrozenSpatialGraph::vertex_descriptor u,
+     const FrozenSpatialGraph::vertex_descriptor v,
+     const FrozenSpatialGraph &g) {
+    return g.edge(u, v);
+}
+
+/**
+ * Readable property map from edge_descriptor to its index in [0, num_edges).
+ */
+struct frozen_edge_index_map {
+    using key_type = FrozenSpatialGraph::edge_descriptor;
+    using value_type = size_t;
+    using reference = size_t;
+    using category = boost::readable_property_map_tag;
+};
+inline size_t get(const frozen_edge_index_map & /*map*/,
+                  const FrozenSpatialGraph::edge_descriptor &e) {
+    return e.m_index;
+}
+
+} // namespace SG
+
+namespace boost {
+using SG::adjacent_vertices;
+using SG::degree;
+using SG::edge;
+using SG::edges;
+using SG::num_edges;
+using SG::num_vertices;
+using SG::out_degree;
+using SG::out_edges;
+using SG::source;
+using SG::target;
+using SG::vertices;
+
+template <> struct property_map<SG::FrozenSpatialGraph, vertex_index_t> {
+    using type = typed_identity_property_map<size_t>;
+    using const_type = type;
+};
+inline typed_identity_property_map<size_t>
+get(vertex_index_t /*tag*/, const SG::FrozenSpatialGraph & /*g*/) {
+    return typed_identity_property_map<size_t>();
+}
+inline size_t get(vertex_index_t /*tag*/,
+                  const SG::FrozenSpatialGraph & /*g*/,
+                  const size_t v) {
+    return v;
+}
+
+template <> struct property_map<SG::FrozenSpatialGraph, edge_index_t> {
+    using type = SG::frozen_edge_index_map;
+    using const_type = type;
+};
+inline SG::frozen_edge_index_map get(edge_index_t /*tag*/,
+                                     const SG::FrozenSpatialGraph & /*g*/) {
+    return SG::frozen_edge_index_map();
+}
+inline size_t get(edge_index_t /*tag*/,
+                  const SG::FrozenSpatialGraph & /*g*/,
+                  const SG::FrozenSpatialGraph::edge_descriptor &e) {
+    return e.m_index;
+}
+} // namespace boost
+
+#endif
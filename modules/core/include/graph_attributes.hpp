@@ -0,0 +1,421 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef GRAPH_ATTRIBUTES_HPP
+#define GRAPH_ATTRIBUTES_HPP
+
+#include "spatial_graph.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Column of values of type T indexed by a dense id: a vertex_descriptor of
+ * a graph with vecS vertices (as GraphType), or the edge id given by
+ * @ref EdgeIndex.
+ *
+ * The column does not follow changes of the graph: removing vertices or
+ * edges shifts the ids of the ones after them, and the values set before
+ * no longer correspond to the same vertex or edge.
+ *
+ * Values are stored contiguously, with a flag per id marking if the value
+ * is set. It replaces the std::unordered_map<id, T> used to hold partial
+ * results (labels, generations, radius...) with the same interface: find,
+ * count, at, emplace, operator[] and iteration over the set values as
+ * (id, value) pairs, in increasing id order. No hashing is involved.
+ *
+ * The column grows when a value is set in an id past its size, so it can
+ * be used without knowing the number of elements beforehand. Use the
+ * constructor with a size to avoid reallocations.
+ *
+ * Use uint8_t instead of bool for flags, std::vector<bool> cannot give
+ * references to its values.
+ */
+template <typename T> class AttributeColumn {
+  public:
+    static_assert(!std::is_same<T, bool>::value,
+                  "AttributeColumn<bool> is not supported, use uint8_t.");
+    using key_type = size_t;
+    using mapped_type = T;
+    using size_type = size_t;
+
+    /** Forward iterator over the ids with a value set. */
+    template <bool IsConst> class iterator_base {
+      public:
+        using column_pointer = typename std::conditional<
+                IsConst, const AttributeColumn *, AttributeColumn *>::type;
+        using mapped_reference =
+                typename std::conditional<IsConst, const T &, T &>::type;
+        using value_type = std::pair<const size_t, mapped_reference>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+        /** operator-> for a value_type created on the fly. */
+        struct pointer {
+            value_type value;
+            const value_type *operator->() const { return &value; }
+        };
+
+        iterator_base() = default;
+        iterator_base(column_pointer column, const size_t id)
+                : m_column(column), m_id(id) {
+            skip_unset();
+        }
+        /** Conversion from iterator to const_iterator. */
+        template <bool OtherIsConst,
+                  typename = typename std::enable_if<IsConst &&
+                                                     !OtherIsConst>::type>
+        iterator_base(const iterator_base<OtherIsConst> &other)
+                : m_column(other.m_column), m_id(other.m_id) {}
+
+        reference operator*() const {
+            return value_type(m_id, m_column->m_values[m_id]);
+        }
+        pointer operator->() const { return pointer{**this}; }
+        iterator_base &operator++() {
+            ++m_id;
+            skip_unset();
+            return *this;
+        }
+        iterator_base operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const iterator_base &other) const {
+            return m_id == other.m_id;
+        }
+        bool operator!=(const iterator_base &other) const {
+            return !(*this == other);
+        }
+
+      private:
+        friend class AttributeColumn;
+        template <bool> friend class iterator_base;
+        void skip_unset() {
+            const auto column_size = m_column->size();
+            while (m_id < column_size && !m_column->m_is_set[m_id]) {
+                ++m_id;
+            }
+        }
+        column_pointer m_column = nullptr;
+        size_t m_id = 0;
+    };
+    using iterator = iterator_base<false>;
+    using const_iterator = iterator_base<true>;
+
+    AttributeColumn() = default;
+    /** Column with num_ids unset values, initialized to default_value. */
+    explicit AttributeColumn(const size_t num_ids,
+                             const T &default_value = T())
+            : m_values(num_ids, default_value), m_is_set(num_ids, 0),
+              m_default_value(default_value) {}
+
+    /** Number of ids in the column (set or not). */
+    size_t size() const { return m_values.size(); }
+    /** Number of ids with a value set. */
+    size_t num_set() const { return m_num_set; }
+    bool empty() const { return m_num_set == 0; }
+    /** Resize the column, new ids are unset. */
+    void resize(const size_t num_ids) {
+        if (num_ids < size()) {
+            m_num_set -= static_cast<size_t>(
+                    std::count(m_is_set.begin() + num_ids, m_is_set.end(), 1));
+        }
+        m_values.resize(num_ids, m_default_value);
+        m_is_set.resize(num_ids, 0);
+    }
+    /** Unset all the values, keeping the size. */
+    void clear() {
+        std::fill(m_values.begin(), m_values.end(), m_default_value);
+        std::fill(m_is_set.begin(), m_is_set.end(), 0);
+        m_num_set = 0;
+    }
+
+    /** True if the value of id is set. */
+    bool has(const size_t id) const { return id < size() && m_is_set[id]; }
+    /** 1 if the value of id is set, 0 otherwise. */
+    size_t count(const size_t id) const { return has(id) ? 1 : 0; }
+
+    /** Value of id. Throws std::out_of_range if not set. */
+    const T &at(const size_t id) const {
+        if (!has(id)) {
+            throw std::out_of_range("AttributeColumn::at: id " +
+                                    std::to_string(id) + " is not set.");
+        }
+        return m_values[id];
+    }
+    T &at(const size_t id) {
+        return const_cast<T &>(static_cast<const AttributeColumn &>(*this).at(id));
+    }
+
+    /** Value of id, it is set (to the default value) if it wasn't. */
+    T &operator[](const size_t id) {
+        mark_set(id);
+        return m_values[id];
+    }
+
+    /**
+     * Set the value of id, only if it is not already set.
+     * Same than std::unordered_map::emplace.
+     *
+     * @return iterator to the value of id, and true if the value was set.
+     */
+    std::pair<iterator, bool> emplace(const size_t id, const T &value) {
+        if (has(id)) {
+            return std::make_pair(iterator(this, id), false);
+        }
+        mark_set(id);
+        m_values[id] = value;
+        return std::make_pair(iterator(this, id), true);
+    }
+    /** Set the value of id, overwriting the existing one. */
+    void set(const size_t id, const T &value) {
+        mark_set(id);
+        m_values[id] = value;
+    }
+    /** Unset the value of id. @return 1 if it was set, 0 otherwise. */
+    size_t erase(const size_t id) {
+        if (!has(id)) {
+            return 0;
+        }
+        m_is_set[id] = 0;
+        m_values[id] = m_default_value;
+        --m_num_set;
+        return 1;
+    }
+
+    iterator find(const size_t id) {
+        return has(id) ? iterator(this, id) : end();
+    }
+    const_iterator find(const size_t id) const {
+        return has(id) ? const_iterator(this, id) : end();
+    }
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    /**
+     * Contiguous values, indexed by id. Unset ids hold the default value.
+     * Use it for tight loops after checking @ref has or when all the values
+     * are known to be set.
+     */
+    const std::vector<T> &values() const { return m_values; }
+    /** Flag per id, 1 if the value is set. */
+    const std::vector<uint8_t> &is_set() const { return m_is_set; }
+
+  private:
+    void mark_set(const size_t id) {
+        if (id >= size()) {
+            resize(id + 1);
+        }
+        if (!m_is_set[id]) {
+            m_is_set[id] = 1;
+            ++m_num_set;
+        }
+    }
+
+    std::vector<T> m_values;
+    std::vector<uint8_t> m_is_set;
+    size_t m_num_set = 0;
+    T m_default_value = T();
+};
+
+/** AttributeColumn indexed by vertex_descriptor. */
+template <typename T> using VertexAttribute = AttributeColumn<T>;
+/** AttributeColumn indexed by the edge id, see @ref EdgeIndex. */
+template <typename T> using EdgeAttribute = AttributeColumn<T>;
+
+/**
+ * Dense integer ids for the edges of a graph.
+ *
+ * The id of an edge is its position in boost::edges(graph). The edge list
+ * of GraphType (listS) keeps the order in which the edges were added, and
+ * it is preserved when copying, serializing or writing the graph, so the
+ * ids are the same in copies of the graph, and any EdgeAttribute computed
+ * on one copy applies to the others. This is not true for the
+ * edge_descriptor, that points to the edge property of one graph.
+ *
+ * Algorithms that visit all the edges should iterate boost::edges(graph)
+ * with a counter, that is the id, and don't need an EdgeIndex. Use it to
+ * get the id of an arbitrary edge_descriptor or of the edge between two
+ * vertices. The ids are not stored in the graph: @ref id is a binary
+ * search over the edge_descriptors, O(log E), and the index takes
+ * O(E log E) to build.
+ *
+ * The index is a snapshot of the graph when it was created. Adding edges
+ * keeps the existing ids, but the new edges are not in the index. Removing
+ * any edge shifts the ids of the edges after it, so the EdgeIndex and every
+ * EdgeAttribute computed with it are invalid and have to be created again.
+ */
+template <typename TGraph> class EdgeIndex {
+  public:
+    using vertex_descriptor =
+            typename boost::graph_traits<TGraph>::vertex_descriptor;
+    using edge_descriptor =
+            typename boost::graph_traits<TGraph>::edge_descriptor;
+    static constexpr size_t invalid_id = std::numeric_limits<size_t>::max();
+
+    explicit EdgeIndex(const TGraph &graph) : m_graph(&graph) {
+        const auto num_edges = boost::num_edges(graph);
+        m_edges.reserve(num_edges);
+        m_sorted_ids.reserve(num_edges);
+        size_t id = 0;
+        const auto edges = boost::edges(graph);
+        for (auto ei = edges.first; ei != edges.second; ++ei, ++id) {
+            m_edges.push_back(*ei);
+            m_sorted_ids.push_back(id);
+        }
+        std::sort(m_sorted_ids.begin(), m_sorted_ids.end(),
+                  [this](const size_t lhs, const size_t rhs) {
+                      return m_edges[lhs] < m_edges[rhs];
+                  });
+    }
+
+    /** Number of edges, ids are in [0, size()). */
+    size_t size() const { return m_edges.size(); }
+    const TGraph &graph() const { return *m_graph; }
+    /** Edge with the input id. */
+    const edge_descriptor &edge(const size_t id) const { return m_edges[id]; }
+    /** All the edges, in id order. */
+    const std::vector<edge_descriptor> &edges() const { return m_edges; }
+
+    /**
+     * Id of the edge, in O(log E). Throws if the edge is not in the index,
+     * for example if it was obtained from other copy of the graph, or added
+     * after creating the index.
+     */
+    size_t id(const edge_descriptor &edge) const {
+        const auto found = std::lower_bound(
+                m_sorted_ids.begin(), m_sorted_ids.end(), edge,
+                [this](const size_t lhs, const edge_descriptor &rhs) {
+                    return m_edges[lhs] < rhs;
+                });
+        if (found == m_sorted_ids.end() || !(m_edges[*found] == edge)) {
+            throw std::runtime_error(
+                    "EdgeIndex::id: the edge is not in the graph.");
+        }
+        return *found;
+    }
+
+    /**
+     * Id of the first edge between source and target (in any direction
+     * for undirected graphs), or invalid_id if there is no such edge.
+     */
+    size_t find(const vertex_descriptor source,
+                const vertex_descriptor target) const {
+        if (source >= boost::num_vertices(*m_graph) ||
+            target >= boost::num_vertices(*m_graph)) {
+            return invalid_id;
+        }
+        const auto edge_exists = boost::edge(source, target, *m_graph);
+        return edge_exists.second ? id(edge_exists.first) : invalid_id;
+    }
+
+  private:
+    const TGraph *m_graph;
+    std::vector<edge_descriptor> m_edges;
+    /** Ids sorted by edge_descriptor, to search the id of an edge. */
+    std::vector<size_t> m_sorted_ids;
+};
+
+template <typename TGraph> constexpr size_t EdgeIndex<TGraph>::invalid_id;
+
+extern template class EdgeIndex<GraphType>;
+
+/* ************ Conversion from and to hash maps ************/
+
+/**
+ * Copy the values of a map keyed by vertex_descriptor into a column with
+ * num_vertices(graph) ids.
+ */
+template <typename TGraph, typename TMap>
+VertexAttribute<typename TMap::mapped_type>
+to_vertex_attribute(const TGraph &graph, const TMap &vertex_map) {
+    VertexAttribute<typename TMap::mapped_type> column(
+            boost::num_vertices(graph));
+    for (const auto &vertex_value : vertex_map) {
+        column.set(vertex_value.first, vertex_value.second);
+    }
+    return column;
+}
+
+/**
+ * Copy the values of a map keyed by edge_descriptor into a column indexed
+ * by edge id. Only the edges of the graph found in the map are set.
+ */
+template <typename TGraph, typename TMap>
+EdgeAttribute<typename TMap::mapped_type>
+to_edge_attribute(const TGraph &graph, const TMap &edge_map) {
+    EdgeAttribute<typename TMap::mapped_type> column(boost::num_edges(graph));
+    size_t id = 0;
+    const auto edges = boost::edges(graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei, ++id) {
+        const auto found = edge_map.find(*ei);
+        if (found != edge_map.end()) {
+            column.set(id, found->second);
+        }
+    }
+    return column;
+}
+
+/** Copy the set values of a column into a map keyed by id. */
+template <typename T>
+std::unordered_map<size_t, T> to_unordered_map(const AttributeColumn<T> &column) {
+    std::unordered_map<size_t, T> output;
+    output.reserve(column.num_set());
+    for (const auto &id_value : column) {
+        output.emplace(id_value.first, id_value.second);
+    }
+    return output;
+}
+
+/**
+ * Copy the set values of an edge column into a map keyed by the
+ * edge_descriptor of the edges of the input graph.
+ */
+template <typename TMap, typename TGraph>
+TMap to_edge_map(const TGraph &graph,
+                 const EdgeAttribute<typename TMap::mapped_type> &column) {
+    TMap output;
+    size_t id = 0;
+    const auto edges = boost::edges(graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei, ++id) {
+        if (column.has(id)) {
+            output.emplace(*ei, column.values()[id]);
+        }
+    }
+    return output;
+}
+
+} // namespace SG
+#endif
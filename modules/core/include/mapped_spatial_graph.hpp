@@ -0,0 +1,178 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef MAPPED_SPATIAL_GRAPH_HPP
+#define MAPPED_SPATIAL_GRAPH_HPP
+
+#include "frozen_spatial_graph.hpp" // for EdgePointsView
+#include "spatial_graph.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Fixed size header of the binary spatial graph format (.sgb).
+ *
+ * The header is followed by these sections, all of them made of 8 byte
+ * elements, so every section is 8 byte aligned:
+ *   - vertex ids:           uint64_t[num_vertices]
+ *   - vertex positions:     double[3 * num_vertices]
+ *   - edge sources:         uint64_t[num_edges]
+ *   - edge targets:         uint64_t[num_edges]
+ *   - edge points offsets:  uint64_t[num_edges + 1]
+ *   - edge points:          double[3 * num_edge_points]
+ *
+ * The edge points of edge i are in the range
+ * [offsets[i], offsets[i + 1]) of the edge points section.
+ * Values are stored in the native byte order of the writer, the field
+ * endianness is used to detect a mismatch at read time.
+ */
+struct BinarySpatialGraphHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianness;
+    uint64_t num_vertices;
+    uint64_t num_edges;
+    uint64_t num_edge_points;
+    uint64_t reserved[3];
+};
+static_assert(sizeof(BinarySpatialGraphHeader) == 64,
+              "BinarySpatialGraphHeader must be 64 bytes.");
+
+constexpr char binary_sg_magic[8] = {'S', 'G', 'E', 'X', 'T', 'S', 'G', 'B'};
+constexpr uint32_t binary_sg_version = 1;
+constexpr uint32_t binary_sg_endianness = 0x01020304;
+
+/**
+ * Initialize a header for a graph with the input sizes.
+ */
+BinarySpatialGraphHeader make_binary_sg_header(const uint64_t num_vertices,
+                                               const uint64_t num_edges,
+                                               const uint64_t num_edge_points);
+/**
+ * Throws if the header is not a valid header of this version of the
+ * format.
+ */
+void check_binary_sg_header(const BinarySpatialGraphHeader &header);
+/**
+ * Throws if the edges do not match the header: sources and targets must be
+ * vertices of the graph, and the edge points offsets (num_edges + 1) must
+ * start at 0, never decrease and end at num_edge_points.
+ * Check it before accessing the edge points of a file, a truncated or
+ * corrupt file would read out of bounds otherwise.
+ */
+void check_binary_sg_edges(const BinarySpatialGraphHeader &header,
+                           const uint64_t *sources,
+                           const uint64_t *targets,
+                           const uint64_t *offsets);
+/**
+ * Total size in bytes of a .sgb file with this header.
+ */
+uint64_t binary_sg_file_size(const BinarySpatialGraphHeader &header);
+
+/**
+ * Read-only access to a binary spatial graph file (.sgb) mapped in memory.
+ *
+ * Opening the file only maps it and validates the header and the file
+ * size, no parsing happens. Positions and edge points are read from the
+ * mapped memory when requested, so the cost of opening does not depend on
+ * the size of the graph. Use @ref to_spatial_graph to get a modifiable
+ * GraphType.
+ *
+ * The edges are not validated when opening. source and target return the
+ * stored values, call @ref validate before using them with a file that
+ * might be corrupt. edge_points checks the offsets of the edge, and
+ * @ref to_spatial_graph validates the whole file.
+ *
+ * Vertices and edges are indexed in the same order than boost::vertices and
+ * boost::edges of the graph that was written.
+ *
+ * On platforms without mmap the whole file is read into memory instead.
+ */
+class MappedSpatialGraph {
+  public:
+    explicit MappedSpatialGraph(const std::string &input_file);
+    ~MappedSpatialGraph();
+    MappedSpatialGraph(const MappedSpatialGraph &) = delete;
+    MappedSpatialGraph &operator=(const MappedSpatialGraph &) = delete;
+    MappedSpatialGraph(MappedSpatialGraph &&other) noexcept;
+    MappedSpatialGraph &operator=(MappedSpatialGraph &&other) noexcept;
+
+    const BinarySpatialGraphHeader &header() const { return *m_header; }
+    size_t num_vertices() const { return m_header->num_vertices; }
+    size_t num_edges() const { return m_header->num_edges; }
+    size_t num_edge_points() const { return m_header->num_edge_points; }
+
+    size_t id(const size_t vertex_index) const { return m_ids[vertex_index]; }
+    PointType pos(const size_t vertex_index) const {
+        const double *p = m_positions + 3 * vertex_index;
+        return PointType{{p[0], p[1], p[2]}};
+    }
+    size_t source(const size_t edge_index) const {
+        return m_sources[edge_index];
+    }
+    size_t target(const size_t edge_index) const {
+        return m_targets[edge_index];
+    }
+    /** Throws if the offsets of the edge are outside the edge points. */
+    EdgePointsView edge_points(const size_t edge_index) const {
+        const auto begin = m_offsets[edge_index];
+        const auto end = m_offsets[edge_index + 1];
+        if (begin > end || end > num_edge_points()) {
+            throw std::runtime_error(
+                    "MappedSpatialGraph: the edge points offsets of edge " +
+                    std::to_string(edge_index) + " are not valid.");
+        }
+        return EdgePointsView(m_edge_points + begin, m_edge_points + end);
+    }
+
+    /**
+     * Throws if the edges do not match the header, @sa check_binary_sg_edges.
+     * It reads the sources, targets and offsets, O(num_edges).
+     */
+    void validate() const;
+
+    /** Validate and copy the mapped graph into a GraphType. */
+    GraphType to_spatial_graph() const;
+
+  private:
+    void map_file(const std::string &input_file);
+    void set_sections();
+    void release();
+
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+    /** Only used when mmap is not available. */
+    std::vector<uint64_t> m_buffer;
+
+    const BinarySpatialGraphHeader *m_header = nullptr;
+    const uint64_t *m_ids = nullptr;
+    const double *m_positions = nullptr;
+    const uint64_t *m_sources = nullptr;
+    const uint64_t *m_targets = nullptr;
+    const uint64_t *m_offsets = nullptr;
+    const PointType *m_edge_points = nullptr;
+};
+
+} // namespace SG
+#endif
@@ -0,0 +1,104 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef PARALLEL_FOR_HPP
+#define PARALLEL_FOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Number of threads to use when the user asks for num_threads = 0: the
+ * number of hardware threads (at least 1).
+ */
+inline size_t default_num_threads(const size_t num_threads = 0) {
+    if (num_threads > 0) {
+        return num_threads;
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+/**
+ * Split [0, n) in contiguous chunks and call func(begin, end) for each
+ * chunk, each one in its own thread.
+ *
+ * At most num_threads chunks are used (0 for @ref default_num_threads), and
+ * chunks have at least min_chunk_size elements, so small inputs run in the
+ * calling thread without spawning any thread.
+ *
+ * func must be safe to call concurrently on different chunks.
+ * The first exception thrown by func is rethrown after joining all threads.
+ *
+ * @param n number of elements
+ * @param func callable with signature void(size_t begin, size_t end)
+ * @param num_threads maximum number of threads, 0 for all hardware threads.
+ * @param min_chunk_size minimum number of elements per chunk.
+ */
+template <typename TFunction>
+void parallel_for_chunks(const size_t n,
+                         TFunction &&func,
+                         const size_t num_threads = 0,
+                         const size_t min_chunk_size = 1024) {
+    if (n == 0) {
+        return;
+    }
+    const size_t max_chunks =
+            std::max<size_t>(1, n / std::max<size_t>(1, min_chunk_size));
+    const size_t num_chunks =
+            std::min(default_num_threads(num_threads), max_chunks);
+    if (num_chunks == 1) {
+        func(size_t(0), n);
+        return;
+    }
+    const size_t chunk_size = (n + num_chunks - 1) / num_chunks;
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> exceptions(num_chunks);
+    threads.reserve(num_chunks);
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+        const size_t begin = chunk * chunk_size;
+        const size_t end = std::min(n, begin + chunk_size);
+        if (begin >= end) {
+            break;
+        }
+        threads.emplace_back([&func, &exceptions, chunk, begin, end]() {
+            try {
+                func(begin, end);
+            } catch (...) {
+                exceptions[chunk] = std::current_exception();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (const auto &exception : exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
+} // namespace SG
+#endif
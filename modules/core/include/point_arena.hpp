@@ -0,0 +1,143 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef POINT_ARENA_HPP
+#define POINT_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Monotonic arena for the edge points of a graph.
+ *
+ * Memory is taken from large blocks and it is never given back
+ * individually, deallocation is a no-op. All the memory is released at once
+ * with release() or when the arena is destroyed, so allocating and freeing
+ * the points of many short edges doesn't hit the heap, nor fragments it.
+ *
+ * The arena is not thread-safe, use one arena per thread.
+ *
+ * @sa ArenaAllocator, ArenaGraphType
+ */
+class PointArena {
+  public:
+    static constexpr size_t default_block_size = 1 << 16;
+    explicit PointArena(const size_t block_size = default_block_size)
+            : m_block_size(block_size) {}
+    PointArena(const PointArena &) = delete;
+    PointArena &operator=(const PointArena &) = delete;
+
+    /** Returns memory for bytes with the input alignment. */
+    void *allocate(const size_t bytes, const size_t alignment);
+    /** Release all the memory of the arena. */
+    void release();
+
+    /** Bytes handed out by allocate since the last release. */
+    size_t bytes_allocated() const { return m_bytes_allocated; }
+    /** Bytes reserved from the heap. */
+    size_t bytes_reserved() const;
+    size_t num_blocks() const { return m_blocks.size(); }
+
+    /**
+     * While a Scope is alive, default constructed ArenaAllocator allocate
+     * from its arena. It allows to use the arena with code that
+     * default-constructs or copies edges, as boost::add_edge does.
+     * Scopes can be nested, the innermost is used.
+     */
+    class Scope {
+      public:
+        explicit Scope(PointArena &arena);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+      private:
+        PointArena *m_previous;
+    };
+    /** Arena of the innermost Scope of this thread, nullptr if none. */
+    static PointArena *current();
+
+  private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+    size_t m_block_size;
+    std::vector<Block> m_blocks;
+    /** Position of the next allocation in the last block. */
+    size_t m_offset = 0;
+    size_t m_bytes_allocated = 0;
+};
+
+/**
+ * Allocator drawing from a PointArena, or from the heap if the arena is
+ * nullptr.
+ *
+ * Default construction and copy construction of containers take the arena
+ * of the current PointArena::Scope.
+ */
+template <typename T> struct ArenaAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+    using is_always_equal = std::false_type;
+
+    ArenaAllocator() noexcept : arena(PointArena::current()) {}
+    explicit ArenaAllocator(PointArena *input_arena) noexcept
+            : arena(input_arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+            : arena(other.arena) {}
+
+    T *allocate(const size_t n) {
+        if (arena == nullptr) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *p, const size_t n) noexcept {
+        if (arena == nullptr) {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+    /** Copies of a container use the arena of the current scope. */
+    ArenaAllocator select_on_container_copy_construction() const {
+        return ArenaAllocator();
+    }
+
+    PointArena *arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) {
+    return lhs.arena == rhs.arena;
+}
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace SG
+#endif
@@ -20,6 +20,7 @@
 
 #ifndef SHORTEST_PATH_HPP
 #define SHORTEST_PATH_HPP
+#include "frozen_spatial_graph.hpp"
 #include "spatial_graph.hpp"
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 #include <vector>
@@ -42,6 +43,11 @@ compute_shortest_path(GraphType::vertex_descriptor start_vertex,
                       GraphType::vertex_descriptor end_vertex,
                       const GraphType &input_g,
                       bool verbose = false);
+std::vector<FrozenSpatialGraph::vertex_descriptor>
+compute_shortest_path(FrozenSpatialGraph::vertex_descriptor start_vertex,
+                      FrozenSpatialGraph::vertex_descriptor end_vertex,
+                      const FrozenSpatialGraph &input_g,
+                      bool verbose = false);
 
 SpatialEdge create_edge_from_path(
         const std::vector<GraphType::vertex_descriptor> &vertex_path,
@@ -60,8 +66,8 @@ struct shortest_path_visitor : boost::default_dijkstra_visitor {
     shortest_path_visitor(vertex_descriptor vd, size_t &visited)
             : destination(vd), visited(visited) {}
 
-    inline void finish_vertex(vertex_descriptor v,
-                              SG::GraphType const &input_sg) {
+    template <typename TGraph>
+    inline void finish_vertex(vertex_descriptor v, TGraph const &input_sg) {
         ++visited;
 
         if (v == destination)
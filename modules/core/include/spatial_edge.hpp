@@ -25,15 +25,33 @@
 #include "common_types.hpp"
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/vector.hpp>
+#include <cstdint>
 #include <iostream>
+#include <sstream>
+#include <string>
 
 namespace SG {
-struct SpatialEdge {
-    using PointType = SG::PointType;
-    using PointContainer = SG::PointContainer;
+/**
+ * Edge of the spatial graph, templated on the type and the number of the
+ * coordinates.
+ * Use SpatialEdge (double, 3D) unless memory is an issue, or
+ * SpatialEdge2D for 2D images.
+ */
+template <typename TScalar, size_t TDimension = 3> struct SpatialEdgeT {
+    using ScalarType = TScalar;
+    static constexpr size_t Dimension = TDimension;
+    using PointType = PointTypeT<TScalar, TDimension>;
+    using PointContainer = PointContainerT<TScalar, TDimension>;
     /// Spatial Points between the nodes of the edge.
     PointContainer edge_points;
 };
+using SpatialEdge = SpatialEdgeT<double>;
+using SpatialEdgeF = SpatialEdgeT<float>;
+using SpatialEdgeI32 = SpatialEdgeT<int32_t>;
+using SpatialEdge2D = SpatialEdgeT<double, 2>;
+
+template <typename TScalar, size_t TDimension>
+constexpr size_t SpatialEdgeT<TScalar, TDimension>::Dimension;
 
 /**
  * Print edge points with default precission.
@@ -45,47 +63,50 @@ struct SpatialEdge {
  * @param edge_points
  * @param os any ostream
  */
-inline void print_edge_points(const PointContainer &edge_points,
-                              std::ostream &os) {
+template <typename TScalar, size_t TDimension>
+inline void
+print_edge_points(const PointContainerT<TScalar, TDimension> &edge_points,
+                  std::ostream &os) {
     auto size = edge_points.size();
     os << "[";
-    for (size_t i = 0; i + 1 < size; ++i) {
-        os << "{" << edge_points[i][0] << " " << edge_points[i][1] << " "
-           << edge_points[i][2] << "},";
-    }
-    if (size > 0) {
-        os << "{" << edge_points[size - 1][0] << " " << edge_points[size - 1][1]
-           << " " << edge_points[size - 1][2] << "}";
+    for (size_t i = 0; i < size; ++i) {
+        os << "{" << edge_points[i][0];
+        for (size_t d = 1; d < TDimension; ++d) {
+            os << " " << edge_points[i][d];
+        }
+        os << (i + 1 < size ? "}," : "}");
     }
     os << "]";
 }
 /* Stream operators */
-inline static std::ostream &operator<<(std::ostream &os,
-                                       const SpatialEdge &se) {
+template <typename TScalar, size_t TDimension>
+inline std::ostream &operator<<(std::ostream &os,
+                                const SpatialEdgeT<TScalar, TDimension> &se) {
     os.precision(100);
     print_edge_points(se.edge_points, os);
     return os;
 }
-inline static std::istream &operator>>(std::istream &is, SpatialEdge &se) {
+template <typename TScalar, size_t TDimension>
+inline std::istream &operator>>(std::istream &is,
+                                SpatialEdgeT<TScalar, TDimension> &se) {
     auto &edge_points = se.edge_points;
 
-    std::string s(std::istreambuf_iterator<char>(is), {});
-    std::string delim_start = "{";
-    std::string delim_end = "}";
-    auto first = s.find(delim_start);
-    auto last = s.find(delim_end);
-    auto pos = first;
-    std::string clean;
+    const std::string s(std::istreambuf_iterator<char>(is), {});
+    const char delim_start = '{';
+    const char delim_end = '}';
+    auto pos = s.find(delim_start);
     while (pos != std::string::npos) {
-        double x = 0;
-        double y = 0;
-        double z = 0;
-        clean = s.substr(pos + delim_start.length(), last - delim_end.length());
-        std::istringstream is_clean(clean);
-        is_clean >> x >> y >> z;
-        edge_points.push_back({{x, y, z}});
-        s.erase(0, last + delim_end.length());
-        pos = s.find(delim_start);
+        PointTypeT<TScalar, TDimension> point{};
+        const auto last = s.find(delim_end, pos);
+        std::istringstream is_clean(s.substr(pos + 1, last - pos - 1));
+        for (auto &x : point) {
+            is_clean >> x;
+        }
+        edge_points.push_back(point);
+        if (last == std::string::npos) {
+            break;
+        }
+        pos = s.find(delim_start, last);
     }
     // set is to the end or lexical_cast fails.
     is.seekg(0, is.end);
@@ -95,8 +116,10 @@ inline static std::istream &operator>>(std::istream &is, SpatialEdge &se) {
 
 namespace boost {
 namespace serialization {
-template <class Archive>
-void serialize(Archive &ar, SG::SpatialEdge &se, unsigned /*version*/) {
+template <class Archive, typename TScalar, size_t TDimension>
+void serialize(Archive &ar,
+               SG::SpatialEdgeT<TScalar, TDimension> &se,
+               unsigned /*version*/) {
     ar &se.edge_points;
 }
 } // namespace serialization
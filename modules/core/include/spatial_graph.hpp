@@ -27,11 +27,31 @@
 #include "spatial_node.hpp"
 
 namespace SG {
-using GraphAL = boost::adjacency_list<boost::listS,
-                                      boost::vecS,
-                                      boost::undirectedS,
-                                      SpatialNode,
-                                      SpatialEdge>;
+/**
+ * Spatial graph with TDimension coordinates of type TScalar.
+ * GraphType (double, 3D) is the graph used by all the algorithms.
+ * GraphTypeF (float) and GraphTypeI32 (int32_t voxel index) reduce memory,
+ * see convert_spatial_graph.hpp to convert between them.
+ * analyze_graph_function creates the graph with one node per voxel as
+ * GraphTypeI32 (spatial_graph_from_image), reduces it, and converts only
+ * the reduced graph to GraphType.
+ * GraphType2D is the graph of 2D images, used by the 2D pipeline:
+ * raw_graph_from_image, reduce_spatial_graph_via_dfs,
+ * compute_graph_properties and the vtk conversions.
+ */
+template <typename TScalar, size_t TDimension = 3>
+using GraphALT = boost::adjacency_list<boost::listS,
+                                       boost::vecS,
+                                       boost::undirectedS,
+                                       SpatialNodeT<TScalar, TDimension>,
+                                       SpatialEdgeT<TScalar, TDimension>>;
+template <typename TScalar, size_t TDimension = 3>
+using GraphTypeT = GraphALT<TScalar, TDimension>;
+
+using GraphAL = GraphALT<double>;
 using GraphType = GraphAL;
+using GraphTypeF = GraphTypeT<float>;
+using GraphTypeI32 = GraphTypeT<int32_t>;
+using GraphType2D = GraphTypeT<double, 2>;
 } // namespace SG
 #endif
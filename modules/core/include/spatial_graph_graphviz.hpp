@@ -0,0 +1,73 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SPATIAL_GRAPH_GRAPHVIZ_HPP
+#define SPATIAL_GRAPH_GRAPHVIZ_HPP
+
+#include "spatial_graph.hpp"
+#include <iostream>
+
+namespace SG {
+
+/**
+ * Dedicated parser and emitter for the graphviz dialect written by SGEXT:
+ *
+ *     graph G {
+ *     0 [spatial_node="x y z"];
+ *     0--1  [spatial_edge="[{x y z},{x y z}]"];
+ *     }
+ *
+ * Both run in a single pass over the data, without boost::dynamic_properties
+ * or a stream per value, so the cost is linear in the size of the file.
+ * They are used by read_graphviz_sg and write_graphviz_sg.
+ */
+
+/**
+ * Write the graph in the same format than boost::write_graphviz_dp with
+ * get_write_dynamic_properties_sg, the output is byte-by-byte the same.
+ * Numbers are written with 100 significant digits, as the stream operators
+ * of SpatialNode and SpatialEdge do.
+ *
+ * @param os output stream
+ * @param graph input spatial graph
+ */
+void emit_graphviz_sg(std::ostream &os, const GraphType &graph);
+
+/**
+ * Parse the graphviz text in [first, last) and add its nodes and edges to
+ * graph.
+ *
+ * The resulting graph is the same than with boost::read_graphviz and
+ * get_read_dynamic_properties_sg: vertices are added in the lexicographic
+ * order of the node names, and edges are added in the order they appear.
+ * As with boost, SpatialNode::id is the node name only for nodes without a
+ * spatial_node attribute, and zero otherwise.
+ *
+ * Attributes other than spatial_node and spatial_edge are ignored.
+ * Subgraphs and directed graphs are not part of the dialect and throw.
+ *
+ * @param first begin of the text
+ * @param last end of the text
+ * @param graph output graph, nodes and edges are appended to it
+ */
+void parse_graphviz_sg(const char *first, const char *last, GraphType &graph);
+
+} // namespace SG
+#endif
@@ -21,6 +21,7 @@
 #ifndef SPATIAL_GRAPH_IO_HPP
 #define SPATIAL_GRAPH_IO_HPP
 
+#include "graph_attributes.hpp"
 #include "hash_edge_descriptor.hpp"
 #include "spatial_graph.hpp"
 #include <boost/graph/graphviz.hpp>
@@ -36,6 +37,12 @@ using edge_to_label_map_t = std::unordered_map<GraphType::edge_descriptor,
                                                SG::edge_hash<GraphType>>;
 
 /* ************* Graphviz *************/
+/**
+ * Dynamic properties used by boost::read_graphviz/write_graphviz_dp with the
+ * SGEXT dialect. read_graphviz_sg and write_graphviz_sg use instead the
+ * dedicated, faster, parser and emitter of @ref spatial_graph_graphviz.hpp,
+ * which give the same results.
+ */
 boost::dynamic_properties get_write_dynamic_properties_sg(GraphType &graph);
 boost::dynamic_properties get_read_dynamic_properties_sg(GraphType &graph);
 void write_graphviz_sg(std::ostream &os, GraphType &graph);
@@ -52,6 +59,23 @@ void read_serialized_sg(std::istream &is, GraphType &graph);
 void read_serialized_sg(const std::string &input_file, GraphType &graph);
 GraphType read_serialized_sg(const std::string &input_file);
 
+/* ************* Binary (.sgb) *************/
+/**
+ * Write/Read the graph in the binary spatial graph format (.sgb).
+ * A fixed header is followed by flat arrays of node ids and positions, the
+ * edge sources and targets, and one contiguous block with all the edge
+ * points. See @ref BinarySpatialGraphHeader for the layout.
+ *
+ * read_binary_sg from a file maps it in memory (@ref MappedSpatialGraph),
+ * use MappedSpatialGraph directly to access the graph lazily without
+ * creating a GraphType.
+ */
+void write_binary_sg(std::ostream &os, const GraphType &graph);
+void write_binary_sg(const std::string &output_file, const GraphType &graph);
+void read_binary_sg(std::istream &is, GraphType &graph);
+void read_binary_sg(const std::string &input_file, GraphType &graph);
+GraphType read_binary_sg(const std::string &input_file);
+
 /* ************ vertex and edge label maps ************/
 
 /**
@@ -96,5 +120,34 @@ read_edge_to_label_map(const std::string &edge_to_label_map_file);
 void write_edge_to_label_map(const edge_to_label_map_t &edge_to_label_map,
                              const std::string &output_filename);
 
+/**
+ * Read/Write the same files than read/write_vertex_to_label_map, using a
+ * column indexed by vertex_descriptor instead of a hash map.
+ * Vertices are written in increasing order.
+ */
+VertexAttribute<size_t>
+read_vertex_labels(const std::string &vertex_to_label_map_file);
+void write_vertex_labels(const VertexAttribute<size_t> &vertex_labels,
+                         const std::string &output_filename);
+
+/**
+ * Read/Write the same files than read/write_edge_to_label_map, using a
+ * column indexed by edge id (see @ref EdgeIndex) instead of a hash map.
+ *
+ * Unlike read_edge_to_label_map, that creates edge_descriptors that are
+ * not part of any graph, the edges of the file are looked up in the graph
+ * of edge_index, so the labels can be used directly with it. Parallel
+ * edges get the labels in the order they appear in the file.
+ * Throws if an edge of the file is not in the graph.
+ *
+ * Edges are written in id order.
+ */
+EdgeAttribute<size_t>
+read_edge_labels(const std::string &edge_to_label_map_file,
+                 const EdgeIndex<GraphType> &edge_index);
+void write_edge_labels(const EdgeAttribute<size_t> &edge_labels,
+                       const EdgeIndex<GraphType> &edge_index,
+                       const std::string &output_filename);
+
 } // namespace SG
 #endif
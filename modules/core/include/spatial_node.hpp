@@ -21,36 +21,59 @@
 #ifndef SPATIAL_NODE_HPP
 #define SPATIAL_NODE_HPP
 #include "array_utilities.hpp"
+#include "common_types.hpp"
 #include <boost/serialization/array.hpp>
+#include <cstdint>
 #include <iostream>
 #include <sstream>
 #include <string>
 namespace SG {
 
-struct SpatialNode {
+/**
+ * Node of the spatial graph, templated on the type and the number of the
+ * coordinates.
+ * Use SpatialNode (double, 3D) unless memory is an issue, or
+ * SpatialNode2D for 2D images.
+ */
+template <typename TScalar, size_t TDimension = 3> struct SpatialNodeT {
     /** id of the node, used in some situations, i.e read_graphviz
      * * @sa read_graphviz
      * Don't expect that the node_id in the .dot files are the same ids than
      * in the graph after read. */
     size_t id;
+    using ScalarType = TScalar;
+    static constexpr size_t Dimension = TDimension;
     /// Use Array to store the position.
-    using PointType = ArrayUtilities::Array3D;
+    using PointType = PointTypeT<TScalar, TDimension>;
     /** Position of node. */
     PointType pos;
 };
+using SpatialNode = SpatialNodeT<double>;
+using SpatialNodeF = SpatialNodeT<float>;
+using SpatialNodeI32 = SpatialNodeT<int32_t>;
+using SpatialNode2D = SpatialNodeT<double, 2>;
+
+template <typename TScalar, size_t TDimension>
+constexpr size_t SpatialNodeT<TScalar, TDimension>::Dimension;
 
 /* Stream operators */
-inline static std::ostream &operator<<(std::ostream &os,
-                                       const SpatialNode &sn) {
+template <typename TScalar, size_t TDimension>
+inline std::ostream &operator<<(std::ostream &os,
+                                const SpatialNodeT<TScalar, TDimension> &sn) {
     os.precision(100);
-    os << sn.pos[0] << " " << sn.pos[1] << " " << sn.pos[2];
+    os << sn.pos[0];
+    for (size_t i = 1; i < TDimension; ++i) {
+        os << " " << sn.pos[i];
+    }
     return os;
 }
-inline static std::istream &operator>>(std::istream &is, SpatialNode &sn) {
-    auto &x = sn.pos[0];
-    auto &y = sn.pos[1];
-    auto &z = sn.pos[2];
-    is >> std::skipws >> x >> y >> z;
+template <typename TScalar, size_t TDimension>
+inline std::istream &operator>>(std::istream &is,
+                                SpatialNodeT<TScalar, TDimension> &sn) {
+    is >> std::skipws;
+    for (auto &x : sn.pos) {
+        is >> x;
+    }
     return is;
 }
 
@@ -58,8 +81,10 @@ inline static std::istream &operator>>(std::istream &is, SpatialNode &sn) {
 
 namespace boost {
 namespace serialization {
-template <class Archive>
-void serialize(Archive &ar, SG::SpatialNode &sn, unsigned /*version*/) {
+template <class Archive, typename TScalar, size_t TDimension>
+void serialize(Archive &ar,
+               SG::SpatialNodeT<TScalar, TDimension> &sn,
+               unsigned /*version*/) {
     ar &sn.id;
     ar &sn.pos;
 }
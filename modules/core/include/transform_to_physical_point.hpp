@@ -23,6 +23,7 @@
 
 #include "spatial_edge.hpp"  // for SG::PointType
 #include "spatial_graph.hpp" // for SG::GraphAL
+#include <vector>
 
 namespace SG {
 
@@ -75,37 +76,128 @@ index_array_to_physical_space_array(const SG::PointType &input_array,
     return physical_array;
 }
 
-inline void
-transform_graph_to_physical_space(SG::GraphAL &sg,
-                                  const SG::PointType &origin,
-                                  const SG::PointType &spacing,
-                                  const SG::DirectionMatrixType &direction) {
-    // Loop over all nodes and transform pos.
-    auto verts = boost::vertices(sg);
-    for (auto &&vi = verts.first; vi != verts.second; ++vi) {
-        sg[*vi].pos = index_array_to_physical_space_array(
-                sg[*vi].pos, origin, spacing, direction);
-    }
-    // Loop over all edges and transform edge_points
-    auto edges = boost::edges(sg);
-    for (auto ei = edges.first; ei != edges.second; ++ei) {
-        for (auto &&ep : sg[*ei].edge_points) {
-            ep = index_array_to_physical_space_array(
-                    ep, origin, spacing, direction);
+/**
+ * Precomputed transform between index and physical space of an image:
+ *
+ *     physical = origin + M * index
+ *     index = M^-1 * (physical - origin)
+ *
+ * with M = direction * diag(spacing), the same than ITK
+ * TransformIndexToPhysicalPoint and TransformPhysicalPointToIndex.
+ *
+ * M and its inverse are computed once in the constructor, instead of for
+ * each point.
+ */
+struct ImageSpaceTransform {
+    ImageSpaceTransform(const SG::PointType &origin,
+                        const SG::PointType &spacing,
+                        const SG::DirectionMatrixType &direction);
+
+    /** Same than index_array_to_physical_space_array. */
+    SG::PointType to_physical(const SG::PointType &index) const;
+    /**
+     * Continuous index, without rounding.
+     * Throws std::runtime_error if the transform is not invertible.
+     */
+    SG::PointType to_index(const SG::PointType &physical) const;
+
+    SG::PointType origin;
+    /** Row-major M = direction * diag(spacing) */
+    SG::DirectionMatrixType index_to_physical;
+    /** Row-major M^-1, zeros if M is singular. */
+    SG::DirectionMatrixType physical_to_index;
+    /** False if M is singular, i.e. zero spacing or invalid direction. */
+    bool is_invertible;
+};
+
+/**
+ * Transform the points in place, from index to physical space.
+ * Points are transformed in batches with the SIMD kernels of
+ * @ref ArrayUtilities::affine_transform_in_place, in parallel.
+ *
+ * @param points pointers to the points to transform
+ * @param transform image transform
+ * @param num_threads maximum number of threads, 0 to use all.
+ */
+void transform_points_to_physical_space(const std::vector<SG::PointType *> &points,
+                                        const ImageSpaceTransform &transform,
+                                        const size_t num_threads = 0);
+
+/**
+ * Transform the points in place, from physical to index space.
+ * Throws std::runtime_error if the transform is not invertible.
+ *
+ * @param points pointers to the points to transform
+ * @param transform image transform
+ * @param round_to_index round the continuous index to the nearest
+ *  integer (half integers up), as ITK TransformPhysicalPointToIndex.
+ * @param num_threads maximum number of threads, 0 to use all.
+ */
+void transform_points_to_index_space(const std::vector<SG::PointType *> &points,
+                                     const ImageSpaceTransform &transform,
+                                     const bool round_to_index = true,
+                                     const size_t num_threads = 0);
+/** Overload for a vector of points. */
+void transform_points_to_index_space(std::vector<SG::PointType> &points,
+                                     const ImageSpaceTransform &transform,
+                                     const bool round_to_index = true,
+                                     const size_t num_threads = 0);
+
+/**
+ * Transform all the vertex positions and edge points of the graph from index
+ * to physical space, in place and in parallel.
+ */
+void transform_graph_to_physical_space(SG::GraphAL &sg,
+                                       const ImageSpaceTransform &transform,
+                                       const size_t num_threads = 0);
+void transform_graph_to_physical_space(SG::GraphAL &sg,
+                                       const SG::PointType &origin,
+                                       const SG::PointType &spacing,
+                                       const SG::DirectionMatrixType &direction);
+
+/**
+ * Inverse of transform_graph_to_physical_space, in place and in parallel.
+ * Positions are rounded to the nearest index, as ITK
+ * TransformPhysicalPointToIndex does.
+ */
+void transform_graph_to_index_space(SG::GraphAL &sg,
+                                    const ImageSpaceTransform &transform,
+                                    const size_t num_threads = 0);
+void transform_graph_to_index_space(SG::GraphAL &sg,
+                                    const SG::PointType &origin,
+                                    const SG::PointType &spacing,
+                                    const SG::DirectionMatrixType &direction);
+
+/**
+ * ImageSpaceTransform from the metadata of a 3D ITK image.
+ */
+template <typename TImage>
+ImageSpaceTransform make_image_space_transform(const TImage *itk_image) {
+    static_assert(TImage::ImageDimension == 3,
+                  "ImageSpaceTransform is only implemented for 3D images.");
+    SG::PointType origin;
+    SG::PointType spacing;
+    SG::DirectionMatrixType direction;
+    const auto &itk_direction = itk_image->GetDirection();
+    for (size_t i = 0; i < 3; i++) {
+        origin[i] = itk_image->GetOrigin()[i];
+        spacing[i] = itk_image->GetSpacing()[i];
+        for (size_t j = 0; j < 3; j++) {
+            direction[3 * i + j] = itk_direction(i, j);
         }
     }
+    return ImageSpaceTransform(origin, spacing, direction);
 }
 
+/**
+ * Points have the same dimension than the image, PointType for 3D images
+ * and PointType2D for 2D images.
+ */
 template <typename TImage>
-SG::PointType
-index_array_to_physical_space_array(const SG::PointType &input_array,
-                                    const TImage *itk_image) {
+PointTypeT<double, TImage::ImageDimension> index_array_to_physical_space_array(
+        const PointTypeT<double, TImage::ImageDimension> &input_array,
+        const TImage *itk_image) {
     constexpr auto dim = TImage::ImageDimension;
-    if (input_array.size() != dim)
-        throw std::runtime_error(
-                "index_array_to_physical_space_array, image dimension" +
-                std::to_string(dim) + " doesn't fit with array size " +
-                std::to_string(input_array.size()));
 
     using ITKIndexType = typename TImage::IndexType;
     using ITKPointType = typename TImage::PointType;
@@ -118,7 +210,7 @@ index_array_to_physical_space_array(const SG::PointType &input_array,
     ITKPointType physical_point;
     itk_image->TransformIndexToPhysicalPoint(input_index, physical_point);
 
-    SG::PointType ret;
+    PointTypeT<double, dim> ret;
     for (size_t i = 0; i < dim; i++) {
         ret[i] = physical_point[i];
     }
@@ -126,15 +218,10 @@ index_array_to_physical_space_array(const SG::PointType &input_array,
 }
 
 template <typename TImage>
-SG::PointType
-physical_space_array_to_index_array(const SG::PointType &input_array,
-                                    const TImage *itk_image) {
+PointTypeT<double, TImage::ImageDimension> physical_space_array_to_index_array(
+        const PointTypeT<double, TImage::ImageDimension> &input_array,
+        const TImage *itk_image) {
     constexpr auto dim = TImage::ImageDimension;
-    if (input_array.size() != dim)
-        throw std::runtime_error(
-                "index_array_to_physical_space_array, image dimension" +
-                std::to_string(dim) + " doesn't fit with array size " +
-                std::to_string(input_array.size()));
 
     using ITKIndexType = typename TImage::IndexType;
     using ITKPointType = typename TImage::PointType;
@@ -147,7 +234,7 @@ physical_space_array_to_index_array(const SG::PointType &input_array,
     ITKIndexType index_point;
     itk_image->TransformPhysicalPointToIndex(input_physical_point, index_point);
 
-    SG::PointType ret;
+    PointTypeT<double, dim> ret;
     for (size_t i = 0; i < dim; i++) {
         ret[i] = index_point[i];
     }
@@ -155,8 +242,9 @@ physical_space_array_to_index_array(const SG::PointType &input_array,
 }
 
 template <typename TImage>
-void transform_graph_to_physical_space(SG::GraphAL &sg,
-                                       const TImage *itk_image) {
+void transform_graph_to_physical_space(
+        GraphTypeT<double, TImage::ImageDimension> &sg,
+        const TImage *itk_image) {
     // Loop over all nodes and transform pos.
     auto verts = boost::vertices(sg);
     for (auto &&vi = verts.first; vi != verts.second; ++vi) {
@@ -173,7 +261,9 @@ void transform_graph_to_physical_space(SG::GraphAL &sg,
 }
 
 template <typename TImage>
-void transform_graph_to_index_space(SG::GraphAL &sg, const TImage *itk_image) {
+void transform_graph_to_index_space(
+        GraphTypeT<double, TImage::ImageDimension> &sg,
+        const TImage *itk_image) {
     // Loop over all nodes and transform pos.
     auto verts = boost::vertices(sg);
     for (auto &&vi = verts.first; vi != verts.second; ++vi) {
@@ -0,0 +1,69 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "arena_spatial_graph.hpp"
+
+namespace SG {
+
+ArenaSpatialGraph::ArenaSpatialGraph(const size_t num_vertices,
+                                     const size_t block_size)
+        : m_arena(new PointArena(block_size)),
+          m_graph(new ArenaGraphType(num_vertices)) {}
+
+ArenaSpatialGraph to_arena_spatial_graph(const GraphType &graph) {
+    const auto num_vertices = boost::num_vertices(graph);
+    ArenaSpatialGraph arena_sg(num_vertices);
+    auto &arena_graph = arena_sg.graph();
+    for (size_t v = 0; v < num_vertices; ++v) {
+        arena_graph[v] = graph[v];
+    }
+    PointArena::Scope scope(arena_sg.arena());
+    const auto edges = boost::edges(graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        // add_edge copies the edge bundle, fill the points after adding it.
+        const auto added = boost::add_edge(boost::source(*ei, graph),
+                                           boost::target(*ei, graph),
+                                           arena_graph);
+        const auto &edge_points = graph[*ei].edge_points;
+        arena_graph[added.first].edge_points.assign(edge_points.cbegin(),
+                                                    edge_points.cend());
+    }
+    return arena_sg;
+}
+
+GraphType to_spatial_graph(const ArenaGraphType &arena_graph) {
+    const auto num_vertices = boost::num_vertices(arena_graph);
+    GraphType graph(num_vertices);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        graph[v] = arena_graph[v];
+    }
+    const auto edges = boost::edges(arena_graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        const auto &edge_points = arena_graph[*ei].edge_points;
+        boost::add_edge(boost::source(*ei, arena_graph),
+                        boost::target(*ei, arena_graph),
+                        SpatialEdge{PointContainer(edge_points.cbegin(),
+                                                   edge_points.cend())},
+                        graph);
+    }
+    return graph;
+}
+
+} // namespace SG
@@ -0,0 +1,332 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "array_utilities_batch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ArrayUtilities {
+
+namespace {
+/**
+ * Operations on the lanes of a SIMD register. The kernels are written once
+ * as generic lambdas over the lanes type, and run with SimdLanes for the
+ * bulk of the batch and ScalarLanes for the remainder.
+ * Operations are done in the same order than the scalar functions, so
+ * the results match them.
+ */
+struct ScalarLanes {
+    using type = double;
+    static constexpr size_t width = 1;
+    static type load(const double *p) { return *p; }
+    static void store(double *p, const type a) { *p = a; }
+    static type set1(const double v) { return v; }
+    static type add(const type a, const type b) { return a + b; }
+    static type sub(const type a, const type b) { return a - b; }
+    static type mul(const type a, const type b) { return a * b; }
+    static type div(const type a, const type b) { return a / b; }
+    static type sqrt(const type a) { return std::sqrt(a); }
+    static type min(const type a, const type b) { return std::min(a, b); }
+    static type max(const type a, const type b) { return std::max(a, b); }
+    static type round_nearest(const type a) { return std::nearbyint(a); }
+    /** (condition > 0) ? a : b */
+    static type select_positive(const type condition,
+                                const type a,
+                                const type b) {
+        return condition > 0.0 ? a : b;
+    }
+};
+
+#if defined(__AVX512F__)
+struct SimdLanes {
+    using type = __m512d;
+    static constexpr size_t width = 8;
+    static type load(const double *p) { return _mm512_loadu_pd(p); }
+    static void store(double *p, const type a) { _mm512_storeu_pd(p, a); }
+    static type set1(const double v) { return _mm512_set1_pd(v); }
+    static type add(const type a, const type b) { return _mm512_add_pd(a, b); }
+    static type sub(const type a, const type b) { return _mm512_sub_pd(a, b); }
+    static type mul(const type a, const type b) { return _mm512_mul_pd(a, b); }
+    static type div(const type a, const type b) { return _mm512_div_pd(a, b); }
+    static type sqrt(const type a) { return _mm512_sqrt_pd(a); }
+    static type min(const type a, const type b) { return _mm512_min_pd(a, b); }
+    static type max(const type a, const type b) { return _mm512_max_pd(a, b); }
+    static type round_nearest(const type a) {
+        return _mm512_roundscale_pd(a,
+                                    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+    static type select_positive(const type condition,
+                                const type a,
+                                const type b) {
+        const auto mask = _mm512_cmp_pd_mask(condition, _mm512_setzero_pd(),
+                                             _CMP_GT_OQ);
+        return _mm512_mask_blend_pd(mask, b, a);
+    }
+};
+#elif defined(__AVX2__)
+struct SimdLanes {
+    using type = __m256d;
+    static constexpr size_t width = 4;
+    static type load(const double *p) { return _mm256_loadu_pd(p); }
+    static void store(double *p, const type a) { _mm256_storeu_pd(p, a); }
+    static type set1(const double v) { return _mm256_set1_pd(v); }
+    static type add(const type a, const type b) { return _mm256_add_pd(a, b); }
+    static type sub(const type a, const type b) { return _mm256_sub_pd(a, b); }
+    static type mul(const type a, const type b) { return _mm256_mul_pd(a, b); }
+    static type div(const type a, const type b) { return _mm256_div_pd(a, b); }
+    static type sqrt(const type a) { return _mm256_sqrt_pd(a); }
+    static type min(const type a, const type b) { return _mm256_min_pd(a, b); }
+    static type max(const type a, const type b) { return _mm256_max_pd(a, b); }
+    static type round_nearest(const type a) {
+        return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+    static type select_positive(const type condition,
+                                const type a,
+                                const type b) {
+        const auto mask =
+                _mm256_cmp_pd(condition, _mm256_setzero_pd(), _CMP_GT_OQ);
+        return _mm256_blendv_pd(b, a, mask);
+    }
+};
+#else
+using SimdLanes = ScalarLanes;
+#endif
+
+/** Run kernel(lanes, i) for each chunk of lanes::width elements in [0,n) */
+template <typename TKernel>
+void for_each_lane(const size_t n, TKernel &&kernel) {
+    const size_t simd_end = n - n % SimdLanes::width;
+    for (size_t i = 0; i < simd_end; i += SimdLanes::width) {
+        kernel(SimdLanes(), i);
+    }
+    for (size_t i = simd_end; i < n; ++i) {
+        kernel(ScalarLanes(), i);
+    }
+}
+
+/** Same order than dot_product: ((0 + x*x) + y*y) + z*z */
+template <typename L>
+typename L::type dot3(const typename L::type &ax,
+                      const typename L::type &ay,
+                      const typename L::type &az,
+                      const typename L::type &bx,
+                      const typename L::type &by,
+                      const typename L::type &bz) {
+    return L::add(L::add(L::mul(ax, bx), L::mul(ay, by)), L::mul(az, bz));
+}
+
+void check_same_size(const Array3DBatch &lhs,
+                     const Array3DBatch &rhs,
+                     const std::string &function_name) {
+    if (lhs.size() != rhs.size()) {
+        throw std::runtime_error(function_name + ": lhs size (" +
+                                 std::to_string(lhs.size()) +
+                                 ") is different than rhs size (" +
+                                 std::to_string(rhs.size()) + ").");
+    }
+}
+
+/** Distances between lhs[lhs_first + i] and rhs[rhs_first + i]. */
+void distances_kernel(const Array3DBatch &lhs,
+                      const size_t lhs_first,
+                      const Array3DBatch &rhs,
+                      const size_t rhs_first,
+                      const size_t n,
+                      double *out) {
+    for_each_lane(n, [&](auto lanes, const size_t i) {
+        using L = decltype(lanes);
+        const auto dx = L::sub(L::load(&lhs.x[lhs_first + i]),
+                               L::load(&rhs.x[rhs_first + i]));
+        const auto dy = L::sub(L::load(&lhs.y[lhs_first + i]),
+                               L::load(&rhs.y[rhs_first + i]));
+        const auto dz = L::sub(L::load(&lhs.z[lhs_first + i]),
+                               L::load(&rhs.z[rhs_first + i]));
+        L::store(&out[i], L::sqrt(dot3<L>(dx, dy, dz, dx, dy, dz)));
+    });
+}
+
+void minus_periodic_kernel(const Array3DBatch &lhs,
+                           const Array3DBatch &rhs,
+                           const Array3D &size_box,
+                           const Array3D &size_box_inverse,
+                           Array3DBatch &out) {
+    const std::vector<double> *lhs_coordinates[3] = {&lhs.x, &lhs.y, &lhs.z};
+    const std::vector<double> *rhs_coordinates[3] = {&rhs.x, &rhs.y, &rhs.z};
+    std::vector<double> *out_coordinates[3] = {&out.x, &out.y, &out.z};
+    for (size_t dim = 0; dim < 3; ++dim) {
+        const auto &l = *lhs_coordinates[dim];
+        const auto &r = *rhs_coordinates[dim];
+        auto &result = *out_coordinates[dim];
+        for_each_lane(lhs.size(), [&](auto lanes, const size_t i) {
+            using L = decltype(lanes);
+            const auto diff = L::sub(L::load(&l[i]), L::load(&r[i]));
+            const auto image = L::mul(
+                    L::set1(size_box[dim]),
+                    L::round_nearest(
+                            L::mul(diff, L::set1(size_box_inverse[dim]))));
+            L::store(&result[i], L::sub(diff, image));
+        });
+    }
+}
+} // namespace
+
+std::vector<double> distances(const Array3DBatch &lhs,
+                              const Array3DBatch &rhs) {
+    check_same_size(lhs, rhs, "distances");
+    std::vector<double> out(lhs.size());
+    distances_kernel(lhs, 0, rhs, 0, lhs.size(), out.data());
+    return out;
+}
+
+std::vector<double> segment_lengths(const Array3DBatch &points) {
+    if (points.size() < 2) {
+        return {};
+    }
+    const size_t n = points.size() - 1;
+    std::vector<double> out(n);
+    distances_kernel(points, 1, points, 0, n, out.data());
+    return out;
+}
+
+double polyline_length(const Array3DBatch &points) {
+    const auto lengths = segment_lengths(points);
+    return std::accumulate(lengths.cbegin(), lengths.cend(), 0.0);
+}
+
+std::vector<double> cos_directors(const Array3DBatch &lhs,
+                                  const Array3DBatch &rhs) {
+    check_same_size(lhs, rhs, "cos_directors");
+    std::vector<double> out(lhs.size());
+    for_each_lane(lhs.size(), [&](auto lanes, const size_t i) {
+        using L = decltype(lanes);
+        const auto ax = L::load(&lhs.x[i]);
+        const auto ay = L::load(&lhs.y[i]);
+        const auto az = L::load(&lhs.z[i]);
+        const auto bx = L::load(&rhs.x[i]);
+        const auto by = L::load(&rhs.y[i]);
+        const auto bz = L::load(&rhs.z[i]);
+        const auto dot = dot3<L>(ax, ay, az, bx, by, bz);
+        const auto norms = L::mul(L::sqrt(dot3<L>(ax, ay, az, ax, ay, az)),
+                                  L::sqrt(dot3<L>(bx, by, bz, bx, by, bz)));
+        const auto cosine =
+                L::min(L::max(L::div(dot, norms), L::set1(-1.0)),
+                       L::set1(1.0));
+        L::store(&out[i], L::select_positive(norms, cosine, L::set1(1.0)));
+    });
+    return out;
+}
+
+std::vector<double> angles(const Array3DBatch &lhs, const Array3DBatch &rhs) {
+    check_same_size(lhs, rhs, "angles");
+    std::vector<double> out(lhs.size());
+    std::vector<double> dots(lhs.size());
+    for_each_lane(lhs.size(), [&](auto lanes, const size_t i) {
+        using L = decltype(lanes);
+        const auto ax = L::load(&lhs.x[i]);
+        const auto ay = L::load(&lhs.y[i]);
+        const auto az = L::load(&lhs.z[i]);
+        const auto bx = L::load(&rhs.x[i]);
+        const auto by = L::load(&rhs.y[i]);
+        const auto bz = L::load(&rhs.z[i]);
+        const auto cx = L::sub(L::mul(ay, bz), L::mul(az, by));
+        const auto cy = L::sub(L::mul(az, bx), L::mul(ax, bz));
+        const auto cz = L::sub(L::mul(ax, by), L::mul(ay, bx));
+        L::store(&out[i], L::sqrt(dot3<L>(cx, cy, cz, cx, cy, cz)));
+        L::store(&dots[i], dot3<L>(ax, ay, az, bx, by, bz));
+    });
+    std::transform(out.cbegin(), out.cend(), dots.cbegin(), out.begin(),
+                   [](const double cross_norm, const double dot) {
+                       return std::atan2(cross_norm, dot);
+                   });
+    return out;
+}
+
+Array3DBatch
+minus_with_boundary_condition_periodic(const Array3DBatch &lhs,
+                                       const Array3DBatch &rhs,
+                                       const Array3D &size_box,
+                                       const Array3D &size_box_inverse) {
+    check_same_size(lhs, rhs, "minus_with_boundary_condition_periodic");
+    Array3DBatch out(lhs.size());
+    minus_periodic_kernel(lhs, rhs, size_box, size_box_inverse, out);
+    return out;
+}
+
+Array3DBatch minus_with_boundary_condition_periodic(const Array3DBatch &lhs,
+                                                    const Array3DBatch &rhs) {
+    const Array3D unit_box = {{1.0, 1.0, 1.0}};
+    return minus_with_boundary_condition_periodic(lhs, rhs, unit_box,
+                                                  unit_box);
+}
+
+std::vector<double>
+distances_with_boundary_condition_periodic(const Array3DBatch &lhs,
+                                           const Array3DBatch &rhs,
+                                           const Array3D &size_box,
+                                           const Array3D &size_box_inverse) {
+    const auto diffs = minus_with_boundary_condition_periodic(
+            lhs, rhs, size_box, size_box_inverse);
+    const Array3DBatch origin(diffs.size());
+    return distances(diffs, origin);
+}
+
+std::vector<double>
+distances_with_boundary_condition_periodic(const Array3DBatch &lhs,
+                                           const Array3DBatch &rhs) {
+    const Array3D unit_box = {{1.0, 1.0, 1.0}};
+    return distances_with_boundary_condition_periodic(lhs, rhs, unit_box,
+                                                      unit_box);
+}
+
+void affine_transform_in_place(Array3DBatch &points,
+                               const std::array<double, 9> &matrix,
+                               const Array3D &translation_before,
+                               const Array3D &translation_after) {
+    for_each_lane(points.size(), [&](auto lanes, const size_t i) {
+        using L = decltype(lanes);
+        const auto x = L::sub(L::load(&points.x[i]),
+                              L::set1(translation_before[0]));
+        const auto y = L::sub(L::load(&points.y[i]),
+                              L::set1(translation_before[1]));
+        const auto z = L::sub(L::load(&points.z[i]),
+                              L::set1(translation_before[2]));
+        // Same order than index_array_to_physical_space_array:
+        // ((t + m0 * x) + m1 * y) + m2 * z
+        const auto row = [&](const size_t r) {
+            return L::add(
+                    L::add(L::add(L::set1(translation_after[r]),
+                                  L::mul(L::set1(matrix[3 * r]), x)),
+                           L::mul(L::set1(matrix[3 * r + 1]), y)),
+                    L::mul(L::set1(matrix[3 * r + 2]), z));
+        };
+        L::store(&points.x[i], row(0));
+        L::store(&points.y[i], row(1));
+        L::store(&points.z[i], row(2));
+    });
+}
+
+} // namespace ArrayUtilities
@@ -0,0 +1,85 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "bit_packed_volume.hpp"
+#include <bitset>
+
+namespace SG {
+
+BitPackedVolume::BitPackedVolume(const IndexType &begin, const SizeType &size)
+        : m_begin(begin), m_size(size) {
+    if (num_voxels() == 0) {
+        m_size = {{0, 0, 0}};
+        return;
+    }
+    m_row_bits = ((m_size[0] + 2 + 63) / 64) * 64;
+    m_padded_size_y = m_size[1] + 2;
+    m_words.assign((m_row_bits / 64) * m_padded_size_y * (m_size[2] + 2), 0);
+}
+
+bool BitPackedVolume::contains(const IndexType &index) const {
+    for (size_t i = 0; i < 3; ++i) {
+        if (index[i] < m_begin[i] || index[i] >= m_begin[i] + m_size[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+BitPackedVolume::IndexType BitPackedVolume::index(const size_t voxel) const {
+    const size_t row = voxel / m_row_bits;
+    return {{m_begin[0] + (voxel % m_row_bits) - 1,
+             m_begin[1] + (row % m_padded_size_y) - 1,
+             m_begin[2] + (row / m_padded_size_y) - 1}};
+}
+
+size_t BitPackedVolume::parity(const size_t voxel) const {
+    const size_t row = voxel / m_row_bits;
+    return (voxel & 1) | (((row % m_padded_size_y) & 1) << 1) |
+           (((row / m_padded_size_y) & 1) << 2);
+}
+
+size_t BitPackedVolume::count() const {
+    size_t total = 0;
+    for (const auto word : m_words) {
+        total += std::bitset<64>(word).count();
+    }
+    return total;
+}
+
+NeighborhoodConfigurationMap::NeighborhoodConfigurationMap(
+        const std::array<uint32_t, 26> &neighbor_masks) {
+    for (size_t dz = 0; dz < 3; ++dz) {
+        for (uint32_t slice = 0; slice < 512; ++slice) {
+            uint32_t config = 0;
+            for (size_t bit = 0; bit < 9; ++bit) {
+                const size_t code_bit = 9 * dz + bit;
+                if (code_bit == 13 || !((slice >> bit) & 1)) {
+                    continue;
+                }
+                config |= neighbor_masks[code_bit < 13 ? code_bit
+                                                       : code_bit - 1];
+            }
+            m_slices[dz][slice] = config;
+        }
+    }
+}
+
+} // namespace SG
@@ -0,0 +1,229 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "chain_code_edge_points.hpp"
+#include "array_utilities.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace SG {
+
+constexpr size_t ChainCodeEdgePoints::bits_per_code;
+constexpr size_t ChainCodeEdgePoints::codes_per_word;
+constexpr uint64_t ChainCodeEdgePoints::code_mask;
+constexpr uint8_t ChainCodeEdgePoints::restart_code;
+
+namespace {
+bool is_lattice_coordinate(const double value) {
+    return std::floor(value) == value &&
+           value >= std::numeric_limits<int32_t>::min() &&
+           value <= std::numeric_limits<int32_t>::max();
+}
+
+ChainCodeEdgePoints::IndexType to_index(const PointType &point) {
+    for (const auto &value : point) {
+        if (!is_lattice_coordinate(value)) {
+            throw std::runtime_error(
+                    "ChainCodeEdgePoints: point " +
+                    ArrayUtilities::to_string(point) +
+                    " is not in the lattice (index space).");
+        }
+    }
+    return {{static_cast<int32_t>(point[0]), static_cast<int32_t>(point[1]),
+             static_cast<int32_t>(point[2])}};
+}
+
+PointType to_point(const ChainCodeEdgePoints::IndexType &index) {
+    return {{static_cast<double>(index[0]), static_cast<double>(index[1]),
+             static_cast<double>(index[2])}};
+}
+} // namespace
+
+uint8_t ChainCodeEdgePoints::step_to_code(const IndexType &from,
+                                          const IndexType &to) {
+    int code = 0;
+    for (size_t i = 0; i < 3; ++i) {
+        const int64_t step = static_cast<int64_t>(to[i]) - from[i];
+        if (step < -1 || step > 1) {
+            return restart_code;
+        }
+        code = 3 * code + static_cast<int>(step + 1);
+    }
+    // code 13 is the null step (same point)
+    if (code == 13) {
+        return restart_code;
+    }
+    return static_cast<uint8_t>(code < 13 ? code : code - 1);
+}
+
+ChainCodeEdgePoints::IndexType
+ChainCodeEdgePoints::code_to_step(const uint8_t code) {
+    const int full_code = code < 13 ? code : code + 1;
+    return {{full_code / 9 - 1, (full_code / 3) % 3 - 1, full_code % 3 - 1}};
+}
+
+ChainCodeEdgePoints::ChainCodeEdgePoints(const PointContainer &edge_points) {
+    m_codes.reserve(edge_points.size() / codes_per_word + 1);
+    for (const auto &point : edge_points) {
+        push_back(point);
+    }
+    m_codes.shrink_to_fit();
+    m_restarts.shrink_to_fit();
+}
+
+bool ChainCodeEdgePoints::is_encodable(const PointContainer &edge_points) {
+    for (const auto &point : edge_points) {
+        for (const auto &value : point) {
+            if (!is_lattice_coordinate(value)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ChainCodeEdgePoints::push_code(const uint8_t code) {
+    const size_t code_index = m_size - 1;
+    if (code_index % codes_per_word == 0) {
+        m_codes.push_back(0);
+    }
+    m_codes.back() |= static_cast<uint64_t>(code)
+                      << (bits_per_code * (code_index % codes_per_word));
+}
+
+void ChainCodeEdgePoints::push_back(const PointType &point) {
+    const auto index = to_index(point);
+    if (m_size == 0) {
+        m_restarts.push_back(index);
+    } else {
+        const auto code = step_to_code(m_last, index);
+        if (code == restart_code) {
+            m_restarts.push_back(index);
+        }
+        push_code(code);
+    }
+    m_last = index;
+    ++m_size;
+}
+
+PointContainer ChainCodeEdgePoints::decode() const {
+    return PointContainer(begin(), end());
+}
+
+PointContainer
+ChainCodeEdgePoints::decode(const PointType &origin,
+                            const PointType &spacing,
+                            const DirectionMatrixType &direction) const {
+    PointContainer points;
+    points.reserve(m_size);
+    for (const auto &point : *this) {
+        points.push_back(index_array_to_physical_space_array(point, origin,
+                                                             spacing, direction));
+    }
+    return points;
+}
+
+ChainCodeEdgePoints::const_iterator::const_iterator(
+        const ChainCodeEdgePoints *chain, const size_t index)
+        : m_chain(chain), m_index(index) {
+    if (m_index == 0 && m_chain->m_size > 0) {
+        m_current = m_chain->m_restarts[0];
+        set_point();
+    }
+}
+
+ChainCodeEdgePoints::const_iterator &
+ChainCodeEdgePoints::const_iterator::operator++() {
+    ++m_index;
+    if (m_index < m_chain->m_size) {
+        const auto code = m_chain->code(m_index - 1);
+        if (code == restart_code) {
+            m_current = m_chain->m_restarts[++m_restart_index];
+        } else {
+            const auto step = code_to_step(code);
+            for (size_t i = 0; i < 3; ++i) {
+                m_current[i] += step[i];
+            }
+        }
+        set_point();
+    }
+    return *this;
+}
+
+void ChainCodeEdgePoints::const_iterator::set_point() {
+    m_point = to_point(m_current);
+}
+
+CompactGraphType compact_spatial_graph(const GraphType &graph) {
+    const auto num_vertices = boost::num_vertices(graph);
+    CompactGraphType compact_graph(num_vertices);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        compact_graph[v] = graph[v];
+    }
+    const auto edges = boost::edges(graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        boost::add_edge(
+                boost::source(*ei, graph), boost::target(*ei, graph),
+                CompactSpatialEdge{ChainCodeEdgePoints(graph[*ei].edge_points)},
+                compact_graph);
+    }
+    return compact_graph;
+}
+
+GraphType to_spatial_graph(const CompactGraphType &compact_graph) {
+    const auto num_vertices = boost::num_vertices(compact_graph);
+    GraphType graph(num_vertices);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        graph[v] = compact_graph[v];
+    }
+    const auto edges = boost::edges(compact_graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        boost::add_edge(boost::source(*ei, compact_graph),
+                        boost::target(*ei, compact_graph),
+                        SpatialEdge{compact_graph[*ei].edge_points.decode()},
+                        graph);
+    }
+    return graph;
+}
+
+GraphType to_spatial_graph(const CompactGraphType &compact_graph,
+                           const PointType &origin,
+                           const PointType &spacing,
+                           const DirectionMatrixType &direction) {
+    const auto num_vertices = boost::num_vertices(compact_graph);
+    GraphType graph(num_vertices);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        graph[v].id = compact_graph[v].id;
+        graph[v].pos = index_array_to_physical_space_array(
+                compact_graph[v].pos, origin, spacing, direction);
+    }
+    const auto edges = boost::edges(compact_graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        boost::add_edge(boost::source(*ei, compact_graph),
+                        boost::target(*ei, compact_graph),
+                        SpatialEdge{compact_graph[*ei].edge_points.decode(
+                                origin, spacing, direction)},
+                        graph);
+    }
+    return graph;
+}
+
+} // namespace SG
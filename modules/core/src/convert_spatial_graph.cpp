@@ -0,0 +1,67 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "convert_spatial_graph.hpp"
+
+namespace SG {
+
+GraphType embed_spatial_graph_in_3d(const GraphType2D &graph_2d) {
+    const auto num_vertices = boost::num_vertices(graph_2d);
+    GraphType graph(num_vertices);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        graph[v].id = graph_2d[v].id;
+        graph[v].pos = embed_point_in_3d(graph_2d[v].pos);
+    }
+    const auto edges = boost::edges(graph_2d);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        const auto &input_edge_points = graph_2d[*ei].edge_points;
+        SpatialEdge output_edge;
+        output_edge.edge_points.reserve(input_edge_points.size());
+        for (const auto &point : input_edge_points) {
+            output_edge.edge_points.push_back(embed_point_in_3d(point));
+        }
+        boost::add_edge(boost::source(*ei, graph_2d),
+                        boost::target(*ei, graph_2d), std::move(output_edge),
+                        graph);
+    }
+    return graph;
+}
+
+// explicit instantiations
+template GraphTypeF convert_spatial_graph<float, double>(
+        const GraphType &input_graph);
+template GraphTypeI32 convert_spatial_graph<int32_t, double>(
+        const GraphType &input_graph);
+template GraphType convert_spatial_graph<double, float>(
+        const GraphTypeF &input_graph);
+template GraphType convert_spatial_graph<double, int32_t>(
+        const GraphTypeI32 &input_graph);
+template GraphType index_graph_to_physical_space_graph<int32_t>(
+        const GraphTypeI32 &index_graph,
+        const PointType &origin,
+        const PointType &spacing,
+        const DirectionMatrixType &direction);
+template GraphType index_graph_to_physical_space_graph<float>(
+        const GraphTypeF &index_graph,
+        const PointType &origin,
+        const PointType &spacing,
+        const DirectionMatrixType &direction);
+
+} // namespace SG
@@ -26,8 +26,12 @@
 
 namespace SG {
 
-double ete_distance(const GraphType::edge_descriptor &edge_desc,
-                    const GraphType &sg) {
+namespace {
+/* Implementations shared by GraphType, GraphType2D and FrozenSpatialGraph */
+template <typename TGraph>
+double ete_distance_impl(
+        const typename boost::graph_traits<TGraph>::edge_descriptor &edge_desc,
+        const TGraph &sg) {
     const auto source = boost::source(edge_desc, sg);
     const auto target = boost::target(edge_desc, sg);
     const auto &source_pos = sg[source].pos;
@@ -35,7 +39,8 @@ double ete_distance(const GraphType::edge_descriptor &edge_desc,
     return ArrayUtilities::distance(target_pos, source_pos);
 }
 
-double edge_points_length(const SpatialEdge &se) {
+template <typename TSpatialEdge>
+double edge_points_length_impl(const TSpatialEdge &se) {
     const auto &eps = se.edge_points;
     size_t npoints = eps.size();
     // if empty or only one point, return null distance
@@ -49,8 +54,10 @@ double edge_points_length(const SpatialEdge &se) {
     return length;
 }
 
-double contour_length(const GraphType::edge_descriptor &edge_desc,
-                      const GraphType &sg) {
+template <typename TGraph>
+double contour_length_impl(
+        const typename boost::graph_traits<TGraph>::edge_descriptor &edge_desc,
+        const TGraph &sg) {
     const auto &se = sg[edge_desc];
     const auto &eps = se.edge_points;
     auto source = boost::source(edge_desc, sg);
@@ -104,7 +111,44 @@ double contour_length(const GraphType::edge_descriptor &edge_desc,
     //     }
     // }
 
-    return dist_to_source + edge_points_length(se) + dist_to_target;
+    return dist_to_source + edge_points_length_impl(se) + dist_to_target;
+}
+} // namespace
+
+double ete_distance(const GraphType::edge_descriptor &edge_desc,
+                    const GraphType &sg) {
+    return ete_distance_impl(edge_desc, sg);
+}
+double ete_distance(const FrozenSpatialGraph::edge_descriptor &edge_desc,
+                    const FrozenSpatialGraph &sg) {
+    return ete_distance_impl(edge_desc, sg);
+}
+double ete_distance(const GraphType2D::edge_descriptor &edge_desc,
+                    const GraphType2D &sg) {
+    return ete_distance_impl(edge_desc, sg);
+}
+
+double edge_points_length(const SpatialEdge &se) {
+    return edge_points_length_impl(se);
+}
+double edge_points_length(const FrozenSpatialEdge &se) {
+    return edge_points_length_impl(se);
+}
+double edge_points_length(const SpatialEdge2D &se) {
+    return edge_points_length_impl(se);
+}
+
+double contour_length(const GraphType::edge_descriptor &edge_desc,
+                      const GraphType &sg) {
+    return contour_length_impl(edge_desc, sg);
+}
+double contour_length(const FrozenSpatialGraph::edge_descriptor &edge_desc,
+                      const FrozenSpatialGraph &sg) {
+    return contour_length_impl(edge_desc, sg);
+}
+double contour_length(const GraphType2D::edge_descriptor &edge_desc,
+                      const GraphType2D &sg) {
+    return contour_length_impl(edge_desc, sg);
 }
 
 bool check_edge_points_are_contiguous(
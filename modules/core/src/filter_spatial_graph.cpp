@@ -23,6 +23,11 @@
 #include "spatial_node.hpp"
 #include <boost/graph/connected_components.hpp>
 #include <boost/graph/copy.hpp>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace SG {
 
@@ -84,16 +89,177 @@ filter_by_sets_no_copy(const EdgeDescriptorUnorderedSet &remove_edges,
     return FilteredGraphType(g, edge_lambda, vertex_lambda);
 }
 
+std::vector<GraphType::vertex_descriptor>
+compact_vertex_map(const std::vector<uint8_t> &remove_vertices) {
+    std::vector<GraphType::vertex_descriptor> vertex_map(
+            remove_vertices.size(), GraphType::null_vertex());
+    GraphType::vertex_descriptor new_vertex = 0;
+    for (size_t v = 0; v < remove_vertices.size(); ++v) {
+        if (!remove_vertices[v]) {
+            vertex_map[v] = new_vertex++;
+        }
+    }
+    return vertex_map;
+}
+
+namespace {
+/** Remaining edges after a compaction, with their new source and target. */
+struct CompactedEdges {
+    std::vector<GraphType::edge_descriptor> descriptors;
+    std::vector<GraphType::vertex_descriptor> sources;
+    std::vector<GraphType::vertex_descriptor> targets;
+};
+
+CompactedEdges
+compacted_edges(const GraphType &g,
+                const EdgeDescriptorUnorderedSet &remove_edges,
+                const std::vector<GraphType::vertex_descriptor> &vertex_map,
+                const size_t num_threads) {
+    const auto null_vertex = GraphType::null_vertex();
+    const auto edges = boost::edges(g);
+    const std::vector<GraphType::edge_descriptor> all_edges(edges.first,
+                                                            edges.second);
+    // Each chunk selects its edges, they are concatenated in order.
+    std::map<size_t, CompactedEdges> kept_per_chunk;
+    std::mutex kept_per_chunk_mutex;
+    parallel_for_chunks(
+            all_edges.size(),
+            [&](size_t begin, size_t end) {
+                CompactedEdges kept;
+                for (size_t i = begin; i < end; ++i) {
+                    const auto &ed = all_edges[i];
+                    const auto source = vertex_map[boost::source(ed, g)];
+                    const auto target = vertex_map[boost::target(ed, g)];
+                    if (source == null_vertex || target == null_vertex ||
+                        remove_edges.count(ed)) {
+                        continue;
+                    }
+                    kept.descriptors.push_back(ed);
+                    kept.sources.push_back(source);
+                    kept.targets.push_back(target);
+                }
+                std::lock_guard<std::mutex> lock(kept_per_chunk_mutex);
+                kept_per_chunk.emplace(begin, std::move(kept));
+            },
+            num_threads);
+    if (kept_per_chunk.size() == 1) {
+        return std::move(kept_per_chunk.begin()->second);
+    }
+    CompactedEdges kept;
+    for (auto &chunk : kept_per_chunk) {
+        const auto &chunk_kept = chunk.second;
+        kept.descriptors.insert(kept.descriptors.end(),
+                                chunk_kept.descriptors.cbegin(),
+                                chunk_kept.descriptors.cend());
+        kept.sources.insert(kept.sources.end(), chunk_kept.sources.cbegin(),
+                            chunk_kept.sources.cend());
+        kept.targets.insert(kept.targets.end(), chunk_kept.targets.cbegin(),
+                            chunk_kept.targets.cend());
+    }
+    return kept;
+}
+
+std::vector<GraphType::vertex_descriptor>
+compact_vertex_map_from_set(const GraphType &g,
+                            const VertexDescriptorUnorderedSet &remove_nodes) {
+    std::vector<uint8_t> remove_vertices(boost::num_vertices(g), 0);
+    for (const auto &v : remove_nodes) {
+        // Vertices not in the graph are ignored, as in filter_by_sets_no_copy.
+        if (v < remove_vertices.size()) {
+            remove_vertices[v] = 1;
+        }
+    }
+    return compact_vertex_map(remove_vertices);
+}
+
+/** Copy the vertices and edges of g that remain after the compaction. */
+void copy_compacted_graph(
+        const GraphType &g,
+        const EdgeDescriptorUnorderedSet &remove_edges,
+        const std::vector<GraphType::vertex_descriptor> &vertex_map,
+        const size_t num_threads,
+        GraphType &compacted_graph) {
+    const auto kept_edges =
+            compacted_edges(g, remove_edges, vertex_map, num_threads);
+    const auto num_vertices = boost::num_vertices(g);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        if (vertex_map[v] != GraphType::null_vertex()) {
+            boost::add_vertex(g[v], compacted_graph);
+        }
+    }
+    for (size_t i = 0; i < kept_edges.descriptors.size(); ++i) {
+        boost::add_edge(kept_edges.sources[i], kept_edges.targets[i],
+                        g[kept_edges.descriptors[i]], compacted_graph);
+    }
+}
+} // namespace
+
+CompactedGraph compact_graph(const GraphType &g,
+                             const EdgeDescriptorUnorderedSet &remove_edges,
+                             const VertexDescriptorUnorderedSet &remove_nodes,
+                             const size_t num_threads) {
+    CompactedGraph compacted;
+    compacted.vertex_map = compact_vertex_map_from_set(g, remove_nodes);
+    copy_compacted_graph(g, remove_edges, compacted.vertex_map, num_threads,
+                         compacted.graph);
+    return compacted;
+}
+
 GraphType filter_by_sets(const EdgeDescriptorUnorderedSet &remove_edges,
                          const VertexDescriptorUnorderedSet &remove_nodes,
-                         const GraphType &g) {
-    auto filtered_view = filter_by_sets_no_copy(remove_edges, remove_nodes, g);
+                         const GraphType &g,
+                         const size_t num_threads) {
     // Copy the graph -- vertex and edge descriptors are invalidated...
     GraphType out_filtered_graph;
-    boost::copy_graph(filtered_view, out_filtered_graph);
+    copy_compacted_graph(g, remove_edges,
+                         compact_vertex_map_from_set(g, remove_nodes),
+                         num_threads, out_filtered_graph);
     return out_filtered_graph;
 }
 
+std::vector<GraphType::vertex_descriptor>
+compact_graph_in_place(GraphType &g,
+                       const EdgeDescriptorUnorderedSet &remove_edges,
+                       const VertexDescriptorUnorderedSet &remove_nodes,
+                       const size_t num_threads) {
+    auto vertex_map = compact_vertex_map_from_set(g, remove_nodes);
+    const auto kept_edges =
+            compacted_edges(g, remove_edges, vertex_map, num_threads);
+    // adjacency_list cannot be moved, so g is cleared and filled again.
+    std::vector<SpatialNode> nodes;
+    const auto num_vertices = boost::num_vertices(g);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        if (vertex_map[v] != GraphType::null_vertex()) {
+            nodes.push_back(std::move(g[v]));
+        }
+    }
+    std::vector<SpatialEdge> edges;
+    edges.reserve(kept_edges.descriptors.size());
+    for (const auto &ed : kept_edges.descriptors) {
+        edges.push_back(std::move(g[ed]));
+    }
+    g.clear();
+    for (auto &node : nodes) {
+        boost::add_vertex(std::move(node), g);
+    }
+    for (size_t i = 0; i < edges.size(); ++i) {
+        boost::add_edge(kept_edges.sources[i], kept_edges.targets[i],
+                        std::move(edges[i]), g);
+    }
+    return vertex_map;
+}
+
+VertexDescriptorUnorderedSet degree_zero_vertices(const GraphType &g) {
+    VertexDescriptorUnorderedSet vertices;
+    const auto num_vertices = boost::num_vertices(g);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        if (boost::out_degree(v, g) == 0) {
+            vertices.insert(v);
+        }
+    }
+    return vertices;
+}
+
 std::vector<ComponentGraphType> filter_component_graphs(
         const GraphType &inputGraph,
         const size_t num_of_components,
@@ -120,38 +286,233 @@ std::vector<ComponentGraphType> filter_component_graphs(
     return component_graphs;
 }
 
+namespace {
+/**
+ * Root of the tree of v, halving the path to it.
+ *
+ * parent[v] <= v always holds: roots are only linked to lower roots, and
+ * halving replaces a parent by one of its ancestors. Concurrent calls only
+ * lose some halving, not correctness.
+ */
+size_t find_root(std::vector<std::atomic<size_t>> &parent, size_t v) {
+    while (true) {
+        size_t p = parent[v].load(std::memory_order_relaxed);
+        if (p == v) {
+            return v;
+        }
+        const size_t grand_parent = parent[p].load(std::memory_order_relaxed);
+        if (grand_parent != p) {
+            parent[v].compare_exchange_weak(p, grand_parent,
+                                            std::memory_order_relaxed);
+        }
+        v = grand_parent;
+    }
+}
+
+/** Link the roots of a and b, the higher root to the lower one. */
+void unite(std::vector<std::atomic<size_t>> &parent, size_t a, size_t b) {
+    while (true) {
+        a = find_root(parent, a);
+        b = find_root(parent, b);
+        if (a == b) {
+            return;
+        }
+        if (a < b) {
+            std::swap(a, b);
+        }
+        size_t expected = a;
+        // Fails if other thread linked a meanwhile, retry from the new roots.
+        if (parent[a].compare_exchange_strong(expected, b)) {
+            return;
+        }
+    }
+}
+
+/**
+ * Component of each vertex, numbered in the order of their lowest vertex.
+ * Union-find over the edges, processed in parallel.
+ */
+std::vector<size_t>
+union_find_component_labels(const GraphType &inputGraph,
+                            const std::vector<GraphType::edge_descriptor> &edges,
+                            size_t &num_of_components,
+                            const size_t num_threads) {
+    const size_t num_vertices = boost::num_vertices(inputGraph);
+    std::vector<std::atomic<size_t>> parent(num_vertices);
+    parallel_for_chunks(
+            num_vertices,
+            [&parent](size_t begin, size_t end) {
+                for (size_t v = begin; v < end; ++v) {
+                    parent[v].store(v, std::memory_order_relaxed);
+                }
+            },
+            num_threads);
+    parallel_for_chunks(
+            edges.size(),
+            [&parent, &edges, &inputGraph](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    unite(parent, boost::source(edges[i], inputGraph),
+                          boost::target(edges[i], inputGraph));
+                }
+            },
+            num_threads);
+
+    // The root of each tree is its lowest vertex, and parent[v] <= v, so the
+    // root of v is known when visiting v in increasing order.
+    std::vector<size_t> vertex_component(num_vertices);
+    num_of_components = 0;
+    for (size_t v = 0; v < num_vertices; ++v) {
+        const size_t p = parent[v].load(std::memory_order_relaxed);
+        vertex_component[v] =
+                (p == v) ? num_of_components++ : vertex_component[p];
+    }
+    return vertex_component;
+}
+
+void copy_component_graph_into(const GraphType &inputGraph,
+                               const GraphComponents &components,
+                               const size_t component,
+                               GraphType &component_graph) {
+    for (size_t i = components.vertex_offsets[component];
+         i < components.vertex_offsets[component + 1]; ++i) {
+        boost::add_vertex(inputGraph[components.vertices[i]], component_graph);
+    }
+    for (size_t i = components.edge_offsets[component];
+         i < components.edge_offsets[component + 1]; ++i) {
+        const auto &ed = components.edges[i];
+        boost::add_edge(
+                components.vertex_local_index[boost::source(ed, inputGraph)],
+                components.vertex_local_index[boost::target(ed, inputGraph)],
+                inputGraph[ed], component_graph);
+    }
+}
+} // namespace
+
 std::vector<ComponentGraphType>
 filter_component_graphs(const GraphType &inputGraph) {
-    std::unordered_map<GraphType::vertex_descriptor, int> components_map;
-    const auto num_of_components = boost::connected_components(
-            inputGraph, boost::make_assoc_property_map(components_map));
-    return filter_component_graphs(inputGraph, num_of_components,
-                                   components_map);
+    // Share the labels between all the filtered graphs, instead of a copy of
+    // a hash map per component.
+    const auto edges = boost::edges(inputGraph);
+    size_t num_of_components = 0;
+    const auto components = std::make_shared<const std::vector<size_t>>(
+            union_find_component_labels(
+                    inputGraph,
+                    std::vector<GraphType::edge_descriptor>(edges.first,
+                                                            edges.second),
+                    num_of_components, 0));
+    std::vector<ComponentGraphType> component_graphs;
+    for (size_t comp_index = 0; comp_index < num_of_components; comp_index++) {
+        component_graphs.emplace_back(
+                inputGraph,
+                // edge_lambda
+                [components, comp_index,
+                 &inputGraph](GraphType::edge_descriptor e) {
+                    return (*components)[source(e, inputGraph)] == comp_index;
+                },
+                // vertex_lambda
+                [components, comp_index](GraphType::vertex_descriptor v) {
+                    return (*components)[v] == comp_index;
+                });
+    }
+    return component_graphs;
+}
+
+GraphComponents connected_components_union_find(const GraphType &inputGraph,
+                                                const size_t num_threads) {
+    GraphComponents components;
+    const size_t num_vertices = boost::num_vertices(inputGraph);
+    const auto edges = boost::edges(inputGraph);
+    components.edges.assign(edges.first, edges.second);
+    const size_t num_edges = components.edges.size();
+
+    auto &vertex_component = components.vertex_component;
+    size_t num_of_components = 0;
+    vertex_component = union_find_component_labels(
+            inputGraph, components.edges, num_of_components, num_threads);
+
+    // Counting sort of vertices and edges by component, keeping their order.
+    auto &vertex_offsets = components.vertex_offsets;
+    vertex_offsets.assign(num_of_components + 1, 0);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        ++vertex_offsets[vertex_component[v] + 1];
+    }
+    for (size_t c = 0; c < num_of_components; ++c) {
+        vertex_offsets[c + 1] += vertex_offsets[c];
+    }
+    components.vertices.resize(num_vertices);
+    components.vertex_local_index.resize(num_vertices);
+    {
+        std::vector<size_t> next(vertex_offsets.cbegin(),
+                                 vertex_offsets.cend() - 1);
+        for (size_t v = 0; v < num_vertices; ++v) {
+            const size_t c = vertex_component[v];
+            components.vertex_local_index[v] = next[c] - vertex_offsets[c];
+            components.vertices[next[c]++] = v;
+        }
+    }
+
+    auto &edge_offsets = components.edge_offsets;
+    edge_offsets.assign(num_of_components + 1, 0);
+    std::vector<size_t> edge_component(num_edges);
+    for (size_t i = 0; i < num_edges; ++i) {
+        edge_component[i] = vertex_component[boost::source(
+                components.edges[i], inputGraph)];
+        ++edge_offsets[edge_component[i] + 1];
+    }
+    for (size_t c = 0; c < num_of_components; ++c) {
+        edge_offsets[c + 1] += edge_offsets[c];
+    }
+    {
+        std::vector<GraphType::edge_descriptor> sorted_edges(num_edges);
+        std::vector<size_t> next(edge_offsets.cbegin(),
+                                 edge_offsets.cend() - 1);
+        for (size_t i = 0; i < num_edges; ++i) {
+            sorted_edges[next[edge_component[i]]++] = components.edges[i];
+        }
+        components.edges = std::move(sorted_edges);
+    }
+    return components;
+}
+
+GraphType copy_component_graph(const GraphType &inputGraph,
+                               const GraphComponents &components,
+                               const size_t component) {
+    GraphType component_graph;
+    copy_component_graph_into(inputGraph, components, component,
+                              component_graph);
+    return component_graph;
+}
+
+std::vector<GraphType>
+copy_component_graphs(const GraphType &inputGraph,
+                      const GraphComponents &components,
+                      const size_t num_threads) {
+    std::vector<GraphType> component_graphs(components.size());
+    for_each_component(
+            components,
+            [&inputGraph, &components, &component_graphs](size_t component) {
+                copy_component_graph_into(inputGraph, components, component,
+                                          component_graphs[component]);
+            },
+            num_threads);
+    return component_graphs;
 }
 
 GraphType copy_largest_connected_component(const GraphType &inputGraph) {
-    auto filtered_graphs = filter_component_graphs(inputGraph);
-    // Get the largest component
-    std::vector<size_t> comp_graph_num_vertices;
-    for (const auto &comp_graph : filtered_graphs) {
-        // Compute the number of vertices of the filtered_graph
-        // Remember that num_vertices of a filtered_graph returns the vertices
-        // of the underlying (parent) graph, so we have to use boost::vertices
-        using vertex_iterator =
-                boost::graph_traits<ComponentGraphType>::vertex_iterator;
-        vertex_iterator vi, vi_end;
-        std::tie(vi, vi_end) = boost::vertices(comp_graph);
-        comp_graph_num_vertices.emplace_back(std::distance(vi, vi_end));
-    }
-    const auto max_element_it = std::max_element(
-            comp_graph_num_vertices.cbegin(), comp_graph_num_vertices.cend());
-
-    const size_t largest_component_graph_index =
-            std::distance(comp_graph_num_vertices.cbegin(), max_element_it);
-    GraphType largest_component_graph;
-    boost::copy_graph(filtered_graphs[largest_component_graph_index],
-                      largest_component_graph);
-    return largest_component_graph;
+    const auto components = connected_components_union_find(inputGraph);
+    if (components.empty()) {
+        return GraphType();
+    }
+    // Get the largest component, the first one in case of ties.
+    size_t largest_component_graph_index = 0;
+    for (size_t c = 1; c < components.size(); ++c) {
+        if (components.num_vertices(c) >
+            components.num_vertices(largest_component_graph_index)) {
+            largest_component_graph_index = c;
+        }
+    }
+    return copy_component_graph(inputGraph, components,
+                                largest_component_graph_index);
 }
 
 void append_graph_in_place(GraphType &g_out, const GraphType &g_to_add) {
@@ -0,0 +1,104 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "frozen_spatial_graph.hpp"
+#include <unordered_map>
+
+namespace SG {
+
+FrozenSpatialGraph::FrozenSpatialGraph(const GraphType &graph) {
+    const auto nverts = boost::num_vertices(graph);
+    const auto nedges = boost::num_edges(graph);
+
+    // Nodes
+    m_ids.reserve(nverts);
+    for (auto &positions_dim : m_positions) {
+        positions_dim.reserve(nverts);
+    }
+    const auto verts = boost::vertices(graph);
+    for (auto vi = verts.first; vi != verts.second; ++vi) {
+        const auto &sn = graph[*vi];
+        m_ids.push_back(sn.id);
+        for (size_t dim = 0; dim < 3; ++dim) {
+            m_positions[dim].push_back(sn.pos[dim]);
+        }
+    }
+
+    // Edges and pooled edge points.
+    // The edge bundle address is unique per edge, use it to find the index
+    // of the edge when building the adjacency.
+    const auto edges = boost::edges(graph);
+    size_t total_edge_points = 0;
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        total_edge_points += graph[*ei].edge_points.size();
+    }
+    std::unordered_map<const SpatialEdge *, size_t> edge_bundle_to_index;
+    edge_bundle_to_index.reserve(nedges);
+    m_sources.reserve(nedges);
+    m_targets.reserve(nedges);
+    m_edge_point_offsets.reserve(nedges + 1);
+    m_edge_points.reserve(total_edge_points);
+    m_edge_point_offsets.push_back(0);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        const auto &se = graph[*ei];
+        edge_bundle_to_index.emplace(&se, m_sources.size());
+        m_sources.push_back(boost::source(*ei, graph));
+        m_targets.push_back(boost::target(*ei, graph));
+        m_edge_points.insert(std::end(m_edge_points),
+                             std::begin(se.edge_points),
+                             std::end(se.edge_points));
+        m_edge_point_offsets.push_back(m_edge_points.size());
+    }
+
+    // CSR adjacency, keeping the out_edges order of the input graph.
+    m_out_offsets.reserve(nverts + 1);
+    m_out_edges.reserve(2 * nedges);
+    m_out_offsets.push_back(0);
+    for (auto vi = verts.first; vi != verts.second; ++vi) {
+        const auto out_edges = boost::out_edges(*vi, graph);
+        for (auto oi = out_edges.first; oi != out_edges.second; ++oi) {
+            m_out_edges.push_back(
+                    OutEdge{boost::target(*oi, graph),
+                            edge_bundle_to_index.at(&graph[*oi])});
+        }
+        m_out_offsets.push_back(m_out_edges.size());
+    }
+}
+
+GraphType FrozenSpatialGraph::to_spatial_graph() const {
+    const auto nverts = num_vertices();
+    GraphType graph(nverts);
+    for (size_t v = 0; v < nverts; ++v) {
+        auto &sn = graph[v];
+        const auto frozen_sn = (*this)[v];
+        sn.id = frozen_sn.id;
+        sn.pos = frozen_sn.pos;
+    }
+    const auto nedges = num_edges();
+    for (size_t edge_index = 0; edge_index < nedges; ++edge_index) {
+        SpatialEdge se;
+        se.edge_points = edge_points(edge_index).to_container();
+        boost::add_edge(m_sources[edge_index], m_targets[edge_index], se,
+                        graph);
+    }
+    return graph;
+}
+
+} // namespace SG
@@ -0,0 +1,253 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "mapped_spatial_graph.hpp"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#define SG_MAPPED_SPATIAL_GRAPH_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SG {
+
+static_assert(sizeof(PointType) == 3 * sizeof(double),
+              "PointType must be layout compatible with double[3].");
+
+BinarySpatialGraphHeader make_binary_sg_header(const uint64_t num_vertices,
+                                               const uint64_t num_edges,
+                                               const uint64_t num_edge_points) {
+    BinarySpatialGraphHeader header{};
+    std::memcpy(header.magic, binary_sg_magic, sizeof(header.magic));
+    header.version = binary_sg_version;
+    header.endianness = binary_sg_endianness;
+    header.num_vertices = num_vertices;
+    header.num_edges = num_edges;
+    header.num_edge_points = num_edge_points;
+    return header;
+}
+
+void check_binary_sg_header(const BinarySpatialGraphHeader &header) {
+    if (std::memcmp(header.magic, binary_sg_magic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error(
+                "check_binary_sg_header: not a binary spatial graph (.sgb).");
+    }
+    if (header.endianness != binary_sg_endianness) {
+        throw std::runtime_error("check_binary_sg_header: the file was written "
+                                 "with a different byte order.");
+    }
+    if (header.version != binary_sg_version) {
+        throw std::runtime_error(
+                "check_binary_sg_header: unsupported version " +
+                std::to_string(header.version) + ". Supported version is " +
+                std::to_string(binary_sg_version) + ".");
+    }
+}
+
+void check_binary_sg_edges(const BinarySpatialGraphHeader &header,
+                           const uint64_t *sources,
+                           const uint64_t *targets,
+                           const uint64_t *offsets) {
+    const uint64_t ne = header.num_edges;
+    if (offsets[0] != 0 || offsets[ne] != header.num_edge_points) {
+        throw std::runtime_error("check_binary_sg_edges: the edge points "
+                                 "offsets don't match the header.");
+    }
+    for (uint64_t e = 0; e < ne; ++e) {
+        if (sources[e] >= header.num_vertices ||
+            targets[e] >= header.num_vertices) {
+            throw std::runtime_error(
+                    "check_binary_sg_edges: edge " + std::to_string(e) +
+                    " has a source or target out of the vertices range.");
+        }
+        if (offsets[e + 1] < offsets[e]) {
+            throw std::runtime_error(
+                    "check_binary_sg_edges: the edge points offsets of edge " +
+                    std::to_string(e) + " decrease.");
+        }
+    }
+}
+
+uint64_t binary_sg_file_size(const BinarySpatialGraphHeader &header) {
+    const uint64_t num_elements =
+            header.num_vertices       // ids
+            + 3 * header.num_vertices // positions
+            + 2 * header.num_edges    // sources and targets
+            + header.num_edges + 1    // offsets
+            + 3 * header.num_edge_points;
+    return sizeof(BinarySpatialGraphHeader) + 8 * num_elements;
+}
+
+MappedSpatialGraph::MappedSpatialGraph(const std::string &input_file) {
+    map_file(input_file);
+    try {
+        if (m_size < sizeof(BinarySpatialGraphHeader)) {
+            throw std::runtime_error("MappedSpatialGraph: input_file: " +
+                                     input_file +
+                                     " is too small to be a .sgb file.");
+        }
+        m_header = reinterpret_cast<const BinarySpatialGraphHeader *>(m_data);
+        check_binary_sg_header(*m_header);
+        // Avoid overflows computing the size of corrupt headers.
+        const uint64_t max_elements = m_size / 8;
+        if (m_header->num_vertices > max_elements ||
+            m_header->num_edges > max_elements ||
+            m_header->num_edge_points > max_elements ||
+            binary_sg_file_size(*m_header) != m_size) {
+            throw std::runtime_error(
+                    "MappedSpatialGraph: input_file: " + input_file +
+                    " size doesn't match the size in its header.");
+        }
+        set_sections();
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+MappedSpatialGraph::~MappedSpatialGraph() { release(); }
+
+MappedSpatialGraph::MappedSpatialGraph(MappedSpatialGraph &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedSpatialGraph &
+MappedSpatialGraph::operator=(MappedSpatialGraph &&other) noexcept {
+    if (this != &other) {
+        release();
+        // Moving the vector keeps its data, so the section pointers are
+        // still valid.
+        m_buffer = std::move(other.m_buffer);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_header = std::exchange(other.m_header, nullptr);
+        m_ids = std::exchange(other.m_ids, nullptr);
+        m_positions = std::exchange(other.m_positions, nullptr);
+        m_sources = std::exchange(other.m_sources, nullptr);
+        m_targets = std::exchange(other.m_targets, nullptr);
+        m_offsets = std::exchange(other.m_offsets, nullptr);
+        m_edge_points = std::exchange(other.m_edge_points, nullptr);
+    }
+    return *this;
+}
+
+void MappedSpatialGraph::map_file(const std::string &input_file) {
+#ifdef SG_MAPPED_SPATIAL_GRAPH_NO_MMAP
+    std::ifstream ifile(input_file, std::ios::binary | std::ios::ate);
+    if (!ifile.is_open()) {
+        throw std::runtime_error("Failed to read input_file: " + input_file +
+                                 ".");
+    }
+    m_size = static_cast<size_t>(ifile.tellg());
+    ifile.seekg(0);
+    // uint64_t storage keeps the sections aligned.
+    m_buffer.resize((m_size + 7) / 8);
+    ifile.read(reinterpret_cast<char *>(m_buffer.data()), m_size);
+    m_data = reinterpret_cast<const char *>(m_buffer.data());
+#else
+    const int fd = ::open(input_file.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to read input_file: " + input_file +
+                                 ".");
+    }
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) == -1) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat input_file: " + input_file +
+                                 ".");
+    }
+    m_size = static_cast<size_t>(file_stat.st_size);
+    if (m_size == 0) {
+        ::close(fd);
+        return;
+    }
+    void *mapped = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        m_size = 0;
+        throw std::runtime_error("Failed to map input_file: " + input_file +
+                                 ".");
+    }
+    m_data = static_cast<const char *>(mapped);
+#endif
+}
+
+void MappedSpatialGraph::set_sections() {
+    const auto nv = num_vertices();
+    const auto ne = num_edges();
+    const auto *elements = reinterpret_cast<const uint64_t *>(
+            m_data + sizeof(BinarySpatialGraphHeader));
+    m_ids = elements;
+    elements += nv;
+    m_positions = reinterpret_cast<const double *>(elements);
+    elements += 3 * nv;
+    m_sources = elements;
+    elements += ne;
+    m_targets = elements;
+    elements += ne;
+    m_offsets = elements;
+    elements += ne + 1;
+    m_edge_points = reinterpret_cast<const PointType *>(elements);
+}
+
+void MappedSpatialGraph::release() {
+#ifndef SG_MAPPED_SPATIAL_GRAPH_NO_MMAP
+    if (m_data != nullptr) {
+        ::munmap(const_cast<char *>(m_data), m_size);
+    }
+#endif
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+}
+
+void MappedSpatialGraph::validate() const {
+    check_binary_sg_edges(*m_header, m_sources, m_targets, m_offsets);
+}
+
+GraphType MappedSpatialGraph::to_spatial_graph() const {
+    validate();
+    const auto nv = num_vertices();
+    const auto ne = num_edges();
+    GraphType graph(nv);
+    for (size_t v = 0; v < nv; ++v) {
+        graph[v].id = id(v);
+        graph[v].pos = pos(v);
+    }
+    for (size_t e = 0; e < ne; ++e) {
+        const auto points = edge_points(e);
+        boost::add_edge(source(e), target(e),
+                        SpatialEdge{PointContainer(points.begin(),
+                                                   points.end())},
+                        graph);
+    }
+    return graph;
+}
+
+} // namespace SG
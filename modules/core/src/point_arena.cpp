@@ -0,0 +1,79 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "point_arena.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace SG {
+
+constexpr size_t PointArena::default_block_size;
+
+namespace {
+thread_local PointArena *current_point_arena = nullptr;
+} // namespace
+
+void *PointArena::allocate(const size_t bytes, const size_t alignment) {
+    if (!m_blocks.empty()) {
+        const auto &block = m_blocks.back();
+        const auto address =
+                reinterpret_cast<uintptr_t>(block.data.get()) + m_offset;
+        const size_t padding = (alignment - address % alignment) % alignment;
+        if (m_offset + padding + bytes <= block.size) {
+            m_offset += padding + bytes;
+            m_bytes_allocated += bytes;
+            return block.data.get() + m_offset - bytes;
+        }
+    }
+    // new[] is aligned for any fundamental type, large requests get their
+    // own block.
+    const size_t block_size = std::max(m_block_size, bytes);
+    m_blocks.push_back(Block{std::unique_ptr<char[]>(new char[block_size]),
+                             block_size});
+    m_offset = bytes;
+    m_bytes_allocated += bytes;
+    return m_blocks.back().data.get();
+}
+
+void PointArena::release() {
+    m_blocks.clear();
+    m_offset = 0;
+    m_bytes_allocated = 0;
+}
+
+size_t PointArena::bytes_reserved() const {
+    return std::accumulate(
+            m_blocks.cbegin(), m_blocks.cend(), size_t(0),
+            [](const size_t sum, const Block &block) {
+                return sum + block.size;
+            });
+}
+
+PointArena::Scope::Scope(PointArena &arena)
+        : m_previous(current_point_arena) {
+    current_point_arena = &arena;
+}
+
+PointArena::Scope::~Scope() { current_point_arena = m_previous; }
+
+PointArena *PointArena::current() { return current_point_arena; }
+
+} // namespace SG
@@ -97,18 +97,25 @@ SpatialEdge create_edge_from_path(
     return sg_edge;
 }
 
-std::vector<GraphType::vertex_descriptor>
-compute_shortest_path(GraphType::vertex_descriptor start_vertex,
-                      GraphType::vertex_descriptor end_vertex,
-                      const GraphType &input_g,
-                      bool verbose) {
-    using vertex_descriptor = GraphType::vertex_descriptor;
-    using edge_descriptor = GraphType::edge_descriptor;
+namespace {
+/* Implementation shared by GraphType and FrozenSpatialGraph */
+template <typename TGraph>
+std::vector<typename boost::graph_traits<TGraph>::vertex_descriptor>
+compute_shortest_path_impl(
+        typename boost::graph_traits<TGraph>::vertex_descriptor start_vertex,
+        typename boost::graph_traits<TGraph>::vertex_descriptor end_vertex,
+        const TGraph &input_g,
+        bool verbose) {
+    using vertex_descriptor =
+            typename boost::graph_traits<TGraph>::vertex_descriptor;
+    using edge_descriptor =
+            typename boost::graph_traits<TGraph>::edge_descriptor;
+    const auto null_vertex = boost::graph_traits<TGraph>::null_vertex();
     size_t visited = 0;
     std::vector<boost::default_color_type> colors(boost::num_vertices(input_g),
                                                   boost::default_color_type{});
     std::vector<vertex_descriptor> _pred(boost::num_vertices(input_g),
-                                         GraphType::null_vertex());
+                                         null_vertex);
     std::vector<size_t> _dist(boost::num_vertices(input_g), -1ULL);
 
     auto *colormap = colors.data();
@@ -162,7 +169,7 @@ compute_shortest_path(GraphType::vertex_descriptor start_vertex,
     if (dist != size_t(-1)) {
         std::deque<vertex_descriptor> path;
         for (vertex_descriptor current = end_vertex;
-             current != GraphType::null_vertex() && predmap[current] != current &&
+             current != null_vertex && predmap[current] != current &&
              current != start_vertex;) {
             path.push_front(predmap[current]);
             current = predmap[current];
@@ -182,4 +189,23 @@ compute_shortest_path(GraphType::vertex_descriptor start_vertex,
     }
     return path_out;
 }
+} // namespace
+
+std::vector<GraphType::vertex_descriptor>
+compute_shortest_path(GraphType::vertex_descriptor start_vertex,
+                      GraphType::vertex_descriptor end_vertex,
+                      const GraphType &input_g,
+                      bool verbose) {
+    return compute_shortest_path_impl(start_vertex, end_vertex, input_g,
+                                      verbose);
+}
+
+std::vector<FrozenSpatialGraph::vertex_descriptor>
+compute_shortest_path(FrozenSpatialGraph::vertex_descriptor start_vertex,
+                      FrozenSpatialGraph::vertex_descriptor end_vertex,
+                      const FrozenSpatialGraph &input_g,
+                      bool verbose) {
+    return compute_shortest_path_impl(start_vertex, end_vertex, input_g,
+                                      verbose);
+}
 } // end namespace SG
@@ -0,0 +1,528 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "spatial_graph_graphviz.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// std::to_chars/from_chars for floating point require C++17 and a recent
+// standard library, use the C functions otherwise.
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define SG_GRAPHVIZ_USE_CHARCONV
+#endif
+
+namespace SG {
+
+namespace {
+
+/* ************* Emitter *************/
+
+/** Accumulate the output and write it to the stream in big chunks. */
+class GraphvizWriteBuffer {
+  public:
+    explicit GraphvizWriteBuffer(std::ostream &os) : m_os(os) {
+        m_buffer.reserve(buffer_capacity + max_double_chars);
+    }
+    ~GraphvizWriteBuffer() { flush(); }
+
+    void append(const char *str, const size_t size) {
+        m_buffer.append(str, size);
+        flush_if_full();
+    }
+    void append(const char *str) { append(str, std::strlen(str)); }
+    void append(const char c) {
+        m_buffer.push_back(c);
+        flush_if_full();
+    }
+    void append(const size_t value) {
+        char buf[24];
+#ifdef SG_GRAPHVIZ_USE_CHARCONV
+        const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+        append(buf, static_cast<size_t>(result.ptr - buf));
+#else
+        const int size = std::snprintf(buf, sizeof(buf), "%zu", value);
+        append(buf, static_cast<size_t>(size));
+#endif
+    }
+    /** Same format than a stream with precision(100): "%.100g". */
+    void append(const double value) {
+        char buf[max_double_chars];
+#ifdef SG_GRAPHVIZ_USE_CHARCONV
+        const auto result = std::to_chars(buf, buf + sizeof(buf), value,
+                                          std::chars_format::general, 100);
+        append(buf, static_cast<size_t>(result.ptr - buf));
+#else
+        const int size = std::snprintf(buf, sizeof(buf), "%.100g", value);
+        append(buf, static_cast<size_t>(size));
+#endif
+    }
+    void append_point(const PointType &point) {
+        append(point[0]);
+        append(' ');
+        append(point[1]);
+        append(' ');
+        append(point[2]);
+    }
+    void flush() {
+        m_os.write(m_buffer.data(),
+                   static_cast<std::streamsize>(m_buffer.size()));
+        m_buffer.clear();
+    }
+
+  private:
+    void flush_if_full() {
+        if (m_buffer.size() >= buffer_capacity) {
+            flush();
+        }
+    }
+    static constexpr size_t buffer_capacity = 1 << 16;
+    // sign, 100 digits, dot and exponent fit.
+    static constexpr size_t max_double_chars = 128;
+    std::ostream &m_os;
+    std::string m_buffer;
+};
+
+/* ************* Parser *************/
+
+class GraphvizParser {
+  public:
+    GraphvizParser(const char *first, const char *last)
+            : m_begin(first), m_it(first), m_end(last) {}
+
+    void parse(GraphType &graph) {
+        parse_header();
+        while (true) {
+            skip_ws();
+            if (m_it == m_end) {
+                error("unexpected end of file, missing '}'");
+            }
+            if (*m_it == '}') {
+                ++m_it;
+                break;
+            }
+            parse_statement();
+        }
+        add_to_graph(graph);
+    }
+
+  private:
+    struct Range {
+        const char *first;
+        const char *last;
+        bool equals(const char *literal) const {
+            const auto size = std::strlen(literal);
+            return static_cast<size_t>(last - first) == size &&
+                   std::memcmp(first, literal, size) == 0;
+        }
+        std::string str() const { return std::string(first, last); }
+    };
+    struct ParsedNode {
+        PointType pos{{0, 0, 0}};
+        bool has_spatial_node = false;
+    };
+    struct ParsedEdge {
+        size_t source;
+        size_t target;
+        PointContainer edge_points;
+    };
+
+    [[noreturn]] void error(const std::string &message) const {
+        const auto line = 1 + std::count(m_begin, m_it, '\n');
+        throw std::runtime_error("read_graphviz_sg: " + message +
+                                 " (line " + std::to_string(line) + ").");
+    }
+
+    void skip_ws() {
+        while (m_it != m_end) {
+            const char c = *m_it;
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                ++m_it;
+            } else if (c == '#' && (m_it == m_begin || *(m_it - 1) == '\n')) {
+                // preprocessor-like lines are comments in graphviz
+                skip_line();
+            } else if (c == '/' && m_it + 1 != m_end && *(m_it + 1) == '/') {
+                skip_line();
+            } else if (c == '/' && m_it + 1 != m_end && *(m_it + 1) == '*') {
+                const char *close = m_it + 2;
+                while (close + 1 < m_end && !(close[0] == '*' && close[1] == '/')) {
+                    ++close;
+                }
+                if (close + 1 >= m_end) {
+                    error("unterminated comment");
+                }
+                m_it = close + 2;
+            } else {
+                break;
+            }
+        }
+    }
+    void skip_line() {
+        while (m_it != m_end && *m_it != '\n') {
+            ++m_it;
+        }
+    }
+    bool consume(const char c) {
+        skip_ws();
+        if (m_it != m_end && *m_it == c) {
+            ++m_it;
+            return true;
+        }
+        return false;
+    }
+    void expect(const char c) {
+        if (!consume(c)) {
+            error(std::string("expected '") + c + "'");
+        }
+    }
+    bool at_edge_operator() {
+        skip_ws();
+        if (m_it + 1 < m_end && m_it[0] == '-') {
+            if (m_it[1] == '-') {
+                return true;
+            }
+            if (m_it[1] == '>') {
+                error("directed edges are not supported");
+            }
+        }
+        return false;
+    }
+
+    static bool is_id_char(const char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+               (c >= '0' && c <= '9') || c == '_' || c == '.' ||
+               static_cast<unsigned char>(c) >= 128;
+    }
+
+    /** Identifier, number or quoted string. Quotes are not included. */
+    Range parse_id() {
+        skip_ws();
+        if (m_it == m_end) {
+            error("unexpected end of file, expected an identifier");
+        }
+        if (*m_it == '"') {
+            const char *first = ++m_it;
+            while (m_it != m_end && *m_it != '"') {
+                // escaped quotes and line continuations
+                if (*m_it == '\\' && m_it + 1 != m_end) {
+                    ++m_it;
+                }
+                ++m_it;
+            }
+            if (m_it == m_end) {
+                error("unterminated string");
+            }
+            return Range{first, m_it++};
+        }
+        if (*m_it == '<') {
+            error("html strings are not supported");
+        }
+        const char *first = m_it;
+        // numerals can start with a minus sign
+        if (*m_it == '-') {
+            ++m_it;
+        }
+        while (m_it != m_end && is_id_char(*m_it)) {
+            ++m_it;
+        }
+        if (first == m_it) {
+            error(std::string("unexpected character '") + *m_it + "'");
+        }
+        return Range{first, m_it};
+    }
+
+    void parse_header() {
+        auto keyword = parse_id();
+        if (keyword.equals("strict")) {
+            keyword = parse_id();
+        }
+        if (keyword.equals("digraph")) {
+            error("directed graphs are not supported");
+        }
+        if (!keyword.equals("graph")) {
+            error("expected 'graph'");
+        }
+        skip_ws();
+        if (m_it != m_end && *m_it != '{') {
+            parse_id(); // graph name
+        }
+        expect('{');
+    }
+
+    void parse_statement() {
+        const auto id = parse_id();
+        skip_ws();
+        if (m_it != m_end && *m_it == '=') {
+            // graph attribute: ID = ID
+            ++m_it;
+            parse_id();
+        } else if (id.equals("graph") || id.equals("node") ||
+                   id.equals("edge")) {
+            // default attributes are not part of the dialect
+            parse_attributes([](const Range &, const Range &) {});
+        } else if (id.equals("subgraph")) {
+            error("subgraphs are not supported");
+        } else if (at_edge_operator()) {
+            parse_edges(id);
+        } else {
+            auto &node = m_nodes[node_index(id)];
+            parse_attributes([&](const Range &key, const Range &value) {
+                if (key.equals("spatial_node")) {
+                    node.pos = parse_point(value);
+                    node.has_spatial_node = true;
+                }
+            });
+        }
+        if (!consume(';')) {
+            consume(',');
+        }
+    }
+
+    void parse_edges(const Range &source_id) {
+        // Chains a -- b -- c share the attributes.
+        const size_t first_edge = m_edges.size();
+        auto source = node_index(source_id);
+        while (at_edge_operator()) {
+            m_it += 2;
+            skip_ws();
+            if (m_it != m_end && *m_it == '{') {
+                error("subgraphs are not supported");
+            }
+            const auto target = node_index(parse_id());
+            m_edges.push_back(ParsedEdge{source, target, PointContainer()});
+            source = target;
+        }
+        parse_attributes([&](const Range &key, const Range &value) {
+            if (key.equals("spatial_edge")) {
+                for (size_t e = first_edge; e < m_edges.size(); ++e) {
+                    m_edges[e].edge_points.clear();
+                    parse_edge_points(value, m_edges[e].edge_points);
+                }
+            }
+        });
+    }
+
+    template <typename TCallback> void parse_attributes(TCallback callback) {
+        while (consume('[')) {
+            while (!consume(']')) {
+                const auto key = parse_id();
+                expect('=');
+                const auto value = parse_id();
+                callback(key, value);
+                if (!consume(',')) {
+                    consume(';');
+                }
+            }
+        }
+    }
+
+    size_t node_index(const Range &id) {
+        const auto inserted = m_name_to_node.emplace(id.str(), m_nodes.size());
+        if (inserted.second) {
+            m_nodes.push_back(ParsedNode());
+        }
+        return inserted.first->second;
+    }
+
+    static const char *skip_number_ws(const char *it, const char *last) {
+        while (it != last && (*it == ' ' || *it == '\t' || *it == '\n' ||
+                              *it == '\r')) {
+            ++it;
+        }
+        return it;
+    }
+    /**
+     * Parse a double at it, returns the end of the number, or it if there is
+     * no number.
+     */
+    static const char *parse_double(const char *it, const char *last,
+                                    double &value) {
+        if (it != last && *it == '+') {
+            ++it;
+        }
+#ifdef SG_GRAPHVIZ_USE_CHARCONV
+        const auto result = std::from_chars(it, last, value);
+        return result.ec == std::errc() ? result.ptr : it;
+#else
+        // strtod requires a null terminated string, copy the token.
+        char buf[512];
+        const char *token_end = it;
+        while (token_end != last && token_end - it < 511 &&
+               std::strchr("0123456789+-.eEinfatyINFATY", *token_end) !=
+                       nullptr) {
+            ++token_end;
+        }
+        const auto size = static_cast<size_t>(token_end - it);
+        std::memcpy(buf, it, size);
+        buf[size] = '\0';
+        char *parsed_end = nullptr;
+        value = std::strtod(buf, &parsed_end);
+        return it + (parsed_end - buf);
+#endif
+    }
+    /**
+     * Read up to three coordinates, missing coordinates are zero, as in the
+     * stream operators of SpatialNode and SpatialEdge.
+     */
+    static const char *parse_coordinates(const char *it, const char *last,
+                                         PointType &point) {
+        point = PointType{{0, 0, 0}};
+        for (size_t i = 0; i < 3; ++i) {
+            it = skip_number_ws(it, last);
+            const char *next = parse_double(it, last, point[i]);
+            if (next == it) {
+                point[i] = 0;
+                break;
+            }
+            it = next;
+        }
+        return it;
+    }
+    static PointType parse_point(const Range &value) {
+        PointType point;
+        parse_coordinates(value.first, value.last, point);
+        return point;
+    }
+    /** Parse "[{x y z},{x y z}]" */
+    static void parse_edge_points(const Range &value,
+                                  PointContainer &edge_points) {
+        const char *it = value.first;
+        const char *last = value.last;
+        while (true) {
+            it = std::find(it, last, '{');
+            if (it == last) {
+                break;
+            }
+            PointType point;
+            it = parse_coordinates(it + 1, last, point);
+            edge_points.push_back(point);
+            it = std::find(it, last, '}');
+        }
+    }
+
+    void add_to_graph(GraphType &graph) {
+        // boost::read_graphviz stores the nodes in a std::map keyed by name,
+        // vertices are created in that order.
+        std::vector<const std::string *> names(m_nodes.size());
+        for (const auto &name_node : m_name_to_node) {
+            names[name_node.second] = &name_node.first;
+        }
+        std::vector<size_t> sorted_nodes(m_nodes.size());
+        std::iota(sorted_nodes.begin(), sorted_nodes.end(), 0);
+        std::sort(sorted_nodes.begin(), sorted_nodes.end(),
+                  [&names](const size_t lhs, const size_t rhs) {
+                      return *names[lhs] < *names[rhs];
+                  });
+        std::vector<GraphType::vertex_descriptor> node_to_vertex(
+                m_nodes.size());
+        for (const auto &node : sorted_nodes) {
+            const auto &name = *names[node];
+            const auto v = boost::add_vertex(graph);
+            // boost sets the id from the name, but then the spatial_node
+            // property replaces the whole SpatialNode (value initialized by
+            // lexical_cast), resetting the id to zero.
+            const auto id = parse_node_id(name);
+            graph[v].id = m_nodes[node].has_spatial_node ? 0 : id;
+            graph[v].pos = m_nodes[node].pos;
+            node_to_vertex[node] = v;
+        }
+        for (auto &edge : m_edges) {
+            boost::add_edge(node_to_vertex[edge.source],
+                            node_to_vertex[edge.target],
+                            SpatialEdge{std::move(edge.edge_points)}, graph);
+        }
+    }
+    static size_t parse_node_id(const std::string &name) {
+        size_t id = 0;
+        const char *first = name.data();
+        const char *last = first + name.size();
+#ifdef SG_GRAPHVIZ_USE_CHARCONV
+        const auto result = std::from_chars(first, last, id);
+        const bool valid = result.ec == std::errc() && result.ptr == last;
+#else
+        char *parsed_end = nullptr;
+        id = std::strtoull(first, &parsed_end, 10);
+        const bool valid = !name.empty() && name[0] != '-' &&
+                           parsed_end == last;
+#endif
+        if (!valid) {
+            throw std::runtime_error("read_graphviz_sg: node name '" + name +
+                                     "' is not a valid node_id.");
+        }
+        return id;
+    }
+
+    const char *m_begin;
+    const char *m_it;
+    const char *m_end;
+    std::unordered_map<std::string, size_t> m_name_to_node;
+    std::vector<ParsedNode> m_nodes;
+    std::vector<ParsedEdge> m_edges;
+};
+
+} // namespace
+
+void emit_graphviz_sg(std::ostream &os, const GraphType &graph) {
+    GraphvizWriteBuffer out(os);
+    out.append("graph G {\n");
+    const auto verts = boost::vertices(graph);
+    for (auto vi = verts.first; vi != verts.second; ++vi) {
+        out.append(static_cast<size_t>(*vi));
+        out.append(" [spatial_node=\"");
+        out.append_point(graph[*vi].pos);
+        out.append("\"];\n");
+    }
+    const auto edges = boost::edges(graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        out.append(static_cast<size_t>(boost::source(*ei, graph)));
+        out.append("--");
+        out.append(static_cast<size_t>(boost::target(*ei, graph)));
+        out.append("  [spatial_edge=\"[");
+        const auto &edge_points = graph[*ei].edge_points;
+        for (size_t i = 0; i < edge_points.size(); ++i) {
+            if (i != 0) {
+                out.append(',');
+            }
+            out.append('{');
+            out.append_point(edge_points[i]);
+            out.append('}');
+        }
+        out.append("]\"];\n");
+    }
+    out.append("}\n");
+}
+
+void parse_graphviz_sg(const char *first, const char *last, GraphType &graph) {
+    GraphvizParser(first, last).parse(graph);
+}
+
+} // namespace SG
@@ -24,6 +24,10 @@
 #include <boost/graph/graphviz.hpp>
 
 #include "spatial_graph_io.hpp"
+#include "mapped_spatial_graph.hpp"
+#include "spatial_graph_graphviz.hpp"
+#include <algorithm>
+#include <limits>
 
 namespace SG {
 
@@ -43,26 +47,30 @@ boost::dynamic_properties get_read_dynamic_properties_sg(GraphType &graph) {
 }
 
 void write_graphviz_sg(std::ostream &os, GraphType &graph) {
-    auto dp = get_write_dynamic_properties_sg(graph);
-    boost::write_graphviz_dp(os, graph, dp);
+    emit_graphviz_sg(os, graph);
 }
 void write_graphviz_sg(const std::string &output_file, GraphType &graph) {
-    auto dp = get_write_dynamic_properties_sg(graph);
     std::ofstream ofile(output_file);
-    boost::write_graphviz_dp(ofile, graph, dp);
+    if(!ofile.is_open()) {
+        throw std::runtime_error("Failed to open output_file: " + output_file + ".");
+    }
+    emit_graphviz_sg(ofile, graph);
 }
 
 void read_graphviz_sg(std::istream &is, GraphType &graph) {
-    auto dp = get_read_dynamic_properties_sg(graph);
-    boost::read_graphviz(is, graph, dp);
+    const std::string content(std::istreambuf_iterator<char>(is), {});
+    parse_graphviz_sg(content.data(), content.data() + content.size(), graph);
 }
 void read_graphviz_sg(const std::string &input_file, GraphType &graph) {
-    auto dp = get_read_dynamic_properties_sg(graph);
-    std::ifstream ifile(input_file);
+    std::ifstream ifile(input_file, std::fstream::binary | std::fstream::in);
     if(!ifile.is_open()) {
         throw std::runtime_error("Failed to read input_file: " + input_file + ".");
     }
-    boost::read_graphviz(ifile, graph, dp);
+    ifile.seekg(0, std::ios::end);
+    std::string content(static_cast<size_t>(ifile.tellg()), '\0');
+    ifile.seekg(0, std::ios::beg);
+    ifile.read(&content[0], static_cast<std::streamsize>(content.size()));
+    parse_graphviz_sg(content.data(), content.data() + content.size(), graph);
 }
 
 GraphType read_graphviz_sg(const std::string &input_file) {
@@ -99,11 +107,146 @@ GraphType read_serialized_sg(const std::string &input_file) {
     return graph;
 }
 
-vertex_to_label_map_t
-read_vertex_to_label_map(const std::string &vertex_to_label_map_file) {
-    std::vector<size_t> vertex_ids;
-    std::vector<size_t> labels;
-    vertex_to_label_map_t output;
+namespace {
+template <typename T>
+void write_binary_array(std::ostream &os, const T *data, const size_t size) {
+    os.write(reinterpret_cast<const char *>(data),
+             static_cast<std::streamsize>(size * sizeof(T)));
+}
+template <typename T>
+void read_binary_array(std::istream &is, T *data, const size_t size) {
+    is.read(reinterpret_cast<char *>(data),
+            static_cast<std::streamsize>(size * sizeof(T)));
+    if (!is) {
+        throw std::runtime_error(
+                "read_binary_sg: unexpected end of the binary graph.");
+    }
+}
+/**
+ * Read size elements into data. data grows in chunks of 1 MiB while they
+ * are read, so a corrupt size fails at the end of the stream instead of
+ * allocating it all at once.
+ */
+template <typename T>
+void read_binary_vector(std::istream &is,
+                        std::vector<T> &data,
+                        const uint64_t size) {
+    constexpr uint64_t chunk_size = (uint64_t(1) << 20) / sizeof(T);
+    data.clear();
+    for (uint64_t read = 0; read < size;) {
+        const uint64_t count = std::min(chunk_size, size - read);
+        data.resize(read + count);
+        read_binary_array(is, data.data() + read, count);
+        read += count;
+    }
+}
+} // namespace
+
+void write_binary_sg(std::ostream &os, const GraphType &graph) {
+    const uint64_t nv = boost::num_vertices(graph);
+    const uint64_t ne = boost::num_edges(graph);
+    std::vector<uint64_t> ids;
+    ids.reserve(nv);
+    std::vector<double> positions;
+    positions.reserve(3 * nv);
+    const auto verts = boost::vertices(graph);
+    for (auto vi = verts.first; vi != verts.second; ++vi) {
+        ids.push_back(graph[*vi].id);
+        positions.insert(positions.end(), graph[*vi].pos.begin(),
+                         graph[*vi].pos.end());
+    }
+    std::vector<uint64_t> sources;
+    sources.reserve(ne);
+    std::vector<uint64_t> targets;
+    targets.reserve(ne);
+    std::vector<uint64_t> offsets;
+    offsets.reserve(ne + 1);
+    offsets.push_back(0);
+    const auto edges = boost::edges(graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        sources.push_back(boost::source(*ei, graph));
+        targets.push_back(boost::target(*ei, graph));
+        offsets.push_back(offsets.back() + graph[*ei].edge_points.size());
+    }
+    const auto header = make_binary_sg_header(nv, ne, offsets.back());
+    write_binary_array(os, &header, 1);
+    write_binary_array(os, ids.data(), ids.size());
+    write_binary_array(os, positions.data(), positions.size());
+    write_binary_array(os, sources.data(), sources.size());
+    write_binary_array(os, targets.data(), targets.size());
+    write_binary_array(os, offsets.data(), offsets.size());
+    // The edge points are already contiguous per edge.
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        const auto &edge_points = graph[*ei].edge_points;
+        write_binary_array(os, edge_points.data(), edge_points.size());
+    }
+}
+void write_binary_sg(const std::string &output_file, const GraphType &graph) {
+    std::ofstream os(output_file, std::fstream::binary | std::fstream::out);
+    if(!os.is_open()) {
+        throw std::runtime_error("Failed to open output_file: " + output_file + ".");
+    }
+    write_binary_sg(os, graph);
+}
+
+void read_binary_sg(std::istream &is, GraphType &graph) {
+    BinarySpatialGraphHeader header;
+    read_binary_array(is, &header, 1);
+    check_binary_sg_header(header);
+    // The sizes are not trusted: avoid overflows computing the size of the
+    // sections, and read them in chunks.
+    const uint64_t max_elements =
+            std::numeric_limits<uint64_t>::max() / sizeof(PointType);
+    if (header.num_vertices > max_elements ||
+        header.num_edges >= max_elements ||
+        header.num_edge_points > max_elements) {
+        throw std::runtime_error(
+                "read_binary_sg: the sizes in the header are not valid.");
+    }
+    const size_t nv = header.num_vertices;
+    const size_t ne = header.num_edges;
+    std::vector<uint64_t> ids;
+    read_binary_vector(is, ids, nv);
+    std::vector<double> positions;
+    read_binary_vector(is, positions, 3 * nv);
+    std::vector<uint64_t> sources;
+    read_binary_vector(is, sources, ne);
+    std::vector<uint64_t> targets;
+    read_binary_vector(is, targets, ne);
+    std::vector<uint64_t> offsets;
+    read_binary_vector(is, offsets, ne + 1);
+    check_binary_sg_edges(header, sources.data(), targets.data(),
+                          offsets.data());
+
+    graph = GraphType(nv);
+    for (size_t v = 0; v < nv; ++v) {
+        graph[v].id = ids[v];
+        graph[v].pos = {{positions[3 * v], positions[3 * v + 1],
+                         positions[3 * v + 2]}};
+    }
+    for (size_t e = 0; e < ne; ++e) {
+        SpatialEdge sg_edge;
+        read_binary_vector(is, sg_edge.edge_points,
+                           offsets[e + 1] - offsets[e]);
+        boost::add_edge(sources[e], targets[e], std::move(sg_edge), graph);
+    }
+}
+void read_binary_sg(const std::string &input_file, GraphType &graph) {
+    graph = MappedSpatialGraph(input_file).to_spatial_graph();
+}
+
+GraphType read_binary_sg(const std::string &input_file) {
+    return MappedSpatialGraph(input_file).to_spatial_graph();
+}
+
+namespace {
+/**
+ * Parse the vertex_id, label file of @ref read_vertex_to_label_map.
+ * Output vectors are filled with the values of each column.
+ */
+void read_vertex_label_columns(const std::string &vertex_to_label_map_file,
+                               std::vector<size_t> &vertex_ids,
+                               std::vector<size_t> &labels) {
     // Create an input filestream
     std::ifstream my_file(vertex_to_label_map_file);
     // Make sure the file is open
@@ -153,47 +296,16 @@ Not the same number of vertex_ids and labels. The file is not populated correctl
                 std::to_string(vertex_ids.size()) +
                 " | #labels: " + std::to_string(labels.size()));
     }
-    for (size_t i = 0; i < vertex_ids.size(); ++i) {
-        output.emplace(vertex_ids[i], labels[i]);
-    }
-    return output;
-}
-
-void write_vertex_to_label_map(const vertex_to_label_map_t &vertex_to_label_map,
-                               const std::string &output_filename) {
-
-    // Create an output filestream object
-    std::ofstream my_file(output_filename);
-    // Populate the header
-    my_file << "# vertex_id , label\n";
-    // Write the map
-    for (const auto &vertex_label_pair : vertex_to_label_map) {
-        my_file << vertex_label_pair.first << ", " << vertex_label_pair.second
-                << "\n";
-    }
-}
-
-void write_edge_to_label_map(const edge_to_label_map_t &edge_to_label_map,
-                             const std::string &output_filename) {
-
-    // Create an output filestream object
-    std::ofstream my_file(output_filename);
-    // Populate the header
-    my_file << "# edge_source-target, label\n";
-    // Write the map
-    for (const auto &edge_label_pair : edge_to_label_map) {
-        auto edge_desc = edge_label_pair.first;
-        my_file << edge_desc.m_source << "-" << edge_desc.m_target << ", "
-                << edge_label_pair.second << "\n";
-    }
 }
 
-edge_to_label_map_t
-read_edge_to_label_map(const std::string &edge_to_label_map_file) {
-    std::vector<size_t> edge_sources;
-    std::vector<size_t> edge_targets;
-    std::vector<size_t> labels;
-    edge_to_label_map_t output;
+/**
+ * Parse the edge_source-target, label file of @ref read_edge_to_label_map.
+ * Output vectors are filled with the values of each column.
+ */
+void read_edge_label_columns(const std::string &edge_to_label_map_file,
+                             std::vector<size_t> &edge_sources,
+                             std::vector<size_t> &edge_targets,
+                             std::vector<size_t> &labels) {
     // Create an input filestream
     std::ifstream my_file(edge_to_label_map_file);
     // Make sure the file is open
@@ -254,6 +366,58 @@ The file is not populated correctly. #edge_sources: )" +
                 " - #edge_targets: " + std::to_string(edge_targets.size()) +
                 " , #labels: " + std::to_string(labels.size()));
     }
+}
+} // namespace
+
+vertex_to_label_map_t
+read_vertex_to_label_map(const std::string &vertex_to_label_map_file) {
+    std::vector<size_t> vertex_ids;
+    std::vector<size_t> labels;
+    read_vertex_label_columns(vertex_to_label_map_file, vertex_ids, labels);
+    vertex_to_label_map_t output;
+    for (size_t i = 0; i < vertex_ids.size(); ++i) {
+        output.emplace(vertex_ids[i], labels[i]);
+    }
+    return output;
+}
+
+void write_vertex_to_label_map(const vertex_to_label_map_t &vertex_to_label_map,
+                               const std::string &output_filename) {
+
+    // Create an output filestream object
+    std::ofstream my_file(output_filename);
+    // Populate the header
+    my_file << "# vertex_id , label\n";
+    // Write the map
+    for (const auto &vertex_label_pair : vertex_to_label_map) {
+        my_file << vertex_label_pair.first << ", " << vertex_label_pair.second
+                << "\n";
+    }
+}
+
+void write_edge_to_label_map(const edge_to_label_map_t &edge_to_label_map,
+                             const std::string &output_filename) {
+
+    // Create an output filestream object
+    std::ofstream my_file(output_filename);
+    // Populate the header
+    my_file << "# edge_source-target, label\n";
+    // Write the map
+    for (const auto &edge_label_pair : edge_to_label_map) {
+        auto edge_desc = edge_label_pair.first;
+        my_file << edge_desc.m_source << "-" << edge_desc.m_target << ", "
+                << edge_label_pair.second << "\n";
+    }
+}
+
+edge_to_label_map_t
+read_edge_to_label_map(const std::string &edge_to_label_map_file) {
+    std::vector<size_t> edge_sources;
+    std::vector<size_t> edge_targets;
+    std::vector<size_t> labels;
+    read_edge_label_columns(edge_to_label_map_file, edge_sources, edge_targets,
+                            labels);
+    edge_to_label_map_t output;
     for (size_t i = 0; i < edge_sources.size(); ++i) {
         auto edge_desc = GraphType::edge_descriptor();
         edge_desc.m_source = edge_sources[i];
@@ -263,4 +427,89 @@ The file is not populated correctly. #edge_sources: )" +
     return output;
 }
 
+VertexAttribute<size_t>
+read_vertex_labels(const std::string &vertex_to_label_map_file) {
+    std::vector<size_t> vertex_ids;
+    std::vector<size_t> labels;
+    read_vertex_label_columns(vertex_to_label_map_file, vertex_ids, labels);
+    const auto max_vertex_id =
+            std::max_element(vertex_ids.cbegin(), vertex_ids.cend());
+    VertexAttribute<size_t> output(
+            max_vertex_id == vertex_ids.cend() ? 0 : *max_vertex_id + 1);
+    for (size_t i = 0; i < vertex_ids.size(); ++i) {
+        output.emplace(vertex_ids[i], labels[i]);
+    }
+    return output;
+}
+
+void write_vertex_labels(const VertexAttribute<size_t> &vertex_labels,
+                         const std::string &output_filename) {
+    std::ofstream my_file(output_filename);
+    my_file << "# vertex_id , label\n";
+    for (const auto &vertex_label_pair : vertex_labels) {
+        my_file << vertex_label_pair.first << ", " << vertex_label_pair.second
+                << "\n";
+    }
+}
+
+EdgeAttribute<size_t>
+read_edge_labels(const std::string &edge_to_label_map_file,
+                 const EdgeIndex<GraphType> &edge_index) {
+    std::vector<size_t> edge_sources;
+    std::vector<size_t> edge_targets;
+    std::vector<size_t> labels;
+    read_edge_label_columns(edge_to_label_map_file, edge_sources, edge_targets,
+                            labels);
+    const auto &graph = edge_index.graph();
+    const auto num_vertices = boost::num_vertices(graph);
+    EdgeAttribute<size_t> output(edge_index.size());
+    for (size_t i = 0; i < edge_sources.size(); ++i) {
+        const auto source = edge_sources[i];
+        const auto target = edge_targets[i];
+        // Parallel edges are written once each, assign the labels to them
+        // in order.
+        size_t edge_id = EdgeIndex<GraphType>::invalid_id;
+        if (source < num_vertices && target < num_vertices) {
+            const auto out_edges = boost::out_edges(source, graph);
+            for (auto ei = out_edges.first; ei != out_edges.second; ++ei) {
+                if (boost::target(*ei, graph) == target) {
+                    const auto id = edge_index.id(*ei);
+                    if (!output.has(id)) {
+                        edge_id = id;
+                        break;
+                    }
+                }
+            }
+        }
+        if (edge_id == EdgeIndex<GraphType>::invalid_id) {
+            throw std::runtime_error(
+                    "read_edge_labels: edge " + std::to_string(source) + "-" +
+                    std::to_string(target) + " in " + edge_to_label_map_file +
+                    " is not in the graph.");
+        }
+        output.set(edge_id, labels[i]);
+    }
+    return output;
+}
+
+void write_edge_labels(const EdgeAttribute<size_t> &edge_labels,
+                       const EdgeIndex<GraphType> &edge_index,
+                       const std::string &output_filename) {
+    const auto &graph = edge_index.graph();
+    std::ofstream my_file(output_filename);
+    my_file << "# edge_source-target, label\n";
+    for (const auto &edge_label_pair : edge_labels) {
+        if (edge_label_pair.first >= edge_index.size()) {
+            throw std::runtime_error(
+                    "write_edge_labels: edge id " +
+                    std::to_string(edge_label_pair.first) +
+                    " is not in the graph.");
+        }
+        const auto &edge = edge_index.edge(edge_label_pair.first);
+        my_file << boost::source(edge, graph) << "-"
+                << boost::target(edge, graph) << ", "
+                << edge_label_pair.second << "\n";
+    }
+}
+
 } // namespace SG
@@ -0,0 +1,221 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "transform_to_physical_point.hpp"
+#include "array_utilities_batch.hpp"
+#include "parallel_for.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace SG {
+
+namespace {
+/** Points transformed at once by each thread. */
+constexpr size_t transform_batch_size = 1024;
+
+/**
+ * Apply the affine transform to the points in [begin, end) in batches:
+ * gather into a structure of arrays, transform with SIMD, and scatter back.
+ */
+void affine_transform_points(const std::vector<SG::PointType *> &points,
+                             const size_t begin,
+                             const size_t end,
+                             const SG::DirectionMatrixType &matrix,
+                             const SG::PointType &translation_before,
+                             const SG::PointType &translation_after,
+                             const bool round_to_index) {
+    ArrayUtilities::Array3DBatch batch;
+    batch.reserve(transform_batch_size);
+    for (size_t first = begin; first < end; first += transform_batch_size) {
+        const size_t last = std::min(end, first + transform_batch_size);
+        batch.clear();
+        for (size_t i = first; i < last; ++i) {
+            batch.push_back(*points[i]);
+        }
+        ArrayUtilities::affine_transform_in_place(
+                batch, matrix, translation_before, translation_after);
+        for (size_t i = first; i < last; ++i) {
+            auto &point = *points[i];
+            point = batch[i - first];
+            if (round_to_index) {
+                // ITK RoundHalfIntegerUp
+                for (auto &value : point) {
+                    value = std::floor(value + 0.5);
+                }
+            }
+        }
+    }
+}
+
+void check_is_invertible(const ImageSpaceTransform &transform) {
+    if (!transform.is_invertible) {
+        throw std::runtime_error(
+                "ImageSpaceTransform: direction * spacing is singular, "
+                "physical points cannot be transformed to index space.");
+    }
+}
+
+std::vector<SG::PointType *> graph_points(SG::GraphAL &sg) {
+    std::vector<SG::PointType *> points;
+    points.reserve(boost::num_vertices(sg));
+    const auto verts = boost::vertices(sg);
+    for (auto vi = verts.first; vi != verts.second; ++vi) {
+        points.push_back(&sg[*vi].pos);
+    }
+    const auto edges = boost::edges(sg);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        for (auto &ep : sg[*ei].edge_points) {
+            points.push_back(&ep);
+        }
+    }
+    return points;
+}
+} // namespace
+
+ImageSpaceTransform::ImageSpaceTransform(
+        const SG::PointType &input_origin,
+        const SG::PointType &spacing,
+        const SG::DirectionMatrixType &direction)
+        : origin(input_origin) {
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            index_to_physical[3 * i + j] = direction[3 * i + j] * spacing[j];
+        }
+    }
+    // Inverse using the adjugate matrix
+    const auto &m = index_to_physical;
+    const double cofactor0 = m[4] * m[8] - m[5] * m[7];
+    const double cofactor1 = m[5] * m[6] - m[3] * m[8];
+    const double cofactor2 = m[3] * m[7] - m[4] * m[6];
+    const double determinant =
+            m[0] * cofactor0 + m[1] * cofactor1 + m[2] * cofactor2;
+    is_invertible = std::abs(determinant) > 0.0 && std::isfinite(determinant);
+    if (!is_invertible) {
+        physical_to_index.fill(0.0);
+        return;
+    }
+    const double inv = 1.0 / determinant;
+    auto &r = physical_to_index;
+    r[0] = cofactor0 * inv;
+    r[1] = (m[2] * m[7] - m[1] * m[8]) * inv;
+    r[2] = (m[1] * m[5] - m[2] * m[4]) * inv;
+    r[3] = cofactor1 * inv;
+    r[4] = (m[0] * m[8] - m[2] * m[6]) * inv;
+    r[5] = (m[2] * m[3] - m[0] * m[5]) * inv;
+    r[6] = cofactor2 * inv;
+    r[7] = (m[1] * m[6] - m[0] * m[7]) * inv;
+    r[8] = (m[0] * m[4] - m[1] * m[3]) * inv;
+}
+
+SG::PointType ImageSpaceTransform::to_physical(const SG::PointType &index) const {
+    const auto &m = index_to_physical;
+    return {{origin[0] + m[0] * index[0] + m[1] * index[1] + m[2] * index[2],
+             origin[1] + m[3] * index[0] + m[4] * index[1] + m[5] * index[2],
+             origin[2] + m[6] * index[0] + m[7] * index[1] + m[8] * index[2]}};
+}
+
+SG::PointType ImageSpaceTransform::to_index(const SG::PointType &physical) const {
+    check_is_invertible(*this);
+    const auto &r = physical_to_index;
+    const SG::PointType d = {{physical[0] - origin[0], physical[1] - origin[1],
+                              physical[2] - origin[2]}};
+    return {{r[0] * d[0] + r[1] * d[1] + r[2] * d[2],
+             r[3] * d[0] + r[4] * d[1] + r[5] * d[2],
+             r[6] * d[0] + r[7] * d[1] + r[8] * d[2]}};
+}
+
+void transform_points_to_physical_space(
+        const std::vector<SG::PointType *> &points,
+        const ImageSpaceTransform &transform,
+        const size_t num_threads) {
+    const SG::PointType zero = {{0.0, 0.0, 0.0}};
+    parallel_for_chunks(
+            points.size(),
+            [&](const size_t begin, const size_t end) {
+                affine_transform_points(points, begin, end,
+                                        transform.index_to_physical, zero,
+                                        transform.origin, false);
+            },
+            num_threads);
+}
+
+void transform_points_to_index_space(const std::vector<SG::PointType *> &points,
+                                     const ImageSpaceTransform &transform,
+                                     const bool round_to_index,
+                                     const size_t num_threads) {
+    check_is_invertible(transform);
+    const SG::PointType zero = {{0.0, 0.0, 0.0}};
+    parallel_for_chunks(
+            points.size(),
+            [&](const size_t begin, const size_t end) {
+                affine_transform_points(points, begin, end,
+                                        transform.physical_to_index,
+                                        transform.origin, zero,
+                                        round_to_index);
+            },
+            num_threads);
+}
+
+void transform_points_to_index_space(std::vector<SG::PointType> &points,
+                                     const ImageSpaceTransform &transform,
+                                     const bool round_to_index,
+                                     const size_t num_threads) {
+    std::vector<SG::PointType *> point_pointers;
+    point_pointers.reserve(points.size());
+    for (auto &point : points) {
+        point_pointers.push_back(&point);
+    }
+    transform_points_to_index_space(point_pointers, transform, round_to_index,
+                                    num_threads);
+}
+
+void transform_graph_to_physical_space(SG::GraphAL &sg,
+                                       const ImageSpaceTransform &transform,
+                                       const size_t num_threads) {
+    transform_points_to_physical_space(graph_points(sg), transform,
+                                       num_threads);
+}
+
+void transform_graph_to_physical_space(
+        SG::GraphAL &sg,
+        const SG::PointType &origin,
+        const SG::PointType &spacing,
+        const SG::DirectionMatrixType &direction) {
+    transform_graph_to_physical_space(
+            sg, ImageSpaceTransform(origin, spacing, direction));
+}
+
+void transform_graph_to_index_space(SG::GraphAL &sg,
+                                    const ImageSpaceTransform &transform,
+                                    const size_t num_threads) {
+    transform_points_to_index_space(graph_points(sg), transform, true,
+                                    num_threads);
+}
+
+void transform_graph_to_index_space(SG::GraphAL &sg,
+                                    const SG::PointType &origin,
+                                    const SG::PointType &spacing,
+                                    const SG::DirectionMatrixType &direction) {
+    transform_graph_to_index_space(
+            sg, ImageSpaceTransform(origin, spacing, direction));
+}
+
+} // namespace SG
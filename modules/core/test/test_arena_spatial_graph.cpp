@@ -0,0 +1,76 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "arena_spatial_graph.hpp"
+#include "gmock/gmock.h"
+
+struct ArenaSpatialGraphFixture : public ::testing::Test {
+    SG::GraphType g;
+    void SetUp() override {
+        // Three vertices, with a short and a long edge.
+        g = SG::GraphType(3);
+        g[0].pos = {{0, 0, 0}};
+        g[1].pos = {{2, 0, 0}};
+        g[2].pos = {{20, 0, 0}};
+        SG::SpatialEdge short_edge;
+        short_edge.edge_points.push_back({{1, 0, 0}});
+        boost::add_edge(0, 1, short_edge, g);
+        SG::SpatialEdge long_edge;
+        for (size_t i = 3; i < 20; ++i) {
+            long_edge.edge_points.push_back({{static_cast<double>(i), 0, 0}});
+        }
+        boost::add_edge(1, 2, long_edge, g);
+    }
+};
+
+TEST_F(ArenaSpatialGraphFixture, round_trip) {
+    const auto arena_sg = SG::to_arena_spatial_graph(g);
+    const auto &arena_graph = arena_sg.graph();
+    EXPECT_EQ(boost::num_vertices(arena_graph), 3u);
+    EXPECT_EQ(boost::num_edges(arena_graph), 2u);
+    // Only the long edge uses the arena, the short one is inline.
+    EXPECT_EQ(arena_sg.arena().bytes_allocated(),
+              17 * sizeof(SG::PointType));
+
+    const auto round_trip = SG::to_spatial_graph(arena_graph);
+    ASSERT_EQ(boost::num_edges(round_trip), 2u);
+    auto ei = boost::edges(g).first;
+    auto round_trip_ei = boost::edges(round_trip).first;
+    for (; ei != boost::edges(g).second; ++ei, ++round_trip_ei) {
+        EXPECT_EQ(g[*ei].edge_points, round_trip[*round_trip_ei].edge_points);
+    }
+    for (size_t v = 0; v < 3; ++v) {
+        EXPECT_EQ(g[v].pos, round_trip[v].pos);
+    }
+}
+
+TEST_F(ArenaSpatialGraphFixture, move_keeps_the_arena) {
+    auto arena_sg = SG::to_arena_spatial_graph(g);
+    const auto *arena = &arena_sg.arena();
+    SG::ArenaSpatialGraph moved(std::move(arena_sg));
+    EXPECT_EQ(&moved.arena(), arena);
+    const auto edges = boost::edges(moved.graph());
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        const auto &edge_points = moved.graph()[*ei].edge_points;
+        if (edge_points.size() > SG::arena_point_container_inline_size) {
+            EXPECT_EQ(edge_points.get_stored_allocator().arena, arena);
+        }
+    }
+}
@@ -0,0 +1,156 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "array_utilities_batch.hpp"
+#include "boundary_conditions.hpp"
+#include "gmock/gmock.h"
+#include <random>
+
+using namespace testing;
+
+// Compilers may contract the scalar functions with FMA, compare with a
+// tolerance.
+constexpr double tolerance = 1e-12;
+
+struct ArrayUtilitiesBatchFixture : public ::testing::Test {
+    // Size not multiple of the SIMD width, to test the remainder.
+    const size_t n = 37;
+    std::vector<ArrayUtilities::Array3D> lhs_arrays;
+    std::vector<ArrayUtilities::Array3D> rhs_arrays;
+    ArrayUtilities::Array3DBatch lhs;
+    ArrayUtilities::Array3DBatch rhs;
+    void SetUp() override {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> dist(-2.0, 2.0);
+        for (size_t i = 0; i < n; ++i) {
+            lhs_arrays.push_back({{dist(gen), dist(gen), dist(gen)}});
+            rhs_arrays.push_back({{dist(gen), dist(gen), dist(gen)}});
+        }
+        // Null, parallel and anti-parallel arrays
+        lhs_arrays[3] = {{0, 0, 0}};
+        rhs_arrays[5] = ArrayUtilities::product_scalar(lhs_arrays[5], 2.0);
+        rhs_arrays[6] = ArrayUtilities::product_scalar(lhs_arrays[6], -3.0);
+        lhs = ArrayUtilities::Array3DBatch(lhs_arrays);
+        rhs = ArrayUtilities::Array3DBatch(rhs_arrays);
+    }
+};
+
+TEST_F(ArrayUtilitiesBatchFixture, distances) {
+    const auto distances = ArrayUtilities::distances(lhs, rhs);
+    ASSERT_EQ(distances.size(), n);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(distances[i],
+                    ArrayUtilities::distance(lhs_arrays[i], rhs_arrays[i]),
+                    tolerance);
+    }
+}
+
+TEST_F(ArrayUtilitiesBatchFixture, segment_lengths) {
+    const auto lengths = ArrayUtilities::segment_lengths(lhs);
+    ASSERT_EQ(lengths.size(), n - 1);
+    double expected_length = 0.0;
+    for (size_t i = 1; i < n; ++i) {
+        const auto expected =
+                ArrayUtilities::distance(lhs_arrays[i], lhs_arrays[i - 1]);
+        EXPECT_NEAR(lengths[i - 1], expected, tolerance);
+        expected_length += expected;
+    }
+    EXPECT_NEAR(ArrayUtilities::polyline_length(lhs), expected_length,
+                tolerance);
+    EXPECT_TRUE(ArrayUtilities::segment_lengths(
+                        ArrayUtilities::Array3DBatch(1))
+                        .empty());
+}
+
+TEST_F(ArrayUtilitiesBatchFixture, cos_directors_and_angles) {
+    const auto cosines = ArrayUtilities::cos_directors(lhs, rhs);
+    const auto angles = ArrayUtilities::angles(lhs, rhs);
+    ASSERT_EQ(cosines.size(), n);
+    ASSERT_EQ(angles.size(), n);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(cosines[i],
+                    ArrayUtilities::cos_director(lhs_arrays[i], rhs_arrays[i]),
+                    tolerance);
+        EXPECT_NEAR(cosines[i], std::cos(angles[i]), tolerance);
+        EXPECT_NEAR(angles[i],
+                    ArrayUtilities::angle(lhs_arrays[i], rhs_arrays[i]),
+                    tolerance);
+        EXPECT_LE(std::abs(cosines[i]), 1.0);
+    }
+    EXPECT_EQ(cosines[3], 1.0);
+    EXPECT_NEAR(cosines[5], 1.0, tolerance);
+    EXPECT_NEAR(cosines[6], -1.0, tolerance);
+}
+
+TEST_F(ArrayUtilitiesBatchFixture, periodic) {
+    const ArrayUtilities::Array3D box = {{1.5, 2.0, 3.0}};
+    const ArrayUtilities::Array3D box_inverse = {{1 / 1.5, 0.5, 1 / 3.0}};
+    const auto diffs = ArrayUtilities::minus_with_boundary_condition_periodic(
+            lhs, rhs, box, box_inverse);
+    const auto distances =
+            ArrayUtilities::distances_with_boundary_condition_periodic(
+                    lhs, rhs, box, box_inverse);
+    const auto diffs_unit_box =
+            ArrayUtilities::minus_with_boundary_condition_periodic(lhs, rhs);
+    const auto distances_unit_box =
+            ArrayUtilities::distances_with_boundary_condition_periodic(lhs,
+                                                                       rhs);
+    for (size_t i = 0; i < n; ++i) {
+        const auto expected_diff =
+                ArrayUtilities::minus_with_boundary_condition_periodic(
+                        lhs_arrays[i], rhs_arrays[i], box, box_inverse);
+        const auto expected_diff_unit_box =
+                ArrayUtilities::minus_with_boundary_condition_periodic(
+                        lhs_arrays[i], rhs_arrays[i]);
+        for (size_t dim = 0; dim < 3; ++dim) {
+            EXPECT_NEAR(diffs[i][dim], expected_diff[dim], tolerance);
+            EXPECT_NEAR(diffs_unit_box[i][dim], expected_diff_unit_box[dim],
+                        tolerance);
+        }
+        EXPECT_NEAR(distances[i],
+                    ArrayUtilities::distance_with_boundary_condition_periodic(
+                            lhs_arrays[i], rhs_arrays[i], box, box_inverse),
+                    tolerance);
+        EXPECT_NEAR(distances_unit_box[i],
+                    ArrayUtilities::distance_with_boundary_condition_periodic(
+                            lhs_arrays[i], rhs_arrays[i]),
+                    tolerance);
+    }
+}
+
+TEST(ArrayUtilitiesBatch, array2d_are_embedded) {
+    const ArrayUtilities::Array2D a = {{1.0, 0.0}};
+    const ArrayUtilities::Array2D b = {{-1.0, 1.0}};
+    ArrayUtilities::Array3DBatch lhs;
+    ArrayUtilities::Array3DBatch rhs;
+    lhs.push_back(a);
+    rhs.push_back(b);
+    EXPECT_NEAR(ArrayUtilities::angles(lhs, rhs)[0],
+                ArrayUtilities::angle(a, b), tolerance);
+    EXPECT_NEAR(ArrayUtilities::distances(lhs, rhs)[0],
+                ArrayUtilities::distance(a, b), tolerance);
+}
+
+TEST(ArrayUtilitiesBatch, throws_with_different_sizes) {
+    const ArrayUtilities::Array3DBatch lhs(3);
+    const ArrayUtilities::Array3DBatch rhs(2);
+    EXPECT_THROW(ArrayUtilities::distances(lhs, rhs), std::runtime_error);
+    EXPECT_THROW(ArrayUtilities::cos_directors(lhs, rhs), std::runtime_error);
+}
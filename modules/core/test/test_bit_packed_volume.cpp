@@ -0,0 +1,137 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "bit_packed_volume.hpp"
+#include "gmock/gmock.h"
+#include <random>
+#include <set>
+
+using Index = SG::BitPackedVolume::IndexType;
+
+TEST(BitPackedVolume, set_test_and_index) {
+    const Index begin = {{5, 3, 7}};
+    SG::BitPackedVolume volume(begin, {{70, 4, 3}});
+    EXPECT_EQ(volume.num_voxels(), 70u * 4u * 3u);
+    EXPECT_EQ(volume.count(), 0u);
+    EXPECT_TRUE(volume.contains({{5, 3, 7}}));
+    EXPECT_TRUE(volume.contains({{74, 6, 9}}));
+    EXPECT_FALSE(volume.contains({{75, 6, 9}}));
+    EXPECT_FALSE(volume.contains({{4, 3, 7}}));
+
+    const Index corner = {{74, 6, 9}};
+    const auto voxel = volume.voxel(corner);
+    EXPECT_EQ(volume.index(voxel), corner);
+    EXPECT_FALSE(volume.test(voxel));
+    volume.set(voxel);
+    EXPECT_TRUE(volume.test(voxel));
+    EXPECT_EQ(volume.count(), 1u);
+    EXPECT_EQ(volume.index(voxel + volume.offset(-1, -1, -1)),
+              (Index{{73, 5, 8}}));
+    // Only the center, the neighbors outside the box are background.
+    EXPECT_EQ(volume.neighborhood(voxel), 1u << 13);
+    volume.reset(voxel);
+    EXPECT_EQ(volume.count(), 0u);
+
+    const SG::BitPackedVolume empty({{1, 1, 1}}, {{0, 4, 4}});
+    EXPECT_EQ(empty.num_voxels(), 0u);
+    EXPECT_EQ(empty.num_bytes(), 0u);
+}
+
+TEST(BitPackedVolume, neighborhood_and_scan) {
+    std::mt19937 generator(13);
+    std::bernoulli_distribution is_foreground(0.3);
+    // Rows across word boundaries, including the padding.
+    for (const size_t size_x : {1, 61, 62, 63, 64, 65, 130}) {
+        const Index begin = {{2, 0, 1}};
+        const SG::BitPackedVolume::SizeType size = {{size_x, 5, 4}};
+        SG::BitPackedVolume volume(begin, size);
+        std::set<Index> foreground;
+        for (size_t z = 0; z < size[2]; ++z) {
+            for (size_t y = 0; y < size[1]; ++y) {
+                for (size_t x = 0; x < size[0]; ++x) {
+                    if (is_foreground(generator)) {
+                        const Index index = {
+                                {begin[0] + x, begin[1] + y, begin[2] + z}};
+                        foreground.insert(index);
+                        volume.set(volume.voxel(index));
+                    }
+                }
+            }
+        }
+        EXPECT_EQ(volume.count(), foreground.size());
+
+        std::vector<size_t> scanned;
+        volume.for_each_in_rows(0, volume.num_rows(), [&](const size_t voxel) {
+            scanned.push_back(voxel);
+        });
+        ASSERT_EQ(scanned.size(), foreground.size());
+        EXPECT_TRUE(std::is_sorted(scanned.begin(), scanned.end()));
+
+        for (const auto voxel : scanned) {
+            const auto index = volume.index(voxel);
+            EXPECT_EQ(foreground.count(index), 1u);
+            uint32_t expected = 0;
+            for (int dz = -1; dz <= 1; ++dz) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        const Index neighbor = {
+                                {index[0] + dx, index[1] + dy, index[2] + dz}};
+                        if (foreground.count(neighbor)) {
+                            expected |= 1u << ((dx + 1) + 3 * (dy + 1) +
+                                               9 * (dz + 1));
+                        }
+                    }
+                }
+            }
+            ASSERT_EQ(volume.neighborhood(voxel), expected)
+                    << "size_x: " << size_x;
+            EXPECT_EQ(volume.parity(voxel),
+                      (((index[0] - begin[0]) & 1) ^ 1) |
+                              ((((index[1] - begin[1]) & 1) ^ 1) << 1) |
+                              ((((index[2] - begin[2]) & 1) ^ 1) << 2));
+        }
+    }
+}
+
+TEST(NeighborhoodConfigurationMap, masks) {
+    std::array<uint32_t, 26> identity;
+    std::array<uint32_t, 26> reversed;
+    for (size_t i = 0; i < 26; ++i) {
+        identity[i] = 1u << i;
+        reversed[i] = 1u << (25 - i);
+    }
+    const SG::NeighborhoodConfigurationMap identity_map(identity);
+    const SG::NeighborhoodConfigurationMap reversed_map(reversed);
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<uint32_t> random_code(0, (1u << 27) - 1);
+    for (size_t n = 0; n < 1000; ++n) {
+        const auto code = random_code(generator);
+        // Remove the center bit.
+        const uint32_t expected = (code & 0x1FFF) | ((code >> 14) << 13);
+        EXPECT_EQ(identity_map(code), expected);
+        uint32_t expected_reversed = 0;
+        for (size_t i = 0; i < 26; ++i) {
+            if ((expected >> i) & 1) {
+                expected_reversed |= 1u << (25 - i);
+            }
+        }
+        EXPECT_EQ(reversed_map(code), expected_reversed);
+    }
+}
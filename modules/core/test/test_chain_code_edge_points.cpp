@@ -0,0 +1,119 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "chain_code_edge_points.hpp"
+#include "gmock/gmock.h"
+
+TEST(ChainCodeEdgePoints, codes_of_all_neighbors) {
+    const SG::ChainCodeEdgePoints::IndexType origin = {{0, 0, 0}};
+    std::vector<bool> used_codes(26, false);
+    for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+            for (int z = -1; z <= 1; ++z) {
+                const SG::ChainCodeEdgePoints::IndexType neighbor = {{x, y, z}};
+                const auto code =
+                        SG::ChainCodeEdgePoints::step_to_code(origin, neighbor);
+                if (x == 0 && y == 0 && z == 0) {
+                    EXPECT_EQ(code, SG::ChainCodeEdgePoints::restart_code);
+                    continue;
+                }
+                ASSERT_LT(code, 26);
+                EXPECT_FALSE(used_codes[code]);
+                used_codes[code] = true;
+                EXPECT_EQ(SG::ChainCodeEdgePoints::code_to_step(code), neighbor);
+            }
+        }
+    }
+    const SG::ChainCodeEdgePoints::IndexType far = {{2, 0, 0}};
+    EXPECT_EQ(SG::ChainCodeEdgePoints::step_to_code(origin, far),
+              SG::ChainCodeEdgePoints::restart_code);
+}
+
+TEST(ChainCodeEdgePoints, encode_decode) {
+    SG::PointContainer points;
+    // 26-connected chain, long enough to use several words.
+    SG::PointType p{{10, -5, 3}};
+    for (size_t i = 0; i < 40; ++i) {
+        points.push_back(p);
+        p[0] += 1;
+        p[1] += static_cast<double>(i % 3) - 1;
+        p[2] += (i % 2 == 0) ? 1 : 0;
+    }
+    // Jump and repeated point are encoded as restarts.
+    points.push_back({{100, 100, 100}});
+    points.push_back({{100, 100, 100}});
+    points.push_back({{101, 99, 100}});
+
+    const SG::ChainCodeEdgePoints chain(points);
+    EXPECT_EQ(chain.size(), points.size());
+    EXPECT_EQ(chain.decode(), points);
+    EXPECT_LT(chain.num_bytes(), points.size() * sizeof(SG::PointType) / 4);
+
+    const SG::PointType origin{{1, 2, 3}};
+    const SG::PointType spacing{{0.5, 0.5, 2.0}};
+    const SG::DirectionMatrixType direction{{1, 0, 0, 0, 1, 0, 0, 0, 1}};
+    const auto physical = chain.decode(origin, spacing, direction);
+    ASSERT_EQ(physical.size(), points.size());
+    EXPECT_EQ(physical[0], (SG::PointType{{6, -0.5, 9}}));
+}
+
+TEST(ChainCodeEdgePoints, empty_and_not_encodable) {
+    const SG::ChainCodeEdgePoints chain;
+    EXPECT_TRUE(chain.empty());
+    EXPECT_TRUE(chain.begin() == chain.end());
+    EXPECT_TRUE(chain.decode().empty());
+
+    const SG::PointContainer physical_points = {{{0.5, 1, 2}}};
+    EXPECT_FALSE(SG::ChainCodeEdgePoints::is_encodable(physical_points));
+    EXPECT_THROW(SG::ChainCodeEdgePoints{physical_points}, std::runtime_error);
+}
+
+TEST(ChainCodeEdgePoints, compact_spatial_graph) {
+    SG::GraphType g(3);
+    g[0].pos = {{0, 0, 0}};
+    g[1].pos = {{3, 0, 0}};
+    g[2].pos = {{3, 3, 0}};
+    SG::SpatialEdge se01;
+    se01.edge_points = {{{1, 0, 0}}, {{2, 0, 0}}};
+    boost::add_edge(0, 1, se01, g);
+    SG::SpatialEdge se12;
+    se12.edge_points = {{{3, 1, 0}}, {{3, 2, 0}}};
+    boost::add_edge(1, 2, se12, g);
+
+    const auto compact_g = SG::compact_spatial_graph(g);
+    EXPECT_EQ(boost::num_vertices(compact_g), 3);
+    EXPECT_EQ(boost::num_edges(compact_g), 2);
+    const auto g_decoded = SG::to_spatial_graph(compact_g);
+    auto edges = boost::edges(g);
+    auto edges_decoded = boost::edges(g_decoded);
+    for (; edges.first != edges.second; ++edges.first, ++edges_decoded.first) {
+        EXPECT_EQ(g[*edges.first].edge_points,
+                  g_decoded[*edges_decoded.first].edge_points);
+    }
+
+    const SG::PointType origin{{0, 0, 0}};
+    const SG::PointType spacing{{2, 2, 2}};
+    const SG::DirectionMatrixType direction{{1, 0, 0, 0, 1, 0, 0, 0, 1}};
+    const auto g_physical =
+            SG::to_spatial_graph(compact_g, origin, spacing, direction);
+    EXPECT_EQ(g_physical[2].pos, (SG::PointType{{6, 6, 0}}));
+    const auto edge12 = boost::edge(1, 2, g_physical).first;
+    EXPECT_EQ(g_physical[edge12].edge_points[1], (SG::PointType{{6, 4, 0}}));
+}
@@ -0,0 +1,126 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "convert_spatial_graph.hpp"
+#include "spatial_graph_io.hpp"
+#include "gmock/gmock.h"
+#include <sstream>
+
+struct ConvertSpatialGraphFixture : public ::testing::Test {
+    SG::GraphType g;
+    void SetUp() override {
+        g = SG::GraphType(3);
+        g[0].pos = {{0, 0, 0}};
+        g[1].pos = {{3, 0, 0}};
+        g[2].pos = {{3, 3, -1}};
+        g[2].id = 7;
+        SG::SpatialEdge se01;
+        se01.edge_points = {{{1, 0, 0}}, {{2, 0, 0}}};
+        boost::add_edge(0, 1, se01, g);
+        SG::SpatialEdge se12;
+        se12.edge_points = {{{3, 1, 0}}, {{3, 2, -1}}};
+        boost::add_edge(1, 2, se12, g);
+    }
+};
+
+TEST_F(ConvertSpatialGraphFixture, int32_round_trip) {
+    const SG::GraphTypeI32 g_index = SG::convert_spatial_graph<int32_t>(g);
+    EXPECT_EQ(boost::num_vertices(g_index), 3);
+    EXPECT_EQ(boost::num_edges(g_index), 2);
+    EXPECT_EQ(g_index[2].id, 7);
+    EXPECT_EQ(g_index[2].pos, (SG::PointTypeT<int32_t>{{3, 3, -1}}));
+    const auto edge12 = boost::edge(1, 2, g_index).first;
+    EXPECT_EQ(g_index[edge12].edge_points[1],
+              (SG::PointTypeT<int32_t>{{3, 2, -1}}));
+    static_assert(sizeof(g_index[edge12].edge_points[0]) * 2 ==
+                          sizeof(g[edge12].edge_points[0]),
+                  "int32 points use half the memory");
+
+    const SG::GraphType g_back = SG::convert_spatial_graph<double>(g_index);
+    EXPECT_EQ(g_back[2].pos, g[2].pos);
+    EXPECT_EQ(g_back[boost::edge(1, 2, g_back).first].edge_points,
+              g[boost::edge(1, 2, g).first].edge_points);
+}
+
+TEST_F(ConvertSpatialGraphFixture, float_rounding) {
+    g[0].pos = {{0.4, 0.6, -0.6}};
+    const auto g_index = SG::convert_spatial_graph<int32_t>(g);
+    EXPECT_EQ(g_index[0].pos, (SG::PointTypeT<int32_t>{{0, 1, -1}}));
+    const auto g_float = SG::convert_spatial_graph<float>(g);
+    EXPECT_FLOAT_EQ(g_float[0].pos[1], 0.6f);
+}
+
+TEST_F(ConvertSpatialGraphFixture, index_graph_to_physical_space_graph) {
+    const auto g_index = SG::convert_spatial_graph<int32_t>(g);
+    const SG::PointType origin{{1, 1, 1}};
+    const SG::PointType spacing{{0.5, 0.5, 2}};
+    const SG::DirectionMatrixType direction{{1, 0, 0, 0, 1, 0, 0, 0, 1}};
+    const auto g_physical = SG::index_graph_to_physical_space_graph(
+            g_index, origin, spacing, direction);
+    auto g_expected = g;
+    SG::transform_graph_to_physical_space(g_expected, origin, spacing,
+                                          direction);
+    for (size_t v = 0; v < 3; ++v) {
+        EXPECT_EQ(g_physical[v].pos, g_expected[v].pos);
+    }
+    const auto edge12 = boost::edge(1, 2, g_physical).first;
+    const auto edge12_expected = boost::edge(1, 2, g_expected).first;
+    EXPECT_EQ(g_physical[edge12].edge_points,
+              g_expected[edge12_expected].edge_points);
+}
+
+TEST_F(ConvertSpatialGraphFixture, stream_operators) {
+    const auto g_index = SG::convert_spatial_graph<int32_t>(g);
+    std::stringstream ss;
+    ss << g_index[2] << " " << g_index[boost::edge(1, 2, g_index).first];
+    EXPECT_EQ(ss.str(), "3 3 -1 [{3 1 0},{3 2 -1}]");
+}
+
+TEST(SpatialGraph2D, stream_operators) {
+    SG::SpatialNode2D node;
+    node.pos = {{1, 2}};
+    SG::SpatialEdge2D edge;
+    edge.edge_points = {{{1, 3}}, {{2, 4}}};
+    std::stringstream ss;
+    ss << node << " " << edge;
+    EXPECT_EQ(ss.str(), "1 2 [{1 3},{2 4}]");
+
+    SG::SpatialNode2D node_read;
+    std::istringstream("3 4") >> node_read;
+    EXPECT_EQ(node_read.pos, (SG::PointType2D{{3, 4}}));
+    SG::SpatialEdge2D edge_read;
+    std::istringstream("[{1 3},{2 4}]") >> edge_read;
+    EXPECT_EQ(edge_read.edge_points, edge.edge_points);
+}
+
+TEST(SpatialGraph2D, embed_spatial_graph_in_3d) {
+    SG::GraphType2D g(2);
+    g[0].pos = {{0, 0}};
+    g[1].pos = {{2, 2}};
+    SG::SpatialEdge2D se;
+    se.edge_points = {{{1, 1}}};
+    boost::add_edge(0, 1, se, g);
+    const auto g_3d = SG::embed_spatial_graph_in_3d(g);
+    EXPECT_EQ(boost::num_vertices(g_3d), 2);
+    EXPECT_EQ(boost::num_edges(g_3d), 1);
+    EXPECT_EQ(g_3d[1].pos, (SG::PointType{{2, 2, 0}}));
+    EXPECT_EQ(g_3d[boost::edge(0, 1, g_3d).first].edge_points,
+              (SG::PointContainer{{{1, 1, 0}}}));
+}
@@ -23,6 +23,7 @@
 #include "spatial_graph.hpp"
 #include "spatial_graph_utilities.hpp"
 #include "gmock/gmock.h"
+#include <boost/graph/connected_components.hpp>
 #include <iostream>
 
 struct FilterByBoundingBoxFixture : public ::testing::Test {
@@ -231,3 +232,209 @@ TEST_F(FilterComponentsFixture, works) {
     SG::print_degrees(second_component);
     SG::print_spatial_edges(second_component);
 }
+
+TEST_F(FilterComponentsFixture, connected_components_union_find) {
+    const auto components = SG::connected_components_union_find(g);
+    EXPECT_EQ(components.size(), 2);
+    EXPECT_EQ(components.num_vertices(0), 3);
+    EXPECT_EQ(components.num_edges(0), 2);
+    EXPECT_EQ(components.num_vertices(1), 2);
+    EXPECT_EQ(components.num_edges(1), 1);
+    EXPECT_THAT(components.vertex_component,
+                ::testing::ElementsAre(0, 0, 0, 1, 1));
+    EXPECT_THAT(components.vertices, ::testing::ElementsAre(0, 1, 2, 3, 4));
+    EXPECT_THAT(components.vertex_local_index,
+                ::testing::ElementsAre(0, 1, 2, 0, 1));
+
+    const auto component_graphs = SG::copy_component_graphs(g, components);
+    ASSERT_EQ(component_graphs.size(), 2);
+    const auto &second_graph = component_graphs[1];
+    EXPECT_EQ(boost::num_vertices(second_graph), 2);
+    EXPECT_EQ(boost::num_edges(second_graph), 1);
+    EXPECT_EQ(second_graph[0].pos, g[3].pos);
+    EXPECT_EQ(second_graph[1].pos, g[4].pos);
+    EXPECT_TRUE(boost::edge(0, 1, second_graph).second);
+
+    const auto largest = SG::copy_largest_connected_component(g);
+    EXPECT_EQ(boost::num_vertices(largest), 3);
+    EXPECT_EQ(boost::num_edges(largest), 2);
+}
+
+TEST(connected_components_union_find, same_components_than_boost) {
+    using GraphType = SG::GraphAL;
+    // Many small components, with loops and parallel edges, and isolated
+    // vertices.
+    const size_t num_vertices = 20000;
+    GraphType g(num_vertices);
+    size_t seed = 7;
+    const auto next_random = [&seed]() {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<size_t>(seed >> 33);
+    };
+    for (size_t i = 0; i < num_vertices; ++i) {
+        const size_t u = next_random() % num_vertices;
+        const size_t v = (u + next_random() % 40) % num_vertices;
+        boost::add_edge(u, v, g);
+    }
+    std::vector<int> expected_components(num_vertices);
+    const size_t expected_num_of_components = boost::connected_components(
+            g, boost::make_iterator_property_map(
+                       expected_components.begin(),
+                       boost::get(boost::vertex_index, g)));
+
+    const auto serial_components = SG::connected_components_union_find(g, 1);
+    const auto components = SG::connected_components_union_find(g, 4);
+    EXPECT_EQ(serial_components.vertex_component, components.vertex_component);
+    EXPECT_EQ(serial_components.edges, components.edges);
+    ASSERT_EQ(components.size(), expected_num_of_components);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        EXPECT_EQ(components.vertex_component[v],
+                  static_cast<size_t>(expected_components[v]));
+    }
+    size_t num_edges = 0;
+    for (size_t c = 0; c < components.size(); ++c) {
+        for (size_t i = components.edge_offsets[c];
+             i < components.edge_offsets[c + 1]; ++i) {
+            const auto source = boost::source(components.edges[i], g);
+            EXPECT_EQ(components.vertex_component[source], c);
+            ++num_edges;
+        }
+    }
+    EXPECT_EQ(num_edges, boost::num_edges(g));
+
+    // Components processed concurrently.
+    std::vector<size_t> component_graph_num_edges(components.size());
+    const auto component_graphs = SG::copy_component_graphs(g, components, 4);
+    SG::for_each_component(
+            components,
+            [&component_graphs, &component_graph_num_edges](size_t c) {
+                component_graph_num_edges[c] =
+                        boost::num_edges(component_graphs[c]);
+            },
+            4);
+    for (size_t c = 0; c < components.size(); ++c) {
+        EXPECT_EQ(component_graph_num_edges[c], components.num_edges(c));
+        EXPECT_EQ(boost::num_vertices(component_graphs[c]),
+                  components.num_vertices(c));
+    }
+}
+
+TEST_F(FilterBySetsFixture, compact_graph) {
+    SG::VertexDescriptorUnorderedSet remove_nodes;
+    SG::EdgeDescriptorUnorderedSet remove_edges;
+    remove_nodes.insert(1);
+    const auto compacted = SG::compact_graph(g, remove_edges, remove_nodes);
+    EXPECT_EQ(boost::num_vertices(compacted.graph), 2);
+    EXPECT_EQ(boost::num_edges(compacted.graph), 0);
+    EXPECT_THAT(compacted.vertex_map,
+                ::testing::ElementsAre(0, GraphType::null_vertex(), 1));
+    EXPECT_EQ(compacted.graph[1].pos, g[2].pos);
+
+    const auto filtered_graph =
+            SG::filter_by_sets(remove_edges, remove_nodes, g);
+    EXPECT_EQ(boost::num_vertices(filtered_graph), 2);
+    EXPECT_EQ(boost::num_edges(filtered_graph), 0);
+
+    auto g_in_place = g;
+    const auto vertex_map =
+            SG::compact_graph_in_place(g_in_place, remove_edges, remove_nodes);
+    EXPECT_EQ(vertex_map, compacted.vertex_map);
+    EXPECT_EQ(boost::num_vertices(g_in_place), 2);
+    EXPECT_EQ(g_in_place[1].pos, g[2].pos);
+}
+
+TEST(compact_graph, same_graph_than_removing_one_by_one) {
+    using GraphType = SG::GraphAL;
+    const size_t num_vertices = 5000;
+    GraphType g(num_vertices);
+    size_t seed = 11;
+    const auto next_random = [&seed]() {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<size_t>(seed >> 33);
+    };
+    for (size_t v = 0; v < num_vertices; ++v) {
+        g[v].pos = {{static_cast<double>(v), 0, 0}};
+    }
+    for (size_t i = 0; i < 3 * num_vertices; ++i) {
+        const size_t u = next_random() % num_vertices;
+        const size_t v = next_random() % num_vertices;
+        SG::SpatialEdge se;
+        se.edge_points.push_back({{static_cast<double>(i), 0, 0}});
+        boost::add_edge(u, v, se, g);
+    }
+    SG::VertexDescriptorUnorderedSet remove_nodes;
+    SG::EdgeDescriptorUnorderedSet remove_edges;
+    for (size_t i = 0; i < num_vertices / 10; ++i) {
+        remove_nodes.insert(next_random() % num_vertices);
+    }
+    const auto edges = boost::edges(g);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        if (next_random() % 7 == 0) {
+            remove_edges.insert(*ei);
+        }
+    }
+
+    // Removing edges, and then vertices in decreasing order.
+    GraphType expected_graph = g;
+    {
+        std::vector<GraphType::edge_descriptor> expected_remove_edges;
+        const auto expected_edges = boost::edges(expected_graph);
+        auto ei = edges.first;
+        for (auto expected_ei = expected_edges.first;
+             expected_ei != expected_edges.second; ++expected_ei, ++ei) {
+            if (remove_edges.count(*ei)) {
+                expected_remove_edges.push_back(*expected_ei);
+            }
+        }
+        for (const auto &ed : expected_remove_edges) {
+            boost::remove_edge(ed, expected_graph);
+        }
+        std::vector<size_t> sorted_remove_nodes(remove_nodes.cbegin(),
+                                                remove_nodes.cend());
+        std::sort(sorted_remove_nodes.rbegin(), sorted_remove_nodes.rend());
+        for (const auto &v : sorted_remove_nodes) {
+            boost::clear_vertex(v, expected_graph);
+            boost::remove_vertex(v, expected_graph);
+        }
+    }
+
+    const auto compacted =
+            SG::compact_graph(g, remove_edges, remove_nodes, 4);
+    const auto compacted_serial =
+            SG::compact_graph(g, remove_edges, remove_nodes, 1);
+    EXPECT_EQ(compacted.vertex_map, compacted_serial.vertex_map);
+    for (const auto &graph : {std::cref(compacted.graph),
+                              std::cref(compacted_serial.graph)}) {
+        ASSERT_EQ(boost::num_vertices(graph.get()),
+                  boost::num_vertices(expected_graph));
+        ASSERT_EQ(boost::num_edges(graph.get()),
+                  boost::num_edges(expected_graph));
+        for (size_t v = 0; v < boost::num_vertices(expected_graph); ++v) {
+            EXPECT_EQ(graph.get()[v].pos, expected_graph[v].pos);
+        }
+        const auto expected_edges = boost::edges(expected_graph);
+        const auto compacted_edges = boost::edges(graph.get());
+        auto ei = compacted_edges.first;
+        for (auto expected_ei = expected_edges.first;
+             expected_ei != expected_edges.second; ++expected_ei, ++ei) {
+            EXPECT_EQ(boost::source(*ei, graph.get()),
+                      boost::source(*expected_ei, expected_graph));
+            EXPECT_EQ(boost::target(*ei, graph.get()),
+                      boost::target(*expected_ei, expected_graph));
+            EXPECT_EQ(graph.get()[*ei].edge_points,
+                      expected_graph[*expected_ei].edge_points);
+        }
+    }
+    for (size_t v = 0; v < num_vertices; ++v) {
+        if (remove_nodes.count(v)) {
+            EXPECT_EQ(compacted.vertex_map[v], GraphType::null_vertex());
+        } else {
+            EXPECT_EQ(compacted.graph[compacted.vertex_map[v]].pos, g[v].pos);
+        }
+    }
+    const auto isolated_vertices = SG::degree_zero_vertices(compacted.graph);
+    for (size_t v = 0; v < boost::num_vertices(compacted.graph); ++v) {
+        EXPECT_EQ(isolated_vertices.count(v) == 1,
+                  boost::out_degree(v, compacted.graph) == 0);
+    }
+}
@@ -0,0 +1,167 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "edge_points_utilities.hpp"
+#include "frozen_spatial_graph.hpp"
+#include "hash_edge_descriptor.hpp"
+#include "shortest_path.hpp"
+#include "spatial_graph.hpp"
+#include "gmock/gmock.h"
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <unordered_set>
+
+BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<SG::FrozenSpatialGraph>));
+BOOST_CONCEPT_ASSERT((boost::EdgeListGraphConcept<SG::FrozenSpatialGraph>));
+BOOST_CONCEPT_ASSERT((boost::IncidenceGraphConcept<SG::FrozenSpatialGraph>));
+BOOST_CONCEPT_ASSERT((boost::AdjacencyGraphConcept<SG::FrozenSpatialGraph>));
+
+/**
+ * Spatial Graph with a self-loop and a parallel edge.
+ *       o 3
+ *       |
+ *  0 o--o 1 == o 2
+ *       @
+ */
+struct FrozenSpatialGraphFixture : public ::testing::Test {
+    using GraphType = SG::GraphAL;
+    GraphType g;
+
+    void SetUp() override {
+        using boost::add_edge;
+        this->g = GraphType(4);
+        g[0].pos = {{0, 0, 0}};
+        g[1].pos = {{2, 0, 0}};
+        g[2].pos = {{4, 0, 0}};
+        g[3].pos = {{2, 2, 0}};
+
+        SG::SpatialEdge se01;
+        se01.edge_points = {{{1, 0, 0}}};
+        add_edge(0, 1, se01, g);
+        SG::SpatialEdge se12;
+        se12.edge_points = {{{3, 0, 0}}};
+        add_edge(1, 2, se12, g);
+        SG::SpatialEdge se12_parallel;
+        se12_parallel.edge_points = {{{3, 1, 0}}, {{3.5, 1, 0}}};
+        add_edge(2, 1, se12_parallel, g);
+        SG::SpatialEdge se13;
+        se13.edge_points = {{{2, 1, 0}}};
+        add_edge(1, 3, se13, g);
+        SG::SpatialEdge se11_loop;
+        se11_loop.edge_points = {{{2, -1, 0}}, {{3, -2, 0}}, {{1, -2, 0}}};
+        add_edge(1, 1, se11_loop, g);
+    }
+};
+
+TEST_F(FrozenSpatialGraphFixture, same_structure_than_input) {
+    const SG::FrozenSpatialGraph fg(g);
+    EXPECT_EQ(boost::num_vertices(fg), boost::num_vertices(g));
+    EXPECT_EQ(boost::num_edges(fg), boost::num_edges(g));
+    EXPECT_EQ(fg.num_edge_points(), 8);
+    const auto verts = boost::vertices(g);
+    for (auto vi = verts.first; vi != verts.second; ++vi) {
+        EXPECT_EQ(fg[*vi].pos, g[*vi].pos);
+        EXPECT_EQ(boost::degree(*vi, fg), boost::degree(*vi, g));
+        // Same order of out edges
+        auto out_g = boost::out_edges(*vi, g);
+        auto out_fg = boost::out_edges(*vi, fg);
+        for (; out_g.first != out_g.second; ++out_g.first, ++out_fg.first) {
+            ASSERT_NE(out_fg.first, out_fg.second);
+            EXPECT_EQ(boost::source(*out_fg.first, fg),
+                      boost::source(*out_g.first, g));
+            EXPECT_EQ(boost::target(*out_fg.first, fg),
+                      boost::target(*out_g.first, g));
+            const auto eps_fg = fg[*out_fg.first].edge_points.to_container();
+            EXPECT_EQ(eps_fg, g[*out_g.first].edge_points);
+        }
+        EXPECT_EQ(out_fg.first, out_fg.second);
+    }
+    size_t edge_index = 0;
+    const auto edges = boost::edges(fg);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        EXPECT_EQ(boost::get(boost::edge_index, fg, *ei), edge_index++);
+    }
+}
+
+TEST_F(FrozenSpatialGraphFixture, edge) {
+    const SG::FrozenSpatialGraph fg(g);
+    const auto edge_01 = boost::edge(0, 1, fg);
+    EXPECT_TRUE(edge_01.second);
+    EXPECT_EQ(fg[edge_01.first].edge_points.size(), 1);
+    EXPECT_FALSE(boost::edge(0, 2, fg).second);
+    EXPECT_TRUE(boost::edge(1, 1, fg).second);
+    // edge_hash works with frozen edge descriptors
+    std::unordered_set<SG::FrozenSpatialGraph::edge_descriptor,
+                       SG::edge_hash<SG::FrozenSpatialGraph>>
+            edge_set;
+    edge_set.insert(edge_01.first);
+    EXPECT_EQ(edge_set.count(boost::edge(1, 0, fg).first), 1);
+}
+
+TEST_F(FrozenSpatialGraphFixture, contour_length) {
+    const SG::FrozenSpatialGraph fg(g);
+    auto edges_g = boost::edges(g);
+    auto edges_fg = boost::edges(fg);
+    for (; edges_g.first != edges_g.second;
+         ++edges_g.first, ++edges_fg.first) {
+        EXPECT_DOUBLE_EQ(SG::contour_length(*edges_fg.first, fg),
+                         SG::contour_length(*edges_g.first, g));
+        EXPECT_DOUBLE_EQ(SG::ete_distance(*edges_fg.first, fg),
+                         SG::ete_distance(*edges_g.first, g));
+    }
+}
+
+TEST_F(FrozenSpatialGraphFixture, compute_shortest_path) {
+    const SG::FrozenSpatialGraph fg(g);
+    const auto path_fg = SG::compute_shortest_path(0, 2, fg);
+    const auto path_g = SG::compute_shortest_path(0, 2, g);
+    EXPECT_EQ(path_fg, path_g);
+    const std::vector<size_t> expected_path = {0, 1, 2};
+    EXPECT_EQ(path_fg, expected_path);
+}
+
+TEST_F(FrozenSpatialGraphFixture, breadth_first_search) {
+    const SG::FrozenSpatialGraph fg(g);
+    std::vector<size_t> discovered_fg;
+    std::vector<size_t> discovered_g;
+    auto recorder = [](std::vector<size_t> &discovered) {
+        return boost::make_bfs_visitor(boost::write_property(
+                boost::typed_identity_property_map<size_t>(),
+                std::back_inserter(discovered), boost::on_discover_vertex()));
+    };
+    boost::breadth_first_search(fg, 3,
+                                boost::visitor(recorder(discovered_fg)));
+    boost::breadth_first_search(g, 3, boost::visitor(recorder(discovered_g)));
+    EXPECT_EQ(discovered_fg, discovered_g);
+}
+
+TEST_F(FrozenSpatialGraphFixture, to_spatial_graph) {
+    const SG::FrozenSpatialGraph fg(g);
+    const auto thawed = fg.to_spatial_graph();
+    EXPECT_EQ(boost::num_vertices(thawed), boost::num_vertices(g));
+    EXPECT_EQ(boost::num_edges(thawed), boost::num_edges(g));
+    auto edges_g = boost::edges(g);
+    auto edges_thawed = boost::edges(thawed);
+    for (; edges_g.first != edges_g.second;
+         ++edges_g.first, ++edges_thawed.first) {
+        EXPECT_EQ(thawed[*edges_thawed.first].edge_points,
+                  g[*edges_g.first].edge_points);
+    }
+}
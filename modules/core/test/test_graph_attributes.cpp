@@ -0,0 +1,198 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "graph_attributes.hpp"
+#include "spatial_graph_io.hpp"
+#include "gmock/gmock.h"
+#include <cstdio>
+#include <fstream>
+
+/**
+ * Spatial Graph with a self-loop and a parallel edge.
+ *       o 3
+ *       |
+ *  0 o--o 1 == o 2
+ *       @
+ */
+struct GraphAttributesFixture : public ::testing::Test {
+    using GraphType = SG::GraphType;
+    GraphType g;
+
+    void SetUp() override {
+        using boost::add_edge;
+        this->g = GraphType(4);
+        g[0].pos = {{0, 0, 0}};
+        g[1].pos = {{2, 0, 0}};
+        g[2].pos = {{4, 0, 0}};
+        g[3].pos = {{2, 2, 0}};
+
+        SG::SpatialEdge se01;
+        se01.edge_points = {{{1, 0, 0}}};
+        add_edge(0, 1, se01, g);
+        SG::SpatialEdge se12;
+        se12.edge_points = {{{3, 0, 0}}};
+        add_edge(1, 2, se12, g);
+        SG::SpatialEdge se12_parallel;
+        se12_parallel.edge_points = {{{3, 1, 0}}, {{3.5, 1, 0}}};
+        add_edge(2, 1, se12_parallel, g);
+        SG::SpatialEdge se13;
+        se13.edge_points = {{{2, 1, 0}}};
+        add_edge(1, 3, se13, g);
+        SG::SpatialEdge se11_loop;
+        se11_loop.edge_points = {{{2, -1, 0}}, {{3, -2, 0}}, {{1, -2, 0}}};
+        add_edge(1, 1, se11_loop, g);
+    }
+};
+
+TEST(AttributeColumn, behaves_as_unordered_map) {
+    SG::VertexAttribute<size_t> column(4);
+    EXPECT_EQ(column.size(), 4);
+    EXPECT_TRUE(column.empty());
+    EXPECT_EQ(column.find(2), column.end());
+    EXPECT_EQ(column.count(2), 0);
+    EXPECT_THROW(column.at(2), std::out_of_range);
+
+    const auto emplaced = column.emplace(2, 20);
+    EXPECT_TRUE(emplaced.second);
+    EXPECT_EQ(emplaced.first->first, 2);
+    EXPECT_EQ(emplaced.first->second, 20);
+    // emplace doesn't overwrite
+    EXPECT_FALSE(column.emplace(2, 30).second);
+    EXPECT_EQ(column.at(2), 20);
+    column[0]++;
+    EXPECT_EQ(column.at(0), 1);
+    // Grows past its size
+    column.set(10, 100);
+    EXPECT_EQ(column.size(), 11);
+    EXPECT_EQ(column.num_set(), 3);
+
+    std::vector<std::pair<size_t, size_t>> id_values;
+    for (const auto &id_value : column) {
+        id_values.emplace_back(id_value.first, id_value.second);
+    }
+    const std::vector<std::pair<size_t, size_t>> expected_id_values = {
+            {0, 1}, {2, 20}, {10, 100}};
+    EXPECT_EQ(id_values, expected_id_values);
+
+    EXPECT_EQ(column.erase(2), 1);
+    EXPECT_EQ(column.erase(2), 0);
+    EXPECT_FALSE(column.has(2));
+    EXPECT_EQ(column.num_set(), 2);
+    column.resize(5);
+    EXPECT_EQ(column.num_set(), 1);
+    column.clear();
+    EXPECT_TRUE(column.empty());
+    EXPECT_EQ(column.size(), 5);
+}
+
+TEST_F(GraphAttributesFixture, edge_index) {
+    const SG::EdgeIndex<GraphType> edge_index(g);
+    EXPECT_EQ(edge_index.size(), boost::num_edges(g));
+    size_t id = 0;
+    const auto edges = boost::edges(g);
+    for (auto ei = edges.first; ei != edges.second; ++ei, ++id) {
+        EXPECT_EQ(edge_index.id(*ei), id);
+        EXPECT_TRUE(edge_index.edge(id) == *ei);
+    }
+    EXPECT_EQ(edge_index.find(0, 1), 0);
+    EXPECT_EQ(edge_index.find(1, 0), 0);
+    EXPECT_EQ(edge_index.find(3, 1), 3);
+    EXPECT_EQ(edge_index.find(1, 1), 4);
+    EXPECT_EQ(edge_index.find(0, 3), SG::EdgeIndex<GraphType>::invalid_id);
+    EXPECT_EQ(edge_index.find(0, 100), SG::EdgeIndex<GraphType>::invalid_id);
+
+    // Ids are the same in a copy of the graph, descriptors are not.
+    const GraphType g_copy = g;
+    const SG::EdgeIndex<GraphType> copy_edge_index(g_copy);
+    for (size_t edge_id = 0; edge_id < edge_index.size(); ++edge_id) {
+        EXPECT_EQ(g[edge_index.edge(edge_id)].edge_points,
+                  g_copy[copy_edge_index.edge(edge_id)].edge_points);
+    }
+    EXPECT_THROW(edge_index.id(copy_edge_index.edge(0)), std::runtime_error);
+}
+
+TEST_F(GraphAttributesFixture, conversion_from_and_to_maps) {
+    SG::edge_to_label_map_t edge_map;
+    const SG::EdgeIndex<GraphType> edge_index(g);
+    edge_map.emplace(edge_index.edge(1), 11);
+    edge_map.emplace(edge_index.edge(2), 12);
+    const auto edge_labels = SG::to_edge_attribute(g, edge_map);
+    EXPECT_EQ(edge_labels.size(), 5);
+    EXPECT_EQ(edge_labels.num_set(), 2);
+    EXPECT_EQ(edge_labels.at(1), 11);
+    EXPECT_EQ(edge_labels.at(2), 12);
+    const auto edge_map_back =
+            SG::to_edge_map<SG::edge_to_label_map_t>(g, edge_labels);
+    EXPECT_EQ(edge_map_back.size(), 2);
+    EXPECT_EQ(edge_map_back.at(edge_index.edge(1)), 11);
+
+    const SG::vertex_to_label_map_t vertex_map = {{1, 10}, {3, 30}};
+    const auto vertex_labels = SG::to_vertex_attribute(g, vertex_map);
+    EXPECT_EQ(vertex_labels.size(), 4);
+    EXPECT_EQ(vertex_labels.at(3), 30);
+    EXPECT_EQ(SG::to_unordered_map(vertex_labels), vertex_map);
+}
+
+TEST_F(GraphAttributesFixture, read_write_labels) {
+    const SG::EdgeIndex<GraphType> edge_index(g);
+    SG::EdgeAttribute<size_t> edge_labels(edge_index.size());
+    edge_labels.set(0, 100);
+    edge_labels.set(1, 101);
+    edge_labels.set(2, 102);
+    edge_labels.set(4, 104);
+    const std::string edge_file = "test_graph_attributes_edge_labels.txt";
+    SG::write_edge_labels(edge_labels, edge_index, edge_file);
+
+    // The file is compatible with read_edge_to_label_map
+    EXPECT_EQ(SG::read_edge_to_label_map(edge_file).size(), 3);
+    // Edges are resolved in a copy of the graph, parallel edges in order.
+    const GraphType g_copy = g;
+    const SG::EdgeIndex<GraphType> copy_edge_index(g_copy);
+    const auto read_edge_labels =
+            SG::read_edge_labels(edge_file, copy_edge_index);
+    EXPECT_EQ(read_edge_labels.num_set(), 4);
+    EXPECT_EQ(read_edge_labels.values(), edge_labels.values());
+    std::remove(edge_file.c_str());
+
+    SG::VertexAttribute<size_t> vertex_labels;
+    vertex_labels.set(1, 3);
+    vertex_labels.set(3, 5);
+    const std::string vertex_file = "test_graph_attributes_vertex_labels.txt";
+    SG::write_vertex_labels(vertex_labels, vertex_file);
+    const auto read_vertex_labels = SG::read_vertex_labels(vertex_file);
+    EXPECT_EQ(read_vertex_labels.num_set(), 2);
+    EXPECT_EQ(read_vertex_labels.at(1), 3);
+    EXPECT_EQ(read_vertex_labels.at(3), 5);
+    EXPECT_EQ(SG::read_vertex_to_label_map(vertex_file).size(), 2);
+    std::remove(vertex_file.c_str());
+}
+
+TEST_F(GraphAttributesFixture, read_edge_labels_throws_if_edge_not_in_graph) {
+    const std::string edge_file = "test_graph_attributes_missing_edge.txt";
+    {
+        std::ofstream my_file(edge_file);
+        my_file << "# edge_source-target, label\n";
+        my_file << "0-3, 1\n";
+    }
+    const SG::EdgeIndex<GraphType> edge_index(g);
+    EXPECT_THROW(SG::read_edge_labels(edge_file, edge_index),
+                 std::runtime_error);
+    std::remove(edge_file.c_str());
+}
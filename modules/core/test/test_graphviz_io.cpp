@@ -2,9 +2,11 @@
 #include "spatial_graph.hpp"
 #include "spatial_graph_io.hpp"
 #include "spatial_node.hpp"
+#include <boost/graph/graphviz.hpp>
 #include "gmock/gmock.h"
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 struct SpatialGraph3DFixture : public ::testing::Test {
     using GraphType = SG::GraphAL;
@@ -64,3 +66,103 @@ TEST_F(SpatialGraph3DFixture, read_graphviz) {
     EXPECT_EQ(boost::num_vertices(g), boost::num_vertices(g2));
     EXPECT_EQ(boost::num_edges(g), boost::num_edges(g2));
 }
+
+struct SpatialGraphGraphvizCompatibilityFixture : public ::testing::Test {
+    using GraphType = SG::GraphType;
+    GraphType g;
+
+    void SetUp() override {
+        // More than 10 vertices: boost::read_graphviz orders them by name
+        const size_t num_vertices = 23;
+        this->g = GraphType(num_vertices);
+        for (size_t i = 0; i < num_vertices; ++i) {
+            g[i].pos = {{0.1 * i, -1.0 / (i + 1), 1e-7 * i * i}};
+        }
+        for (size_t i = 0; i + 1 < num_vertices; ++i) {
+            SG::SpatialEdge se;
+            for (size_t p = 0; p < i % 4; ++p) {
+                se.edge_points.push_back(
+                        {{0.1 * i + 0.01 * p, 1.0 / 3.0, -2.5e10 * p}});
+            }
+            add_edge(i, i + 1, se, g);
+        }
+        // parallel edge and self-loop
+        add_edge(3, 4, g);
+        add_edge(5, 5, SG::SpatialEdge{{{{1.5, 2.5, 3.5}}}}, g);
+    }
+
+    static void expect_equal_graphs(const GraphType &lhs,
+                                    const GraphType &rhs) {
+        ASSERT_EQ(boost::num_vertices(lhs), boost::num_vertices(rhs));
+        ASSERT_EQ(boost::num_edges(lhs), boost::num_edges(rhs));
+        for (size_t v = 0; v < boost::num_vertices(lhs); ++v) {
+            EXPECT_EQ(lhs[v].id, rhs[v].id);
+            EXPECT_EQ(lhs[v].pos, rhs[v].pos);
+        }
+        auto lhs_edges = boost::edges(lhs);
+        auto rhs_edges = boost::edges(rhs);
+        for (; lhs_edges.first != lhs_edges.second;
+             ++lhs_edges.first, ++rhs_edges.first) {
+            const auto &le = *lhs_edges.first;
+            const auto &re = *rhs_edges.first;
+            EXPECT_EQ(boost::source(le, lhs), boost::source(re, rhs));
+            EXPECT_EQ(boost::target(le, lhs), boost::target(re, rhs));
+            EXPECT_EQ(lhs[le].edge_points, rhs[re].edge_points);
+        }
+    }
+};
+
+TEST_F(SpatialGraphGraphvizCompatibilityFixture, write_same_as_boost) {
+    std::stringstream boost_ss;
+    auto dp = SG::get_write_dynamic_properties_sg(g);
+    boost::write_graphviz_dp(boost_ss, g, dp);
+    std::stringstream ss;
+    SG::write_graphviz_sg(ss, g);
+    EXPECT_EQ(boost_ss.str(), ss.str());
+}
+
+TEST_F(SpatialGraphGraphvizCompatibilityFixture, read_same_as_boost) {
+    std::stringstream ss;
+    SG::write_graphviz_sg(ss, g);
+    const auto content = ss.str();
+
+    GraphType boost_g;
+    auto dp = SG::get_read_dynamic_properties_sg(boost_g);
+    std::stringstream boost_ss(content);
+    boost::read_graphviz(boost_ss, boost_g, dp);
+
+    GraphType g_read;
+    std::stringstream read_ss(content);
+    SG::read_graphviz_sg(read_ss, g_read);
+    expect_equal_graphs(boost_g, g_read);
+}
+
+TEST_F(SpatialGraphGraphvizCompatibilityFixture, read_dialect_variants) {
+    const std::string content = "// comment\n"
+                                "graph G {\n"
+                                "  /* nodes */\n"
+                                "  1 [spatial_node=\"1 2 3\"]\n"
+                                "  0 [spatial_node = \"+4 -5 6e-1\"];\n"
+                                "  0 -- 1 -- 2 [spatial_edge=\"[{7 8 9}]\"];\n"
+                                "}\n";
+    GraphType g_read;
+    std::stringstream read_ss(content);
+    SG::read_graphviz_sg(read_ss, g_read);
+    ASSERT_EQ(boost::num_vertices(g_read), 3);
+    ASSERT_EQ(boost::num_edges(g_read), 2);
+    EXPECT_EQ(g_read[0].id, 0);
+    EXPECT_EQ(g_read[0].pos, (SG::PointType{{4, -5, 0.6}}));
+    EXPECT_EQ(g_read[1].pos, (SG::PointType{{1, 2, 3}}));
+    EXPECT_EQ(g_read[2].pos, (SG::PointType{{0, 0, 0}}));
+    for (auto ei = boost::edges(g_read).first;
+         ei != boost::edges(g_read).second; ++ei) {
+        EXPECT_EQ(g_read[*ei].edge_points.size(), 1);
+    }
+
+    std::stringstream directed_ss("digraph G { 0 -> 1; }");
+    EXPECT_THROW(SG::read_graphviz_sg(directed_ss, g_read),
+                 std::runtime_error);
+    std::stringstream unterminated_ss("graph G { 0 [spatial_node=\"1 2 3");
+    EXPECT_THROW(SG::read_graphviz_sg(unterminated_ss, g_read),
+                 std::runtime_error);
+}
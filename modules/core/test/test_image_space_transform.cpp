@@ -0,0 +1,129 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "transform_to_physical_point.hpp"
+#include "gmock/gmock.h"
+#include <random>
+
+struct ImageSpaceTransformFixture : public ::testing::Test {
+    const SG::PointType origin = {{100.0, -5.0, 2.5}};
+    const SG::PointType spacing = {{1.0, 0.1, 10.0}};
+    // Rotation of 90 degrees around z.
+    const SG::DirectionMatrixType direction = {{0, -1, 0, 1, 0, 0, 0, 0, 1}};
+    const double tolerance = 1e-9;
+    SG::GraphType g;
+
+    void SetUp() override {
+        // Enough points to be transformed in several threads and batches.
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> dist(0, 100);
+        const size_t num_vertices = 500;
+        g = SG::GraphType(num_vertices);
+        for (size_t v = 0; v < num_vertices; ++v) {
+            g[v].pos = {{static_cast<double>(dist(gen)),
+                         static_cast<double>(dist(gen)),
+                         static_cast<double>(dist(gen))}};
+        }
+        for (size_t v = 1; v < num_vertices; ++v) {
+            SG::SpatialEdge se;
+            for (size_t i = 0; i < 10; ++i) {
+                se.edge_points.push_back({{static_cast<double>(dist(gen)),
+                                           static_cast<double>(dist(gen)),
+                                           static_cast<double>(dist(gen))}});
+            }
+            boost::add_edge(v - 1, v, se, g);
+        }
+    }
+};
+
+TEST_F(ImageSpaceTransformFixture, to_physical_and_back) {
+    const SG::ImageSpaceTransform transform(origin, spacing, direction);
+    EXPECT_TRUE(transform.is_invertible);
+    const SG::PointType index = {{1, 2, 3}};
+    const auto physical = transform.to_physical(index);
+    EXPECT_EQ(physical, SG::index_array_to_physical_space_array(
+                                index, origin, spacing, direction));
+    const auto back = transform.to_index(physical);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(back[i], index[i], tolerance);
+    }
+}
+
+TEST_F(ImageSpaceTransformFixture, singular_transform_throws_on_inverse) {
+    const SG::PointType zero_spacing = {{1.0, 0.0, 1.0}};
+    const SG::ImageSpaceTransform transform(origin, zero_spacing, direction);
+    EXPECT_FALSE(transform.is_invertible);
+    EXPECT_THROW(transform.to_index(origin), std::runtime_error);
+    EXPECT_THROW(SG::transform_graph_to_index_space(g, transform),
+                 std::runtime_error);
+}
+
+TEST_F(ImageSpaceTransformFixture, transform_graph_in_parallel) {
+    const SG::ImageSpaceTransform transform(origin, spacing, direction);
+    auto physical_g = g;
+    SG::transform_graph_to_physical_space(physical_g, transform, 4);
+    // Same result than the point by point transform.
+    for (size_t v = 0; v < boost::num_vertices(g); ++v) {
+        const auto expected = SG::index_array_to_physical_space_array(
+                g[v].pos, origin, spacing, direction);
+        for (size_t i = 0; i < 3; ++i) {
+            EXPECT_NEAR(physical_g[v].pos[i], expected[i], tolerance);
+        }
+    }
+    auto ei = boost::edges(g).first;
+    auto physical_ei = boost::edges(physical_g).first;
+    for (; ei != boost::edges(g).second; ++ei, ++physical_ei) {
+        const auto &eps = g[*ei].edge_points;
+        const auto &physical_eps = physical_g[*physical_ei].edge_points;
+        ASSERT_EQ(eps.size(), physical_eps.size());
+        for (size_t p = 0; p < eps.size(); ++p) {
+            const auto expected = SG::index_array_to_physical_space_array(
+                    eps[p], origin, spacing, direction);
+            for (size_t i = 0; i < 3; ++i) {
+                EXPECT_NEAR(physical_eps[p][i], expected[i], tolerance);
+            }
+        }
+    }
+
+    // Inverse in place recovers the integer indices.
+    SG::transform_graph_to_index_space(physical_g, origin, spacing, direction);
+    for (size_t v = 0; v < boost::num_vertices(g); ++v) {
+        EXPECT_EQ(physical_g[v].pos, g[v].pos);
+    }
+    ei = boost::edges(g).first;
+    physical_ei = boost::edges(physical_g).first;
+    for (; ei != boost::edges(g).second; ++ei, ++physical_ei) {
+        EXPECT_EQ(physical_g[*physical_ei].edge_points, g[*ei].edge_points);
+    }
+}
+
+TEST_F(ImageSpaceTransformFixture, points_to_index_space_without_rounding) {
+    const SG::ImageSpaceTransform transform(origin, spacing, direction);
+    const SG::PointType index = {{1.25, 2.5, -3.75}};
+    std::vector<SG::PointType> points = {transform.to_physical(index)};
+    SG::transform_points_to_index_space(points, transform, false);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(points[0][i], index[i], tolerance);
+    }
+    std::vector<SG::PointType> rounded_points = {transform.to_physical(index)};
+    SG::transform_points_to_index_space(rounded_points, transform, true);
+    // Half integers are rounded up.
+    EXPECT_EQ(rounded_points[0], (SG::PointType{{1, 3, -4}}));
+}
@@ -0,0 +1,213 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "mapped_spatial_graph.hpp"
+#include "spatial_graph.hpp"
+#include "spatial_graph_io.hpp"
+#include "gmock/gmock.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+struct MappedSpatialGraphFixture : public ::testing::Test {
+    using GraphType = SG::GraphType;
+    GraphType g;
+    const std::string filename = "mapped_spatial_graph_test_out.sgb";
+
+    void SetUp() override {
+        this->g = GraphType(4);
+
+        SG::PointType n3{{0, 3, 0}};
+        SG::PointType n2{{0, 2, 0}};
+        SG::PointType n1{{0, 1, 0}};
+        SG::PointType p0{{0, 0, 0}};
+        SG::PointType e1{{1, 0, 0}};
+        SG::PointType e2{{2, 0, 0}};
+        SG::PointType s1{{0, -1, 0}};
+        SG::PointType s2{{0, -2, 0}};
+        SG::PointType s3{{0, -3, 0.5}};
+
+        g[0].pos = n3;
+        g[1].pos = p0;
+        g[2].pos = s3;
+        g[3].pos = e2;
+        for (size_t i = 0; i < 4; ++i) {
+            g[i].id = 10 + i;
+        }
+
+        SG::SpatialEdge se01;
+        se01.edge_points.insert(std::end(se01.edge_points), {n1, n2});
+        add_edge(0, 1, se01, g);
+        SG::SpatialEdge se12;
+        se12.edge_points.insert(std::end(se12.edge_points), {s1, s2});
+        add_edge(1, 2, se12, g);
+        SG::SpatialEdge se13;
+        se13.edge_points.insert(std::end(se13.edge_points), {e1});
+        add_edge(1, 3, se13, g);
+        // Edge without edge points
+        add_edge(2, 3, SG::SpatialEdge(), g);
+    }
+
+    void expect_equal_graphs(const GraphType &lhs, const GraphType &rhs) {
+        ASSERT_EQ(boost::num_vertices(lhs), boost::num_vertices(rhs));
+        ASSERT_EQ(boost::num_edges(lhs), boost::num_edges(rhs));
+        for (size_t v = 0; v < boost::num_vertices(lhs); ++v) {
+            EXPECT_EQ(lhs[v].id, rhs[v].id);
+            EXPECT_EQ(lhs[v].pos, rhs[v].pos);
+        }
+        auto lhs_edges = boost::edges(lhs);
+        auto rhs_edges = boost::edges(rhs);
+        for (; lhs_edges.first != lhs_edges.second;
+             ++lhs_edges.first, ++rhs_edges.first) {
+            const auto &le = *lhs_edges.first;
+            const auto &re = *rhs_edges.first;
+            EXPECT_EQ(boost::source(le, lhs), boost::source(re, rhs));
+            EXPECT_EQ(boost::target(le, lhs), boost::target(re, rhs));
+            EXPECT_EQ(lhs[le].edge_points, rhs[re].edge_points);
+        }
+    }
+};
+
+TEST_F(MappedSpatialGraphFixture, stream_round_trip) {
+    std::stringstream ss;
+    SG::write_binary_sg(ss, g);
+    GraphType g_read;
+    SG::read_binary_sg(ss, g_read);
+    expect_equal_graphs(g, g_read);
+}
+
+TEST_F(MappedSpatialGraphFixture, mapped_file) {
+    SG::write_binary_sg(filename, g);
+    const SG::MappedSpatialGraph mapped(filename);
+    EXPECT_EQ(mapped.num_vertices(), 4);
+    EXPECT_EQ(mapped.num_edges(), 4);
+    EXPECT_EQ(mapped.num_edge_points(), 5);
+    EXPECT_EQ(mapped.id(2), 12);
+    EXPECT_EQ(mapped.pos(2), g[2].pos);
+    EXPECT_EQ(mapped.source(1), 1);
+    EXPECT_EQ(mapped.target(1), 2);
+    const auto edge_points = mapped.edge_points(1);
+    ASSERT_EQ(edge_points.size(), 2);
+    EXPECT_EQ(edge_points[1], (SG::PointType{{0, -2, 0}}));
+    EXPECT_TRUE(mapped.edge_points(3).empty());
+
+    EXPECT_NO_THROW(mapped.validate());
+    expect_equal_graphs(g, mapped.to_spatial_graph());
+    expect_equal_graphs(g, SG::read_binary_sg(filename));
+}
+
+TEST_F(MappedSpatialGraphFixture, invalid_files_throw) {
+    EXPECT_ANY_THROW(SG::MappedSpatialGraph("non_existing_file.sgb"));
+    const std::string bad_filename = "mapped_spatial_graph_bad.sgb";
+    {
+        std::ofstream os(bad_filename);
+        os << "This is not a binary spatial graph, but it is long enough "
+              "to hold a header.";
+    }
+    EXPECT_ANY_THROW(SG::MappedSpatialGraph{bad_filename});
+    // Truncated file
+    std::stringstream ss;
+    SG::write_binary_sg(ss, g);
+    const auto truncated = ss.str().substr(0, ss.str().size() - 8);
+    {
+        std::ofstream os(bad_filename, std::ios::binary);
+        os << truncated;
+    }
+    EXPECT_ANY_THROW(SG::MappedSpatialGraph{bad_filename});
+    std::stringstream truncated_ss(truncated);
+    GraphType g_read;
+    EXPECT_ANY_THROW(SG::read_binary_sg(truncated_ss, g_read));
+}
+
+TEST_F(MappedSpatialGraphFixture, corrupt_edges_throw) {
+    std::stringstream ss;
+    SG::write_binary_sg(ss, g);
+    const std::string valid = ss.str();
+    const size_t nv = 4;
+    const size_t ne = 4;
+    const size_t targets_begin = sizeof(SG::BinarySpatialGraphHeader) +
+                                 8 * (nv + 3 * nv + ne);
+    const size_t offsets_begin = targets_begin + 8 * ne;
+    const auto corrupt = [&valid](const size_t position,
+                                  const uint64_t value) {
+        std::string corrupted = valid;
+        std::memcpy(&corrupted[position], &value, sizeof(value));
+        return corrupted;
+    };
+    const std::string bad_filename = "mapped_spatial_graph_bad_edges.sgb";
+    const auto expect_throw = [&bad_filename](const std::string &content,
+                                              const size_t bad_edge_points) {
+        {
+            std::ofstream os(bad_filename, std::ios::binary);
+            os << content;
+        }
+        // Opening only checks the header and the size of the file.
+        const SG::MappedSpatialGraph mapped(bad_filename);
+        EXPECT_ANY_THROW(mapped.validate());
+        EXPECT_ANY_THROW(mapped.to_spatial_graph());
+        if (bad_edge_points < mapped.num_edges()) {
+            EXPECT_ANY_THROW(mapped.edge_points(bad_edge_points));
+        }
+        EXPECT_ANY_THROW(SG::read_binary_sg(bad_filename));
+        std::stringstream content_ss(content);
+        GraphType g_read;
+        EXPECT_ANY_THROW(SG::read_binary_sg(content_ss, g_read));
+    };
+    // Target out of the vertices range.
+    expect_throw(corrupt(targets_begin + 8, nv), ne);
+    // Decreasing offsets, the last one is still num_edge_points.
+    expect_throw(corrupt(offsets_begin + 8 * 2, 100), 1);
+    // First offset is not 0.
+    expect_throw(corrupt(offsets_begin, 1), ne);
+}
+
+TEST_F(MappedSpatialGraphFixture, too_large_header_counts_throw) {
+    std::stringstream ss;
+    SG::write_binary_sg(ss, g);
+    const std::string valid = ss.str();
+    const std::string bad_filename = "mapped_spatial_graph_bad_counts.sgb";
+    for (const uint64_t count :
+         {uint64_t(1) << 40, std::numeric_limits<uint64_t>::max() / 3 + 1,
+          std::numeric_limits<uint64_t>::max()}) {
+        for (const auto num_edges : {false, true}) {
+            auto header = SG::make_binary_sg_header(4, 4, 5);
+            if (num_edges) {
+                header.num_edges = count;
+            } else {
+                header.num_vertices = count;
+            }
+            std::string content = valid;
+            std::memcpy(&content[0], &header, sizeof(header));
+            // Fails at the end of the stream instead of allocating the
+            // sizes of the header.
+            std::stringstream content_ss(content);
+            GraphType g_read;
+            EXPECT_THROW(SG::read_binary_sg(content_ss, g_read),
+                         std::runtime_error);
+            {
+                std::ofstream os(bad_filename, std::ios::binary);
+                os << content;
+            }
+            EXPECT_THROW(SG::MappedSpatialGraph{bad_filename},
+                         std::runtime_error);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "point_arena.hpp"
+#include "gmock/gmock.h"
+#include <cstdint>
+#include <vector>
+
+TEST(PointArena, allocate_is_aligned_and_released) {
+    SG::PointArena arena(256);
+    std::vector<char *> pointers;
+    for (size_t i = 0; i < 50; ++i) {
+        auto *p = static_cast<char *>(arena.allocate(1 + i % 7, 8));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 8, 0u);
+        pointers.push_back(p);
+    }
+    // Allocations do not overlap.
+    for (size_t i = 1; i < pointers.size(); ++i) {
+        EXPECT_NE(pointers[i], pointers[i - 1]);
+    }
+    EXPECT_GT(arena.num_blocks(), 1u);
+    EXPECT_GE(arena.bytes_reserved(), arena.bytes_allocated());
+    // Larger than the block size
+    arena.allocate(1000, 8);
+    EXPECT_GE(arena.bytes_reserved(), 1000u);
+    arena.release();
+    EXPECT_EQ(arena.num_blocks(), 0u);
+    EXPECT_EQ(arena.bytes_allocated(), 0u);
+}
+
+TEST(PointArena, scopes_are_nested) {
+    EXPECT_EQ(SG::PointArena::current(), nullptr);
+    SG::PointArena outer;
+    SG::PointArena inner;
+    {
+        SG::PointArena::Scope outer_scope(outer);
+        EXPECT_EQ(SG::PointArena::current(), &outer);
+        {
+            SG::PointArena::Scope inner_scope(inner);
+            EXPECT_EQ(SG::PointArena::current(), &inner);
+        }
+        EXPECT_EQ(SG::PointArena::current(), &outer);
+    }
+    EXPECT_EQ(SG::PointArena::current(), nullptr);
+}
+
+TEST(ArenaAllocator, vector_uses_current_scope) {
+    using ArenaVector = std::vector<double, SG::ArenaAllocator<double>>;
+    SG::PointArena arena;
+    ArenaVector heap_vector(100, 1.0);
+    EXPECT_EQ(heap_vector.get_allocator().arena, nullptr);
+    {
+        SG::PointArena::Scope scope(arena);
+        ArenaVector arena_vector(100, 2.0);
+        EXPECT_EQ(arena_vector.get_allocator().arena, &arena);
+        EXPECT_GE(arena.bytes_allocated(), 100 * sizeof(double));
+        // Copies take the arena of the scope.
+        ArenaVector copy_vector(heap_vector);
+        EXPECT_EQ(copy_vector.get_allocator().arena, &arena);
+        EXPECT_EQ(copy_vector, heap_vector);
+    }
+    // Allocator is kept outside the scope.
+    ArenaVector copy_vector(heap_vector);
+    EXPECT_EQ(copy_vector.get_allocator().arena, nullptr);
+}
@@ -26,18 +26,28 @@
 namespace SG {
 
 /**
- * Use detect_clusters_visitor to obtain a cluster label map, mapping
- * each vertex that belongs to a cluster to a label.
+ * Obtain a cluster label map, mapping each vertex that belongs to a cluster
+ * to a label. Same result than visiting the graph with
+ * DetectClustersGraphVisitor.
  *
  * For assigning that cluster label to spatial_node_id (useful for visualization
  * purposes) use @ref assign_label_to_spatial_node_id
  *
+ * A vertex belongs to a cluster if any of its edges to other vertices has an
+ * end to end distance not larger than cluster_radius. Its label is the smallest
+ * vertex_descriptor among the vertex and those neighbors.
+ * Vertices are labeled in parallel, using only their own edges.
+ *
  * @param input_sg graph from where detect clusters
  * @param cluster_radius the cluster condition
  * @param use_cluster_centroid the node representing the whole cluster
  *  is the one closer to the cluster centroid.  If false, the node is the one
  *  with the smalled vertex_descriptor.
+ *  Note: the centroid was never applied to the labels
+ *  (see DetectClustersGraphVisitor::single_label_maps_to_centroid), both
+ *  options return the smallest vertex_descriptor.
  * @param verbose
+ * @param num_threads 0 to use all the hardware threads.
  *
  * @return  cluster label map
  */
@@ -45,7 +55,8 @@ std::unordered_map<GraphType::vertex_descriptor, GraphType::vertex_descriptor>
 detect_clusters_with_radius(const GraphType &input_sg,
                             const double &cluster_radius,
                             bool use_cluster_centroid = true,
-                            bool verbose = false);
+                            bool verbose = false,
+                            const size_t num_threads = 0);
 
 /**
  * Assign to spatial_node::id of each node of input_sg with the associated label
@@ -23,6 +23,7 @@
 
 #include "array_utilities.hpp"
 #include "edge_points_utilities.hpp" // For SG::ete_distance
+#include "graph_attributes.hpp" // For SG::VertexAttribute
 #include <algorithm>
 #include <boost/graph/adjacency_iterator.hpp>
 #include <boost/graph/adjacency_list.hpp>
@@ -130,9 +131,11 @@ struct DetectClustersGraphVisitor : public boost::default_bfs_visitor {
      * because they are close between each other, or other conditions.
      * After identifying a mergeable cluster, extra logic is needed to
      * choose what nodes/edges to keep, usually this is an asymmetric decision.
+     *
+     * Column indexed by vertex_descriptor with the interface of
+     * std::unordered_map, see @ref VertexAttribute.
      * */
-    using VertexToClusterMap =
-            std::unordered_map<vertex_descriptor, std::set<vertex_descriptor>>;
+    using VertexToClusterMap = VertexAttribute<std::set<vertex_descriptor>>;
 
     DetectClustersGraphVisitor(VertexToClusterMap &vertex_to_cluster_map,
                                ClusterEdgeCondition edge_condition,
@@ -24,8 +24,10 @@
 #include "spatial_graph.hpp"
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/graph_traits.hpp>
+#include <array>
 #include <iostream>
 #include <tuple>
+#include <vector>
 
 namespace SG {
 
@@ -56,35 +58,145 @@ namespace SG {
  * See related tests for further details.
  *
  * @param sg input spatial graph to reduce.
+ * @param inPlace remove the merged nodes from the graph, if false they are
+ * kept with degree 0. They can be removed later with
+ * compact_graph(sg, {}, degree_zero_vertices(sg)), that also removes the
+ * nodes that had degree 0 before the merge.
+ * @param num_threads threads used to find the nodes to merge,
+ * 0 to use all the hardware threads. The result does not depend on it.
  *
  * @return number of nodes merged/cleared.
  */
-size_t merge_three_connected_nodes(GraphType &sg, bool inPlace = true);
+size_t merge_three_connected_nodes(GraphType &sg,
+                                   bool inPlace = true,
+                                   const size_t num_threads = 0);
 // TODO: refactor/merge into merge_three_connected_nodes
-size_t merge_four_connected_nodes(GraphType &sg, bool inPlace = true);
-size_t merge_two_three_connected_nodes(GraphType &sg, bool inPlace = true);
+size_t merge_four_connected_nodes(GraphType &sg,
+                                  bool inPlace = true,
+                                  const size_t num_threads = 0);
+size_t merge_two_three_connected_nodes(GraphType &sg,
+                                       bool inPlace = true,
+                                       const size_t num_threads = 0);
+
+/** Kind of merge performed by @ref plan_merge_nodes. */
+enum class MergeNodesType {
+    /** @ref merge_three_connected_nodes */
+    three_connected,
+    /** @ref merge_four_connected_nodes */
+    four_connected,
+    /** @ref merge_two_three_connected_nodes */
+    two_three_connected
+};
+
+/**
+ * Merges found by @ref plan_merge_nodes, to be applied with
+ * @ref apply_merge_nodes_plan to the same graph.
+ */
+struct MergeNodesPlan {
+    using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
+    struct Merge {
+        vertex_descriptor node_to_remove;
+        vertex_descriptor node_to_merge_into;
+        /** The edge from node_to_remove to this node is moved to
+         * node_to_merge_into without adding the position of node_to_remove
+         * to its edge points.
+         * Only used by two_three_connected, null_vertex otherwise. */
+        vertex_descriptor node_with_unchanged_edge;
+    };
+    MergeNodesType type = MergeNodesType::three_connected;
+    /** In the order they are applied.
+     * A node might be removed more than once, it counts as merged each time. */
+    std::vector<Merge> merges;
+    /** Nodes whose edges between them are removed before the merges.
+     * Only used by three_connected and four_connected. */
+    std::vector<std::array<vertex_descriptor, 3>> triangles;
+};
+
+/**
+ * Find the nodes to merge by @ref merge_three_connected_nodes,
+ * @ref merge_four_connected_nodes or @ref merge_two_three_connected_nodes
+ * without modifying the graph.
+ *
+ * The incidence of the graph is copied to flat arrays, with the neighbors of
+ * each vertex sorted, so the connection between two nodes is found with a
+ * binary search in the neighbors of the node with lower degree, instead of
+ * walking the out edge lists.
+ * The nodes are inspected in parallel, and the plan is assembled in vertex
+ * order, so it does not depend on num_threads.
+ *
+ * @param sg input spatial graph
+ * @param type kind of merge
+ * @param num_threads 0 to use all the hardware threads.
+ *
+ * @return plan to use in @ref apply_merge_nodes_plan
+ */
+MergeNodesPlan plan_merge_nodes(const GraphType &sg,
+                                const MergeNodesType type,
+                                const size_t num_threads = 0);
+
+/**
+ * Apply the merges of @ref plan_merge_nodes to the graph it was planned
+ * from. The edges are edited in flat arrays and the graph is rebuilt once at
+ * the end, with the same vertices and edges (and in the same order) than
+ * applying the merges one by one on the boost graph.
+ *
+ * @param sg spatial graph used in @ref plan_merge_nodes
+ * @param plan merges to perform
+ * @param inPlace remove the merged nodes from the graph, if false they are
+ * kept with degree 0.
+ *
+ * @return number of nodes merged/cleared.
+ */
+size_t apply_merge_nodes_plan(GraphType &sg,
+                              const MergeNodesPlan &plan,
+                              bool inPlace = true);
 
 /**
  * Return a vector of pairs of edges that are parallel between them.
  * If return_unique_pairs is true the out_edges a->b and b->a are considered
  * equal (undirected graph), and the associated duplicated pair is removed.
  *
+ * The out edges of each vertex are bucketed by their target, so only edges
+ * sharing both end vertices are compared. Pairs are ordered by vertex, and
+ * by the position of the edges in the out edges of the vertex.
+ * A loop is not parallel to itself, but to other loops of the same vertex.
+ *
  * @param sg input spatial graph
  * @param return_unique_pairs remove duplicated pair.
  * Recommended set it to true for undirected graphs
+ * @param num_threads 0 to use all the hardware threads.
  *
  * @return vector of pairs of parallel edges
  */
 std::vector<std::pair<boost::graph_traits<GraphType>::edge_descriptor,
                       boost::graph_traits<GraphType>::edge_descriptor> >
-get_parallel_edges(const GraphType &sg, const bool return_unique_pairs = true);
+get_parallel_edges(const GraphType &sg,
+                   const bool return_unique_pairs = true,
+                   const size_t num_threads = 0);
+
+/**
+ * @ref get_parallel_edges restricted to the out edges of the vertices in
+ * [vertices_begin, vertices_end).
+ * It can be called concurrently on different ranges, the results of
+ * consecutive ranges are consecutive in the result of get_parallel_edges.
+ */
+std::vector<std::pair<boost::graph_traits<GraphType>::edge_descriptor,
+                      boost::graph_traits<GraphType>::edge_descriptor> >
+get_parallel_edges_of_vertices(const GraphType &sg,
+                               const size_t vertices_begin,
+                               const size_t vertices_end,
+                               const bool return_unique_pairs = true);
 
 /**
  * Check if the parallel_edges obtained from @ref get_parallel_edges
- * are exactly the same. Containing the same edge_points.
+ * are exactly the same. Containing the same edge_points, in any order.
+ *
+ * The edge points are compared only when an order independent hash of them
+ * is equal for both edges.
  *
  * @param parallel_edges obtained from @ref get_parallel_edges
  * @param sg input spatial graph
+ * @param num_threads 0 to use all the hardware threads.
  *
  * @return vector of pairs of parallel_edges that have the same spatial_edge.
  */
@@ -95,20 +207,25 @@ get_equal_parallel_edges(
                 std::pair<boost::graph_traits<GraphType>::edge_descriptor,
                           boost::graph_traits<GraphType>::edge_descriptor> >
                 &parallel_edges,
-        const GraphType &sg);
+        const GraphType &sg,
+        const size_t num_threads = 0);
 
 /**
  * Use @ref get_parallel_edges to remove the edges of the input graph.
  * Return a new copy of the graph.
+ * Pairs with an edge already removed (more than two parallel edges) are
+ * skipped.
  *
  * @param sg input spatial graph
  * @param keep_largest_spatial_edges keep the parallel edge with largest
  * contour length, if false, keep shorter parallel edges.
+ * @param num_threads 0 to use all the hardware threads.
  *
  * @return new graph without parallel edges
  */
 GraphType remove_parallel_edges(const GraphType &sg,
-                const bool keep_larger_spatial_edges = false);
+                const bool keep_larger_spatial_edges = false,
+                const size_t num_threads = 0);
 
 } // namespace SG
 
@@ -23,15 +23,74 @@
 #include "array_utilities.hpp"
 #include "split_loop.hpp"
 #include <algorithm>
+#include <boost/functional/hash.hpp>
 #include <boost/graph/adjacency_iterator.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/depth_first_search.hpp>
 #include <boost/graph/graph_traits.hpp>
 #include <iostream>
 #include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace SG {
 
+/**
+ * Edges of a graph keyed by their end vertices (lower vertex first), to
+ * find parallel edges without iterating over the out edges of a vertex.
+ */
+template <typename SpatialGraph>
+using VertexPair = std::pair<
+        typename boost::graph_traits<SpatialGraph>::vertex_descriptor,
+        typename boost::graph_traits<SpatialGraph>::vertex_descriptor>;
+template <typename SpatialGraph>
+using EdgesByEndpoints = std::unordered_map<
+        VertexPair<SpatialGraph>,
+        std::vector<
+                typename boost::graph_traits<SpatialGraph>::edge_descriptor>,
+        boost::hash<VertexPair<SpatialGraph>>>;
+
+/**
+ * True if both edges have the same edge points, in the same or in reverse
+ * order. The edge points of a chain between two nodes are unique up to
+ * its direction, so no sorting is needed to compare them.
+ */
+template <typename EdgePointsContainer>
+bool equal_edge_points_any_direction(const EdgePointsContainer &lhs,
+                                     const EdgePointsContainer &rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    return std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs)) ||
+           std::equal(std::begin(lhs), std::end(lhs), rhs.rbegin());
+}
+
+/**
+ * Add the edge (source, target) to sg, unless there is already a parallel
+ * edge with the same edge points (see @ref equal_edge_points_any_direction).
+ *
+ * @return true if the edge was added.
+ */
+template <typename SpatialGraph>
+bool add_edge_if_not_duplicated(
+        typename boost::graph_traits<SpatialGraph>::vertex_descriptor source,
+        typename boost::graph_traits<SpatialGraph>::vertex_descriptor target,
+        const typename boost::edge_bundle_type<SpatialGraph>::type &sg_edge,
+        SpatialGraph &sg,
+        EdgesByEndpoints<SpatialGraph> &edges_by_endpoints) {
+    auto &parallel_edges = edges_by_endpoints[std::minmax(source, target)];
+    for (const auto &parallel_edge : parallel_edges) {
+        if (equal_edge_points_any_direction(sg[parallel_edge].edge_points,
+                                            sg_edge.edge_points)) {
+            return false;
+        }
+    }
+    parallel_edges.push_back(
+            boost::add_edge(source, target, sg_edge, sg).first);
+    return true;
+}
+
 /**
  *
  * Use DFS (Depth first search/visitor) to remove all nodes with degree 2 and
@@ -88,9 +147,11 @@ struct ReduceGraphVisitor : public boost::default_dfs_visitor {
     ReduceGraphVisitor(SpatialGraph &sg,
                        ColorMap &color_map,
                        VertexMap &vertex_map,
+                       EdgesByEndpoints<SpatialGraph> &edges_by_endpoints,
                        bool &is_not_loop,
                        bool &verbose)
             : m_sg(sg), m_color_map(color_map), m_vertex_map(vertex_map),
+              m_edges_by_endpoints(edges_by_endpoints),
               m_is_not_loop(is_not_loop), m_verbose(verbose) {}
 
     /**
@@ -101,6 +162,7 @@ struct ReduceGraphVisitor : public boost::default_dfs_visitor {
     ReduceGraphVisitor(const ReduceGraphVisitor &other)
             : boost::default_dfs_visitor(other), m_sg(other.m_sg),
               m_color_map(other.m_color_map), m_vertex_map(other.m_vertex_map),
+              m_edges_by_endpoints(other.m_edges_by_endpoints),
               m_is_not_loop(other.m_is_not_loop), m_verbose(other.m_verbose) {
         m_is_not_loop = false;
     }
@@ -111,6 +173,8 @@ struct ReduceGraphVisitor : public boost::default_dfs_visitor {
     ColorMap &m_color_map;
     /** vertex map between the input_spatial_graph and the output (m_sg) */
     VertexMap &m_vertex_map;
+    /** edges added to m_sg, to find parallel edges */
+    EdgesByEndpoints<SpatialGraph> &m_edges_by_endpoints;
     bool &m_is_not_loop;
     bool &m_verbose;
 
@@ -165,56 +229,11 @@ struct ReduceGraphVisitor : public boost::default_dfs_visitor {
                 if (!m_sg_edge.edge_points.empty())
                     m_sg_edge.edge_points.pop_back();
 
-                // edge gives one edge (can be any if parallel edges exist.
-                auto any_edge_exist =
-                        boost::edge(m_sg_source, sg_vertex_descriptor, m_sg);
-                if (!any_edge_exist.second) {
-                    boost::add_edge(m_sg_source, sg_vertex_descriptor,
-                                    m_sg_edge, m_sg);
-                    // if(m_verbose)
-                    //   std::cout << "Added new edge: (" << m_source << "," <<
-                    //   u << ") "
-                    //   << m_sg[added.first] << std::endl;
-                } else {
-                    // Iterate over all parallel edges and checks if any of them
-                    // is equal to current edge. If not, add it.
-                    auto out_edges = boost::out_edges(m_sg_source, m_sg);
-                    auto &ei = out_edges.first;
-                    auto &ei_end = out_edges.second;
-                    bool current_edge_already_exist = false;
-                    for (; ei != ei_end && !current_edge_already_exist; ++ei)
-                        if (boost::target(*ei, m_sg) == sg_vertex_descriptor) {
-                            auto parallel_edge = *ei;
-                            auto &parallel_edge_points =
-                                    m_sg[parallel_edge].edge_points;
-                            if (parallel_edge_points.size() ==
-                                m_sg_edge.edge_points.size()) {
-                                auto sorted_current_edge_points =
-                                        m_sg_edge.edge_points;
-                                std::sort(
-                                        std::begin(sorted_current_edge_points),
-                                        std::end(sorted_current_edge_points));
-                                auto sorted_parallel_edge_points =
-                                        parallel_edge_points;
-                                std::sort(
-                                        std::begin(sorted_parallel_edge_points),
-                                        std::end(sorted_parallel_edge_points));
-                                if (sorted_current_edge_points ==
-                                    sorted_parallel_edge_points) {
-                                    // Match, edge exist
-                                    current_edge_already_exist = true;
-                                }
-                            }
-                        }
-                    if (!current_edge_already_exist) {
-                        boost::add_edge(m_sg_source, sg_vertex_descriptor,
-                                        m_sg_edge, m_sg);
-                        // if(m_verbose)
-                        //   std::cout << "Added parallel edge  (" << m_source
-                        //   << "," << u
-                        //   << ") " << m_sg[added.first] << std::endl;
-                    }
-                } // end add parallel edge
+                // Parallel edges are only added if their edge points are
+                // different.
+                add_edge_if_not_duplicated(m_sg_source, sg_vertex_descriptor,
+                                           m_sg_edge, m_sg,
+                                           m_edges_by_endpoints);
             }
 
             if (!sg_vertex_exists)
@@ -290,7 +309,7 @@ struct ReduceGraphVisitor : public boost::default_dfs_visitor {
      */
     void finish_vertex(vertex_descriptor u, const SpatialGraph &input_sg) {
         using Color =
-                typename boost::color_traits<typename ColorMap::mapped_type>;
+                typename boost::color_traits<typename ColorMap::value_type>;
         using adjacency_iterator =
                 typename boost::graph_traits<SpatialGraph>::adjacency_iterator;
         if (m_verbose)
@@ -20,6 +20,7 @@
 
 #ifndef REDUCE_SPATIAL_GRAPH_VIA_DFS_HPP
 #define REDUCE_SPATIAL_GRAPH_VIA_DFS_HPP
+#include "arena_spatial_graph.hpp"
 #include "spatial_graph.hpp"
 
 namespace SG {
@@ -36,6 +37,15 @@ namespace SG {
  * @sa split_loop function.
  *
  *
+ * The GraphType2D overload reduces graphs from 2D images.
+ *
+ * The GraphTypeI32 overload reduces graphs in index space, as created by
+ * spatial_graph_from_image<GraphTypeI32>, convert the (much smaller)
+ * reduced graph afterwards with @ref convert_spatial_graph.
+ *
+ * The ArenaSpatialGraph overload stores the edge points of the output in
+ * its own PointArena, see @ref ArenaSpatialGraph.
+ *
  * @param input_sg input
  * @param verbose pass verbosity flag to follow the visit in std::cout
  *
@@ -43,6 +53,41 @@ namespace SG {
  */
 GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
                                        bool verbose = false);
+GraphType2D reduce_spatial_graph_via_dfs(const GraphType2D &input_sg,
+                                         bool verbose = false);
+GraphTypeI32 reduce_spatial_graph_via_dfs(const GraphTypeI32 &input_sg,
+                                          bool verbose = false);
+ArenaSpatialGraph
+reduce_spatial_graph_via_dfs(const ArenaSpatialGraph &input_sg,
+                             bool verbose = false);
+
+/**
+ * Parallel alternative to @ref reduce_spatial_graph_via_dfs.
+ *
+ * Nodes are the vertices with degree 1 or greater than 2, added in the
+ * order of the input vertices. The chains of vertices with degree 2 are
+ * walked from the nodes in parallel (see @ref parallel_for_chunks), and
+ * added to the output in the order of the input vertices, so the result
+ * does not depend on the number of threads.
+ * Loops and cycles without nodes are split with @ref split_loop, as in
+ * reduce_spatial_graph_via_dfs. Parallel edges with the same edge points
+ * are added once.
+ *
+ * The depth first search of reduce_spatial_graph_via_dfs depends on the
+ * visit order in clusters of nodes, and might skip edges between
+ * neighbor nodes, or loops. Here, each edge of the input is in exactly
+ * one edge of the output (except in cycles of three vertices, reduced to
+ * a node without edges).
+ *
+ * @param input_sg input
+ * @param num_threads 0 to use all the hardware threads.
+ *
+ * @return reduced graph.
+ */
+GraphType reduce_spatial_graph_parallel(const GraphType &input_sg,
+                                        const size_t num_threads = 0);
+GraphType2D reduce_spatial_graph_parallel(const GraphType2D &input_sg,
+                                          const size_t num_threads = 0);
 
 } // namespace SG
 #endif
@@ -20,6 +20,7 @@
 
 #ifndef SPLIT_LOOP_HPP
 #define SPLIT_LOOP_HPP
+#include "arena_spatial_graph.hpp"
 #include "spatial_graph.hpp"
 
 namespace SG {
@@ -50,6 +51,15 @@ namespace SG {
 void split_loop(GraphType::vertex_descriptor loop_vertex_id,
                 const boost::edge_bundle_type<GraphType>::type &sg_edge,
                 GraphType &input_sg);
+void split_loop(GraphType2D::vertex_descriptor loop_vertex_id,
+                const boost::edge_bundle_type<GraphType2D>::type &sg_edge,
+                GraphType2D &input_sg);
+void split_loop(GraphTypeI32::vertex_descriptor loop_vertex_id,
+                const boost::edge_bundle_type<GraphTypeI32>::type &sg_edge,
+                GraphTypeI32 &input_sg);
+void split_loop(ArenaGraphType::vertex_descriptor loop_vertex_id,
+                const boost::edge_bundle_type<ArenaGraphType>::type &sg_edge,
+                ArenaGraphType &input_sg);
 
 } // namespace SG
 #endif
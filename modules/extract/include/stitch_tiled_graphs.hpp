@@ -0,0 +1,101 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef STITCH_TILED_GRAPHS_HPP
+#define STITCH_TILED_GRAPHS_HPP
+
+#include "spatial_graph.hpp"
+
+#include <array>
+#include <boost/functional/hash.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Stitch the reduced graphs of the tiles of a large image into the reduced
+ * graph of the whole image, without holding the image in memory.
+ *
+ * Each tile is a region [begin, end) of the image in index space, tiles
+ * don't overlap and cover the image. The graph of each tile must be
+ * computed with reduced_graph_from_image with boundary_nodes, from the
+ * thin image restricted to the tile: every foreground voxel in the faces
+ * of the tile is a node (a face node), and chains are cut at the faces.
+ *
+ * add_tile appends the graph of the tile, and joins its face nodes with
+ * the face nodes of the tiles added before that are 26-neighbors, face
+ * nodes are identified by their voxel coordinates. Only the face nodes
+ * are kept in the lookup, the memory is bounded by the reduced graph and
+ * the area of the faces.
+ *
+ * stitch removes the face nodes that are not nodes in the whole image:
+ * face nodes with degree 2 are dissolved, joining their two edges, and
+ * face nodes with degree 0 (isolated voxels) are removed.
+ *
+ * The result is the graph of reduced_graph_from_image of the whole image,
+ * up to the numbering of the nodes, the direction of the edges, and the
+ * voxel chosen to split cycles without end points or junctions.
+ */
+class TiledGraphStitcher {
+  public:
+    using IndexType = std::array<long, 3>;
+    using vertex_descriptor = GraphType::vertex_descriptor;
+
+    /**
+     * Append the reduced graph of a tile.
+     *
+     * @param tile_graph reduced graph in index space of the tile, with a
+     * node in every foreground voxel in the faces of the tile.
+     * @param begin first index of the tile region
+     * @param end one past the last index of the tile region
+     */
+    void add_tile(const GraphType &tile_graph,
+                  const IndexType &begin,
+                  const IndexType &end);
+
+    /**
+     * Dissolve the face nodes with degree 2, and remove the isolated face
+     * nodes. The stitcher is left empty.
+     *
+     * @return reduced graph of the whole image, in index space
+     */
+    GraphType stitch();
+
+    size_t num_tiles() const { return m_num_tiles; }
+    /** Number of face nodes of the tiles added so far. */
+    size_t num_face_nodes() const { return m_face_nodes.size(); }
+
+  private:
+    struct FaceNode {
+        vertex_descriptor vertex;
+        size_t tile;
+    };
+    GraphType m_graph;
+    /** 1 if the vertex of m_graph is a face node. */
+    std::vector<uint8_t> m_is_face_node;
+    std::unordered_map<IndexType, FaceNode, boost::hash<IndexType>>
+            m_face_nodes;
+    size_t m_num_tiles = 0;
+};
+
+} // namespace SG
+#endif
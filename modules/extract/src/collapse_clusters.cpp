@@ -20,12 +20,13 @@
 
 #include "collapse_clusters.hpp"
 #include "collapse_clusters_visitor.hpp"
-#include "filter_spatial_graph.hpp" // for filter_component_graphs
+#include "filter_spatial_graph.hpp" // for connected_components_union_find
 #include "hash_edge_descriptor.hpp"
 
 #include <boost/graph/connected_components.hpp>
 #include <boost/graph/depth_first_search.hpp>
 #include <boost/graph/graph_traits.hpp>
+#include <vector>
 
 namespace SG {
 GraphType
@@ -39,9 +40,10 @@ collapse_clusters(const GraphType &input_sg,
     using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
     using edge_descriptor = boost::graph_traits<GraphType>::edge_descriptor;
 
-    using ColorMap = std::map<vertex_descriptor, boost::default_color_type>;
-    ColorMap colorMap;
-    boost::associative_property_map<ColorMap> propColorMap(colorMap);
+    std::vector<boost::default_color_type> colorMap(
+            boost::num_vertices(input_sg), boost::white_color);
+    auto propColorMap = boost::make_iterator_property_map(
+            colorMap.begin(), boost::get(boost::vertex_index, input_sg));
 
     using VertexMap = std::unordered_map<vertex_descriptor, vertex_descriptor>;
     VertexMap vertex_map;
@@ -57,14 +59,14 @@ collapse_clusters(const GraphType &input_sg,
             collapsed_graph, vertex_map, edge_added_map,
             vertex_to_single_label_cluster_map, verbose);
 
-    // Run the visitor for each component of the graph
-    auto filtered_component_graphs = filter_component_graphs(input_sg);
-    for (const auto &component_graph : filtered_component_graphs) {
-        using comp_vertex_iterator =
-                boost::graph_traits<ComponentGraphType>::vertex_iterator;
-        comp_vertex_iterator vi, vi_end;
-        std::tie(vi, vi_end) = boost::vertices(component_graph);
-        boost::depth_first_visit(input_sg, *vi, vis, propColorMap);
+    // Run the visitor for each component of the graph, starting from its
+    // lowest vertex. The visitor populates a single graph, so the components
+    // are visited one after the other.
+    const auto components = connected_components_union_find(input_sg);
+    for (size_t comp_index = 0; comp_index < components.size(); ++comp_index) {
+        const auto &start_vertex =
+                components.vertices[components.vertex_offsets[comp_index]];
+        boost::depth_first_visit(input_sg, start_vertex, vis, propColorMap);
     }
 
     return collapsed_graph;
@@ -20,11 +20,14 @@
 
 #include "detect_clusters.hpp"
 #include "detect_clusters_visitor.hpp"
-#include "filter_spatial_graph.hpp" // for filter_component_graphs
 
-#include <boost/graph/connected_components.hpp>
-#include <boost/graph/depth_first_search.hpp>
+#include "parallel_for.hpp"
+
 #include <boost/graph/graph_traits.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <vector>
 
 namespace SG {
 
@@ -32,56 +35,75 @@ std::unordered_map<GraphType::vertex_descriptor, GraphType::vertex_descriptor>
 detect_clusters_with_radius(const GraphType &input_sg,
                             const double &cluster_radius,
                             bool use_cluster_centroid,
-                            bool verbose) {
+                            bool verbose,
+                            const size_t num_threads) {
 
     using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
-    using edge_descriptor = boost::graph_traits<GraphType>::edge_descriptor;
-
     using DetectClustersGraphVisitorType =
             DetectClustersGraphVisitor<GraphType>;
-    auto cluster_edge_condition = [cluster_radius](edge_descriptor e,
-                                                   const GraphType &input_sg) {
-        return DetectClustersGraphVisitorType::condition_edge_is_close(
-                e, input_sg, cluster_radius);
-    };
-    typename DetectClustersGraphVisitorType::VertexToClusterMap
-            vertex_to_cluster_map;
 
-    DetectClustersGraphVisitorType vis(vertex_to_cluster_map,
-                                       cluster_edge_condition, verbose);
+    // The cluster of a vertex (see DetectClustersGraphVisitor) is the vertex
+    // and its neighbors connected by a close edge, and its label is the
+    // lowest vertex of the cluster. Only the edges of each vertex are needed,
+    // so vertices are labeled independently.
+    const auto num_vertices = boost::num_vertices(input_sg);
+    std::vector<vertex_descriptor> labels(num_vertices);
+    std::vector<uint8_t> belongs_to_cluster(num_vertices, 0);
+    parallel_for_chunks(
+            num_vertices,
+            [&](const size_t vertices_begin, const size_t vertices_end) {
+                for (auto u = vertices_begin; u < vertices_end; ++u) {
+                    auto label = u;
+                    const auto out_edges = boost::out_edges(u, input_sg);
+                    for (auto ei = out_edges.first; ei != out_edges.second;
+                         ++ei) {
+                        const auto target = boost::target(*ei, input_sg);
+                        if (target == u ||
+                            !DetectClustersGraphVisitorType::
+                                    condition_edge_is_close(*ei, input_sg,
+                                                            cluster_radius)) {
+                            continue;
+                        }
+                        belongs_to_cluster[u] = 1;
+                        label = std::min(label, target);
+                    }
+                    labels[u] = label;
+                }
+            },
+            num_threads);
 
-    // For dfs/bfs
-    using ColorMap = std::map<vertex_descriptor, boost::default_color_type>;
-    ColorMap colorMap;
-    boost::associative_property_map<ColorMap> propColorMap(colorMap);
-
-    // Run the visitor for each component of the graph
-    auto filtered_component_graphs = filter_component_graphs(input_sg);
-    for (const auto &component_graph : filtered_component_graphs) {
-        using comp_vertex_iterator =
-                boost::graph_traits<ComponentGraphType>::vertex_iterator;
-        comp_vertex_iterator vi, vi_end;
-        std::tie(vi, vi_end) = boost::vertices(component_graph);
-        boost::queue< vertex_descriptor > Q;  // buffer for bfs
-        boost::breadth_first_visit(input_sg, *vi, Q, vis, propColorMap);
-    }
-    if(verbose) {
+    if (verbose) {
         std::cout << "vertex_to_cluster_map: " << std::endl;
-        for(const auto & vertex_to_cluster_set : vis.m_vertex_to_cluster_map) {
-            std::cout << vertex_to_cluster_set.first << " : [ ";
-            for(const auto & vertex : vertex_to_cluster_set.second) {
+        std::set<vertex_descriptor> cluster_vertices;
+        for (size_t u = 0; u < num_vertices; ++u) {
+            cluster_vertices = {u};
+            const auto out_edges = boost::out_edges(u, input_sg);
+            for (auto ei = out_edges.first; ei != out_edges.second; ++ei) {
+                if (DetectClustersGraphVisitorType::condition_edge_is_close(
+                            *ei, input_sg, cluster_radius)) {
+                    cluster_vertices.insert(boost::target(*ei, input_sg));
+                }
+            }
+            std::cout << u << " : [ ";
+            for (const auto &vertex : cluster_vertices) {
                 std::cout << vertex << ", ";
             }
             std::cout << " ]" << std::endl;
         }
     }
-    const auto single_label_maps = vis.get_single_label_cluster_maps();
-    if (use_cluster_centroid) {
-        const auto centroid_single_label_maps =
-                vis.single_label_maps_to_centroid(single_label_maps, input_sg);
-        return centroid_single_label_maps.vertex_to_single_label_cluster_map;
+
+    // DetectClustersGraphVisitor::single_label_maps_to_centroid modifies
+    // copies of the labels, so the labels were never moved to the centroid.
+    // use_cluster_centroid is kept for compatibility, the result is the same.
+    (void)use_cluster_centroid;
+    std::unordered_map<vertex_descriptor, vertex_descriptor>
+            vertex_to_single_label_cluster_map;
+    for (size_t u = 0; u < num_vertices; ++u) {
+        if (belongs_to_cluster[u]) {
+            vertex_to_single_label_cluster_map.emplace(u, labels[u]);
+        }
     }
-    return single_label_maps.vertex_to_single_label_cluster_map;
+    return vertex_to_single_label_cluster_map;
 }
 
 void assign_label_to_spatial_node_id(
@@ -17,237 +17,624 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  *
  * *******************************************************************/
-
 #include "merge_nodes.hpp"
-#include "boost/graph/copy.hpp"
 #include "edge_points_utilities.hpp"
 #include "filter_spatial_graph.hpp"
+#include "parallel_for.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 
 namespace SG {
 
-size_t merge_three_connected_nodes(GraphType &sg, bool inPlace) {
-    size_t node_was_merged = 0;
-    using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
-    using vertex_iterator = boost::graph_traits<GraphType>::vertex_iterator;
-    using adjacency_iterator =
-            boost::graph_traits<GraphType>::adjacency_iterator;
-    using VertexPair = std::pair<vertex_descriptor, vertex_descriptor>;
-    using VertexTriple =
-            std::tuple<vertex_descriptor, vertex_descriptor, vertex_descriptor>;
-    std::vector<VertexPair> nodes_to_remove;
-    std::vector<VertexTriple> edges_to_remove;
-    vertex_iterator vi, vi_end;
-    std::tie(vi, vi_end) = boost::vertices(sg);
-    for (; vi != vi_end; ++vi) {
-        auto degree_current = boost::out_degree(*vi, sg);
-        // limit to degree 3 nodes
-        if (degree_current == 3) {
-            // Check that current node is not already selected to remove:
-            {
-                auto already_selected_to_delete = std::find_if(
-                        std::begin(nodes_to_remove), std::end(nodes_to_remove),
-                        [&vi](const VertexPair &p) { return p.first == *vi; });
-                if (already_selected_to_delete != std::end(nodes_to_remove)) {
-                    continue;
-                }
-            }
-            adjacency_iterator neighbor_it, neighbor_end_it;
-            std::tie(neighbor_it, neighbor_end_it) =
-                    boost::adjacent_vertices(*vi, sg);
-            std::vector<std::pair<vertex_descriptor, vertex_descriptor>>
-                    neighbors_connected;
-            for (; neighbor_it != neighbor_end_it; ++neighbor_it) {
-                auto other_neighbor_it = neighbor_it;
-                ++other_neighbor_it;
-                if (other_neighbor_it != neighbor_end_it) {
-                    for (; other_neighbor_it != neighbor_end_it;
-                         ++other_neighbor_it) {
-                        auto edge_exist_pair = boost::edge(
-                                *neighbor_it, *other_neighbor_it, sg);
-                        // Check edge between neighbors exist.
-                        if (edge_exist_pair.second) {
-                            // Check there are more than one edge between them.
-                            // Store pair of vertex_descriptor of connected
-                            // neighbors Because removing edges causes
-                            // invalidation of adjacency_iterator
-                            neighbors_connected.emplace_back(
-                                    *neighbor_it, *other_neighbor_it);
-                        }
+namespace {
+using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
+using edge_descriptor = boost::graph_traits<GraphType>::edge_descriptor;
+
+/**
+ * Incidence of the graph in flat arrays.
+ * Edges are numbered in the order of boost::edges, which is also the order
+ * of the out edges of each vertex in the graph (listS out edge lists).
+ */
+struct IncidenceArrays {
+    using Neighbor = std::pair<vertex_descriptor, size_t>;
+    using NeighborIterator = std::vector<Neighbor>::const_iterator;
+    std::vector<edge_descriptor> descriptors;
+    std::vector<vertex_descriptor> sources;
+    std::vector<vertex_descriptor> targets;
+    /** Edges incident to the vertex v are in
+     * [offsets[v], offsets[v + 1]) of incident_edges.
+     * Loops appear twice, as in boost::out_edges. */
+    std::vector<size_t> offsets;
+    std::vector<size_t> incident_edges;
+    /** (neighbor, edge) of incident_edges, sorted in each vertex range.
+     * Empty if not requested. */
+    std::vector<Neighbor> sorted_neighbors;
+
+    size_t degree(const vertex_descriptor v) const {
+        return offsets[v + 1] - offsets[v];
+    }
+    vertex_descriptor opposite(const size_t edge,
+                               const vertex_descriptor v) const {
+        return sources[edge] == v ? targets[edge] : sources[edge];
+    }
+    /** Edges between u and v, in the same order than the out edges.
+     * Searched in the neighbors of the vertex with lower degree. */
+    std::pair<NeighborIterator, NeighborIterator>
+    edges_between(const vertex_descriptor u, const vertex_descriptor v) const {
+        const auto x = degree(u) <= degree(v) ? u : v;
+        const auto y = x == u ? v : u;
+        return std::equal_range(
+                sorted_neighbors.cbegin() + offsets[x],
+                sorted_neighbors.cbegin() + offsets[x + 1], Neighbor(y, 0),
+                [](const Neighbor &a, const Neighbor &b) {
+                    return a.first < b.first;
+                });
+    }
+};
+
+IncidenceArrays incidence_arrays(const GraphType &sg,
+                                 const bool sort_neighbors,
+                                 const size_t num_threads) {
+    IncidenceArrays ia;
+    const auto num_vertices = boost::num_vertices(sg);
+    const auto num_edges = boost::num_edges(sg);
+    ia.descriptors.reserve(num_edges);
+    ia.sources.reserve(num_edges);
+    ia.targets.reserve(num_edges);
+    ia.offsets.assign(num_vertices + 1, 0);
+    const auto edges = boost::edges(sg);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        const auto source = boost::source(*ei, sg);
+        const auto target = boost::target(*ei, sg);
+        ia.descriptors.push_back(*ei);
+        ia.sources.push_back(source);
+        ia.targets.push_back(target);
+        ++ia.offsets[source + 1];
+        ++ia.offsets[target + 1];
+    }
+    for (size_t v = 0; v < num_vertices; ++v) {
+        ia.offsets[v + 1] += ia.offsets[v];
+    }
+    ia.incident_edges.resize(ia.offsets[num_vertices]);
+    std::vector<size_t> next(ia.offsets.cbegin(), ia.offsets.cend() - 1);
+    for (size_t edge = 0; edge < ia.sources.size(); ++edge) {
+        ia.incident_edges[next[ia.sources[edge]]++] = edge;
+        ia.incident_edges[next[ia.targets[edge]]++] = edge;
+    }
+    if (!sort_neighbors) {
+        return ia;
+    }
+    ia.sorted_neighbors.resize(ia.incident_edges.size());
+    parallel_for_chunks(
+            num_vertices,
+            [&ia](const size_t vertices_begin, const size_t vertices_end) {
+                for (auto v = vertices_begin; v < vertices_end; ++v) {
+                    for (auto i = ia.offsets[v]; i < ia.offsets[v + 1]; ++i) {
+                        const auto edge = ia.incident_edges[i];
+                        ia.sorted_neighbors[i] = {ia.opposite(edge, v), edge};
                     }
+                    std::sort(ia.sorted_neighbors.begin() + ia.offsets[v],
+                              ia.sorted_neighbors.begin() + ia.offsets[v + 1]);
                 }
-            }
-
-            for (auto &nv : neighbors_connected) {
-                auto degree_first = boost::out_degree(nv.first, sg);
-                auto degree_second = boost::out_degree(nv.second, sg);
-                // If neighbors have more than degree 3, abort merge
-                // note that sn_current can only have degree 3 as well.
-                if (degree_first != 3 || degree_second != 3) {
-                    continue;
-                }
+            },
+            num_threads);
+    return ia;
+}
 
-                // If there are more than one edge connecting the node trio,
-                // abort.
-                {
-                    bool node_trio_has_parallel_edges = false;
-                    std::vector<vertex_descriptor> tri_nodes = {*vi, nv.first,
-                                                                nv.second};
-                    for (auto it = std::begin(tri_nodes);
-                         it != std::end(tri_nodes) &&
-                         !node_trio_has_parallel_edges;
-                         ++it) {
-                        auto it_other = it;
-                        for (++it_other; it_other != std::end(tri_nodes) &&
-                                         !node_trio_has_parallel_edges;
-                             ++it_other) {
-                            auto out_edges = boost::out_edges(*it, sg);
-                            auto &ei = out_edges.first;
-                            auto &ei_end = out_edges.second;
-                            size_t number_of_edges_between_neighbors = 0;
-                            for (; ei != ei_end; ++ei) {
-                                if (boost::target(*ei, sg) == *it_other) {
-                                    ++number_of_edges_between_neighbors;
-                                }
+/**
+ * Nodes with degree node_degree that have two neighbors with degree 3
+ * connected between them, with no edge points in the three edges of the
+ * triangle. Returns {node, first neighbor, second neighbor} for each pair of
+ * neighbors, ordered by node and by position of the neighbors in the out
+ * edges of the node.
+ */
+std::vector<std::array<vertex_descriptor, 3>>
+find_triangles(const GraphType &sg,
+               const IncidenceArrays &ia,
+               const size_t node_degree,
+               const bool skip_parallel_edges,
+               const size_t num_threads) {
+    using Triangle = std::array<vertex_descriptor, 3>;
+    const auto empty_edge = [&sg, &ia](const IncidenceArrays::NeighborIterator
+                                               &first_edge) {
+        return sg[ia.descriptors[first_edge->second]].edge_points.empty();
+    };
+    const auto num_vertices = boost::num_vertices(sg);
+    std::map<size_t, std::vector<Triangle>> chunk_triangles;
+    std::mutex chunk_triangles_mutex;
+    parallel_for_chunks(
+            num_vertices,
+            [&](const size_t vertices_begin, const size_t vertices_end) {
+                std::vector<Triangle> triangles;
+                for (auto v = vertices_begin; v < vertices_end; ++v) {
+                    if (ia.degree(v) != node_degree) {
+                        continue;
+                    }
+                    const auto begin = ia.offsets[v];
+                    const auto end = ia.offsets[v + 1];
+                    for (auto i = begin; i < end; ++i) {
+                        const auto first =
+                                ia.opposite(ia.incident_edges[i], v);
+                        for (auto j = i + 1; j < end; ++j) {
+                            const auto second =
+                                    ia.opposite(ia.incident_edges[j], v);
+                            const auto edges_neighbors =
+                                    ia.edges_between(first, second);
+                            if (edges_neighbors.first ==
+                                edges_neighbors.second) {
+                                continue;
+                            }
+                            if (ia.degree(first) != 3 ||
+                                ia.degree(second) != 3) {
+                                continue;
+                            }
+                            const auto edges_first = ia.edges_between(v, first);
+                            const auto edges_second =
+                                    ia.edges_between(v, second);
+                            // If there are more than one edge connecting the
+                            // node trio, abort.
+                            if (skip_parallel_edges &&
+                                (std::distance(edges_first.first,
+                                               edges_first.second) > 1 ||
+                                 std::distance(edges_second.first,
+                                               edges_second.second) > 1 ||
+                                 std::distance(edges_neighbors.first,
+                                               edges_neighbors.second) > 1)) {
+                                continue;
                             }
-                            if (number_of_edges_between_neighbors > 1) {
-                                node_trio_has_parallel_edges = true;
+                            // If the edge_points are not empty, abort merge
+                            if (!(empty_edge(edges_neighbors.first) &&
+                                  empty_edge(edges_first.first) &&
+                                  empty_edge(edges_second.first))) {
+                                continue;
                             }
+                            triangles.push_back({v, first, second});
                         }
                     }
-                    if (node_trio_has_parallel_edges) {
-                        continue;
-                    }
                 }
+                std::lock_guard<std::mutex> lock(chunk_triangles_mutex);
+                chunk_triangles.emplace(vertices_begin, std::move(triangles));
+            },
+            num_threads);
+
+    std::vector<Triangle> triangles;
+    for (auto &chunk : chunk_triangles) {
+        triangles.insert(triangles.end(), chunk.second.cbegin(),
+                         chunk.second.cend());
+    }
+    return triangles;
+}
 
-                auto edge_neighbors_pair = boost::edge(nv.first, nv.second, sg);
-                auto edge_first_pair = boost::edge(*vi, nv.first, sg);
-                auto edge_second_pair = boost::edge(*vi, nv.second, sg);
-                auto &edge_neighbors = sg[edge_neighbors_pair.first];
-                auto &edge_first = sg[edge_first_pair.first];
-                auto &edge_second = sg[edge_second_pair.first];
-
-                // If the edge_points are not empty, abort merge
-                if (!(edge_neighbors.edge_points.empty() &&
-                      edge_first.edge_points.empty() &&
-                      edge_second.edge_points.empty())) {
-                    continue;
+/**
+ * Candidate of merge_two_three_connected_nodes for a node:
+ * the neighbor to remove and the target of the edge of the neighbor
+ * that is moved without adding a new edge point.
+ */
+struct TwoThreeCandidate {
+    vertex_descriptor node;
+    vertex_descriptor node_to_remove;
+    vertex_descriptor node_with_unchanged_edge;
+    /** More than one neighbor could be merged, no action taken. */
+    bool ambiguous;
+};
+
+std::vector<TwoThreeCandidate>
+find_two_three_candidates(const GraphType &sg,
+                          const IncidenceArrays &ia,
+                          const size_t num_threads) {
+    const auto num_vertices = boost::num_vertices(sg);
+    const auto max_distance =
+            std::sqrt(3.0) + 2.0 * std::numeric_limits<double>::epsilon();
+    std::map<size_t, std::vector<TwoThreeCandidate>> chunk_candidates;
+    std::mutex chunk_candidates_mutex;
+    parallel_for_chunks(
+            num_vertices,
+            [&](const size_t vertices_begin, const size_t vertices_end) {
+                std::vector<TwoThreeCandidate> candidates;
+                std::vector<vertex_descriptor> three_vertices_connected;
+                for (auto v = vertices_begin; v < vertices_end; ++v) {
+                    if (ia.degree(v) != 3) {
+                        continue;
+                    }
+                    three_vertices_connected.clear();
+                    for (auto i = ia.offsets[v]; i < ia.offsets[v + 1]; ++i) {
+                        const auto neighbor =
+                                ia.opposite(ia.incident_edges[i], v);
+                        if (ia.degree(neighbor) != 3) {
+                            continue;
+                        }
+                        const auto first_edge =
+                                ia.edges_between(v, neighbor).first->second;
+                        if (sg[ia.descriptors[first_edge]]
+                                    .edge_points.empty()) {
+                            three_vertices_connected.push_back(neighbor);
+                        }
+                    }
+                    if (three_vertices_connected.empty()) {
+                        continue;
+                    }
+                    if (three_vertices_connected.size() > 1) {
+                        candidates.push_back({v, 0, 0, true});
+                        continue;
+                    }
+                    const auto candidate = three_vertices_connected[0];
+                    const auto &candidate_pos = sg[candidate].pos;
+                    // Check that the end of the edge points of any of the
+                    // outgoing edges of the candidate touch it.
+                    for (auto i = ia.offsets[candidate];
+                         i < ia.offsets[candidate + 1]; ++i) {
+                        const auto edge = ia.incident_edges[i];
+                        const auto target = ia.opposite(edge, candidate);
+                        if (target == candidate) {
+                            continue;
+                        }
+                        const auto &edge_points =
+                                sg[ia.descriptors[edge]].edge_points;
+                        if (edge_points.empty()) {
+                            continue;
+                        }
+                        if (ArrayUtilities::distance(edge_points.back(),
+                                                     candidate_pos) >
+                            max_distance) {
+                            continue;
+                        }
+                        candidates.push_back({v, candidate, target, false});
+                        // symmetry break: choose the first edge that is
+                        // mergeable.
+                        break;
+                    }
                 }
-
-                nodes_to_remove.emplace_back(nv.first, *vi);
-                nodes_to_remove.emplace_back(nv.second, *vi);
-                edges_to_remove.emplace_back(nv.first, nv.second, *vi);
+                std::lock_guard<std::mutex> lock(chunk_candidates_mutex);
+                chunk_candidates.emplace(vertices_begin,
+                                         std::move(candidates));
+            },
+            num_threads);
+
+    std::vector<TwoThreeCandidate> candidates;
+    for (auto &chunk : chunk_candidates) {
+        candidates.insert(candidates.end(), chunk.second.cbegin(),
+                          chunk.second.cend());
+    }
+    return candidates;
+}
+} // namespace
+
+MergeNodesPlan plan_merge_nodes(const GraphType &sg,
+                                const MergeNodesType type,
+                                const size_t num_threads) {
+    MergeNodesPlan plan;
+    plan.type = type;
+    const auto null_vertex = boost::graph_traits<GraphType>::null_vertex();
+    const auto ia = incidence_arrays(sg, true, num_threads);
+    // Nodes already selected to remove are not inspected.
+    std::vector<uint8_t> selected_to_remove(boost::num_vertices(sg), 0);
+    if (type == MergeNodesType::two_three_connected) {
+        for (const auto &candidate :
+             find_two_three_candidates(sg, ia, num_threads)) {
+            if (selected_to_remove[candidate.node]) {
+                continue;
+            }
+            if (candidate.ambiguous) {
+                std::cout << "WARNING: In merge_two_three_connected_nodes "
+                             "there are two vertices with degree 3 connected "
+                             "with parallel "
+                             "edges "
+                             "with no edge points. "
+                             "Extremely rare? Holes? Logic not handled. No "
+                             "action taken."
+                          << std::endl;
+                continue;
             }
+            plan.merges.push_back({candidate.node_to_remove, candidate.node,
+                                   candidate.node_with_unchanged_edge});
+            selected_to_remove[candidate.node_to_remove] = 1;
         }
+        return plan;
     }
+
+    const bool is_three = (type == MergeNodesType::three_connected);
+    const size_t node_degree = is_three ? 3 : 4;
+    // Only merge_three_connected_nodes skips nodes with parallel edges.
+    const auto triangles =
+            find_triangles(sg, ia, node_degree, is_three, num_threads);
+    auto current_node = null_vertex;
+    bool skip_current_node = false;
+    for (const auto &triangle : triangles) {
+        const auto node = triangle[0];
+        if (node != current_node) {
+            current_node = node;
+            skip_current_node = selected_to_remove[node];
+        }
+        if (skip_current_node) {
+            continue;
+        }
+        plan.merges.push_back({triangle[1], node, null_vertex});
+        plan.merges.push_back({triangle[2], node, null_vertex});
+        plan.triangles.push_back({triangle[1], triangle[2], node});
+        selected_to_remove[triangle[1]] = 1;
+        selected_to_remove[triangle[2]] = 1;
+    }
+    return plan;
+}
+
+size_t apply_merge_nodes_plan(GraphType &sg,
+                              const MergeNodesPlan &plan,
+                              bool inPlace) {
+    if (plan.merges.empty()) {
+        return 0;
+    }
+    // The edges are moved out of the graph while they are edited.
+    auto ia = incidence_arrays(sg, false, 1);
+    std::vector<SpatialEdge> edges;
+    edges.reserve(ia.descriptors.size());
+    for (const auto &ed : ia.descriptors) {
+        edges.push_back(std::move(sg[ed]));
+    }
+    std::vector<uint8_t> alive(edges.size(), 1);
+    // Edges created by the merges, appended to the incident edges.
+    std::unordered_map<vertex_descriptor, std::vector<size_t>> added_edges;
+    const auto incident_size = [&ia, &added_edges](const vertex_descriptor v) {
+        const auto added = added_edges.find(v);
+        return ia.degree(v) +
+               (added == added_edges.end() ? 0 : added->second.size());
+    };
+    const auto incident_edge = [&ia, &added_edges](const vertex_descriptor v,
+                                                   const size_t k) {
+        const auto degree = ia.degree(v);
+        return k < degree ? ia.incident_edges[ia.offsets[v] + k]
+                          : added_edges.at(v)[k - degree];
+    };
+    const auto add_edge = [&](const vertex_descriptor u,
+                              const vertex_descriptor v, SpatialEdge &&edge) {
+        const auto new_edge = edges.size();
+        ia.sources.push_back(u);
+        ia.targets.push_back(v);
+        edges.push_back(std::move(edge));
+        alive.push_back(1);
+        added_edges[u].push_back(new_edge);
+        added_edges[v].push_back(new_edge);
+    };
+
     // First, remove edges between 3 connected nodes
-    for (auto &edge_triple : edges_to_remove) {
-        boost::remove_edge(std::get<0>(edge_triple), std::get<1>(edge_triple),
-                           sg);
-        boost::remove_edge(std::get<0>(edge_triple), std::get<2>(edge_triple),
-                           sg);
-        boost::remove_edge(std::get<1>(edge_triple), std::get<2>(edge_triple),
-                           sg);
+    for (const auto &triangle : plan.triangles) {
+        for (const auto &nodes : {std::make_pair(triangle[0], triangle[1]),
+                                  std::make_pair(triangle[0], triangle[2]),
+                                  std::make_pair(triangle[1], triangle[2])}) {
+            for (size_t k = 0; k < incident_size(nodes.first); ++k) {
+                const auto edge = incident_edge(nodes.first, k);
+                if (ia.opposite(edge, nodes.first) == nodes.second) {
+                    alive[edge] = 0;
+                }
+            }
+        }
     }
 
-    SG::VertexDescriptorUnorderedSet removed_nodes;
+    const bool skip_edge_to_merge_into =
+            (plan.type == MergeNodesType::two_three_connected);
+    VertexDescriptorUnorderedSet removed_nodes;
+    size_t node_was_merged = 0;
     // Connect new nodes to node_to_merge_into.
-    for (auto &nodes : nodes_to_remove) {
-        auto &node_to_remove = nodes.first;
-        auto &node_to_merge_into = nodes.second;
-        auto edges = boost::out_edges(node_to_remove, sg);
-        // Create an edge to the node to merge into.
-        for (auto ei = edges.first; ei != edges.second; ++ei) {
-            auto target = boost::target(*ei, sg);
-            auto &spatial_edge = sg[*ei];
-            auto &sn_to_remove = sg[node_to_remove];
-            SG::insert_unique_edge_point_with_distance_order(
-                    spatial_edge.edge_points, sn_to_remove.pos);
-            boost::add_edge(node_to_merge_into, target, spatial_edge, sg);
-            // boost::remove_edge(node_to_remove, target, sg);
+    for (const auto &merge : plan.merges) {
+        const auto node_to_remove = merge.node_to_remove;
+        const auto node_to_merge_into = merge.node_to_merge_into;
+        const auto &pos_to_remove = sg[node_to_remove].pos;
+        // New edges of node_to_remove are also visited, as in out_edges.
+        for (size_t k = 0; k < incident_size(node_to_remove); ++k) {
+            const auto edge = incident_edge(node_to_remove, k);
+            if (!alive[edge]) {
+                continue;
+            }
+            const auto target = ia.opposite(edge, node_to_remove);
+            if (skip_edge_to_merge_into && target == node_to_merge_into) {
+                continue;
+            }
+            if (target != merge.node_with_unchanged_edge) {
+                SG::insert_unique_edge_point_with_distance_order(
+                        edges[edge].edge_points, pos_to_remove);
+            }
+            auto spatial_edge = edges[edge];
+            add_edge(node_to_merge_into, target, std::move(spatial_edge));
+        }
+        for (size_t k = 0; k < incident_size(node_to_remove); ++k) {
+            alive[incident_edge(node_to_remove, k)] = 0;
         }
-        // Remove vertex destroys all iterators/descripts
-        // when using a vecS as vertex_intex_t
-        // boost::remove_vertex(node_to_remove, sg);
         removed_nodes.insert(node_to_remove);
-        boost::clear_vertex(node_to_remove, sg);
         node_was_merged++;
     }
 
-    if (inPlace) {
-        sg = SG::filter_by_sets({}, removed_nodes, sg);
+    // Move the edges back, append the new ones after the original edges
+    // and remove the rest of the edges and nodes in one compaction.
+    const auto num_original_edges = ia.descriptors.size();
+    EdgeDescriptorUnorderedSet remove_edges;
+    for (size_t edge = 0; edge < num_original_edges; ++edge) {
+        if (alive[edge]) {
+            sg[ia.descriptors[edge]] = std::move(edges[edge]);
+        } else {
+            remove_edges.insert(ia.descriptors[edge]);
+        }
+    }
+    for (size_t edge = num_original_edges; edge < edges.size(); ++edge) {
+        if (alive[edge]) {
+            boost::add_edge(ia.sources[edge], ia.targets[edge],
+                            std::move(edges[edge]), sg);
+        }
+    }
+    compact_graph_in_place(sg, remove_edges,
+                           inPlace ? removed_nodes
+                                   : VertexDescriptorUnorderedSet());
+    return node_was_merged;
+}
+
+size_t merge_three_connected_nodes(GraphType &sg,
+                                   bool inPlace,
+                                   const size_t num_threads) {
+    return apply_merge_nodes_plan(
+            sg,
+            plan_merge_nodes(sg, MergeNodesType::three_connected, num_threads),
+            inPlace);
+}
+
+size_t merge_four_connected_nodes(GraphType &sg,
+                                  bool inPlace,
+                                  const size_t num_threads) {
+    return apply_merge_nodes_plan(
+            sg,
+            plan_merge_nodes(sg, MergeNodesType::four_connected, num_threads),
+            inPlace);
+}
+
+size_t merge_two_three_connected_nodes(GraphType &sg,
+                                       bool inPlace,
+                                       const size_t num_threads) {
+    return apply_merge_nodes_plan(
+            sg,
+            plan_merge_nodes(sg, MergeNodesType::two_three_connected,
+                             num_threads),
+            inPlace);
+}
+
+namespace {
+using EdgePair = std::pair<edge_descriptor, edge_descriptor>;
+
+/**
+ * Hash of the edge points that does not depend on their order.
+ * The hashes of each point are mixed and added, so repeated points count.
+ */
+size_t edge_points_fingerprint(const SpatialEdge::PointContainer &points) {
+    size_t fingerprint = points.size();
+    for (const auto &point : points) {
+        // splitmix64 finalizer, spreads the bits of the point hash before
+        // the (commutative) sum.
+        uint64_t mixed = boost::hash_range(point.cbegin(), point.cend());
+        mixed += 0x9e3779b97f4a7c15ULL;
+        mixed = (mixed ^ (mixed >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+        mixed = (mixed ^ (mixed >> 27U)) * 0x94d049bb133111ebULL;
+        mixed = mixed ^ (mixed >> 31U);
+        fingerprint += static_cast<size_t>(mixed);
     }
+    return fingerprint;
+}
 
-    return node_was_merged;
+/** Same edge points, in any order. */
+bool equal_edge_points_any_order(const SpatialEdge::PointContainer &lhs,
+                                 const SpatialEdge::PointContainer &rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    auto sorted_lhs = lhs;
+    std::sort(std::begin(sorted_lhs), std::end(sorted_lhs));
+    auto sorted_rhs = rhs;
+    std::sort(std::begin(sorted_rhs), std::end(sorted_rhs));
+    return sorted_lhs == sorted_rhs;
 }
+} // namespace
 
 std::vector<std::pair<boost::graph_traits<GraphType>::edge_descriptor,
                       boost::graph_traits<GraphType>::edge_descriptor>>
-get_parallel_edges(const GraphType &sg, const bool return_unique_pairs) {
-    using edge_descriptor = boost::graph_traits<GraphType>::edge_descriptor;
-    using EdgePair = std::pair<edge_descriptor, edge_descriptor>;
+get_parallel_edges_of_vertices(const GraphType &sg,
+                               const size_t vertices_begin,
+                               const size_t vertices_end,
+                               const bool return_unique_pairs) {
+    // Out edge of a vertex: (target, position in the out edges, edge)
+    using OutEdge = std::tuple<vertex_descriptor, size_t, edge_descriptor>;
+    // Pair of parallel edges, with the positions of both edges.
+    using PositionedPair = std::pair<std::pair<size_t, size_t>, EdgePair>;
     std::vector<EdgePair> parallel_edges;
-    const auto verts = boost::vertices(sg);
-    // From
-    // http://www.boost.org/doc/libs/1_66_0/libs/graph/doc/IncidenceGraph.html
-    // It is guaranteed that given: e=out_edge(v); then source(e) == v.
-    for (auto vi = verts.first; vi != verts.second; ++vi) {
-        const auto out_edges = boost::out_edges(*vi, sg);
-        for (auto ei1 = out_edges.first; ei1 != out_edges.second; ++ei1) {
-            auto target1 = boost::target(*ei1, sg);
-            // Copy edge iterator and plus one (to avoid compare the edge with
-            // itself)
-            auto ei2 = ei1;
-            ei2++;
-            for (; ei2 != out_edges.second; ++ei2) {
-                auto target2 = boost::target(*ei2, sg);
-                // WARNING: do not check target2 == source
-                // source(ei2) is guaranteed (by out_edges) to be equal to
-                // source(ei1)
-                if (target2 == target1) // parallel edges
-                {
-                    parallel_edges.emplace_back(std::make_pair(*ei1, *ei2));
-                }
-            }
+    std::vector<OutEdge> out_edges_by_target;
+    std::vector<PositionedPair> vertex_parallel_edges;
+    for (auto v = vertices_begin; v < vertices_end; ++v) {
+        if (boost::out_degree(v, sg) < 2) {
+            continue;
         }
-    }
-
-    // Remove repeated pairs
-    // Note that pairs with switched source/target are added to parallel_edges
-    // pair1: [e1:{0,1}, e2:{0,1}]
-    // pair2: [e1:{1,0}, e2:{1,0}]
-    // If return_unique_pairs is true, the repeated pairs are removed
-    if (return_unique_pairs) {
-        std::vector<std::vector<EdgePair>::const_iterator>
-                parallel_edges_to_remove_iterators;
-        for (auto it1 = parallel_edges.cbegin(); it1 != parallel_edges.cend();
-             it1++) {
-            auto it2 = it1;
-            it2++;
-            for (; it2 != parallel_edges.cend(); it2++) {
-                const bool it2_equal_it1_same_order =
-                        (it2->first == it1->first &&
-                         it2->second == it1->second);
-                const bool it2_equal_it1_swapped = (it2->first == it1->second &&
-                                                    it2->second == it1->first);
-                if (it2_equal_it1_same_order || it2_equal_it1_swapped) {
-                    parallel_edges_to_remove_iterators.push_back(it2);
+        out_edges_by_target.clear();
+        // From
+        // http://www.boost.org/doc/libs/1_66_0/libs/graph/doc/IncidenceGraph.html
+        // It is guaranteed that given: e=out_edge(v); then source(e) == v.
+        const auto out_edges = boost::out_edges(v, sg);
+        size_t position = 0;
+        bool previous_is_loop = false;
+        for (auto ei = out_edges.first; ei != out_edges.second;
+             ++ei, ++position) {
+            const auto target = boost::target(*ei, sg);
+            // A loop is twice (and contiguous) in the out edges of v.
+            if (target == v) {
+                if (previous_is_loop &&
+                    std::get<2>(out_edges_by_target.back()) == *ei) {
+                    previous_is_loop = false;
+                    continue;
                 }
+                previous_is_loop = true;
+            } else {
+                previous_is_loop = false;
+            }
+            // Pairs between lower and upper vertex are reported only once,
+            // from the lower vertex, in the unique case.
+            if (return_unique_pairs && target < v) {
+                continue;
             }
+            out_edges_by_target.emplace_back(target, position, *ei);
         }
-        // perform a copy...
-        std::vector<EdgePair> unique_undirected_parallel_edges;
-        for (auto it1 = parallel_edges.cbegin(); it1 != parallel_edges.cend();
-             it1++) {
-            auto found =
-                    std::find(parallel_edges_to_remove_iterators.cbegin(),
-                              parallel_edges_to_remove_iterators.cend(), it1);
-            if (found == parallel_edges_to_remove_iterators.cend()) {
-                unique_undirected_parallel_edges.push_back(*it1);
+        // Bucket the edges by target, parallel edges are contiguous.
+        std::sort(std::begin(out_edges_by_target),
+                  std::end(out_edges_by_target),
+                  [](const OutEdge &lhs, const OutEdge &rhs) {
+                      return std::tie(std::get<0>(lhs), std::get<1>(lhs)) <
+                             std::tie(std::get<0>(rhs), std::get<1>(rhs));
+                  });
+        vertex_parallel_edges.clear();
+        for (auto it1 = out_edges_by_target.cbegin();
+             it1 != out_edges_by_target.cend(); ++it1) {
+            for (auto it2 = std::next(it1);
+                 it2 != out_edges_by_target.cend() &&
+                 std::get<0>(*it2) == std::get<0>(*it1);
+                 ++it2) {
+                vertex_parallel_edges.emplace_back(
+                        std::make_pair(std::get<1>(*it1), std::get<1>(*it2)),
+                        std::make_pair(std::get<2>(*it1), std::get<2>(*it2)));
             }
         }
-        return unique_undirected_parallel_edges;
+        // Keep the order of the out edges.
+        std::sort(std::begin(vertex_parallel_edges),
+                  std::end(vertex_parallel_edges),
+                  [](const PositionedPair &lhs, const PositionedPair &rhs) {
+                      return lhs.first < rhs.first;
+                  });
+        for (const auto &positioned_pair : vertex_parallel_edges) {
+            parallel_edges.push_back(positioned_pair.second);
+        }
     }
+    return parallel_edges;
+}
 
+std::vector<std::pair<boost::graph_traits<GraphType>::edge_descriptor,
+                      boost::graph_traits<GraphType>::edge_descriptor>>
+get_parallel_edges(const GraphType &sg,
+                   const bool return_unique_pairs,
+                   const size_t num_threads) {
+    std::map<size_t, std::vector<EdgePair>> chunk_parallel_edges;
+    std::mutex chunk_parallel_edges_mutex;
+    parallel_for_chunks(
+            boost::num_vertices(sg),
+            [&](const size_t vertices_begin, const size_t vertices_end) {
+                auto parallel_edges = get_parallel_edges_of_vertices(
+                        sg, vertices_begin, vertices_end, return_unique_pairs);
+                std::lock_guard<std::mutex> lock(chunk_parallel_edges_mutex);
+                chunk_parallel_edges.emplace(vertices_begin,
+                                             std::move(parallel_edges));
+            },
+            num_threads);
+    std::vector<EdgePair> parallel_edges;
+    for (auto &chunk : chunk_parallel_edges) {
+        parallel_edges.insert(parallel_edges.end(), chunk.second.cbegin(),
+                              chunk.second.cend());
+    }
     return parallel_edges;
 }
 
@@ -258,69 +645,63 @@ get_equal_parallel_edges(
                 std::pair<boost::graph_traits<GraphType>::edge_descriptor,
                           boost::graph_traits<GraphType>::edge_descriptor>>
                 &parallel_edges,
-        const GraphType &sg) {
-    using edge_descriptor = boost::graph_traits<GraphType>::edge_descriptor;
-    using EdgePair = std::pair<edge_descriptor, edge_descriptor>;
-    std::vector<EdgePair> equal_parallel_edges;
+        const GraphType &sg,
+        const size_t num_threads) {
+    std::vector<uint8_t> are_equal(parallel_edges.size(), 0);
+    parallel_for_chunks(
+            parallel_edges.size(),
+            [&](const size_t pairs_begin, const size_t pairs_end) {
+                for (auto i = pairs_begin; i < pairs_end; ++i) {
+                    const auto &points_first =
+                            sg[parallel_edges[i].first].edge_points;
+                    const auto &points_second =
+                            sg[parallel_edges[i].second].edge_points;
+                    // Compare the points only if the fingerprints collide.
+                    are_equal[i] =
+                            points_first.size() == points_second.size() &&
+                            edge_points_fingerprint(points_first) ==
+                                    edge_points_fingerprint(points_second) &&
+                            equal_edge_points_any_order(points_first,
+                                                        points_second);
+                }
+            },
+            num_threads);
 
-    for (const auto &edge_pair : parallel_edges) {
-        const auto &points_first = sg[edge_pair.first].edge_points;
-        const auto &points_second = sg[edge_pair.second].edge_points;
-        if (points_first.empty() && points_second.empty()) {
-            // std::cout << "Empty parallel edges between:\n"
-            //     << boost::source(edge_pair.first, sg)
-            //     << "---"
-            //     << boost::target(edge_pair.first, sg)
-            //     << std::endl;
-            equal_parallel_edges.push_back(edge_pair);
-            continue;
-        }
-        if (points_first.size() == points_second.size()) {
-            auto sorted_points_first = points_first;
-            std::sort(std::begin(sorted_points_first),
-                      std::end(sorted_points_first));
-            auto sorted_points_second = points_second;
-            std::sort(std::begin(sorted_points_second),
-                      std::end(sorted_points_second));
-            if (sorted_points_first == sorted_points_second) {
-                // std::cout << "Parallel edges of size " << points_first.size()
-                //     << " between:\n"
-                //     << boost::source(edge_pair.first, sg)
-                //     << "---"
-                //     << boost::target(edge_pair.first, sg)
-                //     << std::endl;
-                equal_parallel_edges.push_back(edge_pair);
-                continue;
-            }
+    std::vector<EdgePair> equal_parallel_edges;
+    for (size_t i = 0; i < parallel_edges.size(); ++i) {
+        if (are_equal[i]) {
+            equal_parallel_edges.push_back(parallel_edges[i]);
         }
     }
-
     return equal_parallel_edges;
 }
 
 GraphType remove_parallel_edges(const GraphType &sg,
-                                const bool keep_larger_spatial_edges) {
-    GraphType sg_no_parallel;
-    boost::copy_graph(sg, sg_no_parallel);
-
+                                const bool keep_larger_spatial_edges,
+                                const size_t num_threads) {
     const bool unique_undirected_parallel_edges = true;
     const auto parallel_edges = get_parallel_edges(
-            sg_no_parallel, unique_undirected_parallel_edges);
+            sg, unique_undirected_parallel_edges, num_threads);
+    // With more than two parallel edges, an edge can be in more than one pair.
+    EdgeDescriptorUnorderedSet removed_edges;
     for (const auto &edge_pair : parallel_edges) {
+        if (removed_edges.count(edge_pair.first) ||
+            removed_edges.count(edge_pair.second)) {
+            continue;
+        }
         const auto &points_first = sg[edge_pair.first].edge_points;
         const auto &points_second = sg[edge_pair.second].edge_points;
         // In case there are no points remove the second one.
         // We remove the second edge, in case there are more than
         // two parallel_edges
         if (points_first.empty() && points_second.empty()) {
-            boost::remove_edge(edge_pair.second, sg_no_parallel);
+            removed_edges.insert(edge_pair.second);
             continue;
         }
 
-        const auto contour_length_first =
-                contour_length(edge_pair.first, sg_no_parallel);
+        const auto contour_length_first = contour_length(edge_pair.first, sg);
         const auto contour_length_second =
-                contour_length(edge_pair.second, sg_no_parallel);
+                contour_length(edge_pair.second, sg);
 
         bool remove_second_edge = false;
         if (contour_length_first >= contour_length_second) {
@@ -330,336 +711,13 @@ GraphType remove_parallel_edges(const GraphType &sg,
         }
 
         if (remove_second_edge) {
-            boost::remove_edge(edge_pair.second, sg_no_parallel);
+            removed_edges.insert(edge_pair.second);
         } else {
-            boost::remove_edge(edge_pair.first, sg_no_parallel);
-        }
-    }
-    return sg_no_parallel;
-}
-
-size_t merge_four_connected_nodes(GraphType &sg, bool inPlace) {
-    size_t node_was_merged = 0;
-    using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
-    using vertex_iterator = boost::graph_traits<GraphType>::vertex_iterator;
-    using adjacency_iterator =
-            boost::graph_traits<GraphType>::adjacency_iterator;
-    using VertexPair = std::pair<vertex_descriptor, vertex_descriptor>;
-    using VertexTriple =
-            std::tuple<vertex_descriptor, vertex_descriptor, vertex_descriptor>;
-    std::vector<VertexPair> nodes_to_remove;
-    std::vector<VertexTriple> edges_to_remove;
-    vertex_iterator vi, vi_end;
-    std::tie(vi, vi_end) = boost::vertices(sg);
-    for (; vi != vi_end; ++vi) {
-        auto degree_current = boost::out_degree(*vi, sg);
-        // limit to degree 4 nodes
-        if (degree_current == 4) {
-            // Check that current node is not already selected to remove:
-            {
-                auto already_selected_to_delete = std::find_if(
-                        std::begin(nodes_to_remove), std::end(nodes_to_remove),
-                        [&vi](const VertexPair &p) { return p.first == *vi; });
-                if (already_selected_to_delete != std::end(nodes_to_remove)) {
-                    continue;
-                }
-            }
-            adjacency_iterator neighbor_it, neighbor_end_it;
-            std::tie(neighbor_it, neighbor_end_it) =
-                    boost::adjacent_vertices(*vi, sg);
-            std::vector<std::pair<vertex_descriptor, vertex_descriptor>>
-                    neighbors_connected;
-            for (; neighbor_it != neighbor_end_it; ++neighbor_it) {
-                auto other_neighbor_it = neighbor_it;
-                ++other_neighbor_it;
-                for (; other_neighbor_it != neighbor_end_it;
-                     ++other_neighbor_it) {
-                    auto edge_exist_pair =
-                            boost::edge(*neighbor_it, *other_neighbor_it, sg);
-                    // Check edge between neighbors exist.
-                    if (edge_exist_pair.second) {
-                        // Check there are more than one edge between them.
-                        // Store pair of vertex_descriptor of connected
-                        // neighbors Because removing edges causes invalidation
-                        // of adjacency_iterator
-                        neighbors_connected.emplace_back(*neighbor_it,
-                                                         *other_neighbor_it);
-                    }
-                }
-            }
-
-            for (auto &nv : neighbors_connected) {
-                auto degree_first = boost::out_degree(nv.first, sg);
-                auto degree_second = boost::out_degree(nv.second, sg);
-                // If neighbors have more than degree 3, abort merge
-                // note that sn_current can only have degree 4
-                if (degree_first != 3 || degree_second != 3) {
-                    continue;
-                }
-
-                // If there are more than one edge connecting the node trio,
-                // abort.
-                // NOLINTNEXTLINE
-                if (false) {
-                    bool node_trio_has_parallel_edges = false;
-                    std::vector<vertex_descriptor> tri_nodes = {*vi, nv.first,
-                                                                nv.second};
-                    for (auto it = std::begin(tri_nodes);
-                         it != std::end(tri_nodes) &&
-                         !node_trio_has_parallel_edges;
-                         ++it) {
-                        auto it_other = it;
-                        for (++it_other; it_other != std::end(tri_nodes) &&
-                                         !node_trio_has_parallel_edges;
-                             ++it_other) {
-                            auto out_edges = boost::out_edges(*it, sg);
-                            auto &ei = out_edges.first;
-                            auto &ei_end = out_edges.second;
-                            size_t number_of_edges_between_neighbors = 0;
-                            for (; ei != ei_end; ++ei) {
-                                if (boost::target(*ei, sg) == *it_other) {
-                                    ++number_of_edges_between_neighbors;
-                                }
-                            }
-                            if (number_of_edges_between_neighbors > 1) {
-                                node_trio_has_parallel_edges = true;
-                            }
-                        }
-                    }
-                    if (node_trio_has_parallel_edges) {
-                        continue;
-                    }
-                }
-
-                auto edge_neighbors_pair = boost::edge(nv.first, nv.second, sg);
-                auto edge_first_pair = boost::edge(*vi, nv.first, sg);
-                auto edge_second_pair = boost::edge(*vi, nv.second, sg);
-                auto &edge_neighbors = sg[edge_neighbors_pair.first];
-                auto &edge_first = sg[edge_first_pair.first];
-                auto &edge_second = sg[edge_second_pair.first];
-
-                // If the edge_points are not empty, abort merge
-                if (!(edge_neighbors.edge_points.empty() &&
-                      edge_first.edge_points.empty() &&
-                      edge_second.edge_points.empty())) {
-                    continue;
-                }
-
-                nodes_to_remove.emplace_back(nv.first, *vi);
-                nodes_to_remove.emplace_back(nv.second, *vi);
-                edges_to_remove.emplace_back(nv.first, nv.second, *vi);
-            }
-        }
-    }
-    // First, remove edges between 3 connected nodes
-    for (auto &edge_triple : edges_to_remove) {
-        boost::remove_edge(std::get<0>(edge_triple), std::get<1>(edge_triple),
-                           sg);
-        boost::remove_edge(std::get<0>(edge_triple), std::get<2>(edge_triple),
-                           sg);
-        boost::remove_edge(std::get<1>(edge_triple), std::get<2>(edge_triple),
-                           sg);
-    }
-
-    SG::VertexDescriptorUnorderedSet removed_nodes;
-    // Connect new nodes to node_to_merge_into.
-    for (auto &nodes : nodes_to_remove) {
-        auto &node_to_remove = nodes.first;
-        auto &node_to_merge_into = nodes.second;
-        auto edges = boost::out_edges(node_to_remove, sg);
-        // Create an edge to the node to merge into.
-        for (auto ei = edges.first; ei != edges.second; ++ei) {
-            auto target = boost::target(*ei, sg);
-            auto &spatial_edge = sg[*ei];
-            auto &sn_to_remove = sg[node_to_remove];
-            SG::insert_unique_edge_point_with_distance_order(
-                    spatial_edge.edge_points, sn_to_remove.pos);
-            boost::add_edge(node_to_merge_into, target, spatial_edge, sg);
-            // boost::remove_edge(node_to_remove, target, sg);
+            removed_edges.insert(edge_pair.first);
         }
-        // Remove vertex destroys all iterators/descripts
-        // when using a vecS as vertex_intex_t
-        // boost::remove_vertex(node_to_remove, sg);
-        removed_nodes.insert(node_to_remove);
-        boost::clear_vertex(node_to_remove, sg);
-        node_was_merged++;
     }
-
-    if (inPlace) {
-        sg = SG::filter_by_sets({}, removed_nodes, sg);
-    }
-
-    return node_was_merged;
+    // Vertices are not removed, the descriptors are the same than in sg.
+    return filter_by_sets(removed_edges, {}, sg, num_threads);
 }
 
-size_t merge_two_three_connected_nodes(GraphType &sg, bool inPlace) {
-    size_t node_was_merged = 0;
-    using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
-    using vertex_iterator = boost::graph_traits<GraphType>::vertex_iterator;
-    using adjacency_iterator =
-            boost::graph_traits<GraphType>::adjacency_iterator;
-    using VertexTriple =
-            std::tuple<vertex_descriptor, vertex_descriptor, vertex_descriptor>;
-    // First vertex descriptor is the node to be deleted
-    // Second vertex descriptor is the node to be merged into
-    // Third vertex descriptor is the node which edge just needs a change of
-    // target
-    std::vector<VertexTriple> nodes_to_remove;
-    // std::vector<VertexPair> edges_to_merge;
-    vertex_iterator vi, vi_end;
-    std::tie(vi, vi_end) = boost::vertices(sg);
-    for (; vi != vi_end; ++vi) {
-        auto degree_current = boost::out_degree(*vi, sg);
-        // limit to degree 3 nodes
-        if (degree_current == 3) {
-            // Check that current node is not already selected to remove:
-            {
-                auto already_selected_to_delete = std::find_if(
-                        std::begin(nodes_to_remove), std::end(nodes_to_remove),
-                        [&vi](const VertexTriple &p) {
-                            return std::get<0>(p) == *vi;
-                        });
-                if (already_selected_to_delete != std::end(nodes_to_remove)) {
-                    continue;
-                }
-            }
-            adjacency_iterator neighbor_it, neighbor_end_it;
-            std::tie(neighbor_it, neighbor_end_it) =
-                    boost::adjacent_vertices(*vi, sg);
-            std::vector<vertex_descriptor> three_vertices_connected;
-            for (; neighbor_it != neighbor_end_it; ++neighbor_it) {
-                const auto degree_neighbor =
-                        boost::out_degree(*neighbor_it, sg);
-                if (degree_neighbor == 3) { // current degree has also degree 3
-                    const auto &spatial_edge =
-                            sg[boost::edge(*vi, *neighbor_it, sg).first];
-                    // If the edge_points are not empty, abort merge
-                    if (spatial_edge.edge_points.empty()) {
-                        three_vertices_connected.emplace_back(*neighbor_it);
-                    }
-                }
-            }
-
-            if (three_vertices_connected.empty()) {
-                continue;
-            }
-            if (three_vertices_connected.size() > 1) {
-                std::cout << "WARNING: In merge_two_three_connected_nodes "
-                             "there are two vertices with degree 3 connected "
-                             "with parallel "
-                             "edges "
-                             "with no edge points. "
-                             "Extremely rare? Holes? Logic not handled. No "
-                             "action taken."
-                          << std::endl;
-                continue;
-            }
-            const auto &connected_vertex_candidate_to_remove =
-                    three_vertices_connected[0];
-            const auto sn_candidate = sg[three_vertices_connected[0]];
-
-            /* Check if the edge points of the three vertices are able to be
-             * merged
-             *
-             * Not possible, it will generate duplicated edge_points if merged
-             * \  /
-             *  \/
-             *  |
-             *  /\
-             * /  \
-             * Possible: not duplicated edge points when merged
-             * \   /    \    /
-             *  \_/      \  /
-             *  |         \/
-             *  /\        /\
-             * /  \      /  \
-             *
-             */
-
-            // std::vector<std::pair<vertex_descriptor, vertex_descriptor>>
-            // outgoing_edges;
-            const auto out_edges =
-                    boost::out_edges(connected_vertex_candidate_to_remove, sg);
-            for (auto ei = out_edges.first; ei != out_edges.second; ++ei) {
-                auto target = boost::target(*ei, sg);
-                if (target == connected_vertex_candidate_to_remove) {
-                    continue;
-                }
-                const auto &edge_points = sg[*ei].edge_points;
-                std::vector<double> distances_to_candidate;
-                const auto ep_size = edge_points.size();
-                if (ep_size == 0) {
-                    continue;
-                }
-                if (ep_size == 1) {
-                    distances_to_candidate.emplace_back(
-                            ArrayUtilities::distance(edge_points[0],
-                                                     sn_candidate.pos));
-                }
-                if (ep_size > 1) {
-                    distances_to_candidate.emplace_back(
-                            ArrayUtilities::distance(edge_points[ep_size - 1],
-                                                     sn_candidate.pos));
-                }
-                // Check that any of the outgoing edge points (only check begin
-                // and end) touch (26_9 -- compute distance) the three connected
-                // vertex.
-                auto min_it =
-                        std::min_element(std::begin(distances_to_candidate),
-                                         std::end(distances_to_candidate));
-                auto min_dist = *min_it;
-                if (min_dist >
-                    sqrt(3.0) + 2.0 * std::numeric_limits<double>::epsilon()) {
-                    // Not possible for this edge
-                    continue;
-                } // else
-                nodes_to_remove.emplace_back(
-                        connected_vertex_candidate_to_remove, *vi, target);
-                // symmetry break: choose the first edge that is mergeable.
-                break;
-            }
-        }
-    }
-    SG::VertexDescriptorUnorderedSet removed_nodes;
-    // Connect new nodes to node_to_merge_into.
-    for (auto &node_triple : nodes_to_remove) {
-        auto &node_to_remove = std::get<0>(node_triple);
-        auto &node_to_merge_into = std::get<1>(node_triple);
-        auto &node_which_edge_does_not_require_add_point =
-                std::get<2>(node_triple);
-        auto edges = boost::out_edges(node_to_remove, sg);
-        // Create an edge to the node to merge into.
-        for (auto ei = edges.first; ei != edges.second; ++ei) {
-            auto target = boost::target(*ei, sg);
-            if (target == node_to_merge_into) {
-                continue;
-            }
-            if (target == node_which_edge_does_not_require_add_point) {
-                auto &spatial_edge = sg[*ei];
-                boost::add_edge(node_to_merge_into,
-                                node_which_edge_does_not_require_add_point,
-                                spatial_edge, sg);
-            } else {
-                auto &spatial_edge = sg[*ei];
-                auto &sn_to_remove = sg[node_to_remove];
-                SG::insert_unique_edge_point_with_distance_order(
-                        spatial_edge.edge_points, sn_to_remove.pos);
-                boost::add_edge(node_to_merge_into, target, spatial_edge, sg);
-            }
-        }
-        // Remove vertex destroys all iterators/descripts
-        // when using a vecS as vertex_intex_t
-        // boost::remove_vertex(node_to_remove, sg);
-        removed_nodes.insert(node_to_remove);
-        // clear vertex destroys all the edges, but the node is still there.
-        boost::clear_vertex(node_to_remove, sg);
-        node_was_merged++;
-    }
-
-    if (inPlace) {
-        sg = SG::filter_by_sets({}, removed_nodes, sg);
-    }
-
-    return node_was_merged;
-}
 } // end namespace SG
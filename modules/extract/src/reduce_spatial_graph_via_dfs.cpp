@@ -19,26 +19,41 @@
  * *******************************************************************/
 
 #include "reduce_spatial_graph_via_dfs.hpp"
+#include "parallel_for.hpp"
 #include "reduce_dfs_visitor.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+
 namespace SG {
 
-GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
+namespace {
+template <typename TGraph>
+void reduce_spatial_graph_via_dfs_impl(const TGraph &input_sg,
+                                       TGraph &sg,
                                        bool verbose) {
-    GraphType sg;
-    using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
-    using vertex_iterator = boost::graph_traits<GraphType>::vertex_iterator;
+    using vertex_descriptor =
+            typename boost::graph_traits<TGraph>::vertex_descriptor;
+    using vertex_iterator =
+            typename boost::graph_traits<TGraph>::vertex_iterator;
 
-    using ColorMap = std::map<vertex_descriptor, boost::default_color_type>;
-    ColorMap colorMap;
-    using Color = boost::color_traits<ColorMap::mapped_type>;
-    boost::associative_property_map<ColorMap> propColorMap(colorMap);
+    // vecS graph: the vertex_descriptor is the index in the color vector.
+    using ColorMap = std::vector<boost::default_color_type>;
+    using Color = boost::color_traits<typename ColorMap::value_type>;
+    ColorMap colorMap(boost::num_vertices(input_sg), Color::white());
+    auto propColorMap = boost::make_iterator_property_map(
+            colorMap.begin(), boost::get(boost::vertex_index, input_sg));
 
     // std::cout << "ReduceGraphVistor:" << std::endl;
     using VertexMap = std::unordered_map<vertex_descriptor, vertex_descriptor>;
     VertexMap vertex_map;
+    EdgesByEndpoints<TGraph> edges_by_endpoints;
     bool is_not_loop = false;
-    ReduceGraphVisitor<GraphType, VertexMap, ColorMap> vis(
-            sg, colorMap, vertex_map, is_not_loop, verbose);
+    ReduceGraphVisitor<TGraph, VertexMap, ColorMap> vis(
+            sg, colorMap, vertex_map, edges_by_endpoints, is_not_loop, verbose);
 
     // for each end vertex:
     vertex_iterator vi, vi_end;
@@ -49,7 +64,7 @@ GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
     // Stop the visit when find a non-chain (degree= 2) vertex.
     auto finish_on_junctions = [&start, &is_not_loop, &propColorMap,
                                 &verbose](vertex_descriptor u,
-                                          const GraphType &g) {
+                                          const TGraph &g) {
         // Do not terminate at the start.
         // The self-loop case is handled by back_edge (using is_not_loop)
         if (u == start) {
@@ -67,11 +82,6 @@ GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
         return false; // Do not terminate
     };
 
-    vertex_iterator ui, ui_end;
-    for (std::tie(ui, ui_end) = boost::vertices(input_sg); ui != ui_end; ++ui) {
-        put(propColorMap, *ui, Color::white());
-    }
-
     for (; vi != vi_end; ++vi) {
         auto degree = boost::out_degree(*vi, input_sg);
         if (degree == 1) {
@@ -102,12 +112,12 @@ GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
     {
         bool end_visit_flag = false;
         auto finish_on_end_visit_flag = [&end_visit_flag](vertex_descriptor /*unused*/,
-                                                        const GraphType & /*unused*/) {
+                                                        const TGraph & /*unused*/) {
             // finish if end_visit_flag is true
             return end_visit_flag;
         };
         // Detect self-loops (no degree > 2 in any vertex)
-        SelfLoopGraphVisitor<GraphType, VertexMap, ColorMap> vis_self_loop(
+        SelfLoopGraphVisitor<TGraph, VertexMap, ColorMap> vis_self_loop(
                 sg, colorMap, start, end_visit_flag);
         for (vi = vi_start; vi != vi_end; ++vi) {
             if (get(propColorMap, *vi) == Color::white() &&
@@ -125,7 +135,182 @@ GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
             }
         }
     }
+}
+
+template <typename TGraph>
+void reduce_spatial_graph_parallel_impl(const TGraph &input_sg,
+                                        TGraph &sg,
+                                        const size_t num_threads) {
+    using vertex_descriptor =
+            typename boost::graph_traits<TGraph>::vertex_descriptor;
+    using edge_descriptor =
+            typename boost::graph_traits<TGraph>::edge_descriptor;
+    using SpatialEdge = typename boost::edge_bundle_type<TGraph>::type;
+    constexpr auto null_vertex = std::numeric_limits<vertex_descriptor>::max();
+
+    /** Chain of vertices with degree 2 between two nodes. */
+    struct Chain {
+        vertex_descriptor source;
+        vertex_descriptor target;
+        SpatialEdge sg_edge;
+    };
+
+    const auto num_vertices = boost::num_vertices(input_sg);
+    const auto is_node = [&input_sg](const vertex_descriptor v) {
+        const auto degree = boost::out_degree(v, input_sg);
+        return degree == 1 || degree > 2;
+    };
+    // Next vertex of the chain, from the edge it was reached with.
+    const auto next_edge = [&input_sg](const vertex_descriptor v,
+                                       const edge_descriptor incoming) {
+        const auto out_edges = boost::out_edges(v, input_sg);
+        for (auto ei = out_edges.first; ei != out_edges.second; ++ei) {
+            if (*ei != incoming) {
+                return *ei;
+            }
+        }
+        return incoming;
+    };
+
+    // Walk the chains from each node in parallel. Each chain is walked from
+    // both of its ends, and kept only from the end where
+    // (node, first chain vertex) is lower, so no synchronization is needed.
+    std::map<size_t, std::vector<Chain>> chunk_chains;
+    std::mutex chunk_chains_mutex;
+    // Vertices of degree 2 already walked from a node.
+    std::vector<std::atomic<uint8_t>> in_chain(num_vertices);
+    parallel_for_chunks(
+            num_vertices,
+            [&](const size_t vertices_begin, const size_t vertices_end) {
+                std::vector<Chain> chains;
+                for (auto u = vertices_begin; u < vertices_end; ++u) {
+                    if (!is_node(u)) {
+                        continue;
+                    }
+                    const auto out_edges = boost::out_edges(u, input_sg);
+                    for (auto ei = out_edges.first; ei != out_edges.second;
+                         ++ei) {
+                        Chain chain{u, null_vertex, SpatialEdge()};
+                        auto incoming = *ei;
+                        auto v = boost::target(incoming, input_sg);
+                        const auto first = v;
+                        auto last = u;
+                        while (!is_node(v)) {
+                            in_chain[v].store(1, std::memory_order_relaxed);
+                            chain.sg_edge.edge_points.push_back(
+                                    input_sg[v].pos);
+                            last = v;
+                            incoming = next_edge(v, incoming);
+                            v = boost::target(incoming, input_sg);
+                        }
+                        chain.target = v;
+                        const bool is_direct_edge = (first == v);
+                        if (is_direct_edge
+                                    ? u < v
+                                    : std::make_pair(u, first) <
+                                              std::make_pair(v, last)) {
+                            chains.push_back(std::move(chain));
+                        }
+                    }
+                }
+                std::lock_guard<std::mutex> lock(chunk_chains_mutex);
+                chunk_chains.emplace(vertices_begin, std::move(chains));
+            },
+            num_threads);
+
+    // Add nodes and chains in the order of the input vertices,
+    // independently of the threads used.
+    std::vector<vertex_descriptor> node_map(num_vertices, null_vertex);
+    for (vertex_descriptor v = 0; v < num_vertices; ++v) {
+        if (is_node(v)) {
+            node_map[v] = boost::add_vertex(input_sg[v], sg);
+        }
+    }
+    EdgesByEndpoints<TGraph> edges_by_endpoints;
+    for (const auto &begin_chains : chunk_chains) {
+        for (const auto &chain : begin_chains.second) {
+            const auto source = node_map[chain.source];
+            if (chain.source == chain.target) {
+                // Loop, as in ReduceGraphVisitor::back_edge
+                if (chain.sg_edge.edge_points.size() > 1) {
+                    split_loop(source, chain.sg_edge, sg);
+                }
+            } else {
+                add_edge_if_not_duplicated(source, node_map[chain.target],
+                                           chain.sg_edge, sg,
+                                           edges_by_endpoints);
+            }
+        }
+    }
+
+    // Vertices of degree 2 not in any chain form cycles without nodes,
+    // handled as SelfLoopGraphVisitor does.
+    for (vertex_descriptor u = 0; u < num_vertices; ++u) {
+        if (boost::out_degree(u, input_sg) != 2 ||
+            in_chain[u].load(std::memory_order_relaxed)) {
+            continue;
+        }
+        const auto source = boost::add_vertex(input_sg[u], sg);
+        in_chain[u].store(1, std::memory_order_relaxed);
+        SpatialEdge sg_edge;
+        auto incoming = *boost::out_edges(u, input_sg).first;
+        auto v = boost::target(incoming, input_sg);
+        while (v != u) {
+            in_chain[v].store(1, std::memory_order_relaxed);
+            sg_edge.edge_points.push_back(input_sg[v].pos);
+            incoming = next_edge(v, incoming);
+            v = boost::target(incoming, input_sg);
+        }
+        if (sg_edge.edge_points.size() > 2) {
+            split_loop(source, sg_edge, sg);
+        }
+    }
+}
+} // namespace
+
+GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
+                                       bool verbose) {
+    GraphType sg;
+    reduce_spatial_graph_via_dfs_impl(input_sg, sg, verbose);
+    return sg;
+}
+
+GraphType2D reduce_spatial_graph_via_dfs(const GraphType2D &input_sg,
+                                         bool verbose) {
+    GraphType2D sg;
+    reduce_spatial_graph_via_dfs_impl(input_sg, sg, verbose);
+    return sg;
+}
+
+GraphTypeI32 reduce_spatial_graph_via_dfs(const GraphTypeI32 &input_sg,
+                                          bool verbose) {
+    GraphTypeI32 sg;
+    reduce_spatial_graph_via_dfs_impl(input_sg, sg, verbose);
+    return sg;
+}
+
+GraphType reduce_spatial_graph_parallel(const GraphType &input_sg,
+                                        const size_t num_threads) {
+    GraphType sg;
+    reduce_spatial_graph_parallel_impl(input_sg, sg, num_threads);
+    return sg;
+}
+
+GraphType2D reduce_spatial_graph_parallel(const GraphType2D &input_sg,
+                                          const size_t num_threads) {
+    GraphType2D sg;
+    reduce_spatial_graph_parallel_impl(input_sg, sg, num_threads);
+    return sg;
+}
 
+ArenaSpatialGraph
+reduce_spatial_graph_via_dfs(const ArenaSpatialGraph &input_sg,
+                             bool verbose) {
+    ArenaSpatialGraph sg;
+    // The edges of the output, and the temporary edges of the visitors,
+    // allocate from the output arena.
+    PointArena::Scope scope(sg.arena());
+    reduce_spatial_graph_via_dfs_impl(input_sg.graph(), sg.graph(), verbose);
     return sg;
 }
 } // namespace SG
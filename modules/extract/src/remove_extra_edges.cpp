@@ -19,6 +19,7 @@
  * *******************************************************************/
 
 #include "remove_extra_edges.hpp"
+#include "filter_spatial_graph.hpp"
 #include <tuple>
 
 namespace SG {
@@ -29,6 +30,8 @@ bool remove_extra_edges(GraphType &sg) {
     using vertex_iterator = boost::graph_traits<GraphType>::vertex_iterator;
     using adjacency_iterator =
             boost::graph_traits<GraphType>::adjacency_iterator;
+    using out_edge_iterator =
+            boost::graph_traits<GraphType>::out_edge_iterator;
     vertex_iterator vi, vi_end;
     std::vector<std::pair<vertex_descriptor, vertex_descriptor>>
             edges_to_remove;
@@ -92,13 +95,27 @@ bool remove_extra_edges(GraphType &sg) {
             }
         }
     }
+    // Remove all of them at once. Each pair removes the first of its edges
+    // not removed yet, the same edge that boost::edge would return if the
+    // edges were removed one by one. A pair found twice removes two
+    // parallel edges if there are.
+    EdgeDescriptorUnorderedSet remove_edges;
     for (auto &edge : edges_to_remove) {
-        auto edge_exist = boost::edge(edge.first, edge.second, sg);
-        if (edge_exist.second) {
-            boost::remove_edge(edge_exist.first, sg);
-            any_edge_was_removed = true;
+        out_edge_iterator ei, ei_end;
+        std::tie(ei, ei_end) = boost::out_edges(edge.first, sg);
+        for (; ei != ei_end; ++ei) {
+            if (boost::target(*ei, sg) == edge.second &&
+                !remove_edges.count(*ei)) {
+                remove_edges.insert(*ei);
+                any_edge_was_removed = true;
+                break;
+            }
         }
     }
+    if (any_edge_was_removed) {
+        // Vertices are not removed, their descriptors do not change.
+        compact_graph_in_place(sg, remove_edges, {});
+    }
     return any_edge_was_removed;
 }
 } // namespace SG
@@ -26,11 +26,13 @@
 
 namespace SG {
 
-void split_loop(GraphType::vertex_descriptor loop_vertex_id,
-                const boost::edge_bundle_type<GraphType>::type &sg_edge,
-                GraphType &input_sg) {
-    using SpatialEdge = boost::edge_bundle_type<GraphType>::type;
-    using SpatialNode = boost::vertex_bundle_type<GraphType>::type;
+namespace {
+template <typename TGraph>
+void split_loop_impl(
+        typename TGraph::vertex_descriptor loop_vertex_id,
+        const typename boost::edge_bundle_type<TGraph>::type &sg_edge,
+        TGraph &input_sg) {
+    using SpatialNode = typename boost::vertex_bundle_type<TGraph>::type;
     auto &edge_points = sg_edge.edge_points;
     size_t middle_index = edge_points.size() / 2;
     // std::cout << "VertexId:" << loop_vertex_id << " .EdgePoints.size():" <<
@@ -39,21 +41,44 @@ void split_loop(GraphType::vertex_descriptor loop_vertex_id,
     sg_node.pos = edge_points[middle_index];
     auto created_vertex_id = boost::add_vertex(sg_node, input_sg);
     auto nth = std::next(edge_points.begin(), middle_index);
-    SpatialEdge created_sg_edge1;
-    created_sg_edge1.edge_points.insert(std::end(created_sg_edge1.edge_points),
-                                        edge_points.begin(), nth);
-    SpatialEdge created_sg_edge2;
-    created_sg_edge2.edge_points.insert(std::end(created_sg_edge2.edge_points),
-                                        std::next(nth), edge_points.end());
-    boost::add_edge(loop_vertex_id, created_vertex_id, created_sg_edge1,
-                    input_sg);
-    boost::add_edge(loop_vertex_id, created_vertex_id, created_sg_edge2,
-                    input_sg);
+    // add_edge copies the edge bundle, fill the points of the added edges.
+    const auto created_edge1 =
+            boost::add_edge(loop_vertex_id, created_vertex_id, input_sg).first;
+    input_sg[created_edge1].edge_points.assign(edge_points.begin(), nth);
+    const auto created_edge2 =
+            boost::add_edge(loop_vertex_id, created_vertex_id, input_sg).first;
+    input_sg[created_edge2].edge_points.assign(std::next(nth),
+                                               edge_points.end());
     // std::cout << "Degree Original: " << boost::degree(loop_vertex_id,
     // input_sg)
     // << std::endl; std::cout << "Degree created: " <<
     // boost::degree(created_vertex_id, input_sg) << std::endl;
     boost::remove_edge(loop_vertex_id, loop_vertex_id, input_sg);
 }
+} // namespace
+
+void split_loop(GraphType::vertex_descriptor loop_vertex_id,
+                const boost::edge_bundle_type<GraphType>::type &sg_edge,
+                GraphType &input_sg) {
+    split_loop_impl(loop_vertex_id, sg_edge, input_sg);
+}
+
+void split_loop(GraphType2D::vertex_descriptor loop_vertex_id,
+                const boost::edge_bundle_type<GraphType2D>::type &sg_edge,
+                GraphType2D &input_sg) {
+    split_loop_impl(loop_vertex_id, sg_edge, input_sg);
+}
+
+void split_loop(GraphTypeI32::vertex_descriptor loop_vertex_id,
+                const boost::edge_bundle_type<GraphTypeI32>::type &sg_edge,
+                GraphTypeI32 &input_sg) {
+    split_loop_impl(loop_vertex_id, sg_edge, input_sg);
+}
+
+void split_loop(ArenaGraphType::vertex_descriptor loop_vertex_id,
+                const boost::edge_bundle_type<ArenaGraphType>::type &sg_edge,
+                ArenaGraphType &input_sg) {
+    split_loop_impl(loop_vertex_id, sg_edge, input_sg);
+}
 
 } // namespace SG
@@ -0,0 +1,159 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "stitch_tiled_graphs.hpp"
+#include "array_utilities.hpp"
+#include "filter_spatial_graph.hpp"
+#include "split_loop.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SG {
+
+namespace {
+TiledGraphStitcher::IndexType to_index(const PointType &pos) {
+    return {{std::lround(pos[0]), std::lround(pos[1]), std::lround(pos[2])}};
+}
+
+bool is_in_face(const TiledGraphStitcher::IndexType &index,
+                const TiledGraphStitcher::IndexType &begin,
+                const TiledGraphStitcher::IndexType &end) {
+    for (size_t d = 0; d < 3; ++d) {
+        if (index[d] == begin[d] || index[d] + 1 == end[d]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Append the edge points of the edge to points, ordered from the far end
+ * of the edge towards pos.
+ */
+void append_towards(const PointContainer &edge_points,
+                    const PointType &pos,
+                    PointContainer &points) {
+    if (!edge_points.empty() &&
+        ArrayUtilities::distance(edge_points.front(), pos) <
+                ArrayUtilities::distance(edge_points.back(), pos)) {
+        points.insert(points.end(), edge_points.rbegin(), edge_points.rend());
+    } else {
+        points.insert(points.end(), edge_points.begin(), edge_points.end());
+    }
+}
+} // namespace
+
+void TiledGraphStitcher::add_tile(const GraphType &tile_graph,
+                                  const IndexType &begin,
+                                  const IndexType &end) {
+    const size_t tile = m_num_tiles++;
+    const auto offset = boost::num_vertices(m_graph);
+    const auto num_tile_vertices = boost::num_vertices(tile_graph);
+    for (size_t v = 0; v < num_tile_vertices; ++v) {
+        boost::add_vertex(tile_graph[v], m_graph);
+    }
+    const auto edges = boost::edges(tile_graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        boost::add_edge(offset + boost::source(*ei, tile_graph),
+                        offset + boost::target(*ei, tile_graph),
+                        tile_graph[*ei], m_graph);
+    }
+    m_is_face_node.resize(offset + num_tile_vertices, 0);
+
+    for (size_t v = 0; v < num_tile_vertices; ++v) {
+        const auto index = to_index(tile_graph[v].pos);
+        if (!is_in_face(index, begin, end)) {
+            continue;
+        }
+        const auto vertex = offset + v;
+        m_is_face_node[vertex] = 1;
+        // Join with the face nodes of other tiles. Neighbors in this tile
+        // are already joined in tile_graph.
+        for (long dz = -1; dz <= 1; ++dz) {
+            for (long dy = -1; dy <= 1; ++dy) {
+                for (long dx = -1; dx <= 1; ++dx) {
+                    const IndexType neighbor = {
+                            {index[0] + dx, index[1] + dy, index[2] + dz}};
+                    const auto found = m_face_nodes.find(neighbor);
+                    if (found != m_face_nodes.end() &&
+                        found->second.tile != tile) {
+                        boost::add_edge(found->second.vertex, vertex,
+                                        m_graph);
+                    }
+                }
+            }
+        }
+        m_face_nodes.emplace(index, FaceNode{vertex, tile});
+    }
+}
+
+GraphType TiledGraphStitcher::stitch() {
+    // Dissolve the face nodes with degree 2. The degree of the other ends
+    // doesn't change, so a single pass is enough.
+    const auto num_vertices = boost::num_vertices(m_graph);
+    for (vertex_descriptor v = 0; v < num_vertices; ++v) {
+        if (!m_is_face_node[v] || boost::degree(v, m_graph) != 2) {
+            continue;
+        }
+        const auto out_edges = boost::out_edges(v, m_graph);
+        const auto first_edge = *out_edges.first;
+        const auto second_edge = *std::next(out_edges.first);
+        const auto first_end = boost::target(first_edge, m_graph);
+        const auto second_end = boost::target(second_edge, m_graph);
+        // The node of a cycle joined with itself.
+        if (first_end == v) {
+            continue;
+        }
+        const auto &pos = m_graph[v].pos;
+        SpatialEdge sg_edge;
+        append_towards(m_graph[first_edge].edge_points, pos,
+                       sg_edge.edge_points);
+        sg_edge.edge_points.push_back(pos);
+        const auto second_start = sg_edge.edge_points.size();
+        append_towards(m_graph[second_edge].edge_points, pos,
+                       sg_edge.edge_points);
+        std::reverse(std::next(sg_edge.edge_points.begin(), second_start),
+                     sg_edge.edge_points.end());
+        boost::clear_vertex(v, m_graph);
+        if (first_end == second_end) {
+            split_loop(first_end, sg_edge, m_graph);
+        } else {
+            boost::add_edge(first_end, second_end, sg_edge, m_graph);
+        }
+    }
+
+    // Remove the dissolved and isolated face nodes.
+    VertexDescriptorUnorderedSet remove_nodes;
+    for (vertex_descriptor v = 0; v < num_vertices; ++v) {
+        if (m_is_face_node[v] && boost::degree(v, m_graph) == 0) {
+            remove_nodes.insert(v);
+        }
+    }
+    GraphType stitched = filter_by_sets({}, remove_nodes, m_graph);
+
+    m_graph.clear();
+    m_is_face_node.clear();
+    m_face_nodes.clear();
+    m_num_tiles = 0;
+    return stitched;
+}
+
+} // namespace SG
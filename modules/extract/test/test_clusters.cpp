@@ -180,3 +180,43 @@ TEST_F(sg_clusters, collapse_specific_clusters) {
     EXPECT_EQ( boost::degree(3, collapsed_graph), 1);
 }
 
+
+TEST(detect_clusters_with_radius, label_is_lowest_close_neighbor) {
+    // Chain 0-1-2 with close edges, and 3 far away from 2.
+    SG::GraphType g(4);
+    g[0].pos = {{0, 0, 0}};
+    g[1].pos = {{1, 0, 0}};
+    g[2].pos = {{2, 0, 0}};
+    g[3].pos = {{10, 0, 0}};
+    boost::add_edge(1, 2, g);
+    boost::add_edge(0, 1, g);
+    boost::add_edge(2, 3, g);
+    boost::add_edge(3, 3, g);
+    const double cluster_radius = 1.5;
+    const auto cluster_label_map =
+            SG::detect_clusters_with_radius(g, cluster_radius, true, false, 1);
+    EXPECT_EQ(cluster_label_map.size(), 3);
+    EXPECT_EQ(cluster_label_map.at(0), 0);
+    EXPECT_EQ(cluster_label_map.at(1), 0);
+    // The cluster of a vertex only includes its own neighbors.
+    EXPECT_EQ(cluster_label_map.at(2), 1);
+    EXPECT_EQ(cluster_label_map.count(3), 0);
+}
+
+TEST(detect_clusters_with_radius, does_not_depend_on_num_threads) {
+    const size_t num_vertices = 5000;
+    SG::GraphType g(num_vertices);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        g[v].pos = {{static_cast<double>(v % 7), static_cast<double>(v), 0}};
+        if (v > 0) {
+            boost::add_edge(v - 1, v, g);
+        }
+    }
+    const double cluster_radius = 2.0;
+    const auto cluster_label_map_serial =
+            SG::detect_clusters_with_radius(g, cluster_radius, false, false, 1);
+    const auto cluster_label_map =
+            SG::detect_clusters_with_radius(g, cluster_radius, false, false, 4);
+    EXPECT_FALSE(cluster_label_map_serial.empty());
+    EXPECT_EQ(cluster_label_map_serial, cluster_label_map);
+}
@@ -6,6 +6,7 @@
 #include <DGtal/topology/Object.h>
 #include <iostream>
 
+#include "filter_spatial_graph.hpp"
 #include "merge_nodes.hpp"
 #include "reduce_spatial_graph_via_dfs.hpp"
 #include "remove_extra_edges.hpp"
@@ -291,3 +292,179 @@ TEST_F(ContourLengthCornercase2Fixture, merge_nodes) {
     // // renderWindowInteractor->Initialize();
     // renderWindowInteractor->Start();
 }
+
+/**
+ * num_triangles triangles of degree 3 nodes, each node with a leaf.
+ *   o       o
+ *   |       |
+ *   o-------o
+ *    \     /
+ *     \   /
+ *      \ /
+ *       o
+ *       |
+ *       o
+ */
+SG::GraphType triangles_with_leaves(const size_t num_triangles) {
+    SG::GraphType sg(6 * num_triangles);
+    for (size_t t = 0; t < num_triangles; ++t) {
+        const size_t first = 6 * t;
+        const double x = 10.0 * t;
+        sg[first + 0].pos = {x, 0, 0};
+        sg[first + 1].pos = {x + 1, 1, 0};
+        sg[first + 2].pos = {x + 1, 0, 1};
+        sg[first + 3].pos = {x - 3, 0, 0};
+        sg[first + 4].pos = {x + 1, 4, 0};
+        sg[first + 5].pos = {x + 1, 0, 4};
+        boost::add_edge(first + 0, first + 1, sg);
+        boost::add_edge(first + 1, first + 2, sg);
+        boost::add_edge(first + 0, first + 2, sg);
+        for (size_t n = 0; n < 3; ++n) {
+            auto leaf_edge = SG::SpatialEdge();
+            const auto &node_pos = sg[first + n].pos;
+            const auto &leaf_pos = sg[first + n + 3].pos;
+            for (size_t i = 1; i < 3; ++i) {
+                leaf_edge.edge_points.push_back(
+                        {node_pos[0] + i * (leaf_pos[0] - node_pos[0]) / 3,
+                         node_pos[1] + i * (leaf_pos[1] - node_pos[1]) / 3,
+                         node_pos[2] + i * (leaf_pos[2] - node_pos[2]) / 3});
+            }
+            boost::add_edge(first + n, first + n + 3, leaf_edge, sg);
+        }
+    }
+    return sg;
+}
+
+TEST(merge_nodes_plan, three_connected) {
+    const auto sg = triangles_with_leaves(1);
+    const auto plan =
+            SG::plan_merge_nodes(sg, SG::MergeNodesType::three_connected, 1);
+    ASSERT_EQ(plan.merges.size(), 2);
+    EXPECT_EQ(plan.merges[0].node_to_remove, 1);
+    EXPECT_EQ(plan.merges[0].node_to_merge_into, 0);
+    EXPECT_EQ(plan.merges[1].node_to_remove, 2);
+    EXPECT_EQ(plan.merges[1].node_to_merge_into, 0);
+    ASSERT_EQ(plan.triangles.size(), 1);
+    EXPECT_EQ(plan.triangles[0][0], 1);
+    EXPECT_EQ(plan.triangles[0][1], 2);
+    EXPECT_EQ(plan.triangles[0][2], 0);
+
+    auto merged_sg = sg;
+    const bool inPlace = false;
+    EXPECT_EQ(SG::apply_merge_nodes_plan(merged_sg, plan, inPlace), 2);
+    EXPECT_EQ(boost::num_vertices(merged_sg), 6);
+    EXPECT_EQ(boost::num_edges(merged_sg), 3);
+    EXPECT_EQ(boost::out_degree(0, merged_sg), 3);
+    EXPECT_EQ(boost::out_degree(1, merged_sg), 0);
+    EXPECT_EQ(boost::out_degree(2, merged_sg), 0);
+    // The removed nodes are now part of the edges to the leaves.
+    const auto edge_to_leaf = boost::edge(0, 4, merged_sg);
+    ASSERT_TRUE(edge_to_leaf.second);
+    const auto &edge_points = merged_sg[edge_to_leaf.first].edge_points;
+    ASSERT_EQ(edge_points.size(), 3);
+    EXPECT_EQ(edge_points[0], sg[1].pos);
+
+    auto merged_inplace_sg = sg;
+    EXPECT_EQ(SG::merge_three_connected_nodes(merged_inplace_sg), 2);
+    EXPECT_EQ(boost::num_vertices(merged_inplace_sg), 4);
+    EXPECT_EQ(boost::num_edges(merged_inplace_sg), 3);
+
+    // Removing the nodes left with degree 0 gives the in place result.
+    const auto compacted = SG::compact_graph(
+            merged_sg, {}, SG::degree_zero_vertices(merged_sg));
+    ASSERT_EQ(boost::num_vertices(compacted.graph), 4);
+    EXPECT_EQ(boost::num_edges(compacted.graph), 3);
+    for (size_t v = 0; v < 4; ++v) {
+        EXPECT_EQ(compacted.graph[v].pos, merged_inplace_sg[v].pos);
+        EXPECT_EQ(boost::out_degree(v, compacted.graph),
+                  boost::out_degree(v, merged_inplace_sg));
+    }
+}
+
+TEST(merge_nodes_plan, does_not_depend_on_num_threads) {
+    const auto sg = triangles_with_leaves(1000);
+    for (const auto type : {SG::MergeNodesType::three_connected,
+                            SG::MergeNodesType::four_connected,
+                            SG::MergeNodesType::two_three_connected}) {
+        const auto plan_serial = SG::plan_merge_nodes(sg, type, 1);
+        const auto plan_parallel = SG::plan_merge_nodes(sg, type, 4);
+        ASSERT_EQ(plan_serial.merges.size(), plan_parallel.merges.size());
+        for (size_t i = 0; i < plan_serial.merges.size(); ++i) {
+            EXPECT_EQ(plan_serial.merges[i].node_to_remove,
+                      plan_parallel.merges[i].node_to_remove);
+            EXPECT_EQ(plan_serial.merges[i].node_to_merge_into,
+                      plan_parallel.merges[i].node_to_merge_into);
+            EXPECT_EQ(plan_serial.merges[i].node_with_unchanged_edge,
+                      plan_parallel.merges[i].node_with_unchanged_edge);
+        }
+        EXPECT_EQ(plan_serial.triangles, plan_parallel.triangles);
+    }
+    auto merged_sg = sg;
+    EXPECT_EQ(SG::merge_three_connected_nodes(merged_sg, true, 4), 2000);
+    EXPECT_EQ(boost::num_vertices(merged_sg), 4000);
+    EXPECT_EQ(boost::num_edges(merged_sg), 3000);
+}
+
+TEST(parallel_edges, buckets_and_loops) {
+    SG::GraphType sg(3);
+    auto edge_points = SG::SpatialEdge();
+    edge_points.edge_points = {{1, 0, 0}, {2, 0, 0}};
+    auto reversed_edge_points = SG::SpatialEdge();
+    reversed_edge_points.edge_points = {{2, 0, 0}, {1, 0, 0}};
+    auto other_edge_points = SG::SpatialEdge();
+    other_edge_points.edge_points = {{1, 1, 0}, {2, 1, 0}, {3, 1, 0}};
+    // Three parallel edges between 0 and 1, two of them are equal.
+    boost::add_edge(0, 1, edge_points, sg);
+    boost::add_edge(1, 0, reversed_edge_points, sg);
+    boost::add_edge(0, 1, other_edge_points, sg);
+    boost::add_edge(1, 2, sg);
+    // Two loops in 2
+    boost::add_edge(2, 2, edge_points, sg);
+    boost::add_edge(2, 2, other_edge_points, sg);
+
+    const auto parallel_edges = SG::get_parallel_edges(sg, true, 1);
+    ASSERT_EQ(parallel_edges.size(), 4);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(boost::source(parallel_edges[i].first, sg), 0);
+        EXPECT_EQ(boost::target(parallel_edges[i].first, sg), 1);
+    }
+    EXPECT_EQ(boost::source(parallel_edges[3].first, sg), 2);
+    EXPECT_EQ(boost::target(parallel_edges[3].first, sg), 2);
+    EXPECT_NE(parallel_edges[3].first, parallel_edges[3].second);
+
+    // Each pair also from the other end vertex.
+    EXPECT_EQ(SG::get_parallel_edges(sg, false, 1).size(), 7);
+
+    const auto equal_parallel_edges =
+            SG::get_equal_parallel_edges(parallel_edges, sg, 1);
+    ASSERT_EQ(equal_parallel_edges.size(), 1);
+    EXPECT_EQ(equal_parallel_edges[0], parallel_edges[0]);
+
+    const auto sg_no_parallel = SG::remove_parallel_edges(sg, true, 1);
+    EXPECT_EQ(boost::num_edges(sg_no_parallel), 3);
+    const auto remaining_edge = boost::edge(0, 1, sg_no_parallel);
+    ASSERT_TRUE(remaining_edge.second);
+    // The largest edge is kept.
+    EXPECT_EQ(sg_no_parallel[remaining_edge.first].edge_points,
+              other_edge_points.edge_points);
+}
+
+TEST(parallel_edges, does_not_depend_on_num_threads) {
+    const size_t num_vertices = 5000;
+    SG::GraphType sg(num_vertices);
+    for (size_t v = 0; v + 1 < num_vertices; ++v) {
+        auto spatial_edge = SG::SpatialEdge();
+        spatial_edge.edge_points = {{static_cast<double>(v), 1, 0}};
+        boost::add_edge(v, v + 1, spatial_edge, sg);
+        if (v % 3 == 0) {
+            boost::add_edge(v + 1, v, spatial_edge, sg);
+        }
+    }
+    const auto parallel_edges_serial = SG::get_parallel_edges(sg, true, 1);
+    const auto parallel_edges = SG::get_parallel_edges(sg, true, 4);
+    EXPECT_EQ(parallel_edges_serial.size(), 1667);
+    EXPECT_EQ(parallel_edges_serial, parallel_edges);
+    EXPECT_EQ(SG::get_parallel_edges_of_vertices(sg, 0, 10).size(), 4);
+    EXPECT_EQ(SG::get_equal_parallel_edges(parallel_edges, sg, 4).size(),
+              1667);
+}
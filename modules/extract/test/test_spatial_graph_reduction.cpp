@@ -6,6 +6,7 @@
 #include <DGtal/topology/Object.h>
 #include <iostream>
 
+#include "convert_spatial_graph.hpp"
 #include "merge_nodes.hpp"
 #include "reduce_spatial_graph_via_dfs.hpp"
 #include "remove_extra_edges.hpp"
@@ -801,6 +802,92 @@ TEST_F(sg_square, reduce_graph) {
     EXPECT_EQ(equal_edge_points(reduced_g, expected_g), true);
 }
 
+TEST_F(sg_square, reduce_graph_arena) {
+    const auto arena_sg = SG::to_arena_spatial_graph(g);
+    const auto reduced_arena_sg =
+            SG::reduce_spatial_graph_via_dfs(arena_sg);
+    const auto reduced_g = SG::to_spatial_graph(reduced_arena_sg.graph());
+    EXPECT_EQ(num_vertices(reduced_g), 2);
+    EXPECT_EQ(num_edges(reduced_g), 2);
+    const auto expected_g = SG::reduce_spatial_graph_via_dfs(g);
+    EXPECT_EQ(equal_vertex_positions(reduced_g, expected_g), true);
+    EXPECT_EQ(equal_edge_points(reduced_g, expected_g), true);
+}
+
+TEST_F(sg_square, reduce_graph_parallel) {
+    const auto reduced_g = SG::reduce_spatial_graph_parallel(g);
+    EXPECT_EQ(num_vertices(reduced_g), 2);
+    EXPECT_EQ(num_edges(reduced_g), 2);
+    const auto expected_g = sg_square_expected().g;
+    EXPECT_EQ(equal_vertex_positions(reduced_g, expected_g), true);
+    EXPECT_EQ(equal_edge_points(reduced_g, expected_g), true);
+}
+
+/**
+ * 2D Spatial Graph with 8-connected branches
+ *
+ *       o
+ *      /
+ *     o
+ *    / \
+ *   o   o
+ *  /     \
+ * o       o
+ */
+TEST(reduce_graph_2D, branches) {
+    using SpatialGraph = SG::GraphType2D;
+    SpatialGraph sg(6);
+    sg[0].pos = {{0, 0}};
+    sg[1].pos = {{1, 1}};
+    sg[2].pos = {{2, 2}};
+    sg[3].pos = {{3, 3}};
+    sg[4].pos = {{3, 1}};
+    sg[5].pos = {{4, 0}};
+    boost::add_edge(0, 1, sg);
+    boost::add_edge(1, 2, sg);
+    boost::add_edge(2, 3, sg);
+    boost::add_edge(2, 4, sg);
+    boost::add_edge(4, 5, sg);
+    const SpatialGraph reduced_g = SG::reduce_spatial_graph_via_dfs(sg);
+    EXPECT_EQ(num_vertices(reduced_g), 4);
+    EXPECT_EQ(num_edges(reduced_g), 3);
+    std::vector<SG::PointType2D> all_edge_points;
+    for (auto ep = boost::edges(reduced_g); ep.first != ep.second;
+         ++ep.first) {
+        const auto &eps = reduced_g[*ep.first].edge_points;
+        all_edge_points.insert(std::end(all_edge_points), std::begin(eps),
+                               std::end(eps));
+    }
+    std::sort(std::begin(all_edge_points), std::end(all_edge_points));
+    const std::vector<SG::PointType2D> expected_edge_points = {{{1, 1}},
+                                                               {{3, 1}}};
+    EXPECT_EQ(all_edge_points, expected_edge_points);
+
+    // Same result than reducing the graph in 3D.
+    const auto reduced_g_3d =
+            SG::reduce_spatial_graph_via_dfs(SG::embed_spatial_graph_in_3d(sg));
+    EXPECT_EQ(equal_vertex_positions(SG::embed_spatial_graph_in_3d(reduced_g),
+                                     reduced_g_3d),
+              true);
+    EXPECT_EQ(equal_edge_points(SG::embed_spatial_graph_in_3d(reduced_g),
+                                reduced_g_3d),
+              true);
+
+    // Same result with the parallel reduction, with any number of threads.
+    for (const size_t num_threads : {1, 2, 4}) {
+        const auto reduced_parallel_g =
+                SG::reduce_spatial_graph_parallel(sg, num_threads);
+        EXPECT_EQ(equal_vertex_positions(
+                          SG::embed_spatial_graph_in_3d(reduced_parallel_g),
+                          reduced_g_3d),
+                  true);
+        EXPECT_EQ(equal_edge_points(
+                          SG::embed_spatial_graph_in_3d(reduced_parallel_g),
+                          reduced_g_3d),
+                  true);
+    }
+}
+
 TEST_F(sg_square_plus_one, reduce_graph) {
     std::cout << "Reduce graph - square plus one" << std::endl;
     using SpatialGraph = SpatialGraphBaseFixture::GraphType;
@@ -816,6 +903,104 @@ TEST_F(sg_square_plus_one, reduce_graph) {
     EXPECT_EQ(equal_edge_points(reduced_g, expected_g), true);
 }
 
+TEST_F(sg_square_plus_one, reduce_graph_parallel) {
+    const auto reduced_g = SG::reduce_spatial_graph_parallel(g);
+    EXPECT_EQ(num_vertices(reduced_g), 3);
+    EXPECT_EQ(num_edges(reduced_g), 3);
+    const auto expected_g = SG::reduce_spatial_graph_via_dfs(g);
+    EXPECT_EQ(equal_vertex_positions(reduced_g, expected_g), true);
+    EXPECT_EQ(equal_edge_points(reduced_g, expected_g), true);
+}
+
+/**
+ * Many components, each one with an end node, a junction with a loop and
+ * a cycle without nodes:
+ *
+ *    o           o-o
+ *   / \         /   \
+ *  o   o       o     o
+ *   \ /         \   /
+ *    o            o
+ *    |
+ *    o
+ *    |
+ *    o
+ */
+TEST(reduce_graph_parallel, many_components) {
+    using SpatialGraph = SpatialGraphBaseFixture::GraphType;
+    SpatialGraph sg;
+    const size_t num_components = 300;
+    for (size_t i = 0; i < num_components; ++i) {
+        const double x = 10.0 * i;
+        const auto add_vertex = [&sg](const SG::PointType &pos) {
+            const auto v = boost::add_vertex(sg);
+            sg[v].pos = pos;
+            return v;
+        };
+        const auto end = add_vertex({{x, 0, 0}});
+        const auto a1 = add_vertex({{x, 1, 0}});
+        const auto a2 = add_vertex({{x, 2, 0}});
+        const auto junction = add_vertex({{x, 3, 0}});
+        const auto l1 = add_vertex({{x + 1, 4, 0}});
+        const auto l2 = add_vertex({{x, 5, 0}});
+        const auto l3 = add_vertex({{x - 1, 4, 0}});
+        boost::add_edge(end, a1, sg);
+        boost::add_edge(a1, a2, sg);
+        boost::add_edge(a2, junction, sg);
+        boost::add_edge(junction, l1, sg);
+        boost::add_edge(l1, l2, sg);
+        boost::add_edge(l2, l3, sg);
+        boost::add_edge(l3, junction, sg);
+        std::vector<SpatialGraph::vertex_descriptor> cycle;
+        for (size_t c = 0; c < 5; ++c) {
+            cycle.push_back(add_vertex({{x + c % 2, 10.0 + c, 0}}));
+        }
+        for (size_t c = 0; c < 5; ++c) {
+            boost::add_edge(cycle[c], cycle[(c + 1) % 5], sg);
+        }
+    }
+    const auto expected_g = SG::reduce_spatial_graph_via_dfs(sg);
+    // end, junction, loop node, and two nodes per cycle.
+    EXPECT_EQ(num_vertices(expected_g), 5 * num_components);
+    EXPECT_EQ(num_edges(expected_g), 5 * num_components);
+
+    const auto reduced_g = SG::reduce_spatial_graph_parallel(sg, 1);
+    EXPECT_EQ(num_vertices(reduced_g), num_vertices(expected_g));
+    EXPECT_EQ(num_edges(reduced_g), num_edges(expected_g));
+    EXPECT_EQ(equal_vertex_positions(reduced_g, expected_g), true);
+    EXPECT_EQ(equal_edge_points(reduced_g, expected_g), true);
+
+    // The output does not depend on the number of threads.
+    const auto reduced_threads_g = SG::reduce_spatial_graph_parallel(sg, 3);
+    EXPECT_EQ(all_vertex_positions(reduced_threads_g),
+              all_vertex_positions(reduced_g));
+    EXPECT_EQ(all_edge_points(reduced_threads_g), all_edge_points(reduced_g));
+}
+
+TEST_F(sg_square_plus_one, reduce_graph_arena) {
+    const auto arena_sg = SG::to_arena_spatial_graph(g);
+    const auto reduced_arena_sg =
+            SG::reduce_spatial_graph_via_dfs(arena_sg);
+    const auto reduced_g = SG::to_spatial_graph(reduced_arena_sg.graph());
+    const auto expected_g = SG::reduce_spatial_graph_via_dfs(g);
+    EXPECT_EQ(num_vertices(reduced_g), num_vertices(expected_g));
+    EXPECT_EQ(num_edges(reduced_g), num_edges(expected_g));
+    EXPECT_EQ(equal_vertex_positions(reduced_g, expected_g), true);
+    EXPECT_EQ(equal_edge_points(reduced_g, expected_g), true);
+}
+
+TEST_F(sg_square_plus_one, reduce_graph_index_space) {
+    const SG::GraphTypeI32 index_g = SG::convert_spatial_graph<int32_t>(g);
+    const SG::GraphTypeI32 reduced_index_g =
+            SG::reduce_spatial_graph_via_dfs(index_g);
+    const auto reduced_g = SG::convert_spatial_graph<double>(reduced_index_g);
+    const auto expected_g = SG::reduce_spatial_graph_via_dfs(g);
+    EXPECT_EQ(num_vertices(reduced_g), num_vertices(expected_g));
+    EXPECT_EQ(num_edges(reduced_g), num_edges(expected_g));
+    EXPECT_EQ(equal_vertex_positions(reduced_g, expected_g), true);
+    EXPECT_EQ(equal_edge_points(reduced_g, expected_g), true);
+}
+
 /**
  * In 3D, structure that  gives more nodes than expected.
  * Domain::Point p0(0, 0, 0);
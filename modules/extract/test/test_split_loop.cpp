@@ -40,3 +40,17 @@ TEST(split_loop, split_loop) {
         EXPECT_EQ(equal_edge_points, true);
     }
 }
+
+TEST(split_loop, split_loop_2D) {
+    using SpatialGraph = SG::GraphType2D;
+    using SpatialEdge = typename boost::edge_bundle_type<SpatialGraph>::type;
+    auto sg = SpatialGraph(1);
+    sg[0].pos = {{0, 0}};
+    SpatialEdge sg_edge;
+    sg_edge.edge_points = {{{0, 1}}, {{1, 1}}, {{1, 0}}};
+    boost::add_edge(0, 0, sg_edge, sg);
+    SG::split_loop(0, sg_edge, sg);
+    EXPECT_EQ(num_vertices(sg), 2);
+    EXPECT_EQ(num_edges(sg), 2);
+    EXPECT_EQ(sg[1].pos, (SG::PointType2D{{1, 1}}));
+}
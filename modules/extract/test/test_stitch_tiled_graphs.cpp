@@ -0,0 +1,140 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "stitch_tiled_graphs.hpp"
+
+#include "gmock/gmock.h"
+
+namespace {
+/** Line of voxels along x, in y = z = 1. */
+SG::PointType line_point(const double x) { return {{x, 1, 1}}; }
+} // namespace
+
+TEST(stitch_tiled_graphs, line_across_tiles) {
+    // Line from x = 0 to 11, cut by tiles of size 4 in x.
+    SG::TiledGraphStitcher stitcher;
+    for (long begin = 0; begin < 12; begin += 4) {
+        SG::GraphType tile_graph(2);
+        tile_graph[0].pos = line_point(begin);
+        tile_graph[1].pos = line_point(begin + 3);
+        SG::SpatialEdge sg_edge;
+        sg_edge.edge_points = {line_point(begin + 1), line_point(begin + 2)};
+        boost::add_edge(0, 1, sg_edge, tile_graph);
+        stitcher.add_tile(tile_graph, {{begin, 0, 0}}, {{begin + 4, 3, 3}});
+    }
+    EXPECT_EQ(stitcher.num_tiles(), 3);
+    EXPECT_EQ(stitcher.num_face_nodes(), 6);
+    const auto stitched = stitcher.stitch();
+    EXPECT_EQ(stitcher.num_tiles(), 0);
+    ASSERT_EQ(boost::num_vertices(stitched), 2);
+    ASSERT_EQ(boost::num_edges(stitched), 1);
+    EXPECT_EQ(stitched[0].pos, line_point(0));
+    EXPECT_EQ(stitched[1].pos, line_point(11));
+    const auto edge = *boost::edges(stitched).first;
+    auto points = stitched[edge].edge_points;
+    if (points.front() != line_point(1)) {
+        std::reverse(points.begin(), points.end());
+    }
+    SG::PointContainer expected;
+    for (double x = 1; x < 11; ++x) {
+        expected.push_back(line_point(x));
+    }
+    EXPECT_EQ(points, expected);
+}
+
+TEST(stitch_tiled_graphs, junction_and_isolated_voxel_in_face) {
+    // Tile [0, 3): end point at x = 0, chain to the face node at x = 2.
+    // Tile [3, 6): junction at x = 3 in the face, with two branches.
+    // Isolated voxel in the face of the second tile, at (5, 5, 5).
+    SG::TiledGraphStitcher stitcher;
+    {
+        SG::GraphType tile_graph(2);
+        tile_graph[0].pos = {{0, 2, 2}};
+        tile_graph[1].pos = {{2, 2, 2}};
+        SG::SpatialEdge sg_edge;
+        sg_edge.edge_points = {{{1, 2, 2}}};
+        boost::add_edge(0, 1, sg_edge, tile_graph);
+        stitcher.add_tile(tile_graph, {{0, 0, 0}}, {{3, 6, 6}});
+    }
+    {
+        SG::GraphType tile_graph(4);
+        tile_graph[0].pos = {{3, 2, 2}};
+        tile_graph[1].pos = {{5, 0, 0}};
+        tile_graph[2].pos = {{5, 4, 4}};
+        tile_graph[3].pos = {{5, 5, 5}};
+        SG::SpatialEdge up;
+        up.edge_points = {{{4, 1, 1}}};
+        boost::add_edge(0, 1, up, tile_graph);
+        SG::SpatialEdge down;
+        down.edge_points = {{{4, 3, 3}}};
+        boost::add_edge(0, 2, down, tile_graph);
+        stitcher.add_tile(tile_graph, {{3, 0, 0}}, {{6, 6, 6}});
+    }
+    const auto stitched = stitcher.stitch();
+    // The face node at x = 2 is dissolved, the isolated voxel removed.
+    ASSERT_EQ(boost::num_vertices(stitched), 4);
+    EXPECT_EQ(boost::num_edges(stitched), 3);
+    EXPECT_EQ(stitched[0].pos, (SG::PointType{{0, 2, 2}}));
+    EXPECT_EQ(stitched[1].pos, (SG::PointType{{3, 2, 2}}));
+    EXPECT_EQ(boost::degree(1, stitched), 3);
+    const auto edge = boost::edge(0, 1, stitched);
+    ASSERT_TRUE(edge.second);
+    EXPECT_EQ(stitched[edge.first].edge_points,
+              (SG::PointContainer{{{1, 2, 2}}, {{2, 2, 2}}}));
+}
+
+TEST(stitch_tiled_graphs, cycle_across_tiles) {
+    // Square cycle in z = 1, cut in two by the tiles [0, 2) and [2, 4) in x.
+    // All its voxels are face nodes with degree 2.
+    SG::TiledGraphStitcher stitcher;
+    for (long begin = 0; begin < 4; begin += 2) {
+        const double x0 = begin;
+        const double x1 = begin + 1;
+        const double y0 = 0;
+        const double y1 = 3;
+        SG::GraphType tile_graph(4);
+        tile_graph[0].pos = {{x0, y0, 1}};
+        tile_graph[1].pos = {{x1, y0, 1}};
+        tile_graph[2].pos = {{x0, y1, 1}};
+        tile_graph[3].pos = {{x1, y1, 1}};
+        boost::add_edge(0, 1, tile_graph);
+        boost::add_edge(2, 3, tile_graph);
+        if (begin == 0) {
+            SG::SpatialEdge side;
+            side.edge_points = {{{x0, 1, 1}}, {{x0, 2, 1}}};
+            boost::add_edge(0, 2, side, tile_graph);
+        } else {
+            SG::SpatialEdge side;
+            side.edge_points = {{{x1, 1, 1}}, {{x1, 2, 1}}};
+            boost::add_edge(1, 3, side, tile_graph);
+        }
+        stitcher.add_tile(tile_graph, {{begin, 0, 0}}, {{begin + 2, 4, 3}});
+    }
+    const auto stitched = stitcher.stitch();
+    // A cycle is split in two nodes, as split_loop does.
+    EXPECT_EQ(boost::num_vertices(stitched), 2);
+    EXPECT_EQ(boost::num_edges(stitched), 2);
+    size_t num_points = boost::num_vertices(stitched);
+    const auto edges = boost::edges(stitched);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        num_points += stitched[*ei].edge_points.size();
+    }
+    EXPECT_EQ(num_points, 12);
+}
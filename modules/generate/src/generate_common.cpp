@@ -19,6 +19,7 @@
  * *******************************************************************/
 
 #include "generate_common.hpp"
+#include "array_utilities_batch.hpp"
 #include "rng.hpp"
 #include "spatial_graph_utilities.hpp" // for AdjacentVerticesPositions
 #include <tuple>                       // for std::tie
@@ -56,9 +57,13 @@ PointType generate_random_array(const double &max_modulus) {
     return RNG::random_orientation(rand_modulus);
 }
 
+// The edges adjacent to a single node are a handful, called for every
+// step of the annealing: a scalar loop is faster than filling batches.
 std::vector<double> cosine_directors_from_connected_edges(
         const std::vector<VectorType> &outgoing_edges) {
     std::vector<double> cosine_directors;
+    const auto num_edges = outgoing_edges.size();
+    cosine_directors.reserve(num_edges * (num_edges - (num_edges > 0)) / 2);
     for (auto first = outgoing_edges.begin(); first != outgoing_edges.end();
          ++first) {
         for (auto second = first + 1; second != outgoing_edges.end();
@@ -86,31 +91,33 @@ std::vector<double> cosine_directors_between_edges_and_target_edge(
 std::vector<double> get_all_end_to_end_distances_of_edges(
         const GraphType &graph, const ArrayUtilities::boundary_condition &bc) {
 
-    std::vector<double> unordered_distances;
+    ArrayUtilities::Array3DBatch sources;
+    ArrayUtilities::Array3DBatch targets;
+    sources.reserve(boost::num_edges(graph));
+    targets.reserve(boost::num_edges(graph));
     auto edges = boost::edges(graph);
     for (auto ei = edges.first, e_end = edges.second; ei != e_end; ++ei) {
-        auto source = boost::source(*ei, graph);
-        auto target = boost::target(*ei, graph);
-        double dist;
-        if (bc == ArrayUtilities::boundary_condition::NONE) {
-            dist = ArrayUtilities::distance(graph[target].pos,
-                                            graph[source].pos);
-        } else if (bc == ArrayUtilities::boundary_condition::PERIODIC) {
-            dist = ArrayUtilities::distance_with_boundary_condition_periodic(
-                    graph[target].pos, graph[source].pos);
-        }
-        unordered_distances.push_back(dist);
+        sources.push_back(graph[boost::source(*ei, graph)].pos);
+        targets.push_back(graph[boost::target(*ei, graph)].pos);
+    }
+    if (bc == ArrayUtilities::boundary_condition::PERIODIC) {
+        return ArrayUtilities::distances_with_boundary_condition_periodic(
+                targets, sources);
     }
-    return unordered_distances;
+    return ArrayUtilities::distances(targets, sources);
 }
 
 std::vector<double> get_all_cosine_directors_between_connected_edges(
         const GraphType &graph, const ArrayUtilities::boundary_condition &bc) {
 
-    std::vector<double> unordered_cosines;
+    // Gather the pairs of edges of all vertices, and compute all the cosines
+    // at once.
+    ArrayUtilities::Array3DBatch firsts;
+    ArrayUtilities::Array3DBatch seconds;
+    std::vector<VectorType> outgoing_edges;
     auto [vi, vi_end] = boost::vertices(graph);
     for (; vi != vi_end; ++vi) {
-        std::vector<VectorType> outgoing_edges;
+        outgoing_edges.clear();
         auto [ei, ei_end] = boost::out_edges(*vi, graph);
         for (; ei != ei_end; ++ei) {
             const auto source_pos = graph[source(*ei, graph)].pos;
@@ -123,13 +130,16 @@ std::vector<double> get_all_cosine_directors_between_connected_edges(
             outgoing_edges.push_back(
                     ArrayUtilities::minus(target_image_pos, source_pos));
         }
-        const auto cosine_directors_from_vertex =
-                cosine_directors_from_connected_edges(outgoing_edges);
-        unordered_cosines.insert(std::end(unordered_cosines),
-                                 std::begin(cosine_directors_from_vertex),
-                                 std::end(cosine_directors_from_vertex));
+        for (auto first = outgoing_edges.cbegin();
+             first != outgoing_edges.cend(); ++first) {
+            for (auto second = first + 1; second != outgoing_edges.cend();
+                 ++second) {
+                firsts.push_back(*first);
+                seconds.push_back(*second);
+            }
+        }
     }
-    return unordered_cosines;
+    return ArrayUtilities::cos_directors(firsts, seconds);
 }
 
 std::vector<VectorType> get_adjacent_edges_from_source(
@@ -21,13 +21,15 @@
 #ifndef SG_CREATE_VERTEX_TO_RADIUS_MAP_HPP
 #define SG_CREATE_VERTEX_TO_RADIUS_MAP_HPP
 
+#include "graph_attributes.hpp" // for VertexAttribute
 #include "image_types.hpp" // for image types
 #include "spatial_graph.hpp"
-#include "transform_to_physical_point.hpp" // for physical_space_array_to_index_array
+#include "transform_to_physical_point.hpp" // for transform_points_to_index_space
 
 #include <boost/graph/filtered_graph.hpp> // for create_vertex_to_radius_map
 #include <boost/core/ignore_unused.hpp>
 #include <unordered_map>
+#include <vector>
 
 namespace SG {
 
@@ -35,7 +37,8 @@ using VertexToRadiusMap =
         std::unordered_map<typename GraphType::vertex_descriptor, double>;
 
 /**
- * Create a vertex to local radius map from a distance map and a graph.
+ * Create a column with the local radius of each vertex, from a distance map
+ * and a graph. Indexed by vertex_descriptor, see @ref VertexAttribute.
  *
  * @tparam TGraph to work with filter_graphs as well.
  *
@@ -47,29 +50,39 @@ using VertexToRadiusMap =
  *  false indicates that positions are in index space. See @sa transform_to_physical_point
  * @param verbose extra information at execution
  *
- * @return vertex to local radius map using the distance map
+ * @return local radius of each vertex using the distance map
  */
 template<typename TGraph>
-VertexToRadiusMap create_vertex_to_radius_map(
+VertexAttribute<double> create_vertex_radius_attribute(
         const typename FloatImageType::Pointer &distance_map_image,
         const TGraph &input_graph,
         const bool spatial_nodes_position_are_in_physical_space = false,
         const bool verbose = false)
 {
     boost::ignore_unused(verbose);
-    VertexToRadiusMap vertex_to_local_radius_map;
-    // Iterate over all nodes
+    VertexAttribute<double> vertex_radius(boost::num_vertices(input_graph));
+    // Gather the positions of all nodes, to transform them to index space
+    // at once.
     using vertex_iterator = typename boost::graph_traits<TGraph>::vertex_iterator;
     vertex_iterator vi, vi_end;
+    std::vector<PointType> positions;
     std::tie(vi, vi_end) = boost::vertices(input_graph);
     for (; vi != vi_end; vi++) {
+        positions.push_back(input_graph[*vi].pos);
+    }
+    if (spatial_nodes_position_are_in_physical_space) {
+        transform_points_to_index_space(
+                positions,
+                make_image_space_transform(distance_map_image.GetPointer()));
+    }
+
+    size_t position_index = 0;
+    std::tie(vi, vi_end) = boost::vertices(input_graph);
+    for (; vi != vi_end; vi++, position_index++) {
         // Get the value of the distance map image associated to the position of
         // the node
-        const auto spatial_node_position_index_space =
-                spatial_nodes_position_are_in_physical_space
-                        ? physical_space_array_to_index_array(
-                                  input_graph[*vi].pos, distance_map_image.GetPointer())
-                        : input_graph[*vi].pos;
+        const auto &spatial_node_position_index_space =
+                positions[position_index];
 
         // Transform index_position to ITK IndexType
         typename FloatImageType::IndexType pixel_index;
@@ -78,11 +91,39 @@ VertexToRadiusMap create_vertex_to_radius_map(
         }
 
         const auto dmap_value = distance_map_image->GetPixel(pixel_index);
-        // Populate the output map
-        vertex_to_local_radius_map.emplace(*vi, static_cast<double>(dmap_value));
+        // Populate the output column
+        vertex_radius.emplace(*vi, static_cast<double>(dmap_value));
     }
 
-    return vertex_to_local_radius_map;
+    return vertex_radius;
+}
+
+/**
+ * Create a vertex to local radius map from a distance map and a graph.
+ * Same than @ref create_vertex_radius_attribute, returning a hash map.
+ *
+ * @tparam TGraph to work with filter_graphs as well.
+ *
+ * @param distance_map_image obtained from a binary image @sa
+ * create_distance_map_function
+ * @param input_graph input spatial graph to get the vertices/nodes
+ * @param spatial_nodes_position_are_in_physical_space flag to check if
+ *  position of nodes were already converted to physical space, or are still in index space.
+ *  false indicates that positions are in index space. See @sa transform_to_physical_point
+ * @param verbose extra information at execution
+ *
+ * @return vertex to local radius map using the distance map
+ */
+template<typename TGraph>
+VertexToRadiusMap create_vertex_to_radius_map(
+        const typename FloatImageType::Pointer &distance_map_image,
+        const TGraph &input_graph,
+        const bool spatial_nodes_position_are_in_physical_space = false,
+        const bool verbose = false)
+{
+    return to_unordered_map(create_vertex_radius_attribute(
+            distance_map_image, input_graph,
+            spatial_nodes_position_are_in_physical_space, verbose));
 }
 
 // explicit instantiation in create_vertex_to_radius_map.cpp
@@ -91,6 +132,12 @@ extern template VertexToRadiusMap create_vertex_to_radius_map<GraphType>(
         const GraphType &input_graph,
         const bool spatial_nodes_position_are_in_physical_space,
         const bool /*verbose*/);
+extern template VertexAttribute<double>
+create_vertex_radius_attribute<GraphType>(
+        const typename FloatImageType::Pointer &distance_map_image,
+        const GraphType &input_graph,
+        const bool spatial_nodes_position_are_in_physical_space,
+        const bool /*verbose*/);
 
 } // end namespace SG
 #endif
@@ -0,0 +1,181 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_FOREGROUND_ROWS_HPP
+#define SG_FOREGROUND_ROWS_HPP
+
+#include "parallel_for.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Sparse representation of the foreground (non-zero) pixels of a 2D or 3D
+ * binary image, used to build spatial graphs from thin images without
+ * hashing any point.
+ *
+ * The image is seen as num_rows = size_y * size_z rows along x (2D images
+ * have size_z = 1). The foreground pixels are numbered in the order of the
+ * image buffer, and the pixels of a row are [row_offsets[row],
+ * row_offsets[row + 1]), with their x coordinates sorted in xs.
+ * Coordinates are relative to the start of the buffered region.
+ */
+struct ForegroundRows {
+    static constexpr size_t invalid_pixel = std::numeric_limits<size_t>::max();
+
+    size_t size_x = 0;
+    size_t size_y = 0;
+    size_t size_z = 0;
+    /** Start index of the buffered region, (x, y, z). */
+    std::array<long, 3> start = {{0, 0, 0}};
+    std::vector<size_t> row_offsets;
+    std::vector<size_t> xs;
+
+    size_t num_rows() const { return size_y * size_z; }
+    /** Number of foreground pixels. */
+    size_t size() const { return xs.size(); }
+    size_t row(const size_t y, const size_t z) const { return z * size_y + y; }
+
+    /** Foreground pixel at (x, y, z), or invalid_pixel if background. */
+    size_t find(const long x, const long y, const long z) const {
+        if (x < 0 || y < 0 || z < 0 || x >= static_cast<long>(size_x) ||
+            y >= static_cast<long>(size_y) || z >= static_cast<long>(size_z)) {
+            return invalid_pixel;
+        }
+        const auto r = row(static_cast<size_t>(y), static_cast<size_t>(z));
+        const auto first = xs.begin() + row_offsets[r];
+        const auto last = xs.begin() + row_offsets[r + 1];
+        const auto it = std::lower_bound(first, last, static_cast<size_t>(x));
+        return (it != last && *it == static_cast<size_t>(x))
+                       ? static_cast<size_t>(it - xs.begin())
+                       : invalid_pixel;
+    }
+
+    /**
+     * Call func(neighbor, nx, ny, nz) for each foreground neighbor of the
+     * pixel at (x, y, z): 26-connectivity in 3D, 8-connectivity in 2D.
+     * Neighbors are visited in the order of the image buffer.
+     */
+    template <typename TFunction>
+    void for_each_neighbor(const long x,
+                           const long y,
+                           const long z,
+                           TFunction &&func) const {
+        for (long nz = z - 1; nz <= z + 1; ++nz) {
+            if (nz < 0 || nz >= static_cast<long>(size_z)) {
+                continue;
+            }
+            for (long ny = y - 1; ny <= y + 1; ++ny) {
+                if (ny < 0 || ny >= static_cast<long>(size_y)) {
+                    continue;
+                }
+                const auto r =
+                        row(static_cast<size_t>(ny), static_cast<size_t>(nz));
+                const auto first_x = static_cast<size_t>(std::max(x - 1, 0L));
+                const auto last = row_offsets[r + 1];
+                auto neighbor = static_cast<size_t>(
+                        std::lower_bound(xs.begin() + row_offsets[r],
+                                         xs.begin() + last, first_x) -
+                        xs.begin());
+                for (; neighbor < last &&
+                       static_cast<long>(xs[neighbor]) <= x + 1;
+                     ++neighbor) {
+                    const long nx = static_cast<long>(xs[neighbor]);
+                    if (nx == x && ny == y && nz == z) {
+                        continue;
+                    }
+                    func(neighbor, nx, ny, nz);
+                }
+            }
+        }
+    }
+};
+
+/**
+ * Scan the buffer of the image in parallel and return its ForegroundRows.
+ *
+ * @tparam TImage 2D or 3D itk::Image
+ * @param image input binary image
+ * @param num_threads 0 to use all the hardware threads.
+ */
+template <typename TImage>
+ForegroundRows foreground_rows(const TImage *image,
+                               const size_t num_threads = 0) {
+    constexpr unsigned int Dimension = TImage::ImageDimension;
+    static_assert(Dimension == 2 || Dimension == 3,
+                  "foreground_rows: only 2D and 3D images.");
+    const auto region = image->GetBufferedRegion();
+    const auto &start = region.GetIndex();
+    const auto &size = region.GetSize();
+    const auto *buffer = image->GetBufferPointer();
+
+    ForegroundRows rows;
+    rows.size_x = size[0];
+    rows.size_y = size[1];
+    rows.size_z = Dimension == 3 ? size[Dimension - 1] : 1;
+    for (unsigned int d = 0; d < Dimension; ++d) {
+        rows.start[d] = static_cast<long>(start[d]);
+    }
+    const size_t size_x = rows.size_x;
+    const size_t num_rows = rows.num_rows();
+
+    // Count the foreground pixels of each row, to number them.
+    rows.row_offsets.assign(num_rows + 1, 0);
+    parallel_for_chunks(
+            num_rows,
+            [&](const size_t rows_begin, const size_t rows_end) {
+                for (size_t row = rows_begin; row < rows_end; ++row) {
+                    const auto *row_buffer = buffer + row * size_x;
+                    size_t count = 0;
+                    for (size_t x = 0; x < size_x; ++x) {
+                        count += (row_buffer[x] != 0);
+                    }
+                    rows.row_offsets[row + 1] = count;
+                }
+            },
+            num_threads);
+    std::partial_sum(rows.row_offsets.begin(), rows.row_offsets.end(),
+                     rows.row_offsets.begin());
+
+    rows.xs.resize(rows.row_offsets[num_rows]);
+    parallel_for_chunks(
+            num_rows,
+            [&](const size_t rows_begin, const size_t rows_end) {
+                for (size_t row = rows_begin; row < rows_end; ++row) {
+                    const auto *row_buffer = buffer + row * size_x;
+                    auto pixel = rows.row_offsets[row];
+                    for (size_t x = 0; x < size_x; ++x) {
+                        if (row_buffer[x] != 0) {
+                            rows.xs[pixel++] = x;
+                        }
+                    }
+                }
+            },
+            num_threads);
+    return rows;
+}
+
+} // end namespace SG
+#endif
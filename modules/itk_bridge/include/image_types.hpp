@@ -27,6 +27,7 @@ namespace SG {
     constexpr unsigned int BinaryImageDimension = 3;
     using BinaryImagePixelType = unsigned char;
     using BinaryImageType = itk::Image<BinaryImagePixelType, BinaryImageDimension>;
+    using BinaryImageType2D = itk::Image<BinaryImagePixelType, 2>;
 
     constexpr unsigned int FloatImageDimension = 3;
     using FloatImagePixelType = float;
@@ -0,0 +1,610 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_PARALLEL_THINNING_HPP
+#define SG_PARALLEL_THINNING_HPP
+
+#include "bit_packed_volume.hpp"
+#include "parallel_for.hpp"
+#include "sparse_binary_image.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Offsets (x, y, z) of the 26 neighbors of a voxel, with z the slowest.
+ * The i-th neighbor is the i-th bit in the configurations of
+ * @ref parallel_thinning when neighbor_masks[i] = 1 << i.
+ */
+inline std::array<std::array<int, 3>, 26> neighbor26_offsets() {
+    std::array<std::array<int, 3>, 26> offsets;
+    size_t index = 0;
+    for (int dz = -1; dz <= 1; ++dz) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0 && dz == 0) {
+                    continue;
+                }
+                offsets[index++] = {{dx, dy, dz}};
+            }
+        }
+    }
+    return offsets;
+}
+
+namespace detail {
+/**
+ * State of parallel_thinning between iterations. It can be copied to
+ * continue the thinning from the same point with other parameters.
+ */
+struct ParallelThinningState {
+    BitPackedVolume foreground;
+    /** Voxels kept in the skeleton. */
+    BitPackedVolume constrained;
+    BitPackedVolume queued;
+    /** Iteration (starting at 1) in which is_skel held for the first time. */
+    std::unordered_map<size_t, uint32_t> births;
+    /** Voxels to evaluate in the next iteration, sorted. */
+    std::vector<size_t> candidates;
+    /** Last finished iteration. */
+    uint32_t iteration = 0;
+    /** True when the last iteration removed no voxel. */
+    bool finished = false;
+};
+
+/**
+ * Crop the foreground of the image to its bounding box, and queue the
+ * voxels with a background 6-neighbor.
+ */
+template <typename TImage>
+ParallelThinningState
+parallel_thinning_initial_state(const TImage *input_image,
+                                const size_t num_threads) {
+    static_assert(TImage::ImageDimension == 3,
+                  "parallel_thinning: only 3D images.");
+    const auto &size = input_image->GetBufferedRegion().GetSize();
+    const auto *input_buffer = input_image->GetBufferPointer();
+    ParallelThinningState state;
+
+    // Bounding box of the foreground, in buffer coordinates.
+    const size_t num_image_rows = size[1] * size[2];
+    BitPackedVolume::IndexType box_begin = {{size[0], size[1], size[2]}};
+    BitPackedVolume::IndexType box_last = {{0, 0, 0}};
+    std::mutex box_mutex;
+    parallel_for_chunks(
+            num_image_rows,
+            [&](const size_t rows_begin, const size_t rows_end) {
+                BitPackedVolume::IndexType chunk_begin = {
+                        {size[0], size[1], size[2]}};
+                BitPackedVolume::IndexType chunk_last = {{0, 0, 0}};
+                for (size_t row = rows_begin; row < rows_end; ++row) {
+                    const auto *row_buffer = input_buffer + row * size[0];
+                    const BitPackedVolume::IndexType yz = {
+                            {0, row % size[1], row / size[1]}};
+                    for (size_t x = 0; x < size[0]; ++x) {
+                        if (row_buffer[x] == 0) {
+                            continue;
+                        }
+                        chunk_begin[0] = std::min(chunk_begin[0], x);
+                        chunk_last[0] = std::max(chunk_last[0], x);
+                        for (size_t i = 1; i < 3; ++i) {
+                            chunk_begin[i] = std::min(chunk_begin[i], yz[i]);
+                            chunk_last[i] = std::max(chunk_last[i], yz[i]);
+                        }
+                    }
+                }
+                std::lock_guard<std::mutex> lock(box_mutex);
+                for (size_t i = 0; i < 3; ++i) {
+                    box_begin[i] = std::min(box_begin[i], chunk_begin[i]);
+                    box_last[i] = std::max(box_last[i], chunk_last[i]);
+                }
+            },
+            num_threads, 64);
+    if (box_begin[0] > box_last[0]) {
+        state.finished = true;
+        return state;
+    }
+    const BitPackedVolume::SizeType box_size = {
+            {box_last[0] - box_begin[0] + 1, box_last[1] - box_begin[1] + 1,
+             box_last[2] - box_begin[2] + 1}};
+
+    // One bit per voxel of the box for each state. Each row of the box
+    // has its own words, so rows can be written concurrently.
+    state.foreground = BitPackedVolume(box_begin, box_size);
+    state.constrained = BitPackedVolume(box_begin, box_size);
+    state.queued = BitPackedVolume(box_begin, box_size);
+    auto &foreground = state.foreground;
+    const size_t num_rows = foreground.num_rows();
+    parallel_for_chunks(
+            num_rows,
+            [&](const size_t rows_begin, const size_t rows_end) {
+                for (size_t row = rows_begin; row < rows_end; ++row) {
+                    const size_t y = box_begin[1] + row % box_size[1];
+                    const size_t z = box_begin[2] + row / box_size[1];
+                    const auto *row_buffer =
+                            input_buffer + size[0] * (y + size[1] * z);
+                    const auto row_voxel =
+                            foreground.voxel({{box_begin[0], y, z}});
+                    for (size_t x = 0; x < box_size[0]; ++x) {
+                        if (row_buffer[box_begin[0] + x] != 0) {
+                            foreground.set(row_voxel + x);
+                        }
+                    }
+                }
+            },
+            num_threads, 64);
+
+    // Queue the voxels with a background 6-neighbor.
+    constexpr uint32_t face_neighbors = (1u << 4) | (1u << 10) | (1u << 12) |
+                                        (1u << 14) | (1u << 16) | (1u << 22);
+    foreground.for_each_in_rows(0, num_rows, [&](const size_t voxel) {
+        if ((foreground.neighborhood(voxel) & face_neighbors) !=
+            face_neighbors) {
+            state.queued.set(voxel);
+            state.candidates.push_back(voxel);
+        }
+    });
+    return state;
+}
+
+/**
+ * True if the next iteration might keep a voxel with min_persistence that
+ * is not kept with persistence, i.e. a voxel satisfying is_skel could have
+ * an age in [min_persistence, persistence).
+ */
+inline bool parallel_thinning_may_diverge(const ParallelThinningState &state,
+                                          const int min_persistence,
+                                          const int persistence) {
+    if (min_persistence == persistence) {
+        return false;
+    }
+    // Voxels satisfying is_skel for the first time have age 0.
+    if (min_persistence == 0) {
+        return true;
+    }
+    const uint32_t next_iteration = state.iteration + 1;
+    for (const auto &birth : state.births) {
+        const auto age = next_iteration - birth.second;
+        if (age >= static_cast<uint32_t>(min_persistence) &&
+            age < static_cast<uint32_t>(persistence)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Run one iteration of parallel_thinning with persistence.
+ *
+ * @param min_persistence lower persistence sharing the state.
+ *
+ * @return the largest age in [min_persistence, persistence) of the voxels
+ * satisfying is_skel that were not kept, or -1 if none. The iteration
+ * would have been the same for the persistence values greater than it.
+ */
+template <typename TIsSimple, typename TIsSkel>
+int parallel_thinning_iteration(
+        ParallelThinningState &state,
+        const NeighborhoodConfigurationMap &to_configuration,
+        const TIsSimple &is_simple,
+        const TIsSkel &is_skel,
+        const int persistence,
+        const int min_persistence,
+        const size_t num_threads,
+        const bool verbose) {
+    auto &foreground = state.foreground;
+    auto &constrained = state.constrained;
+    auto &queued = state.queued;
+    auto &births = state.births;
+    std::array<std::ptrdiff_t, 26> neighbors;
+    const auto offsets = neighbor26_offsets();
+    for (size_t i = 0; i < 26; ++i) {
+        neighbors[i] = foreground.offset(offsets[i][0], offsets[i][1],
+                                         offsets[i][2]);
+    }
+
+    const uint32_t iteration = ++state.iteration;
+    enum Decision : uint8_t { none, removed, kept, waiting };
+    std::array<std::vector<size_t>, 8> subfields;
+    for (const auto voxel : state.candidates) {
+        queued.reset(voxel);
+        subfields[foreground.parity(voxel)].push_back(voxel);
+    }
+    std::vector<uint8_t> decisions;
+    std::vector<size_t> next_candidates;
+    size_t num_removed = 0;
+    int diverging_age = -1;
+    std::mutex diverging_age_mutex;
+    for (const auto &voxels : subfields) {
+        decisions.assign(voxels.size(), none);
+        // The voxels of a subfield are not neighbors of each other, so
+        // their decisions don't depend on the decisions of the others,
+        // and can be applied after all of them are taken.
+        parallel_for_chunks(
+                voxels.size(),
+                [&](const size_t begin, const size_t end) {
+                    int chunk_diverging_age = -1;
+                    for (size_t i = begin; i < end; ++i) {
+                        const auto voxel = voxels[i];
+                        if (constrained.test(voxel)) {
+                            continue;
+                        }
+                        const auto config = to_configuration(
+                                foreground.neighborhood(voxel));
+                        if (is_skel(config)) {
+                            if (persistence == 0) {
+                                decisions[i] = kept;
+                                continue;
+                            }
+                            const auto birth = births.find(voxel);
+                            const uint32_t age =
+                                    birth == births.end()
+                                            ? 0
+                                            : iteration - birth->second;
+                            if (age >= static_cast<uint32_t>(persistence)) {
+                                decisions[i] = kept;
+                                continue;
+                            }
+                            if (age >= static_cast<uint32_t>(
+                                               min_persistence)) {
+                                chunk_diverging_age =
+                                        std::max(chunk_diverging_age,
+                                                 static_cast<int>(age));
+                            }
+                            decisions[i] = waiting;
+                        }
+                        if (is_simple(config)) {
+                            decisions[i] = removed;
+                        }
+                    }
+                    if (chunk_diverging_age >= 0) {
+                        std::lock_guard<std::mutex> lock(diverging_age_mutex);
+                        diverging_age =
+                                std::max(diverging_age, chunk_diverging_age);
+                    }
+                },
+                num_threads, 256);
+        // Apply the decisions, and queue the neighbors of the removed
+        // voxels and the voxels waiting for persistence.
+        const size_t num_voxels = voxels.size();
+        for (size_t i = 0; i < num_voxels; ++i) {
+            const auto voxel = voxels[i];
+            if (decisions[i] == kept) {
+                constrained.set(voxel);
+                continue;
+            }
+            if (decisions[i] == waiting) {
+                births.emplace(voxel, iteration);
+                if (!queued.test(voxel)) {
+                    queued.set(voxel);
+                    next_candidates.push_back(voxel);
+                }
+                continue;
+            }
+            if (decisions[i] != removed) {
+                continue;
+            }
+            ++num_removed;
+            foreground.reset(voxel);
+            for (const auto neighbor : neighbors) {
+                const size_t next = voxel + neighbor;
+                if (foreground.test(next) && !constrained.test(next) &&
+                    !queued.test(next)) {
+                    queued.set(next);
+                    next_candidates.push_back(next);
+                }
+            }
+        }
+    }
+    if (verbose) {
+        std::cout << "parallel_thinning: iteration " << iteration
+                  << " removed " << num_removed << " voxels." << std::endl;
+    }
+    std::sort(next_candidates.begin(), next_candidates.end());
+    state.candidates.swap(next_candidates);
+    state.finished = num_removed == 0 || state.candidates.empty();
+    return diverging_age;
+}
+
+/** Image with the foreground of the state, with value 255. */
+template <typename TImage>
+typename TImage::Pointer
+parallel_thinning_image(const ParallelThinningState &state,
+                        const TImage *input_image,
+                        const size_t num_threads) {
+    const auto region = input_image->GetBufferedRegion();
+    const auto &size = region.GetSize();
+    auto output_image = TImage::New();
+    output_image->SetRegions(region);
+    output_image->CopyInformation(input_image);
+    output_image->Allocate();
+    output_image->FillBuffer(0);
+    auto *output_buffer = output_image->GetBufferPointer();
+    const auto &foreground = state.foreground;
+    parallel_for_chunks(
+            foreground.num_rows(),
+            [&](const size_t rows_begin, const size_t rows_end) {
+                foreground.for_each_in_rows(
+                        rows_begin, rows_end, [&](const size_t voxel) {
+                            const auto index = foreground.index(voxel);
+                            output_buffer[index[0] +
+                                          size[0] * (index[1] +
+                                                     size[1] * index[2])] =
+                                    255;
+                        });
+            },
+            num_threads, 64);
+    return output_image;
+}
+
+/** Foreground of the state, with the metadata of the input image. */
+inline SparseBinaryImage
+parallel_thinning_sparse_image(const ParallelThinningState &state,
+                               const BinaryImageType *input_image) {
+    SparseBinaryImage sparse_image;
+    copy_image_information(input_image, sparse_image);
+    const auto &start = sparse_image.region.GetIndex();
+    const auto &foreground = state.foreground;
+    sparse_image.indices.reserve(foreground.count());
+    // Voxels are visited in the order of the image buffer.
+    foreground.for_each_in_rows(
+            0, foreground.num_rows(), [&](const size_t voxel) {
+                const auto index = foreground.index(voxel);
+                SparseBinaryImage::IndexType image_index;
+                for (unsigned int d = 0; d < 3; ++d) {
+                    image_index[d] =
+                            start[d] + static_cast<long>(index[d]);
+                }
+                sparse_image.indices.push_back(image_index);
+            });
+    return sparse_image;
+}
+
+/**
+ * Thin the persistence values sharing the iterations, see
+ * @ref parallel_thinning_sweep. make_output(state) creates the output of a
+ * group of values from their final state.
+ */
+template <typename TImage,
+          typename TIsSimple,
+          typename TIsSkel,
+          typename TMakeOutput>
+auto parallel_thinning_sweep(const TImage *input_image,
+                             const std::array<uint32_t, 26> &neighbor_masks,
+                             const TIsSimple &is_simple,
+                             const TIsSkel &is_skel,
+                             const std::vector<int> &persistences,
+                             const size_t num_threads,
+                             const bool verbose,
+                             const TMakeOutput &make_output)
+        -> std::vector<decltype(make_output(
+                std::declval<const ParallelThinningState &>()))> {
+    using OutputType = decltype(
+            make_output(std::declval<const ParallelThinningState &>()));
+    for (const auto persistence : persistences) {
+        if (persistence < 0) {
+            throw std::runtime_error("parallel_thinning: persistence must "
+                                     "be non-negative, but it is " +
+                                     std::to_string(persistence) + ".");
+        }
+    }
+    std::vector<int> values(persistences);
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    const NeighborhoodConfigurationMap to_configuration(neighbor_masks);
+
+    // Each branch thins the values [first, last), that have the same state.
+    struct Branch {
+        detail::ParallelThinningState state;
+        size_t first;
+        size_t last;
+    };
+    std::vector<OutputType> thin_outputs(values.size());
+    std::vector<Branch> branches;
+    if (!values.empty()) {
+        branches.push_back(
+                {detail::parallel_thinning_initial_state(input_image,
+                                                         num_threads),
+                 0, values.size()});
+    }
+    while (!branches.empty()) {
+        Branch branch = std::move(branches.back());
+        branches.pop_back();
+        auto &state = branch.state;
+        while (!state.finished) {
+            const int min_persistence = values[branch.first];
+            const int persistence = values[branch.last - 1];
+            if (!detail::parallel_thinning_may_diverge(state, min_persistence,
+                                                       persistence)) {
+                detail::parallel_thinning_iteration(
+                        state, to_configuration, is_simple, is_skel,
+                        persistence, min_persistence, num_threads, verbose);
+                continue;
+            }
+            auto checkpoint = state;
+            const int diverging_age = detail::parallel_thinning_iteration(
+                    state, to_configuration, is_simple, is_skel, persistence,
+                    min_persistence, num_threads, verbose);
+            if (diverging_age < 0) {
+                continue;
+            }
+            // Values up to diverging_age keep more voxels, they continue
+            // from the checkpoint.
+            const auto split = static_cast<size_t>(
+                    std::upper_bound(values.begin() + branch.first,
+                                     values.begin() + branch.last,
+                                     diverging_age) -
+                    values.begin());
+            if (verbose) {
+                std::cout << "parallel_thinning: persistence values up to "
+                          << diverging_age << " diverge in iteration "
+                          << state.iteration << "." << std::endl;
+            }
+            branches.push_back({std::move(checkpoint), branch.first, split});
+            branch.first = split;
+        }
+        thin_outputs[branch.first] = make_output(state);
+        for (size_t i = branch.first + 1; i < branch.last; ++i) {
+            thin_outputs[i] = thin_outputs[branch.first];
+        }
+    }
+
+    std::vector<OutputType> outputs;
+    outputs.reserve(persistences.size());
+    for (const auto persistence : persistences) {
+        outputs.push_back(thin_outputs[static_cast<size_t>(
+                std::lower_bound(values.begin(), values.end(), persistence) -
+                values.begin())]);
+    }
+    return outputs;
+}
+} // namespace detail
+
+/**
+ * Thin a 3D binary image removing simple voxels in parallel, for several
+ * persistence values at once.
+ *
+ * The thinning of all the values is the same until a voxel satisfying
+ * is_skel reaches the persistence of some of them. The state is copied
+ * before the iterations where this can happen, and the values that keep a
+ * different set of voxels continue from the copy, so the iterations
+ * before the divergence are shared. See @ref parallel_thinning for the
+ * other parameters.
+ *
+ * @param persistences non-negative persistence values, in any order.
+ *
+ * @return thin images, one per value of persistences, in the same order.
+ */
+template <typename TImage, typename TIsSimple, typename TIsSkel>
+std::vector<typename TImage::Pointer>
+parallel_thinning_sweep(const TImage *input_image,
+                        const std::array<uint32_t, 26> &neighbor_masks,
+                        const TIsSimple &is_simple,
+                        const TIsSkel &is_skel,
+                        const std::vector<int> &persistences,
+                        const size_t num_threads = 0,
+                        const bool verbose = false) {
+    return detail::parallel_thinning_sweep(
+            input_image, neighbor_masks, is_simple, is_skel, persistences,
+            num_threads, verbose,
+            [input_image,
+             num_threads](const detail::ParallelThinningState &state) {
+                return detail::parallel_thinning_image(state, input_image,
+                                                       num_threads);
+            });
+}
+
+/**
+ * Same than @ref parallel_thinning_sweep, but the thin images are returned
+ * as their foreground voxels, without creating the dense images.
+ *
+ * @return thin images, one per value of persistences, in the same order.
+ */
+template <typename TIsSimple, typename TIsSkel>
+std::vector<SparseBinaryImage>
+parallel_thinning_sparse_sweep(const BinaryImageType *input_image,
+                               const std::array<uint32_t, 26> &neighbor_masks,
+                               const TIsSimple &is_simple,
+                               const TIsSkel &is_skel,
+                               const std::vector<int> &persistences,
+                               const size_t num_threads = 0,
+                               const bool verbose = false) {
+    return detail::parallel_thinning_sweep(
+            input_image, neighbor_masks, is_simple, is_skel, persistences,
+            num_threads, verbose,
+            [input_image](const detail::ParallelThinningState &state) {
+                return detail::parallel_thinning_sparse_image(state,
+                                                              input_image);
+            });
+}
+
+/**
+ * Thin a 3D binary image removing simple voxels in parallel.
+ *
+ * Each iteration visits the voxels that might have changed (initially the
+ * voxels with a background 6-neighbor) in 8 sub-iterations, one per
+ * subfield: the voxels with the same parity of x, y and z. Voxels of a
+ * subfield are not 26-neighbors, so removing the simple voxels of a
+ * subfield at once preserves the topology, and the predicates of each
+ * voxel only read voxels of other subfields. The voxels of a subfield are
+ * evaluated concurrently, and the result doesn't depend on the number of
+ * threads.
+ *
+ * Voxels satisfying is_skel are kept in the skeleton (as the set K of the
+ * asymmetric thinning of DGtal). With persistence > 0, a voxel is only
+ * kept when is_skel holds persistence iterations after it held for the
+ * first time, the meanwhile it can be removed if it is simple.
+ *
+ * The predicates receive the configuration of the 26-neighborhood of a
+ * voxel: the bitwise or of neighbor_masks[i] of each foreground neighbor
+ * i, with the order of @ref neighbor26_offsets. Use the masks of the
+ * look-up tables, for example the ones of
+ * DGtal::functions::mapZeroPointNeighborhoodToConfigurationMask.
+ *
+ * The foreground is cropped to its bounding box and stored in
+ * BitPackedVolume, with one bit per voxel for the foreground, the voxels
+ * kept in the skeleton and the queued voxels. The configurations are
+ * computed from the words of the volume with NeighborhoodConfigurationMap.
+ *
+ * The result is topologically equivalent to the thinning of
+ * asymetricThinningScheme with the same predicates, but not voxel by
+ * voxel: there are no cliques to select from, the object is peeled
+ * symmetrically from its border.
+ *
+ * @tparam TImage 3D itk::Image
+ * @param input_image binary image, foreground is any non-zero value.
+ * @param neighbor_masks configuration bit of each neighbor.
+ * @param is_simple predicate on the configuration, true if the voxel is
+ * simple.
+ * @param is_skel predicate on the configuration, true if the voxel has to
+ * be kept in the skeleton.
+ * @param persistence number of iterations is_skel has to hold.
+ * @param num_threads 0 to use all the hardware threads.
+ * @param verbose print the voxels removed in each iteration.
+ *
+ * @return thin image, with value 255 in the foreground.
+ */
+template <typename TImage, typename TIsSimple, typename TIsSkel>
+typename TImage::Pointer
+parallel_thinning(const TImage *input_image,
+                  const std::array<uint32_t, 26> &neighbor_masks,
+                  const TIsSimple &is_simple,
+                  const TIsSkel &is_skel,
+                  const int persistence = 0,
+                  const size_t num_threads = 0,
+                  const bool verbose = false) {
+    return parallel_thinning_sweep(input_image, neighbor_masks, is_simple,
+                                   is_skel, std::vector<int>{persistence},
+                                   num_threads, verbose)
+            .front();
+}
+
+} // end namespace SG
+#endif
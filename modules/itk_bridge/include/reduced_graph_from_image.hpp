@@ -0,0 +1,332 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_REDUCED_GRAPH_FROM_IMAGE_HPP
+#define SG_REDUCED_GRAPH_FROM_IMAGE_HPP
+
+#include "foreground_rows.hpp"
+#include "image_types.hpp"
+#include "parallel_for.hpp"
+#include "sparse_binary_image.hpp"
+#include "spatial_graph.hpp"
+#include "split_loop.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Create the reduced spatial graph of a thin binary image in one pass,
+ * without creating the graph with one node per pixel.
+ *
+ * The result is equivalent to:
+ *   reduce_spatial_graph_via_dfs(spatial_graph_from_image(image))
+ * with 26-connectivity in 3D and 8-connectivity in 2D:
+ * - Pixels are classified by their number of foreground neighbors in
+ *   parallel. End points (1 neighbor) and junctions (more than 2) are the
+ *   nodes of the graph. Isolated pixels (0 neighbors) are ignored.
+ * - From each end point, and then from each junction, chains of pixels
+ *   with 2 neighbors are walked until the next node, and their positions
+ *   are stored in SpatialEdge::edge_points. Nodes that are neighbors are
+ *   joined with an edge without edge points.
+ * - Chains starting and finishing in the same junction are split with
+ *   @ref split_loop, as ReduceGraphVisitor does.
+ * - Cycles without nodes get a node in their first pixel (in buffer order)
+ *   and are split with @ref split_loop, as SelfLoopGraphVisitor does.
+ *
+ * End points and junctions are numbered in the order of the image buffer,
+ * followed by the nodes created splitting loops. Each edge between
+ * neighbor pixels is walked by exactly one edge of the result (except in
+ * cycles of three pixels, reduced to a node without edges, as
+ * SelfLoopGraphVisitor does). In clusters of junctions the depth first
+ * search of reduce_spatial_graph_via_dfs depends on the visit order, and
+ * might skip edges between neighbor junctions, or loops.
+ *
+ * Only the foreground pixels (see @ref foreground_rows) and one byte per
+ * pixel for its number of neighbors are stored, the peak memory is much
+ * lower than the graph with one node per pixel.
+ *
+ * Note that @ref remove_extra_edges modifies the graph with one node per
+ * pixel before reducing it, use the two steps when it is needed.
+ *
+ * With boundary_nodes, every foreground pixel in the faces of the image
+ * region is also a node, and chains are cut at the faces. This is used to
+ * stitch the graphs of the tiles of a larger image, see
+ * @ref TiledGraphStitcher.
+ *
+ * @tparam TSpatialGraph GraphType for 3D images, GraphType2D for 2D images.
+ * @tparam TImage itk::Image with ImageDimension equal to the dimension of
+ * the spatial graph, or SparseBinaryImage.
+ * @param image input thin binary image
+ * @param num_threads 0 to use all the hardware threads.
+ * @param boundary_nodes add a node in every foreground pixel in the faces
+ * of the image.
+ *
+ * @return reduced spatial graph in index space
+ */
+template <typename TSpatialGraph, typename TImage>
+TSpatialGraph reduced_graph_from_image(const TImage *image,
+                                       const size_t num_threads = 0,
+                                       const bool boundary_nodes = false) {
+    constexpr unsigned int Dimension = TImage::ImageDimension;
+    static_assert(Dimension == 2 || Dimension == 3,
+                  "reduced_graph_from_image: only 2D and 3D images.");
+    using vertex_descriptor =
+            typename boost::graph_traits<TSpatialGraph>::vertex_descriptor;
+    using SpatialNodeType =
+            typename boost::vertex_bundle_type<TSpatialGraph>::type;
+    using SpatialEdgeType =
+            typename boost::edge_bundle_type<TSpatialGraph>::type;
+    using PointType = typename SpatialNodeType::PointType;
+    constexpr size_t invalid_pixel = ForegroundRows::invalid_pixel;
+
+    const auto rows = foreground_rows(image, num_threads);
+    const size_t num_pixels = rows.size();
+    const size_t num_rows = rows.num_rows();
+    const size_t size_y = rows.size_y;
+    const std::array<size_t, 3> sizes = {
+            {rows.size_x, rows.size_y, rows.size_z}};
+
+    // Number of neighbors of each pixel, and pixels in the faces that are
+    // nodes because of boundary_nodes.
+    std::vector<uint8_t> degrees(num_pixels, 0);
+    std::vector<uint8_t> forced_nodes(boundary_nodes ? num_pixels : 0, 0);
+    parallel_for_chunks(
+            num_rows,
+            [&](const size_t rows_begin, const size_t rows_end) {
+                for (size_t row = rows_begin; row < rows_end; ++row) {
+                    const long y = static_cast<long>(row % size_y);
+                    const long z = static_cast<long>(row / size_y);
+                    for (auto pixel = rows.row_offsets[row];
+                         pixel < rows.row_offsets[row + 1]; ++pixel) {
+                        uint8_t degree = 0;
+                        rows.for_each_neighbor(
+                                static_cast<long>(rows.xs[pixel]), y, z,
+                                [&degree](size_t, long, long, long) {
+                                    ++degree;
+                                });
+                        degrees[pixel] = degree;
+                        if (!boundary_nodes) {
+                            continue;
+                        }
+                        const std::array<long, 3> coords = {
+                                {static_cast<long>(rows.xs[pixel]), y, z}};
+                        for (unsigned int d = 0; d < Dimension; ++d) {
+                            if (coords[d] == 0 ||
+                                coords[d] + 1 ==
+                                        static_cast<long>(sizes[d])) {
+                                forced_nodes[pixel] = 1;
+                            }
+                        }
+                    }
+                }
+            },
+            num_threads);
+
+    const auto to_position = [&rows](const long x, const long y,
+                                     const long z) {
+        const std::array<long, 3> coords = {{x, y, z}};
+        PointType pos;
+        for (unsigned int d = 0; d < Dimension; ++d) {
+            pos[d] = static_cast<double>(rows.start[d] + coords[d]);
+        }
+        return pos;
+    };
+    const auto is_node = [&degrees, &forced_nodes,
+                          boundary_nodes](const size_t pixel) {
+        return degrees[pixel] == 1 || degrees[pixel] > 2 ||
+               (boundary_nodes && forced_nodes[pixel]);
+    };
+
+    // Nodes in the order of the buffer. The coordinates of the nodes are
+    // kept to walk from them.
+    TSpatialGraph sg;
+    std::vector<vertex_descriptor> pixel_to_node(num_pixels);
+    std::vector<size_t> node_pixels;
+    std::vector<std::array<long, 3>> node_coords;
+    for (size_t row = 0; row < num_rows; ++row) {
+        const long y = static_cast<long>(row % size_y);
+        const long z = static_cast<long>(row / size_y);
+        for (auto pixel = rows.row_offsets[row];
+             pixel < rows.row_offsets[row + 1]; ++pixel) {
+            if (!is_node(pixel)) {
+                continue;
+            }
+            const long x = static_cast<long>(rows.xs[pixel]);
+            SpatialNodeType node;
+            node.pos = to_position(x, y, z);
+            pixel_to_node[pixel] = boost::add_vertex(node, sg);
+            node_pixels.push_back(pixel);
+            node_coords.push_back({{x, y, z}});
+        }
+    }
+
+    // Pixels with 2 neighbors already in an edge, and nodes already walked.
+    std::vector<uint8_t> visited(num_pixels, 0);
+
+    // Walk the chain of pixels with 2 neighbors starting at (pixel, coords),
+    // coming from previous, and append their positions to sg_edge. Returns
+    // the pixel ending the chain: a node, or the first pixel of a cycle.
+    const auto walk_chain = [&](size_t previous, size_t pixel,
+                                std::array<long, 3> coords,
+                                SpatialEdgeType &sg_edge) {
+        while (!is_node(pixel) && !visited[pixel]) {
+            visited[pixel] = 1;
+            sg_edge.edge_points.push_back(
+                    to_position(coords[0], coords[1], coords[2]));
+            size_t next = invalid_pixel;
+            std::array<long, 3> next_coords = coords;
+            rows.for_each_neighbor(
+                    coords[0], coords[1], coords[2],
+                    [&](const size_t neighbor, const long nx, const long ny,
+                        const long nz) {
+                        if (neighbor != previous && next == invalid_pixel) {
+                            next = neighbor;
+                            next_coords = {{nx, ny, nz}};
+                        }
+                    });
+            previous = pixel;
+            pixel = next;
+            coords = next_coords;
+        }
+        return pixel;
+    };
+
+    const auto walk_from_node = [&](const size_t node_index) {
+        const auto pixel = node_pixels[node_index];
+        const auto source = pixel_to_node[pixel];
+        const auto &coords = node_coords[node_index];
+        rows.for_each_neighbor(
+                coords[0], coords[1], coords[2],
+                [&](const size_t neighbor, const long nx, const long ny,
+                    const long nz) {
+                    if (is_node(neighbor)) {
+                        // Neighbor nodes are joined once.
+                        if (!visited[neighbor]) {
+                            boost::add_edge(source, pixel_to_node[neighbor],
+                                            sg);
+                        }
+                        return;
+                    }
+                    if (visited[neighbor]) {
+                        return;
+                    }
+                    SpatialEdgeType sg_edge;
+                    const auto last_pixel = walk_chain(
+                            pixel, neighbor, {{nx, ny, nz}}, sg_edge);
+                    if (last_pixel == pixel) {
+                        split_loop(source, sg_edge, sg);
+                    } else {
+                        boost::add_edge(source, pixel_to_node[last_pixel],
+                                        sg_edge, sg);
+                    }
+                });
+        visited[pixel] = 1;
+    };
+
+    // End points first, then junctions (and boundary nodes), as
+    // reduce_spatial_graph_via_dfs.
+    const size_t num_nodes = node_pixels.size();
+    for (size_t node_index = 0; node_index < num_nodes; ++node_index) {
+        if (degrees[node_pixels[node_index]] == 1) {
+            walk_from_node(node_index);
+        }
+    }
+    for (size_t node_index = 0; node_index < num_nodes; ++node_index) {
+        if (degrees[node_pixels[node_index]] != 1) {
+            walk_from_node(node_index);
+        }
+    }
+
+    // Cycles without nodes, the first pixel of each cycle becomes a node.
+    for (size_t row = 0; row < num_rows; ++row) {
+        const long y = static_cast<long>(row % size_y);
+        const long z = static_cast<long>(row / size_y);
+        for (auto pixel = rows.row_offsets[row];
+             pixel < rows.row_offsets[row + 1]; ++pixel) {
+            if (degrees[pixel] != 2 || visited[pixel]) {
+                continue;
+            }
+            const long x = static_cast<long>(rows.xs[pixel]);
+            SpatialNodeType node;
+            node.pos = to_position(x, y, z);
+            const auto source = boost::add_vertex(node, sg);
+            visited[pixel] = 1;
+            size_t neighbor = invalid_pixel;
+            std::array<long, 3> neighbor_coords = {{0, 0, 0}};
+            rows.for_each_neighbor(
+                    x, y, z,
+                    [&](const size_t n, const long nx, const long ny,
+                        const long nz) {
+                        if (neighbor == invalid_pixel) {
+                            neighbor = n;
+                            neighbor_coords = {{nx, ny, nz}};
+                        }
+                    });
+            SpatialEdgeType sg_edge;
+            walk_chain(pixel, neighbor, neighbor_coords, sg_edge);
+            if (sg_edge.edge_points.size() > 2) {
+                split_loop(source, sg_edge, sg);
+            }
+        }
+    }
+    return sg;
+}
+
+/**
+ * Same than above, for an image pointer (itk::SmartPointer).
+ */
+template <typename TSpatialGraph, typename TImage>
+TSpatialGraph reduced_graph_from_image(const itk::SmartPointer<TImage> &image,
+                                       const size_t num_threads = 0,
+                                       const bool boundary_nodes = false) {
+    return reduced_graph_from_image<TSpatialGraph, TImage>(
+            image.GetPointer(), num_threads, boundary_nodes);
+}
+
+/**
+ * Same than above, for the foreground voxels of a thin image, without
+ * creating the dense image, see @ref thin_function_sparse.
+ */
+template <typename TSpatialGraph>
+TSpatialGraph reduced_graph_from_image(const SparseBinaryImage &image,
+                                       const size_t num_threads = 0,
+                                       const bool boundary_nodes = false) {
+    return reduced_graph_from_image<TSpatialGraph, SparseBinaryImage>(
+            &image, num_threads, boundary_nodes);
+}
+
+// explicit instantiation in reduced_graph_from_image.cpp
+extern template GraphType
+reduced_graph_from_image<GraphType, BinaryImageType>(
+        const BinaryImageType *image, const size_t num_threads,
+        const bool boundary_nodes);
+extern template GraphType
+reduced_graph_from_image<GraphType, SparseBinaryImage>(
+        const SparseBinaryImage *image, const size_t num_threads,
+        const bool boundary_nodes);
+extern template GraphType2D
+reduced_graph_from_image<GraphType2D, BinaryImageType2D>(
+        const BinaryImageType2D *image, const size_t num_threads,
+        const bool boundary_nodes);
+
+} // end namespace SG
+#endif
@@ -0,0 +1,100 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_SPARSE_BINARY_IMAGE_HPP
+#define SG_SPARSE_BINARY_IMAGE_HPP
+
+#include "foreground_rows.hpp"
+#include "image_types.hpp"
+
+#include <vector>
+
+namespace SG {
+
+/**
+ * Foreground voxels of a 3D binary image, with the metadata of the image,
+ * but without its buffer.
+ *
+ * Thin images only have a few foreground voxels, this is the hand-off
+ * between the thinning (@ref thin_function_sparse) and the graph
+ * extraction (@ref spatial_graph_from_image and
+ * @ref reduced_graph_from_image accept it as input), so the dense image is
+ * only created when it is needed, see @ref image_from_sparse_binary_image.
+ */
+struct SparseBinaryImage {
+    static constexpr unsigned int ImageDimension =
+            BinaryImageType::ImageDimension;
+    using IndexType = BinaryImageType::IndexType;
+    using RegionType = BinaryImageType::RegionType;
+
+    /** Indices of the foreground voxels, sorted in the order of the image
+     * buffer (x is the fastest index), without duplicates. */
+    std::vector<IndexType> indices;
+    /** Region of the image, all the indices are inside. */
+    RegionType region;
+    BinaryImageType::PointType origin;
+    BinaryImageType::SpacingType spacing;
+    BinaryImageType::DirectionType direction;
+
+    /** Number of foreground voxels. */
+    size_t size() const { return indices.size(); }
+    bool empty() const { return indices.empty(); }
+};
+
+/**
+ * Set the buffered region, origin, spacing and direction of the
+ * reference image to the sparse image.
+ */
+void copy_image_information(const BinaryImageType *reference,
+                            SparseBinaryImage &sparse_image);
+
+/**
+ * Sort the indices of the sparse image in the order of the image buffer
+ * and remove the duplicates. Throws if any index is outside its region.
+ */
+void sort_indices(SparseBinaryImage &sparse_image);
+
+/**
+ * Foreground (non-zero) voxels of the image.
+ *
+ * @param image binary image
+ * @param num_threads 0 to use all the hardware threads.
+ */
+SparseBinaryImage sparse_binary_image_from_image(const BinaryImageType *image,
+                                                 const size_t num_threads = 0);
+
+/**
+ * Dense image with the region and metadata of the sparse image, and value
+ * 255 in the foreground voxels.
+ */
+BinaryImageType::Pointer
+image_from_sparse_binary_image(const SparseBinaryImage &sparse_image);
+
+/**
+ * ForegroundRows of the sparse image, built from its sorted indices
+ * without scanning the region.
+ * Allows to use the sparse image as input of @ref spatial_graph_from_image
+ * and @ref reduced_graph_from_image.
+ */
+ForegroundRows foreground_rows(const SparseBinaryImage *sparse_image,
+                               const size_t num_threads = 0);
+
+} // end namespace SG
+#endif
@@ -0,0 +1,223 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_SPATIAL_GRAPH_FROM_IMAGE_HPP
+#define SG_SPATIAL_GRAPH_FROM_IMAGE_HPP
+
+#include "foreground_rows.hpp"
+#include "image_types.hpp"
+#include "parallel_for.hpp"
+#include "sparse_binary_image.hpp"
+#include "spatial_graph.hpp"
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Create a spatial graph from a binary image (usually a thin image), with
+ * one node per foreground (non-zero) pixel and one edge between each pair
+ * of foreground pixels that are neighbors: 26-connectivity in 3D and
+ * 8-connectivity in 2D. Edges have no edge points.
+ *
+ * The result is the same graph than the one obtained from the DGtal
+ * Object of the image with @ref spatial_graph_from_object (DT26_6 and DT8_4
+ * topologies), but the buffer of the image is scanned linearly, without
+ * hashing any point:
+ * - Nodes are numbered in the order of the image buffer (x is the fastest
+ *   index), and their positions are the image indices (index space).
+ *   The foreground pixels are found with @ref foreground_rows.
+ * - Each edge is added once, looking only at the forward half of the
+ *   neighborhood (13 neighbors in 3D, 4 in 2D) of each pixel, so
+ *   boost::edge is never queried.
+ * - Rows are processed in parallel (see @ref parallel_for_chunks), the
+ *   resulting graph does not depend on the number of threads.
+ *
+ * @tparam TSpatialGraph GraphType for 3D images, GraphType2D for 2D images.
+ * GraphTypeI32 stores the index of the voxels with half the memory per
+ * node, see @ref index_graph_to_physical_space_graph.
+ * @tparam TImage itk::Image with ImageDimension equal to the dimension of
+ * the spatial graph, or SparseBinaryImage.
+ * @param image input binary image
+ * @param num_threads 0 to use all the hardware threads.
+ *
+ * @return spatial graph in index space
+ */
+template <typename TSpatialGraph, typename TImage>
+TSpatialGraph spatial_graph_from_image(const TImage *image,
+                                       const size_t num_threads = 0) {
+    constexpr unsigned int Dimension = TImage::ImageDimension;
+    static_assert(Dimension == 2 || Dimension == 3,
+                  "spatial_graph_from_image: only 2D and 3D images.");
+    using vertex_descriptor =
+            typename boost::graph_traits<TSpatialGraph>::vertex_descriptor;
+    using EdgeVertices = std::pair<vertex_descriptor, vertex_descriptor>;
+    using ScalarType =
+            typename boost::vertex_bundle_type<TSpatialGraph>::type::ScalarType;
+
+    const auto rows = foreground_rows(image, num_threads);
+    const auto &row_offsets = rows.row_offsets;
+    const auto &xs = rows.xs;
+    const size_t size_y = rows.size_y;
+    const size_t size_z = rows.size_z;
+    const size_t num_rows = rows.num_rows();
+
+    // The node of a pixel is its position in rows.xs.
+    TSpatialGraph sg(rows.size());
+    parallel_for_chunks(
+            num_rows,
+            [&](const size_t rows_begin, const size_t rows_end) {
+                for (size_t row = rows_begin; row < rows_end; ++row) {
+                    const std::array<size_t, 3> row_coords = {
+                            {0, row % size_y, row / size_y}};
+                    for (auto vertex = row_offsets[row];
+                         vertex < row_offsets[row + 1]; ++vertex) {
+                        auto &pos = sg[vertex].pos;
+                        pos[0] = static_cast<ScalarType>(
+                                rows.start[0] + static_cast<long>(xs[vertex]));
+                        for (unsigned int d = 1; d < Dimension; ++d) {
+                            pos[d] = static_cast<ScalarType>(
+                                    rows.start[d] +
+                                    static_cast<long>(row_coords[d]));
+                        }
+                    }
+                }
+            },
+            num_threads);
+
+    // Rows holding the forward half of the neighborhood of a row, besides
+    // the row itself: (dy, dz) = (1, 0), (-1, 1), (0, 1), (1, 1).
+    constexpr size_t num_neighbor_rows = 4;
+    constexpr std::array<std::array<int, 2>, num_neighbor_rows>
+            neighbor_row_offsets = {{{{1, 0}}, {{-1, 1}}, {{0, 1}}, {{1, 1}}}};
+
+    // Edges of each chunk of rows, in scan order, keyed by its first row.
+    std::map<size_t, std::vector<EdgeVertices>> chunk_edges;
+    std::mutex chunk_edges_mutex;
+    parallel_for_chunks(
+            num_rows,
+            [&](const size_t rows_begin, const size_t rows_end) {
+                std::vector<EdgeVertices> edges;
+                for (size_t row = rows_begin; row < rows_end; ++row) {
+                    const auto row_begin = row_offsets[row];
+                    const auto row_end = row_offsets[row + 1];
+                    if (row_begin == row_end) {
+                        continue;
+                    }
+                    const long y = static_cast<long>(row % size_y);
+                    const long z = static_cast<long>(row / size_y);
+                    // Range of nodes of each neighbor row, and a cursor that
+                    // advances with x.
+                    std::array<size_t, num_neighbor_rows> cursors;
+                    std::array<size_t, num_neighbor_rows> cursors_end;
+                    for (size_t n = 0; n < num_neighbor_rows; ++n) {
+                        const long ny = y + neighbor_row_offsets[n][0];
+                        const long nz = z + neighbor_row_offsets[n][1];
+                        if (ny < 0 || ny >= static_cast<long>(size_y) ||
+                            nz >= static_cast<long>(size_z)) {
+                            cursors[n] = cursors_end[n] = 0;
+                            continue;
+                        }
+                        const size_t neighbor_row =
+                                static_cast<size_t>(nz) * size_y +
+                                static_cast<size_t>(ny);
+                        cursors[n] = row_offsets[neighbor_row];
+                        cursors_end[n] = row_offsets[neighbor_row + 1];
+                    }
+                    for (size_t vertex = row_begin; vertex < row_end;
+                         ++vertex) {
+                        const size_t x = xs[vertex];
+                        // Same row, dx = 1
+                        if (vertex + 1 < row_end && xs[vertex + 1] == x + 1) {
+                            edges.emplace_back(vertex, vertex + 1);
+                        }
+                        // Neighbor rows, dx = -1, 0, 1
+                        for (size_t n = 0; n < num_neighbor_rows; ++n) {
+                            auto &cursor = cursors[n];
+                            const auto cursor_end = cursors_end[n];
+                            while (cursor < cursor_end && xs[cursor] + 1 < x) {
+                                ++cursor;
+                            }
+                            for (auto neighbor = cursor;
+                                 neighbor < cursor_end && xs[neighbor] <= x + 1;
+                                 ++neighbor) {
+                                edges.emplace_back(vertex, neighbor);
+                            }
+                        }
+                    }
+                }
+                std::lock_guard<std::mutex> lock(chunk_edges_mutex);
+                chunk_edges.emplace(rows_begin, std::move(edges));
+            },
+            num_threads);
+
+    // Add the edges in scan order, independently of the threads used.
+    for (const auto &rows_begin_edges : chunk_edges) {
+        for (const auto &edge : rows_begin_edges.second) {
+            boost::add_edge(edge.first, edge.second, sg);
+        }
+    }
+    return sg;
+}
+
+/**
+ * Same than above, for an image pointer (itk::SmartPointer).
+ */
+template <typename TSpatialGraph, typename TImage>
+TSpatialGraph spatial_graph_from_image(const itk::SmartPointer<TImage> &image,
+                                       const size_t num_threads = 0) {
+    return spatial_graph_from_image<TSpatialGraph, TImage>(image.GetPointer(),
+                                                           num_threads);
+}
+
+/**
+ * Same than above, for the foreground voxels of a thin image, without
+ * creating the dense image, see @ref thin_function_sparse.
+ */
+template <typename TSpatialGraph>
+TSpatialGraph spatial_graph_from_image(const SparseBinaryImage &image,
+                                       const size_t num_threads = 0) {
+    return spatial_graph_from_image<TSpatialGraph, SparseBinaryImage>(
+            &image, num_threads);
+}
+
+// explicit instantiation in spatial_graph_from_image.cpp
+extern template GraphType
+spatial_graph_from_image<GraphType, BinaryImageType>(
+        const BinaryImageType *image, const size_t num_threads);
+extern template GraphType
+spatial_graph_from_image<GraphType, SparseBinaryImage>(
+        const SparseBinaryImage *image, const size_t num_threads);
+extern template GraphTypeI32
+spatial_graph_from_image<GraphTypeI32, BinaryImageType>(
+        const BinaryImageType *image, const size_t num_threads);
+extern template GraphTypeI32
+spatial_graph_from_image<GraphTypeI32, SparseBinaryImage>(
+        const SparseBinaryImage *image, const size_t num_threads);
+extern template GraphType2D
+spatial_graph_from_image<GraphType2D, BinaryImageType2D>(
+        const BinaryImageType2D *image, const size_t num_threads);
+
+} // end namespace SG
+#endif
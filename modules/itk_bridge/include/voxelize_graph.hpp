@@ -23,7 +23,7 @@
 
 #include "image_types.hpp"
 #include "spatial_graph.hpp"
-#include "spatial_graph_io.hpp" // for vertex_to_label_map_t
+#include "spatial_graph_io.hpp" // for vertex_to_label_map_t, VertexAttribute
 #include <functional>
 #include <unordered_map>
 
@@ -104,6 +104,22 @@ edge_to_label_map_t create_edge_to_label_map_from_vertex_to_label_map_using_max(
         const GraphType &graph,
         const vertex_to_label_map_t &vertex_to_label_map);
 
+/**
+ * Same than @ref create_edge_to_label_map_from_vertex_to_label_map, with
+ * label columns indexed by vertex_descriptor and edge id.
+ */
+EdgeAttribute<size_t> create_edge_labels_from_vertex_labels(
+        const GraphType &graph,
+        const VertexAttribute<size_t> &vertex_labels,
+        const edge_label_function_t &edge_label_func);
+
+/**
+ * Same than @ref create_edge_to_label_map_from_vertex_to_label_map_using_max,
+ * with label columns indexed by vertex_descriptor and edge id.
+ */
+EdgeAttribute<size_t> create_edge_labels_from_vertex_labels_using_max(
+        const GraphType &graph, const VertexAttribute<size_t> &vertex_labels);
+
 /**
  * Create an image from the input graph.
  * Uses a reference_image (for example, the thin image used to create the graph)
@@ -129,5 +145,18 @@ voxelize_graph(const GraphType &graph,
                const vertex_to_label_map_t &vertex_to_label_map,
                const edge_to_label_map_t &edge_to_label_map,
                const bool &graph_positions_are_in_physical_space = true);
+
+/**
+ * Same than above, with the labels in columns indexed by vertex_descriptor
+ * and edge id (see @ref EdgeIndex), as read by @ref read_vertex_labels and
+ * @ref read_edge_labels. Vertices and edges without a label are not
+ * voxelized.
+ */
+BinaryImageType::Pointer
+voxelize_graph(const GraphType &graph,
+               const BinaryImageType::Pointer &reference_image,
+               const VertexAttribute<size_t> &vertex_labels,
+               const EdgeAttribute<size_t> &edge_labels,
+               const bool &graph_positions_are_in_physical_space = true);
 } // end namespace SG
 #endif
@@ -28,4 +28,9 @@ template VertexToRadiusMap create_vertex_to_radius_map<GraphType>(
         const GraphType &input_graph,
         const bool spatial_nodes_position_are_in_physical_space,
         const bool /*verbose*/);
+template VertexAttribute<double> create_vertex_radius_attribute<GraphType>(
+        const typename FloatImageType::Pointer &distance_map_image,
+        const GraphType &input_graph,
+        const bool spatial_nodes_position_are_in_physical_space,
+        const bool /*verbose*/);
 } // end namespace SG
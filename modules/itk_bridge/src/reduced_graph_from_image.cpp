@@ -0,0 +1,37 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "reduced_graph_from_image.hpp"
+
+namespace SG {
+
+// explicit instantiation
+template GraphType reduced_graph_from_image<GraphType, BinaryImageType>(
+        const BinaryImageType *image, const size_t num_threads,
+        const bool boundary_nodes);
+template GraphType2D
+reduced_graph_from_image<GraphType2D, BinaryImageType2D>(
+        const BinaryImageType2D *image, const size_t num_threads,
+        const bool boundary_nodes);
+template GraphType reduced_graph_from_image<GraphType, SparseBinaryImage>(
+        const SparseBinaryImage *image, const size_t num_threads,
+        const bool boundary_nodes);
+
+} // end namespace SG
@@ -0,0 +1,154 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "sparse_binary_image.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace SG {
+
+namespace {
+bool is_inside(const SparseBinaryImage::RegionType &region,
+               const SparseBinaryImage::IndexType &index) {
+    const auto &start = region.GetIndex();
+    const auto &size = region.GetSize();
+    for (unsigned int d = 0; d < SparseBinaryImage::ImageDimension; ++d) {
+        if (index[d] < start[d] ||
+            index[d] >= start[d] + static_cast<long>(size[d])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Strict order of the image buffer: z, then y, then x. */
+bool buffer_order(const SparseBinaryImage::IndexType &a,
+                  const SparseBinaryImage::IndexType &b) {
+    for (unsigned int d = SparseBinaryImage::ImageDimension; d-- > 0;) {
+        if (a[d] != b[d]) {
+            return a[d] < b[d];
+        }
+    }
+    return false;
+}
+} // namespace
+
+void copy_image_information(const BinaryImageType *reference,
+                            SparseBinaryImage &sparse_image) {
+    sparse_image.region = reference->GetBufferedRegion();
+    sparse_image.origin = reference->GetOrigin();
+    sparse_image.spacing = reference->GetSpacing();
+    sparse_image.direction = reference->GetDirection();
+}
+
+void sort_indices(SparseBinaryImage &sparse_image) {
+    auto &indices = sparse_image.indices;
+    for (const auto &index : indices) {
+        if (!is_inside(sparse_image.region, index)) {
+            throw std::runtime_error(
+                    "sort_indices: index (" + std::to_string(index[0]) +
+                    ", " + std::to_string(index[1]) + ", " +
+                    std::to_string(index[2]) +
+                    ") is outside the region of the sparse image.");
+        }
+    }
+    std::sort(indices.begin(), indices.end(), buffer_order);
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
+
+SparseBinaryImage sparse_binary_image_from_image(const BinaryImageType *image,
+                                                 const size_t num_threads) {
+    SparseBinaryImage sparse_image;
+    copy_image_information(image, sparse_image);
+    const auto rows = foreground_rows(image, num_threads);
+    sparse_image.indices.resize(rows.size());
+    parallel_for_chunks(
+            rows.num_rows(),
+            [&](const size_t rows_begin, const size_t rows_end) {
+                for (size_t row = rows_begin; row < rows_end; ++row) {
+                    const long y = rows.start[1] +
+                                   static_cast<long>(row % rows.size_y);
+                    const long z = rows.start[2] +
+                                   static_cast<long>(row / rows.size_y);
+                    for (auto voxel = rows.row_offsets[row];
+                         voxel < rows.row_offsets[row + 1]; ++voxel) {
+                        auto &index = sparse_image.indices[voxel];
+                        index[0] = rows.start[0] +
+                                   static_cast<long>(rows.xs[voxel]);
+                        index[1] = y;
+                        index[2] = z;
+                    }
+                }
+            },
+            num_threads);
+    return sparse_image;
+}
+
+BinaryImageType::Pointer
+image_from_sparse_binary_image(const SparseBinaryImage &sparse_image) {
+    auto image = BinaryImageType::New();
+    image->SetRegions(sparse_image.region);
+    image->SetOrigin(sparse_image.origin);
+    image->SetSpacing(sparse_image.spacing);
+    image->SetDirection(sparse_image.direction);
+    image->Allocate();
+    image->FillBuffer(0);
+    const auto &start = sparse_image.region.GetIndex();
+    const auto &size = sparse_image.region.GetSize();
+    auto *buffer = image->GetBufferPointer();
+    for (const auto &index : sparse_image.indices) {
+        buffer[static_cast<size_t>(index[0] - start[0]) +
+               size[0] * (static_cast<size_t>(index[1] - start[1]) +
+                          size[1] * static_cast<size_t>(index[2] -
+                                                        start[2]))] = 255;
+    }
+    return image;
+}
+
+ForegroundRows foreground_rows(const SparseBinaryImage *sparse_image,
+                               const size_t /* num_threads */) {
+    const auto &start = sparse_image->region.GetIndex();
+    const auto &size = sparse_image->region.GetSize();
+    ForegroundRows rows;
+    rows.size_x = size[0];
+    rows.size_y = size[1];
+    rows.size_z = size[2];
+    for (unsigned int d = 0; d < SparseBinaryImage::ImageDimension; ++d) {
+        rows.start[d] = static_cast<long>(start[d]);
+    }
+    // The indices are sorted, a single pass fills the rows.
+    rows.row_offsets.assign(rows.num_rows() + 1, 0);
+    rows.xs.reserve(sparse_image->size());
+    for (const auto &index : sparse_image->indices) {
+        const auto row =
+                rows.row(static_cast<size_t>(index[1] - start[1]),
+                         static_cast<size_t>(index[2] - start[2]));
+        ++rows.row_offsets[row + 1];
+        rows.xs.push_back(static_cast<size_t>(index[0] - start[0]));
+    }
+    std::partial_sum(rows.row_offsets.begin(), rows.row_offsets.end(),
+                     rows.row_offsets.begin());
+    return rows;
+}
+
+} // end namespace SG
@@ -19,6 +19,7 @@
  * *******************************************************************/
 
 #include "voxelize_graph.hpp"
+#include "transform_to_physical_point.hpp"
 
 #include <fstream>
 #include <iostream>
@@ -28,8 +29,8 @@ namespace SG {
 BinaryImageType::Pointer
 voxelize_graph(const GraphType &graph,
                const BinaryImageType::Pointer &reference_image,
-               const vertex_to_label_map_t &vertex_to_label_map,
-               const edge_to_label_map_t &edge_to_label_map,
+               const VertexAttribute<size_t> &vertex_labels,
+               const EdgeAttribute<size_t> &edge_labels,
                const bool &graph_positions_are_in_physical_space) {
     BinaryImageType::Pointer voxelized_image = BinaryImageType::New();
     // Create empty image with same parameters than reference_image
@@ -44,49 +45,53 @@ voxelize_graph(const GraphType &graph,
     // background.
     bool any_label_is_zero = false;
 
-    GraphType::vertex_iterator vi, vi_end;
-    std::tie(vi, vi_end) = boost::vertices(graph);
-    for (; vi != vi_end; ++vi) {
-        const auto vertex = *vi;
-        // if found node in map, populate voxel with value
-        const auto find_node_label = vertex_to_label_map.find(vertex);
-        if (find_node_label != vertex_to_label_map.cend()) {
-            const auto &label = find_node_label->second;
+    // Gather the positions to voxelize and their labels, to transform all
+    // of them to index space at once.
+    std::vector<PointType> positions;
+    std::vector<size_t> labels;
+
+    const auto num_vertices = boost::num_vertices(graph);
+    for (size_t vertex = 0; vertex < num_vertices; ++vertex) {
+        // if the node has a label, populate voxel with value
+        if (vertex_labels.has(vertex)) {
+            const auto &label = vertex_labels.values()[vertex];
             if (label == 0) {
                 any_label_is_zero = true;
             }
-            const auto &position = graph[vertex].pos;
-            const auto itk_index =
-                    graph_position_to_image_index<BinaryImageType>(
-                            position, reference_image,
-                            graph_positions_are_in_physical_space);
-            voxelized_image->SetPixel(itk_index, label);
+            positions.push_back(graph[vertex].pos);
+            labels.push_back(label);
         }
     }
 
+    size_t edge_id = 0;
     GraphType::edge_iterator ei, ei_end;
     std::tie(ei, ei_end) = boost::edges(graph);
-    for (; ei != ei_end; ++ei) {
-        const auto edge = *ei;
-        // if found edge in map, populate voxel with value
-        const auto find_edge_label = edge_to_label_map.find(edge);
-        if (find_edge_label != edge_to_label_map.cend()) {
-            const auto &label = find_edge_label->second;
+    for (; ei != ei_end; ++ei, ++edge_id) {
+        // if the edge has a label, populate voxel with value
+        if (edge_labels.has(edge_id)) {
+            const auto &label = edge_labels.values()[edge_id];
             if (label == 0) {
                 any_label_is_zero = true;
             }
             // Populate all edge points voxels with this label
-            const auto &edge_points = graph[edge].edge_points;
-            for (const auto &ep : edge_points) {
-                const auto itk_index =
-                        graph_position_to_image_index<BinaryImageType>(
-                                ep, reference_image,
-                                graph_positions_are_in_physical_space);
-                voxelized_image->SetPixel(itk_index, label);
-            }
+            const auto &edge_points = graph[*ei].edge_points;
+            positions.insert(std::end(positions), std::begin(edge_points),
+                             std::end(edge_points));
+            labels.insert(std::end(labels), edge_points.size(), label);
         }
     }
 
+    if (graph_positions_are_in_physical_space) {
+        transform_points_to_index_space(
+                positions,
+                make_image_space_transform(reference_image.GetPointer()));
+    }
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const auto itk_index = graph_position_to_image_index<BinaryImageType>(
+                positions[i], reference_image, false);
+        voxelized_image->SetPixel(itk_index, labels[i]);
+    }
+
     if (any_label_is_zero) {
         std::cerr << "Warning in voxelize_graph: the maps have one or more "
                      "labels equal to zero, these will be lost in the "
@@ -97,29 +102,57 @@ voxelize_graph(const GraphType &graph,
     return voxelized_image;
 }
 
-edge_to_label_map_t create_edge_to_label_map_from_vertex_to_label_map(
+BinaryImageType::Pointer
+voxelize_graph(const GraphType &graph,
+               const BinaryImageType::Pointer &reference_image,
+               const vertex_to_label_map_t &vertex_to_label_map,
+               const edge_to_label_map_t &edge_to_label_map,
+               const bool &graph_positions_are_in_physical_space) {
+    return voxelize_graph(graph, reference_image,
+                          to_vertex_attribute(graph, vertex_to_label_map),
+                          to_edge_attribute(graph, edge_to_label_map),
+                          graph_positions_are_in_physical_space);
+}
+
+EdgeAttribute<size_t> create_edge_labels_from_vertex_labels(
         const GraphType &graph,
-        const vertex_to_label_map_t &vertex_to_label_map,
+        const VertexAttribute<size_t> &vertex_labels,
         const edge_label_function_t &edge_label_func) {
-    auto edge_to_label_map = edge_to_label_map_t();
+    EdgeAttribute<size_t> edge_labels(boost::num_edges(graph));
+    size_t edge_id = 0;
     GraphType::edge_iterator ei, ei_end;
     std::tie(ei, ei_end) = boost::edges(graph);
-    for (; ei != ei_end; ++ei) {
-        const auto edge = *ei;
-        const auto source = boost::source(edge, graph);
-        const auto target = boost::target(edge, graph);
-        const auto find_source_label = vertex_to_label_map.find(source);
-        const auto find_target_label = vertex_to_label_map.find(target);
+    for (; ei != ei_end; ++ei, ++edge_id) {
+        const auto source = boost::source(*ei, graph);
+        const auto target = boost::target(*ei, graph);
         // Only populate edge label if source and target label exists.
-        if (find_source_label != vertex_to_label_map.cend() &&
-            find_target_label != vertex_to_label_map.cend()) {
-            const auto source_label = find_source_label->second;
-            const auto target_label = find_target_label->second;
-            const auto edge_label = edge_label_func(source_label, target_label);
-            edge_to_label_map.emplace(edge, edge_label);
+        if (vertex_labels.has(source) && vertex_labels.has(target)) {
+            edge_labels.set(edge_id,
+                            edge_label_func(vertex_labels.values()[source],
+                                            vertex_labels.values()[target]));
         }
     }
-    return edge_to_label_map;
+    return edge_labels;
+}
+
+EdgeAttribute<size_t> create_edge_labels_from_vertex_labels_using_max(
+        const GraphType &graph, const VertexAttribute<size_t> &vertex_labels) {
+    const auto edge_function = [](const size_t &source_label,
+                                  const size_t &target_label) {
+        return std::max<size_t>(source_label, target_label);
+    };
+    return create_edge_labels_from_vertex_labels(graph, vertex_labels,
+                                                 edge_function);
+}
+
+edge_to_label_map_t create_edge_to_label_map_from_vertex_to_label_map(
+        const GraphType &graph,
+        const vertex_to_label_map_t &vertex_to_label_map,
+        const edge_label_function_t &edge_label_func) {
+    return to_edge_map<edge_to_label_map_t>(
+            graph, create_edge_labels_from_vertex_labels(
+                           graph, to_vertex_attribute(graph, vertex_to_label_map),
+                           edge_label_func));
 }
 
 edge_to_label_map_t create_edge_to_label_map_from_vertex_to_label_map_using_max(
@@ -0,0 +1,496 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "image_types.hpp"
+#include "parallel_thinning.hpp"
+
+#include "gmock/gmock.h"
+#include <bitset>
+#include <random>
+#include <set>
+#include <unordered_set>
+
+namespace {
+using ImageType = SG::BinaryImageType;
+
+ImageType::Pointer create_image(const size_t size_x,
+                                const size_t size_y,
+                                const size_t size_z) {
+    auto image = ImageType::New();
+    ImageType::RegionType region;
+    ImageType::IndexType start;
+    start.Fill(0);
+    ImageType::SizeType size;
+    size[0] = size_x;
+    size[1] = size_y;
+    size[2] = size_z;
+    region.SetIndex(start);
+    region.SetSize(size);
+    image->SetRegions(region);
+    image->Allocate();
+    image->FillBuffer(0);
+    return image;
+}
+
+/** Accessor to the voxel (x, y, z), 0 outside the image. */
+struct Voxels {
+    explicit Voxels(const ImageType *image)
+            : size(image->GetBufferedRegion().GetSize()),
+              buffer(image->GetBufferPointer()) {}
+    bool operator()(const long x, const long y, const long z) const {
+        if (x < 0 || y < 0 || z < 0 || x >= static_cast<long>(size[0]) ||
+            y >= static_cast<long>(size[1]) || z >= static_cast<long>(size[2])) {
+            return false;
+        }
+        return buffer[x + size[0] * (y + size[1] * z)] != 0;
+    }
+    ImageType::SizeType size;
+    const unsigned char *buffer;
+};
+
+/** Number of connected components of the points with the adjacency. */
+template <typename TAdjacent>
+size_t count_components(const std::vector<std::array<int, 3>> &points,
+                        const TAdjacent &adjacent) {
+    std::vector<bool> visited(points.size(), false);
+    size_t components = 0;
+    for (size_t seed = 0; seed < points.size(); ++seed) {
+        if (visited[seed]) {
+            continue;
+        }
+        ++components;
+        std::vector<size_t> stack = {seed};
+        visited[seed] = true;
+        while (!stack.empty()) {
+            const auto current = stack.back();
+            stack.pop_back();
+            for (size_t other = 0; other < points.size(); ++other) {
+                if (!visited[other] && adjacent(points[current], points[other])) {
+                    visited[other] = true;
+                    stack.push_back(other);
+                }
+            }
+        }
+    }
+    return components;
+}
+
+int chebyshev(const std::array<int, 3> &a, const std::array<int, 3> &b) {
+    return std::max({std::abs(a[0] - b[0]), std::abs(a[1] - b[1]),
+                     std::abs(a[2] - b[2])});
+}
+int manhattan(const std::array<int, 3> &a, const std::array<int, 3> &b) {
+    return std::abs(a[0] - b[0]) + std::abs(a[1] - b[1]) +
+           std::abs(a[2] - b[2]);
+}
+
+/**
+ * Simple voxel in the (26, 6) topology, from the configuration with
+ * neighbor_masks[i] = 1 << i: one 26-component of foreground neighbors, and
+ * one 6-component of background 18-neighbors 6-adjacent to the voxel.
+ */
+bool is_simple_brute_force(const uint32_t config) {
+    static const auto offsets = SG::neighbor26_offsets();
+    std::vector<std::array<int, 3>> foreground;
+    std::vector<std::array<int, 3>> background;
+    for (size_t i = 0; i < 26; ++i) {
+        if (config & (1u << i)) {
+            foreground.push_back(offsets[i]);
+        } else if (manhattan(offsets[i], {{0, 0, 0}}) <= 2) {
+            background.push_back(offsets[i]);
+        }
+    }
+    const auto adjacent26 = [](const std::array<int, 3> &a,
+                               const std::array<int, 3> &b) {
+        return chebyshev(a, b) == 1;
+    };
+    if (count_components(foreground, adjacent26) != 1) {
+        return false;
+    }
+    // Keep the background components with a 6-neighbor of the voxel.
+    const auto adjacent6 = [](const std::array<int, 3> &a,
+                              const std::array<int, 3> &b) {
+        return manhattan(a, b) == 1;
+    };
+    std::vector<std::array<int, 3>> face_background;
+    for (const auto &p : background) {
+        if (manhattan(p, {{0, 0, 0}}) == 1) {
+            face_background.push_back(p);
+        }
+    }
+    if (face_background.empty()) {
+        return false;
+    }
+    // Components of the background reached from the face neighbors.
+    std::vector<std::array<int, 3>> all = face_background;
+    for (const auto &p : background) {
+        if (manhattan(p, {{0, 0, 0}}) == 2) {
+            all.push_back(p);
+        }
+    }
+    std::vector<int> component(all.size(), -1);
+    int num_components = 0;
+    for (size_t seed = 0; seed < face_background.size(); ++seed) {
+        if (component[seed] != -1) {
+            continue;
+        }
+        std::vector<size_t> stack = {seed};
+        component[seed] = num_components;
+        while (!stack.empty()) {
+            const auto current = stack.back();
+            stack.pop_back();
+            for (size_t other = 0; other < all.size(); ++other) {
+                if (component[other] == -1 &&
+                    adjacent6(all[current], all[other])) {
+                    component[other] = num_components;
+                    stack.push_back(other);
+                }
+            }
+        }
+        ++num_components;
+    }
+    return num_components == 1;
+}
+
+std::array<uint32_t, 26> identity_masks() {
+    std::array<uint32_t, 26> masks;
+    for (size_t i = 0; i < 26; ++i) {
+        masks[i] = 1u << i;
+    }
+    return masks;
+}
+
+const auto is_end = [](const uint32_t config) {
+    return std::bitset<32>(config).count() == 1;
+};
+const auto is_ultimate = [](const uint32_t) { return false; };
+
+/** Components (26), cavities (6-components of the background minus the
+ * outside), and Euler characteristic of the union of the voxels. */
+struct Topology {
+    size_t components = 0;
+    size_t cavities = 0;
+    long euler = 0;
+    bool operator==(const Topology &other) const {
+        return components == other.components && cavities == other.cavities &&
+               euler == other.euler;
+    }
+};
+
+Topology compute_topology(const ImageType *image) {
+    const Voxels voxels(image);
+    const long sx = voxels.size[0];
+    const long sy = voxels.size[1];
+    const long sz = voxels.size[2];
+    // Flood fill with a margin of background around the image.
+    const auto flood = [&](const bool value, const int connectivity) {
+        const long mx = sx + 2, my = sy + 2, mz = sz + 2;
+        std::vector<int> labels(mx * my * mz, -1);
+        const auto at = [&](long x, long y, long z) {
+            return voxels(x - 1, y - 1, z - 1);
+        };
+        size_t count = 0;
+        for (long z = 0; z < mz; ++z) {
+            for (long y = 0; y < my; ++y) {
+                for (long x = 0; x < mx; ++x) {
+                    const long id = x + mx * (y + my * z);
+                    if (at(x, y, z) != value || labels[id] != -1) {
+                        continue;
+                    }
+                    std::vector<std::array<long, 3>> stack = {{{x, y, z}}};
+                    labels[id] = static_cast<int>(count);
+                    while (!stack.empty()) {
+                        const auto p = stack.back();
+                        stack.pop_back();
+                        for (int dz = -1; dz <= 1; ++dz) {
+                            for (int dy = -1; dy <= 1; ++dy) {
+                                for (int dx = -1; dx <= 1; ++dx) {
+                                    const int n = std::abs(dx) +
+                                                  std::abs(dy) + std::abs(dz);
+                                    if (n == 0 ||
+                                        (connectivity == 6 && n > 1)) {
+                                        continue;
+                                    }
+                                    const long nx = p[0] + dx;
+                                    const long ny = p[1] + dy;
+                                    const long nz = p[2] + dz;
+                                    if (nx < 0 || ny < 0 || nz < 0 ||
+                                        nx >= mx || ny >= my || nz >= mz) {
+                                        continue;
+                                    }
+                                    const long nid = nx + mx * (ny + my * nz);
+                                    if (at(nx, ny, nz) == value &&
+                                        labels[nid] == -1) {
+                                        labels[nid] = static_cast<int>(count);
+                                        stack.push_back({{nx, ny, nz}});
+                                    }
+                                }
+                            }
+                        }
+                    }
+                    ++count;
+                }
+            }
+        }
+        return count;
+    };
+    Topology topology;
+    topology.components = flood(true, 26);
+    topology.cavities = flood(false, 6) - 1;
+    // Cells of the closed cubes, in doubled coordinates.
+    std::unordered_set<long> cells;
+    const long cx = 2 * sx + 3, cy = 2 * sy + 3;
+    for (long z = 0; z < sz; ++z) {
+        for (long y = 0; y < sy; ++y) {
+            for (long x = 0; x < sx; ++x) {
+                if (!voxels(x, y, z)) {
+                    continue;
+                }
+                for (int c = -1; c <= 1; ++c) {
+                    for (int b = -1; b <= 1; ++b) {
+                        for (int a = -1; a <= 1; ++a) {
+                            const long px = 2 * x + 1 + a;
+                            const long py = 2 * y + 1 + b;
+                            const long pz = 2 * z + 1 + c;
+                            if (cells.insert(px + cx * (py + cy * pz))
+                                        .second) {
+                                const int dimension =
+                                        (px & 1) + (py & 1) + (pz & 1);
+                                topology.euler +=
+                                        (dimension % 2 == 0) ? 1 : -1;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return topology;
+}
+
+size_t count_foreground(const ImageType *image) {
+    const auto *buffer = image->GetBufferPointer();
+    return std::count_if(
+            buffer, buffer + image->GetBufferedRegion().GetNumberOfPixels(),
+            [](const unsigned char v) { return v != 0; });
+}
+
+bool is_subset(const ImageType *thin, const ImageType *image) {
+    const auto num_pixels = image->GetBufferedRegion().GetNumberOfPixels();
+    for (size_t i = 0; i < num_pixels; ++i) {
+        if (thin->GetBufferPointer()[i] && !image->GetBufferPointer()[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Configuration of the voxel with identity masks. */
+uint32_t configuration(const Voxels &voxels,
+                       const long x, const long y, const long z) {
+    static const auto offsets = SG::neighbor26_offsets();
+    uint32_t config = 0;
+    for (size_t i = 0; i < 26; ++i) {
+        if (voxels(x + offsets[i][0], y + offsets[i][1], z + offsets[i][2])) {
+            config |= 1u << i;
+        }
+    }
+    return config;
+}
+} // namespace
+
+TEST(parallel_thinning, ultimate_box_is_a_voxel) {
+    auto image = create_image(14, 12, 10);
+    const Voxels voxels(image.GetPointer());
+    auto *buffer = image->GetBufferPointer();
+    for (long z = 2; z < 8; ++z) {
+        for (long y = 2; y < 10; ++y) {
+            for (long x = 2; x < 12; ++x) {
+                buffer[x + 14 * (y + 12 * z)] = 255;
+            }
+        }
+    }
+    const auto thin = SG::parallel_thinning(image.GetPointer(),
+                                            identity_masks(),
+                                            is_simple_brute_force,
+                                            is_ultimate);
+    EXPECT_EQ(count_foreground(thin.GetPointer()), 1);
+}
+
+TEST(parallel_thinning, skeletons_of_a_ring) {
+    // Thick square ring around a hole along z.
+    auto image = create_image(20, 20, 8);
+    auto *buffer = image->GetBufferPointer();
+    for (long z = 1; z < 7; ++z) {
+        for (long y = 2; y < 18; ++y) {
+            for (long x = 2; x < 18; ++x) {
+                const bool in_hole = x >= 8 && x < 12 && y >= 8 && y < 12;
+                buffer[x + 20 * (y + 20 * z)] = in_hole ? 0 : 255;
+            }
+        }
+    }
+    const auto topology = compute_topology(image.GetPointer());
+    EXPECT_EQ(topology.euler, 0);
+    const auto end_thin = SG::parallel_thinning(
+            image.GetPointer(), identity_masks(), is_simple_brute_force,
+            is_end);
+    EXPECT_TRUE(is_subset(end_thin.GetPointer(), image.GetPointer()));
+    EXPECT_EQ(compute_topology(end_thin.GetPointer()), topology);
+
+    // The ultimate skeleton is a closed curve: every voxel has at least
+    // two neighbors.
+    const auto thin = SG::parallel_thinning(image.GetPointer(),
+                                            identity_masks(),
+                                            is_simple_brute_force,
+                                            is_ultimate);
+    EXPECT_EQ(compute_topology(thin.GetPointer()), topology);
+    const Voxels thin_voxels(thin.GetPointer());
+    size_t num_voxels = 0;
+    for (long z = 0; z < 8; ++z) {
+        for (long y = 0; y < 20; ++y) {
+            for (long x = 0; x < 20; ++x) {
+                if (!thin_voxels(x, y, z)) {
+                    continue;
+                }
+                ++num_voxels;
+                const auto config = configuration(thin_voxels, x, y, z);
+                EXPECT_GE(std::bitset<32>(config).count(), 2);
+            }
+        }
+    }
+    EXPECT_GT(num_voxels, 16);
+    EXPECT_LE(num_voxels, count_foreground(end_thin.GetPointer()));
+}
+
+TEST(parallel_thinning, random_topology_and_threads) {
+    auto image = create_image(24, 20, 18);
+    std::mt19937 gen(13);
+    std::bernoulli_distribution is_foreground(0.6);
+    auto *buffer = image->GetBufferPointer();
+    for (size_t i = 0; i < 24 * 20 * 18; ++i) {
+        buffer[i] = is_foreground(gen) ? 255 : 0;
+    }
+    const auto topology = compute_topology(image.GetPointer());
+    for (const int persistence : {0, 2}) {
+        const auto thin = SG::parallel_thinning(
+                image.GetPointer(), identity_masks(), is_simple_brute_force,
+                is_end, persistence, 1);
+        EXPECT_TRUE(is_subset(thin.GetPointer(), image.GetPointer()));
+        EXPECT_EQ(compute_topology(thin.GetPointer()), topology);
+        EXPECT_LT(count_foreground(thin.GetPointer()),
+                  count_foreground(image.GetPointer()) / 2);
+        // Same result with any number of threads.
+        for (const size_t num_threads : {2, 4, 7}) {
+            const auto thin_threads = SG::parallel_thinning(
+                    image.GetPointer(), identity_masks(),
+                    is_simple_brute_force, is_end, persistence, num_threads);
+            EXPECT_TRUE(std::equal(
+                    thin->GetBufferPointer(),
+                    thin->GetBufferPointer() + 24 * 20 * 18,
+                    thin_threads->GetBufferPointer()));
+        }
+    }
+
+    // The ultimate skeleton has no simple voxels left.
+    const auto ultimate = SG::parallel_thinning(
+            image.GetPointer(), identity_masks(), is_simple_brute_force,
+            is_ultimate);
+    EXPECT_EQ(compute_topology(ultimate.GetPointer()), topology);
+    const Voxels voxels(ultimate.GetPointer());
+    for (long z = 0; z < 18; ++z) {
+        for (long y = 0; y < 20; ++y) {
+            for (long x = 0; x < 24; ++x) {
+                if (voxels(x, y, z)) {
+                    EXPECT_FALSE(is_simple_brute_force(
+                            configuration(voxels, x, y, z)));
+                }
+            }
+        }
+    }
+}
+
+TEST(parallel_thinning, persistence_sweep) {
+    // Thick bar with thick branches of different lengths.
+    const long size_x = 40, size_y = 30, size_z = 12;
+    auto image = create_image(size_x, size_y, size_z);
+    auto *buffer = image->GetBufferPointer();
+    const auto set_box = [&](const long x0, const long x1, const long y0,
+                             const long y1, const long z0, const long z1) {
+        for (long z = z0; z < z1; ++z) {
+            for (long y = y0; y < y1; ++y) {
+                for (long x = x0; x < x1; ++x) {
+                    buffer[x + size_x * (y + size_y * z)] = 255;
+                }
+            }
+        }
+    };
+    set_box(2, 38, 4, 9, 3, 8);
+    for (long branch = 0; branch < 4; ++branch) {
+        const long x = 6 + 9 * branch;
+        set_box(x, x + 3, 9, 12 + 4 * branch, 4, 7);
+    }
+    // Curve voxels are eroded from the branch ends while they wait for
+    // persistence, so each value keeps branches of a different length.
+    const auto is_curve = [](const uint32_t config) {
+        return std::bitset<32>(config).count() == 2;
+    };
+    const std::vector<int> persistences = {3, 0, 2, 2, 1, 6};
+    const auto thin_images = SG::parallel_thinning_sweep(
+            image.GetPointer(), identity_masks(), is_simple_brute_force,
+            is_curve, persistences, 2);
+    ASSERT_EQ(thin_images.size(), persistences.size());
+    std::set<std::vector<unsigned char>> different_images;
+    for (size_t i = 0; i < persistences.size(); ++i) {
+        const auto thin = SG::parallel_thinning(
+                image.GetPointer(), identity_masks(), is_simple_brute_force,
+                is_curve, persistences[i], 2);
+        EXPECT_TRUE(std::equal(thin->GetBufferPointer(),
+                               thin->GetBufferPointer() + size_x * size_y * size_z,
+                               thin_images[i]->GetBufferPointer()))
+                << "persistence: " << persistences[i];
+        different_images.emplace(thin->GetBufferPointer(),
+                                 thin->GetBufferPointer() + size_x * size_y * size_z);
+    }
+    // The values do give different skeletons.
+    EXPECT_GT(different_images.size(), 2u);
+
+    // Same foreground voxels without creating the dense images.
+    const auto sparse_images = SG::parallel_thinning_sparse_sweep(
+            image.GetPointer(), identity_masks(), is_simple_brute_force,
+            is_curve, persistences, 2);
+    ASSERT_EQ(sparse_images.size(), persistences.size());
+    for (size_t i = 0; i < persistences.size(); ++i) {
+        EXPECT_EQ(sparse_images[i].indices,
+                  SG::sparse_binary_image_from_image(
+                          thin_images[i].GetPointer())
+                          .indices);
+    }
+
+    EXPECT_TRUE(SG::parallel_thinning_sweep(image.GetPointer(),
+                                            identity_masks(),
+                                            is_simple_brute_force, is_end,
+                                            std::vector<int>{})
+                        .empty());
+    EXPECT_THROW(SG::parallel_thinning_sweep(image.GetPointer(),
+                                             identity_masks(),
+                                             is_simple_brute_force, is_end,
+                                             std::vector<int>{1, -1}),
+                 std::runtime_error);
+}
@@ -0,0 +1,337 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "reduce_spatial_graph_via_dfs.hpp"
+#include "reduced_graph_from_image.hpp"
+#include "spatial_graph_from_image.hpp"
+#include "stitch_tiled_graphs.hpp"
+
+#include "gmock/gmock.h"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace {
+template <typename TImage>
+typename TImage::Pointer
+create_image(const typename TImage::SizeType &size,
+             const typename TImage::IndexType &start) {
+    auto image = TImage::New();
+    typename TImage::RegionType region;
+    region.SetIndex(start);
+    region.SetSize(size);
+    image->SetRegions(region);
+    image->Allocate();
+    image->FillBuffer(0);
+    return image;
+}
+
+template <typename TImage>
+void fill_random(TImage *image, const double foreground_probability) {
+    std::mt19937 gen(29);
+    std::bernoulli_distribution is_foreground(foreground_probability);
+    auto *buffer = image->GetBufferPointer();
+    const auto num_pixels = image->GetBufferedRegion().GetNumberOfPixels();
+    for (size_t i = 0; i < num_pixels; ++i) {
+        buffer[i] = is_foreground(gen) ? 255 : 0;
+    }
+}
+
+/** Set the pixels at the given offsets (x, y, z) from the buffer start. */
+void set_pixels(SG::BinaryImageType *image,
+                const std::vector<std::array<size_t, 3>> &pixels) {
+    const auto size = image->GetBufferedRegion().GetSize();
+    auto *buffer = image->GetBufferPointer();
+    for (const auto &p : pixels) {
+        buffer[p[0] + size[0] * (p[1] + size[1] * p[2])] = 255;
+    }
+}
+
+/**
+ * Sorted nodes and edges of a graph, independent of the node numbering.
+ * Edges are (source position, target position, edge points), with the
+ * lower position first.
+ */
+template <typename TGraph>
+struct GraphPositions {
+    using PointType = typename TGraph::vertex_bundled::PointType;
+    using EdgeTuple =
+            std::tuple<PointType, PointType, std::vector<PointType>>;
+    std::vector<PointType> nodes;
+    std::vector<EdgeTuple> edges;
+
+    explicit GraphPositions(const TGraph &graph) {
+        const auto num_vertices = boost::num_vertices(graph);
+        for (size_t v = 0; v < num_vertices; ++v) {
+            nodes.push_back(graph[v].pos);
+        }
+        const auto graph_edges = boost::edges(graph);
+        for (auto ei = graph_edges.first; ei != graph_edges.second; ++ei) {
+            auto source_pos = graph[boost::source(*ei, graph)].pos;
+            auto target_pos = graph[boost::target(*ei, graph)].pos;
+            std::vector<PointType> points(graph[*ei].edge_points.begin(),
+                                          graph[*ei].edge_points.end());
+            if (target_pos < source_pos) {
+                std::swap(source_pos, target_pos);
+                std::reverse(points.begin(), points.end());
+            }
+            edges.emplace_back(source_pos, target_pos, points);
+        }
+        std::sort(nodes.begin(), nodes.end());
+        std::sort(edges.begin(), edges.end());
+    }
+};
+
+template <typename TGraph, typename TImage>
+void expect_same_than_reduce_via_dfs(const TImage *image) {
+    const auto raw_graph = SG::spatial_graph_from_image<TGraph>(image);
+    const auto expected =
+            GraphPositions<TGraph>(SG::reduce_spatial_graph_via_dfs(raw_graph));
+    const auto result =
+            GraphPositions<TGraph>(SG::reduced_graph_from_image<TGraph>(image));
+    EXPECT_EQ(result.nodes, expected.nodes);
+    EXPECT_EQ(result.edges, expected.edges);
+}
+
+/**
+ * Check that each edge of the graph with one node per pixel is in exactly
+ * one edge of the reduced graph, walking from its source to its target
+ * through its edge points.
+ * The only exception are cycles of three pixels, that are reduced to a
+ * node without edges, as reduce_spatial_graph_via_dfs does.
+ */
+template <typename TGraph, typename TImage>
+void expect_all_pixel_edges_in_reduced_edges(const TImage *image) {
+    using PointType = typename TGraph::vertex_bundled::PointType;
+    using PointPair = std::pair<PointType, PointType>;
+    const auto raw_graph = SG::spatial_graph_from_image<TGraph>(image);
+    const auto reduced = SG::reduced_graph_from_image<TGraph>(image);
+
+    std::vector<PointPair> raw_edges;
+    const auto raw_graph_edges = boost::edges(raw_graph);
+    for (auto ei = raw_graph_edges.first; ei != raw_graph_edges.second; ++ei) {
+        const auto &source_pos = raw_graph[boost::source(*ei, raw_graph)].pos;
+        const auto &target_pos = raw_graph[boost::target(*ei, raw_graph)].pos;
+        raw_edges.emplace_back(std::min(source_pos, target_pos),
+                               std::max(source_pos, target_pos));
+    }
+    std::sort(raw_edges.begin(), raw_edges.end());
+
+    std::vector<PointPair> walked_edges;
+    const auto reduced_edges = boost::edges(reduced);
+    for (auto ei = reduced_edges.first; ei != reduced_edges.second; ++ei) {
+        std::vector<PointType> path;
+        path.push_back(reduced[boost::source(*ei, reduced)].pos);
+        path.insert(path.end(), reduced[*ei].edge_points.begin(),
+                    reduced[*ei].edge_points.end());
+        path.push_back(reduced[boost::target(*ei, reduced)].pos);
+        for (size_t i = 0; i + 1 < path.size(); ++i) {
+            walked_edges.emplace_back(std::min(path[i], path[i + 1]),
+                                      std::max(path[i], path[i + 1]));
+        }
+    }
+    std::sort(walked_edges.begin(), walked_edges.end());
+
+    std::vector<PointPair> missing_edges;
+    std::set_difference(raw_edges.begin(), raw_edges.end(),
+                        walked_edges.begin(), walked_edges.end(),
+                        std::back_inserter(missing_edges));
+    size_t num_nodes_without_edges = 0;
+    for (size_t v = 0; v < boost::num_vertices(reduced); ++v) {
+        num_nodes_without_edges += (boost::out_degree(v, reduced) == 0);
+    }
+    EXPECT_EQ(missing_edges.size(), 3 * num_nodes_without_edges);
+    EXPECT_EQ(walked_edges.size() + missing_edges.size(), raw_edges.size());
+
+    // The result does not depend on the number of threads.
+    const auto result = GraphPositions<TGraph>(reduced);
+    const auto result_single_thread = GraphPositions<TGraph>(
+            SG::reduced_graph_from_image<TGraph>(image, 1));
+    EXPECT_EQ(result_single_thread.nodes, result.nodes);
+    EXPECT_EQ(result_single_thread.edges, result.edges);
+}
+
+/**
+ * End points, junctions and the edges between them. The other nodes are
+ * created splitting cycles, they depend on the first voxel visited.
+ */
+GraphPositions<SG::GraphType> end_points_and_junctions(SG::GraphType graph) {
+    const auto num_vertices = boost::num_vertices(graph);
+    std::vector<bool> is_kept(num_vertices);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        const auto degree = boost::degree(v, graph);
+        is_kept[v] = degree == 1 || degree > 2;
+    }
+    boost::remove_edge_if(
+            [&graph, &is_kept](const SG::GraphType::edge_descriptor &e) {
+                return !is_kept[boost::source(e, graph)] ||
+                       !is_kept[boost::target(e, graph)];
+            },
+            graph);
+    auto positions = GraphPositions<SG::GraphType>(graph);
+    positions.nodes.clear();
+    for (size_t v = 0; v < num_vertices; ++v) {
+        if (is_kept[v]) {
+            positions.nodes.push_back(graph[v].pos);
+        }
+    }
+    std::sort(positions.nodes.begin(), positions.nodes.end());
+    return positions;
+}
+} // namespace
+
+TEST(reduced_graph_from_image, chains_junctions_and_cycle) {
+    using ImageType = SG::BinaryImageType;
+    ImageType::SizeType size;
+    size.Fill(16);
+    ImageType::IndexType start;
+    start[0] = -2;
+    start[1] = 0;
+    start[2] = 3;
+    auto image = create_image<ImageType>(size, start);
+    set_pixels(image.GetPointer(),
+               {// Line with two end points
+                {{1, 1, 1}}, {{2, 1, 1}}, {{3, 2, 1}}, {{4, 2, 1}},
+                {{5, 2, 2}}, {{6, 2, 2}},
+                // Cycle without nodes in another slice
+                {{10, 10, 8}}, {{11, 10, 8}}, {{12, 11, 8}}, {{12, 12, 8}},
+                {{11, 13, 8}}, {{10, 13, 8}}, {{9, 12, 8}}, {{9, 11, 8}},
+                // T shape, with a cluster of four junctions in its center
+                {{2, 5, 12}}, {{3, 5, 12}}, {{4, 5, 12}}, {{5, 5, 12}},
+                {{6, 5, 12}}, {{7, 5, 12}}, {{8, 5, 12}}, {{5, 6, 12}},
+                {{5, 7, 12}}, {{5, 8, 12}},
+                // Isolated pixel, ignored
+                {{14, 1, 14}}});
+    const auto reduced = SG::reduced_graph_from_image<SG::GraphType>(image);
+    // End points and junctions in buffer order: 2 in the line, 3 end points
+    // and 4 junctions in the T. Then the first pixel of the cycle and the
+    // node splitting it.
+    ASSERT_EQ(boost::num_vertices(reduced), 11);
+    // Line: 1, T: 3 arms and 5 edges between junctions, cycle: 2.
+    ASSERT_EQ(boost::num_edges(reduced), 11);
+    EXPECT_EQ(reduced[0].pos, (SG::PointType{{-1, 1, 4}}));
+    EXPECT_EQ(reduced[1].pos, (SG::PointType{{4, 2, 5}}));
+    const auto line_edge = boost::edge(0, 1, reduced);
+    ASSERT_TRUE(line_edge.second);
+    EXPECT_EQ(reduced[line_edge.first].edge_points.size(), 4);
+    // Center of the T
+    EXPECT_EQ(reduced[4].pos, (SG::PointType{{3, 5, 15}}));
+    EXPECT_EQ(boost::out_degree(4, reduced), 3);
+    EXPECT_EQ(reduced[9].pos, (SG::PointType{{8, 10, 11}}));
+    EXPECT_EQ(boost::out_degree(9, reduced), 2);
+    EXPECT_EQ(boost::out_degree(10, reduced), 2);
+    expect_same_than_reduce_via_dfs<SG::GraphType>(image.GetPointer());
+}
+
+TEST(reduced_graph_from_image, all_pixel_edges_in_reduced_edges_3D) {
+    using ImageType = SG::BinaryImageType;
+    ImageType::SizeType size;
+    size[0] = 48;
+    size[1] = 40;
+    size[2] = 32;
+    ImageType::IndexType start;
+    start.Fill(0);
+    auto image = create_image<ImageType>(size, start);
+    fill_random(image.GetPointer(), 0.04);
+    expect_all_pixel_edges_in_reduced_edges<SG::GraphType>(image.GetPointer());
+}
+
+TEST(reduced_graph_from_image, all_pixel_edges_in_reduced_edges_2D) {
+    using ImageType = SG::BinaryImageType2D;
+    ImageType::SizeType size;
+    size[0] = 60;
+    size[1] = 50;
+    ImageType::IndexType start;
+    start[0] = 5;
+    start[1] = -7;
+    auto image = create_image<ImageType>(size, start);
+    fill_random(image.GetPointer(), 0.15);
+    expect_all_pixel_edges_in_reduced_edges<SG::GraphType2D>(
+            image.GetPointer());
+}
+
+TEST(reduced_graph_from_image, stitch_tiles_as_whole_image) {
+    using ImageType = SG::BinaryImageType;
+    ImageType::SizeType size;
+    size[0] = 40;
+    size[1] = 33;
+    size[2] = 25;
+    ImageType::IndexType start;
+    start[0] = 3;
+    start[1] = -4;
+    start[2] = 0;
+    auto image = create_image<ImageType>(size, start);
+    fill_random(image.GetPointer(), 0.04);
+    const auto whole = SG::reduced_graph_from_image<SG::GraphType>(image);
+
+    // Copy each tile to its own image, in the same index space.
+    const std::array<long, 3> tile_size = {{10, 9, 8}};
+    SG::TiledGraphStitcher stitcher;
+    const auto *buffer = image->GetBufferPointer();
+    for (long z = 0; z < static_cast<long>(size[2]); z += tile_size[2]) {
+        for (long y = 0; y < static_cast<long>(size[1]); y += tile_size[1]) {
+            for (long x = 0; x < static_cast<long>(size[0]);
+                 x += tile_size[0]) {
+                const std::array<long, 3> offset = {{x, y, z}};
+                ImageType::SizeType tile_image_size;
+                ImageType::IndexType tile_start;
+                SG::TiledGraphStitcher::IndexType begin;
+                SG::TiledGraphStitcher::IndexType end;
+                for (size_t d = 0; d < 3; ++d) {
+                    tile_image_size[d] = std::min(
+                            tile_size[d],
+                            static_cast<long>(size[d]) - offset[d]);
+                    tile_start[d] = start[d] + offset[d];
+                    begin[d] = tile_start[d];
+                    end[d] = tile_start[d] + tile_image_size[d];
+                }
+                auto tile = create_image<ImageType>(tile_image_size,
+                                                    tile_start);
+                auto *tile_buffer = tile->GetBufferPointer();
+                for (size_t k = 0; k < tile_image_size[2]; ++k) {
+                    for (size_t j = 0; j < tile_image_size[1]; ++j) {
+                        for (size_t i = 0; i < tile_image_size[0]; ++i) {
+                            tile_buffer[i + tile_image_size[0] *
+                                                    (j + tile_image_size[1] *
+                                                                 k)] =
+                                    buffer[(x + i) +
+                                           size[0] * ((y + j) +
+                                                      size[1] * (z + k))];
+                        }
+                    }
+                }
+                const auto boundary_nodes = true;
+                stitcher.add_tile(SG::reduced_graph_from_image<SG::GraphType>(
+                                          tile, 0, boundary_nodes),
+                                  begin, end);
+            }
+        }
+    }
+    EXPECT_EQ(stitcher.num_tiles(), 4 * 4 * 4);
+    const auto stitched = stitcher.stitch();
+
+    const auto expected = end_points_and_junctions(whole);
+    const auto result = end_points_and_junctions(stitched);
+    EXPECT_GT(expected.nodes.size(), 100);
+    EXPECT_EQ(result.nodes, expected.nodes);
+    EXPECT_EQ(result.edges, expected.edges);
+}
@@ -0,0 +1,143 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "reduced_graph_from_image.hpp"
+#include "sparse_binary_image.hpp"
+#include "spatial_graph_from_image.hpp"
+
+#include "gmock/gmock.h"
+#include <random>
+
+namespace {
+using ImageType = SG::BinaryImageType;
+
+ImageType::Pointer create_random_image(const double foreground_probability) {
+    auto image = ImageType::New();
+    ImageType::RegionType region;
+    ImageType::IndexType start;
+    start[0] = -3;
+    start[1] = 2;
+    start[2] = 5;
+    ImageType::SizeType size;
+    size[0] = 31;
+    size[1] = 17;
+    size[2] = 12;
+    region.SetIndex(start);
+    region.SetSize(size);
+    image->SetRegions(region);
+    ImageType::PointType origin;
+    origin[0] = 1.5;
+    origin[1] = -2.0;
+    origin[2] = 0.25;
+    image->SetOrigin(origin);
+    ImageType::SpacingType spacing;
+    spacing[0] = 0.5;
+    spacing[1] = 1.0;
+    spacing[2] = 2.0;
+    image->SetSpacing(spacing);
+    image->Allocate();
+    std::mt19937 gen(7);
+    std::bernoulli_distribution is_foreground(foreground_probability);
+    auto *buffer = image->GetBufferPointer();
+    for (size_t i = 0; i < region.GetNumberOfPixels(); ++i) {
+        buffer[i] = is_foreground(gen) ? 255 : 0;
+    }
+    return image;
+}
+
+template <typename TGraph> void expect_same_graph(const TGraph &a,
+                                                  const TGraph &b) {
+    ASSERT_EQ(boost::num_vertices(a), boost::num_vertices(b));
+    ASSERT_EQ(boost::num_edges(a), boost::num_edges(b));
+    for (size_t v = 0; v < boost::num_vertices(a); ++v) {
+        EXPECT_EQ(a[v].pos, b[v].pos);
+    }
+    auto ei = boost::edges(a).first;
+    auto ei_b = boost::edges(b).first;
+    for (; ei != boost::edges(a).second; ++ei, ++ei_b) {
+        EXPECT_EQ(boost::source(*ei, a), boost::source(*ei_b, b));
+        EXPECT_EQ(boost::target(*ei, a), boost::target(*ei_b, b));
+        EXPECT_EQ(a[*ei].edge_points, b[*ei_b].edge_points);
+    }
+}
+} // namespace
+
+TEST(sparse_binary_image, round_trip) {
+    const auto image = create_random_image(0.1);
+    const auto sparse = SG::sparse_binary_image_from_image(image.GetPointer(), 2);
+    const auto *buffer = image->GetBufferPointer();
+    const auto num_pixels = image->GetBufferedRegion().GetNumberOfPixels();
+    size_t num_foreground = 0;
+    for (size_t i = 0; i < num_pixels; ++i) {
+        num_foreground += (buffer[i] != 0);
+    }
+    ASSERT_EQ(sparse.size(), num_foreground);
+    EXPECT_EQ(sparse.origin, image->GetOrigin());
+    EXPECT_EQ(sparse.spacing, image->GetSpacing());
+
+    const auto dense = SG::image_from_sparse_binary_image(sparse);
+    EXPECT_EQ(dense->GetBufferedRegion().GetIndex(),
+              image->GetBufferedRegion().GetIndex());
+    EXPECT_EQ(dense->GetOrigin(), image->GetOrigin());
+    const auto *dense_buffer = dense->GetBufferPointer();
+    for (size_t i = 0; i < num_pixels; ++i) {
+        EXPECT_EQ(dense_buffer[i], buffer[i]);
+    }
+}
+
+TEST(sparse_binary_image, sort_indices) {
+    const auto image = create_random_image(0.1);
+    const auto sparse = SG::sparse_binary_image_from_image(image.GetPointer());
+    auto shuffled = sparse;
+    std::mt19937 gen(3);
+    std::shuffle(shuffled.indices.begin(), shuffled.indices.end(), gen);
+    shuffled.indices.push_back(shuffled.indices.front());
+    SG::sort_indices(shuffled);
+    EXPECT_EQ(shuffled.indices, sparse.indices);
+
+    auto outside = sparse;
+    auto index = outside.region.GetIndex();
+    index[1] -= 1;
+    outside.indices.push_back(index);
+    EXPECT_THROW(SG::sort_indices(outside), std::runtime_error);
+}
+
+TEST(sparse_binary_image, same_graphs_than_image) {
+    const auto image = create_random_image(0.05);
+    const auto sparse = SG::sparse_binary_image_from_image(image.GetPointer());
+    expect_same_graph(SG::spatial_graph_from_image<SG::GraphType>(image),
+                      SG::spatial_graph_from_image<SG::GraphType>(sparse));
+    expect_same_graph(SG::reduced_graph_from_image<SG::GraphType>(image),
+                      SG::reduced_graph_from_image<SG::GraphType>(sparse));
+    const bool boundary_nodes = true;
+    expect_same_graph(
+            SG::reduced_graph_from_image<SG::GraphType>(image, 2,
+                                                        boundary_nodes),
+            SG::reduced_graph_from_image<SG::GraphType>(sparse, 2,
+                                                        boundary_nodes));
+}
+
+TEST(sparse_binary_image, empty) {
+    const auto image = create_random_image(0.0);
+    const auto sparse = SG::sparse_binary_image_from_image(image.GetPointer());
+    EXPECT_TRUE(sparse.empty());
+    const auto sg = SG::reduced_graph_from_image<SG::GraphType>(sparse);
+    EXPECT_EQ(boost::num_vertices(sg), 0);
+}
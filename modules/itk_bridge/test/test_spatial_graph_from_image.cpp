@@ -0,0 +1,177 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "spatial_graph_from_image.hpp"
+
+#include "gmock/gmock.h"
+#include <random>
+#include <set>
+#include <tuple>
+
+namespace {
+template <typename TImage>
+typename TImage::Pointer
+create_random_binary_image(const typename TImage::SizeType &size,
+                           const typename TImage::IndexType &start,
+                           const double foreground_probability) {
+    auto image = TImage::New();
+    typename TImage::RegionType region;
+    region.SetIndex(start);
+    region.SetSize(size);
+    image->SetRegions(region);
+    image->Allocate();
+    image->FillBuffer(0);
+    std::mt19937 gen(42);
+    std::bernoulli_distribution is_foreground(foreground_probability);
+    auto *buffer = image->GetBufferPointer();
+    const auto num_pixels = region.GetNumberOfPixels();
+    for (size_t i = 0; i < num_pixels; ++i) {
+        buffer[i] = is_foreground(gen) ? 255 : 0;
+    }
+    return image;
+}
+
+/** Edges as pairs of sorted positions, to compare graphs. */
+template <typename TGraph>
+std::set<std::pair<typename TGraph::vertex_bundled::PointType,
+                   typename TGraph::vertex_bundled::PointType>>
+edge_positions(const TGraph &graph) {
+    std::set<std::pair<typename TGraph::vertex_bundled::PointType,
+                       typename TGraph::vertex_bundled::PointType>>
+            output;
+    const auto edges = boost::edges(graph);
+    for (auto ei = edges.first; ei != edges.second; ++ei) {
+        const auto &source_pos = graph[boost::source(*ei, graph)].pos;
+        const auto &target_pos = graph[boost::target(*ei, graph)].pos;
+        output.emplace(std::min(source_pos, target_pos),
+                       std::max(source_pos, target_pos));
+    }
+    return output;
+}
+
+/** Brute force: connect all pairs of nodes that are neighbors. */
+template <typename TGraph>
+std::set<std::pair<typename TGraph::vertex_bundled::PointType,
+                   typename TGraph::vertex_bundled::PointType>>
+brute_force_edge_positions(const TGraph &graph) {
+    std::set<std::pair<typename TGraph::vertex_bundled::PointType,
+                       typename TGraph::vertex_bundled::PointType>>
+            output;
+    std::set<typename TGraph::vertex_bundled::PointType> positions;
+    const auto num_vertices = boost::num_vertices(graph);
+    for (size_t v = 0; v < num_vertices; ++v) {
+        positions.insert(graph[v].pos);
+    }
+    const size_t dimension = TGraph::vertex_bundled::Dimension;
+    size_t num_offsets = 1;
+    for (size_t d = 0; d < dimension; ++d) {
+        num_offsets *= 3;
+    }
+    for (const auto &pos : positions) {
+        for (size_t offset = 0; offset < num_offsets; ++offset) {
+            auto other = pos;
+            size_t remainder = offset;
+            for (size_t d = 0; d < dimension; ++d) {
+                other[d] += static_cast<double>(remainder % 3) - 1.0;
+                remainder /= 3;
+            }
+            if (pos < other && positions.count(other)) {
+                output.emplace(pos, other);
+            }
+        }
+    }
+    return output;
+}
+} // namespace
+
+TEST(spatial_graph_from_image, same_graph_than_brute_force_3D) {
+    using ImageType = SG::BinaryImageType;
+    ImageType::SizeType size;
+    size[0] = 64;
+    size[1] = 64;
+    size[2] = 48;
+    ImageType::IndexType start;
+    start[0] = -3;
+    start[1] = 2;
+    start[2] = 5;
+    const auto image = create_random_binary_image<ImageType>(size, start, 0.05);
+
+    const auto sg = SG::spatial_graph_from_image<SG::GraphType>(image, 1);
+    size_t num_foreground = 0;
+    const auto *buffer = image->GetBufferPointer();
+    for (size_t i = 0; i < size[0] * size[1] * size[2]; ++i) {
+        num_foreground += (buffer[i] != 0);
+    }
+    ASSERT_EQ(boost::num_vertices(sg), num_foreground);
+    // Nodes are in buffer order, in index space.
+    for (size_t v = 0; v + 1 < boost::num_vertices(sg); ++v) {
+        const auto &pos = sg[v].pos;
+        const auto &next_pos = sg[v + 1].pos;
+        EXPECT_TRUE(std::make_tuple(pos[2], pos[1], pos[0]) <
+                    std::make_tuple(next_pos[2], next_pos[1], next_pos[0]));
+    }
+    EXPECT_EQ(sg[0].pos[2], start[2]);
+
+    const auto edges = edge_positions(sg);
+    EXPECT_EQ(edges.size(), boost::num_edges(sg)); // no parallel edges
+    EXPECT_EQ(edges, brute_force_edge_positions(sg));
+
+    // Same graph, including edge order, with multiple threads.
+    const auto sg_threads =
+            SG::spatial_graph_from_image<SG::GraphType>(image, 3);
+    ASSERT_EQ(boost::num_vertices(sg_threads), boost::num_vertices(sg));
+    ASSERT_EQ(boost::num_edges(sg_threads), boost::num_edges(sg));
+    auto ei = boost::edges(sg).first;
+    auto ei_threads = boost::edges(sg_threads).first;
+    for (; ei != boost::edges(sg).second; ++ei, ++ei_threads) {
+        EXPECT_EQ(boost::source(*ei, sg),
+                  boost::source(*ei_threads, sg_threads));
+        EXPECT_EQ(boost::target(*ei, sg),
+                  boost::target(*ei_threads, sg_threads));
+    }
+}
+
+TEST(spatial_graph_from_image, same_graph_than_brute_force_2D) {
+    using ImageType = SG::BinaryImageType2D;
+    ImageType::SizeType size;
+    size[0] = 40;
+    size[1] = 30;
+    ImageType::IndexType start;
+    start[0] = 0;
+    start[1] = 0;
+    const auto image = create_random_binary_image<ImageType>(size, start, 0.3);
+
+    const auto sg = SG::spatial_graph_from_image<SG::GraphType2D>(image);
+    const auto edges = edge_positions(sg);
+    EXPECT_EQ(edges.size(), boost::num_edges(sg));
+    EXPECT_EQ(edges, brute_force_edge_positions(sg));
+}
+
+TEST(spatial_graph_from_image, empty_image) {
+    using ImageType = SG::BinaryImageType;
+    ImageType::SizeType size;
+    size.Fill(4);
+    ImageType::IndexType start;
+    start.Fill(0);
+    const auto image = create_random_binary_image<ImageType>(size, start, 0.0);
+    const auto sg = SG::spatial_graph_from_image<SG::GraphType>(image);
+    EXPECT_EQ(boost::num_vertices(sg), 0);
+    EXPECT_EQ(boost::num_edges(sg), 0);
+}
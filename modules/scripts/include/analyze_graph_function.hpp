@@ -23,6 +23,7 @@
 
 #include "spatial_graph.hpp"
 #include "image_types.hpp" // For SG::BinaryImageType
+#include "sparse_binary_image.hpp"
 #include <itkImage.h>
 #include <itkImageFileReader.h>
 #include "transform_to_physical_point.hpp"
@@ -39,7 +40,9 @@ typename ItkImageType::Pointer itk_image_from_file( const std::string & filename
     return reader->GetOutput();
 }
 /**
- * Read graph from a binary itk image or file using ITK and DGtal
+ * Read graph from a binary itk image or file.
+ * Each foreground voxel is a node, connected to its 26-neighbors.
+ * See @ref spatial_graph_from_image.
  *
  * @param filename
  *
@@ -48,6 +51,28 @@ typename ItkImageType::Pointer itk_image_from_file( const std::string & filename
 GraphType raw_graph_from_image(
         const SG::BinaryImageType::Pointer & thin_image);
 GraphType raw_graph_from_image(const std::string & filename);
+/**
+ * Read graph from the foreground voxels of a thin image, without the dense
+ * image, see @ref thin_function_sparse.
+ *
+ * @param thin_image sparse thin image
+ *
+ * @return SpatialGraph, in index space
+ */
+GraphType raw_graph_from_image(const SG::SparseBinaryImage & thin_image);
+
+/**
+ * Read graph from a 2D binary itk image or file.
+ * It uses the 2D topology (8-connected foreground, 4-connected background)
+ * and 2D points, instead of a 3D image with a single slice.
+ *
+ * @param thin_image 2D binary image
+ *
+ * @return 2D SpatialGraph, in index space
+ */
+GraphType2D raw_graph_from_image(
+        const SG::BinaryImageType2D::Pointer & thin_image);
+GraphType2D raw_graph_from_image_2d(const std::string & filename);
 
 /**
  * Merge nodes optionally using all merge nodes methods
@@ -74,7 +99,7 @@ void check_parallel_edges_interface(GraphType & reduced_g, bool verbose = false)
 
 template <typename ItkImageType>
 void transform_to_physical_point_interface(
-        GraphType & reduced_g,
+        GraphTypeT<double, ItkImageType::ImageDimension> & reduced_g,
         typename ItkImageType::Pointer itk_image,
         const std::string &spacing,
         bool verbose = false
@@ -129,6 +154,7 @@ void transform_to_physical_point_interface(
  * @param exportVtu
  * @param exportGraphviz
  * @param verbose
+ * @param exportBinary write the graph in the binary format (.sgb)
  */
 void export_graph_interface(GraphType & reduced_g,
         const std::string & exportReducedGraph_foldername,
@@ -137,7 +163,8 @@ void export_graph_interface(GraphType & reduced_g,
         bool exportVtu = false,
         bool exportVtuWithEdgePoints = false,
         bool exportGraphviz = false,
-        const bool verbose = false
+        const bool verbose = false,
+        bool exportBinary = false
         );
 
 void export_graph_data_interface(const GraphType & reduced_g,
@@ -152,6 +179,14 @@ void export_graph_data_interface(const GraphType & reduced_g,
  * Given an input binary image file holding a thin/skeleton (that can be read internally ITK)
  * Transform to it a DGtal Object, and transform it into a
  * GraphType.
+ *
+ * traceReducedGraph: trace the reduced graph directly from the image with
+ * @ref reduced_graph_from_image, instead of creating the graph with one node
+ * per voxel and reducing it with @ref reduce_spatial_graph_via_dfs.
+ * It uses less memory, but in clusters of adjacent junctions it keeps
+ * every voxel adjacency, so the graph might have extra edges or loops
+ * compared to the dfs reduction. Ignored if removeExtraEdges is true,
+ * it needs the graph with one node per voxel.
  */
 GraphType analyze_graph_function(
         const SG::BinaryImageType::Pointer & thin_image,
@@ -174,7 +209,9 @@ GraphType analyze_graph_function(
         bool ignoreEdgesToEndNodes = false,
         size_t ignoreEdgesShorterThan = 0,
         bool verbose = false,
-        bool visualize = false);
+        bool visualize = false,
+        bool exportBinary = false,
+        bool traceReducedGraph = false);
 
 GraphType analyze_graph_function_io(
         const std::string & filename_thin_image,
@@ -196,7 +233,9 @@ GraphType analyze_graph_function_io(
         bool ignoreEdgesToEndNodes = false,
         size_t ignoreEdgesShorterThan = 0,
         bool verbose = false,
-        bool visualize = false);
+        bool visualize = false,
+        bool exportBinary = false,
+        bool traceReducedGraph = false);
 
 } // end namespace SG
 #endif
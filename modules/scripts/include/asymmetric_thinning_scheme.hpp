@@ -0,0 +1,426 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef ASYMMETRIC_THINNING_SCHEME_HPP
+#define ASYMMETRIC_THINNING_SCHEME_HPP
+
+#include <DGtal/base/Common.h>
+#include <DGtal/topology/KhalimskyCellHashFunctions.h>
+#include <DGtal/topology/VoxelComplex.h>
+#include <DGtal/topology/VoxelComplexFunctions.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace SG {
+
+namespace detail {
+/**
+ * State of asymmetric_thinning_scheme between passes. It can be copied to
+ * continue the thinning from the same point with other parameters.
+ */
+template <typename TComplex>
+struct AsymmetricThinningState {
+  using Cell = typename TComplex::Cell;
+  using Clique = typename TComplex::Clique;
+  explicit AsymmetricThinningState(const TComplex & vc)
+    : X(vc), K(vc.space()) {
+    K.copySimplicityTable(vc);
+  }
+  TComplex X;
+  /** Voxels kept in the skeleton. */
+  TComplex K;
+  /** Critical voxels (non simple). */
+  std::unordered_set<Cell> critical_voxels;
+  /** Critical cliques of the cells of dimension 0, 1 and 2. */
+  std::array<std::unordered_map<Cell, Clique>, 3> critical_cliques;
+  /** Voxels not in K where Skel has to be evaluated after the next pass. */
+  std::unordered_set<Cell> skel_candidates;
+  /** Pass (starting at 1) in which Skel held for the first time. */
+  std::unordered_map<Cell, uint32_t> births;
+  /** Last finished pass. */
+  uint32_t pass = 0;
+  /** True when the last pass removed no voxel. */
+  bool finished = false;
+
+  /** Evaluate again the critical clique of the cell. */
+  void update_cell(const Cell & cell) {
+    const auto & ks = X.space();
+    const auto d = ks.uDim(cell);
+    const TComplex & const_X = X;
+    const auto it = const_X.findCell(d, cell);
+    const bool is_critical = it != const_X.end(d) &&
+      const_X.criticalCliquePair(d, it).first;
+    if(d == 3) {
+      if(is_critical) {
+        critical_voxels.insert(cell);
+      } else {
+        critical_voxels.erase(cell);
+      }
+      return;
+    }
+    critical_cliques[d].erase(cell);
+    if(is_critical) {
+      critical_cliques[d].emplace(cell,
+          const_X.criticalCliquePair(d, it).second);
+    }
+  }
+
+  /** Evaluate all the cells, used before the first pass. */
+  void update_all_cells() {
+    std::vector<Cell> cells;
+    for(size_t d = 0; d <= 3; ++d) {
+      for(auto it = X.begin(d), itE = X.end(d); it != itE; ++it) {
+        cells.push_back(it->first);
+      }
+    }
+    for(const auto & cell : cells) {
+      update_cell(cell);
+    }
+    for(auto it = X.begin(3), itE = X.end(3); it != itE; ++it) {
+      skel_candidates.insert(it->first);
+    }
+  }
+};
+
+/**
+ * Remove the voxels of X not selected from its critical cliques, and
+ * evaluate again the cells around them.
+ *
+ * @return number of removed voxels.
+ */
+template <typename TComplex>
+size_t asymmetric_thinning_removal(
+    AsymmetricThinningState<TComplex> & state,
+    const std::function<std::pair<typename TComplex::Cell,
+      typename TComplex::Data>(const typename TComplex::Clique &)> & Select) {
+  using Cell = typename TComplex::Cell;
+  using Clique = typename TComplex::Clique;
+  using Data = typename TComplex::Data;
+  using Point = typename TComplex::KSpace::Point;
+  auto & X = state.X;
+  const auto & ks = X.space();
+  ++state.pass;
+
+  TComplex Y(state.K);
+  for(size_t d = 4; d-- > 0;) {
+    std::vector<std::pair<Cell, Data>> selected;
+    const auto select_if_free = [&](const Clique & clique) {
+      for(auto it = clique.begin(3), itE = clique.end(3); it != itE; ++it) {
+        if(Y.belongs(it->first)) {
+          return;
+        }
+      }
+      selected.push_back(Select(clique));
+    };
+    if(d == 3) {
+      const TComplex & const_X = X;
+      for(const auto & voxel : state.critical_voxels) {
+        if(!Y.belongs(voxel)) {
+          select_if_free(
+              const_X.criticalCliquePair(3, const_X.findCell(3, voxel))
+              .second);
+        }
+      }
+    } else {
+      for(const auto & cell_clique : state.critical_cliques[d]) {
+        select_if_free(cell_clique.second);
+      }
+    }
+    for(const auto & cell_data : selected) {
+      Y.insertVoxelCell(cell_data.first, true, cell_data.second);
+    }
+  }
+
+  std::vector<Cell> removed;
+  for(auto it = X.begin(3), itE = X.end(3); it != itE; ++it) {
+    if(!Y.belongs(it->first)) {
+      removed.push_back(it->first);
+    }
+  }
+  state.finished = removed.empty();
+  X = Y;
+
+  // The voxels in the 26-neighborhood of the removed voxels, and the
+  // cells of their closure, are the only ones that might have changed.
+  const Point & lower = ks.lowerBound();
+  const Point & upper = ks.upperBound();
+  std::unordered_set<Cell> dirty_voxels;
+  for(const auto & voxel : removed) {
+    const Point center = ks.uCoords(voxel);
+    for(int dz = -1; dz <= 1; ++dz) {
+      for(int dy = -1; dy <= 1; ++dy) {
+        for(int dx = -1; dx <= 1; ++dx) {
+          const Point neighbor = center + Point(dx, dy, dz);
+          if(neighbor.inf(lower) == lower && neighbor.sup(upper) == upper) {
+            dirty_voxels.insert(ks.uSpel(neighbor));
+          }
+        }
+      }
+    }
+  }
+  std::unordered_set<Cell> dirty_cells;
+  for(const auto & voxel : dirty_voxels) {
+    dirty_cells.insert(voxel);
+    for(const auto & face : ks.uFaces(voxel)) {
+      dirty_cells.insert(face);
+    }
+    if(X.belongs(voxel) && !state.K.belongs(voxel)) {
+      state.skel_candidates.insert(voxel);
+    }
+  }
+  for(const auto & cell : dirty_cells) {
+    state.update_cell(cell);
+  }
+  return removed.size();
+}
+
+/** Voxel of X where Skel holds, with the passes since it held first. */
+template <typename TComplex>
+struct SkelVoxel {
+  typename TComplex::Cell voxel;
+  typename TComplex::Data data;
+  uint32_t age;
+};
+
+/** Evaluate Skel in the voxels that changed, and the ones waiting. */
+template <typename TComplex>
+std::vector<SkelVoxel<TComplex>> asymmetric_thinning_skel_voxels(
+    AsymmetricThinningState<TComplex> & state,
+    const std::function<bool(const TComplex &,
+      const typename TComplex::Cell &)> & Skel) {
+  auto & X = state.X;
+  for(const auto & birth : state.births) {
+    state.skel_candidates.insert(birth.first);
+  }
+  std::vector<SkelVoxel<TComplex>> skel_voxels;
+  for(const auto & voxel : state.skel_candidates) {
+    const auto it = X.findCell(3, voxel);
+    if(it == X.end(3)) {
+      state.births.erase(voxel);
+      continue;
+    }
+    if(state.K.belongs(voxel) || !Skel(X, voxel)) {
+      continue;
+    }
+    const auto birth = state.births.find(voxel);
+    skel_voxels.push_back({voxel, it->second,
+        birth == state.births.end() ? 0 : state.pass - birth->second});
+  }
+  state.skel_candidates.clear();
+  return skel_voxels;
+}
+
+/** Add to K the voxels where Skel held for persistence passes. */
+template <typename TComplex>
+void asymmetric_thinning_constrain(
+    AsymmetricThinningState<TComplex> & state,
+    const std::vector<SkelVoxel<TComplex>> & skel_voxels,
+    const uint32_t persistence) {
+  for(const auto & skel_voxel : skel_voxels) {
+    if(skel_voxel.age >= persistence) {
+      state.K.insertVoxelCell(skel_voxel.voxel, true, skel_voxel.data);
+      state.births.erase(skel_voxel.voxel);
+    } else {
+      state.births.emplace(skel_voxel.voxel, state.pass);
+    }
+  }
+}
+} // end namespace detail
+
+/**
+ * Asymmetric thinning scheme for several persistence values at once.
+ *
+ * The thinning of all the values is the same until a voxel where Skel
+ * holds reaches the persistence of some of them. At that pass the state
+ * is copied, and the values that add a different set of voxels to K
+ * continue from the copy, so the passes before the divergence are
+ * shared. See @ref asymmetric_thinning_scheme for the other parameters.
+ *
+ * @param persistences persistence values, in any order.
+ *
+ * @return thin complexes, one per value of persistences, in the same order.
+ */
+template <typename TComplex>
+std::vector<TComplex> asymmetric_thinning_scheme_sweep(
+    const TComplex & vc,
+    std::function<std::pair<typename TComplex::Cell, typename TComplex::Data>(
+      const typename TComplex::Clique &)> Select,
+    std::function<bool(const TComplex &, const typename TComplex::Cell &)> Skel,
+    const std::vector<uint32_t> & persistences,
+    const bool verbose = false) {
+  using State = detail::AsymmetricThinningState<TComplex>;
+  std::vector<uint32_t> values(persistences);
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+
+  // Each branch thins the values [first, last), that have the same state.
+  struct Branch {
+    State state;
+    size_t first;
+    size_t last;
+  };
+  std::vector<std::unique_ptr<TComplex>> thin_complexes(values.size());
+  std::vector<Branch> branches;
+  if(!values.empty()) {
+    branches.push_back({State(vc), 0, values.size()});
+    branches.back().state.update_all_cells();
+  }
+  while(!branches.empty()) {
+    Branch branch = std::move(branches.back());
+    branches.pop_back();
+    auto & state = branch.state;
+    while(!state.finished) {
+      const auto num_removed =
+        detail::asymmetric_thinning_removal<TComplex>(state, Select);
+      const auto skel_voxels =
+        detail::asymmetric_thinning_skel_voxels<TComplex>(state, Skel);
+      if(verbose) {
+        DGtal::trace.info() << "pass: " << state.pass
+          << ", removed voxels: " << num_removed
+          << ", skel voxels: " << skel_voxels.size()
+          << ", K: " << state.K.nbCells(3)
+          << ", X: " << state.X.nbCells(3) << std::endl;
+      }
+      if(state.finished) {
+        break;
+      }
+      // Values p and q > p add the same voxels to K if no voxel has an
+      // age in [p, q). The smaller values continue from copies.
+      std::vector<uint32_t> ages;
+      for(const auto & skel_voxel : skel_voxels) {
+        ages.push_back(skel_voxel.age);
+      }
+      std::sort(ages.begin(), ages.end());
+      size_t group_first = branch.first;
+      for(size_t i = branch.first + 1; i < branch.last; ++i) {
+        const auto age = std::lower_bound(ages.begin(), ages.end(),
+            values[i - 1]);
+        if(age == ages.end() || *age >= values[i]) {
+          continue;
+        }
+        if(verbose) {
+          DGtal::trace.info() << "persistence values up to " << values[i - 1]
+            << " diverge in pass " << state.pass << std::endl;
+        }
+        branches.push_back({state, group_first, i});
+        detail::asymmetric_thinning_constrain<TComplex>(
+            branches.back().state, skel_voxels, values[group_first]);
+        group_first = i;
+      }
+      branch.first = group_first;
+      detail::asymmetric_thinning_constrain<TComplex>(
+          state, skel_voxels, values[branch.first]);
+    }
+    for(size_t i = branch.first; i < branch.last; ++i) {
+      thin_complexes[i].reset(new TComplex(state.X));
+    }
+  }
+
+  std::vector<TComplex> output_complexes;
+  output_complexes.reserve(persistences.size());
+  for(const auto persistence : persistences) {
+    output_complexes.push_back(*thin_complexes[static_cast<size_t>(
+          std::lower_bound(values.begin(), values.end(), persistence) -
+          values.begin())]);
+  }
+  return output_complexes;
+}
+
+/**
+ * Asymmetric thinning scheme of Couprie and Bertrand, as
+ * DGtal::functions::asymetricThinningScheme, but tracking the voxels that
+ * change between passes.
+ *
+ * The critical cliques of the complex and the Skel condition only depend
+ * on the 26-neighborhood of the voxels involved. The critical cliques of
+ * each cell are cached, and after each pass only the cells (and the Skel
+ * condition of the voxels) in the 26-neighborhood of the removed voxels are
+ * evaluated again. Late passes, where most of the object is already
+ * constrained or critical, only evaluate the few voxels that changed.
+ *
+ * Each pass:
+ * - Y = K
+ * - for d = 3 to 0: select a voxel (with Select) of each critical d-clique
+ *   of X that doesn't intersect Y, then add the selected voxels to Y.
+ * - X = Y
+ * - add to K the voxels of X where Skel holds.
+ * until no voxel is removed.
+ *
+ * With persistence > 0, a voxel is added to K when Skel holds persistence
+ * passes after it held for the first time, as in parallel_thinning.
+ * This is not the rule of DGtal::functions::persistenceAsymetricThinningScheme
+ * and the results differ, use @ref asymmetric_thinning to get the results
+ * of DGtal for any persistence.
+ *
+ * @tparam TComplex DGtal::VoxelComplex
+ * @param vc input complex, with a simplicity table.
+ * @param Select function selecting a voxel of a critical clique.
+ * @param Skel function, true if the voxel has to be kept in the skeleton.
+ * @param persistence number of passes Skel has to hold.
+ * @param verbose print the removed and evaluated voxels in each pass.
+ *
+ * @return thin complex
+ */
+template <typename TComplex>
+TComplex asymmetric_thinning_scheme(
+    const TComplex & vc,
+    std::function<std::pair<typename TComplex::Cell, typename TComplex::Data>(
+      const typename TComplex::Clique &)> Select,
+    std::function<bool(const TComplex &, const typename TComplex::Cell &)> Skel,
+    const uint32_t persistence = 0,
+    const bool verbose = false) {
+  return asymmetric_thinning_scheme_sweep<TComplex>(vc, Select, Skel,
+      std::vector<uint32_t>{persistence}, verbose).front();
+}
+
+/**
+ * Asymmetric thinning with the results of DGtal.
+ * Without persistence, it is @ref asymmetric_thinning_scheme, which gives
+ * the same complex than DGtal::functions::asymetricThinningScheme
+ * evaluating only the voxels that change. With persistence > 0 it is
+ * DGtal::functions::persistenceAsymetricThinningScheme.
+ *
+ * @sa asymmetric_thinning_scheme for the parameters.
+ */
+template <typename TComplex>
+TComplex asymmetric_thinning(
+    const TComplex & vc,
+    std::function<std::pair<typename TComplex::Cell, typename TComplex::Data>(
+      const typename TComplex::Clique &)> Select,
+    std::function<bool(const TComplex &, const typename TComplex::Cell &)> Skel,
+    const uint32_t persistence = 0,
+    const bool verbose = false) {
+  if(persistence == 0) {
+    return asymmetric_thinning_scheme<TComplex>(vc, Select, Skel, 0, verbose);
+  }
+  return DGtal::functions::persistenceAsymetricThinningScheme<TComplex>(
+      vc, Select, Skel, persistence, verbose);
+}
+
+} // end namespace SG
+#endif
@@ -0,0 +1,106 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef LOOKUP_TABLES_HPP
+#define LOOKUP_TABLES_HPP
+
+#include <boost/dynamic_bitset_fwd.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace DGtal {
+template <typename T> class CountedPtr;
+}
+
+namespace SG {
+
+/**
+ * Process-wide registry of the DGtal look-up tables used by thin_function
+ * (simplicity_table26_6.zlib, isthmusicity_table26_6.zlib, ...).
+ *
+ * Each table is decompressed once per process and shared by the following
+ * calls, until @ref clear_lookup_tables.
+ *
+ * If a cache folder is set (@ref set_lookup_tables_cache_folder, or the
+ * environment variable SGEXT_TABLES_CACHE_FOLDER), the decompressed tables
+ * are also written there as raw .bin files, and later processes read those
+ * files instead of inflating the .zlib tables. A .bin file that cannot be
+ * read is replaced by the .zlib table, and a cache folder that cannot be
+ * written only prints a warning.
+ *
+ * The registry can be used from multiple threads. The returned pointers
+ * are DGtal::CountedPtr, copy them from a single thread.
+ */
+using LookupTablePointer = DGtal::CountedPtr<boost::dynamic_bitset<>>;
+
+/**
+ * Table in table_filename (a DGtal .zlib table), loaded once per process.
+ *
+ * @param table_filename full path of the table.
+ */
+LookupTablePointer load_lookup_table(const std::string & table_filename);
+
+/**
+ * Load the simplicity and isthmus tables of tables_folder in the registry.
+ * Useful before a batch of thin_function calls.
+ *
+ * @param tables_folder folder with the DGtal tables.
+ */
+void preload_lookup_tables(const std::string & tables_folder);
+
+/**
+ * Remove all the tables from the registry. Tables in use are released
+ * when their last user is done. The .bin files are not removed.
+ */
+void clear_lookup_tables();
+
+/** Number of tables in the registry. */
+size_t num_loaded_lookup_tables();
+
+/**
+ * Folder to persist the decompressed tables as .bin files.
+ * Empty string disables the persistence.
+ */
+void set_lookup_tables_cache_folder(const std::string & cache_folder);
+std::string get_lookup_tables_cache_folder();
+
+/**
+ * Fixed size header of the .bin tables, followed by the blocks of the
+ * bitset, in the native byte order of the writer.
+ */
+struct BinaryLookupTableHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bits_per_block;
+    uint64_t num_bits;
+};
+constexpr char binary_lookup_table_magic[8] = {'S', 'G', 'E', 'X', 'T', 'L', 'U', 'T'};
+constexpr uint32_t binary_lookup_table_version = 1;
+
+/** Write table as a .bin file. */
+void write_lookup_table_binary(const boost::dynamic_bitset<> & table,
+                               const std::string & output_filename);
+/** Read a table written by write_lookup_table_binary.
+ * Throws if the file is not a valid .bin table. */
+boost::dynamic_bitset<> read_lookup_table_binary(const std::string & input_filename);
+
+} // end namespace SG
+#endif
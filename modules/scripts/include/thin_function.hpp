@@ -23,7 +23,9 @@
 
 #include <string>
 #include <limits>
+#include <vector>
 #include "image_types.hpp"
+#include "sparse_binary_image.hpp"
 #include "spatial_graph.hpp"
 
 namespace SG {
@@ -97,6 +99,36 @@ inline SkelSelectType skel_select_string_to_enum(const std::string & select_stri
     throw std::runtime_error("select_string is not valid: " + select_string);
 }
 
+/**
+ * Enumeration of available thinning engines.
+ */
+enum class ThinEngineType {
+    /** Asymmetric thinning scheme processing cliques serially.
+     * The complex is a DGtal::VoxelComplex, with a hash map of cells.
+     * See @ref asymmetric_thinning */
+    asymmetric,
+    /** Removal of simple voxels in parallel, by subfields.
+     * The voxels are stored in BitPackedVolume, one bit per voxel, use it
+     * to thin volumes too large for the asymmetric engine.
+     * See @ref parallel_thinning */
+    parallel
+};
+
+inline std::string to_string(const ThinEngineType & engine_en) {
+    switch(engine_en)
+    {
+        case ThinEngineType::asymmetric: return "asymmetric"; break;
+        case ThinEngineType::parallel: return "parallel"; break;
+        default:
+            throw std::runtime_error("engine_en is not valid");
+    }
+}
+inline ThinEngineType thin_engine_string_to_enum(const std::string & engine_string) {
+    if(engine_string == "asymmetric") return ThinEngineType::asymmetric;
+    if(engine_string == "parallel") return ThinEngineType::parallel;
+    throw std::runtime_error("engine_string is not valid: " + engine_string);
+}
+
 template < typename TImage, typename TComplex >
 std::pair<typename TComplex::Cell, typename TComplex::Data>
 select_max_value_of_clique(
@@ -168,6 +200,18 @@ select_max_value_of_clique(
  * @param visualize visualize the end result.
  *      Only if compile definitions are enabled.
  *
+ * @param engine_str thinning engine.
+ *     Valid options: asymmetric, parallel
+ *     asymmetric: asymmetric thinning of DGtal, sequential.
+ *     parallel: remove simple voxels of each subfield in parallel, see
+ *     @ref parallel_thinning. The result is topologically equivalent, and
+ *     deterministic. There is no asymmetric choice, the object is peeled
+ *     symmetrically, so skel_select_type_str and distance_map_image are
+ *     not used.
+ *
+ * @param num_threads threads of the parallel engine,
+ *     0 to use all the hardware threads.
+ *
  * @return thin image
  */
 
@@ -180,7 +224,81 @@ BinaryImageType::Pointer thin_function(
     const FloatImageType::Pointer & distance_map_image = nullptr,
     const bool profile = false,
     const bool verbose = false,
-    const bool visualize = false
+    const bool visualize = false,
+    const std::string & engine_str = "asymmetric",
+    const size_t num_threads = 0
+    );
+
+/**
+ * Same than @ref thin_function, but the thin image is returned as its
+ * foreground voxels, with the metadata of input_image, without creating
+ * the dense image.
+ * Use it as input of @ref raw_graph_from_image or
+ * @ref reduced_graph_from_image, and @ref image_from_sparse_binary_image
+ * only if the image is needed.
+ *
+ * @return sorted indices of the thin image
+ */
+SparseBinaryImage thin_function_sparse(
+    const BinaryImageType::Pointer & input_image,
+    const std::string & skel_type_str,
+    const std::string & skel_select_type_str,
+    const std::string & tables_folder,
+    const int & persistence = 0,
+    const FloatImageType::Pointer & distance_map_image = nullptr,
+    const bool profile = false,
+    const bool verbose = false,
+    const bool visualize = false,
+    const std::string & engine_str = "asymmetric",
+    const size_t num_threads = 0
+    );
+
+/**
+ * Thin input image for several persistence values in one run, see
+ * @ref thin_function for the rest of parameters.
+ *
+ * With the parallel engine, the thinning of all the persistence values is
+ * the same until a voxel reaches the smaller persistence values. From that
+ * pass the thinning is checkpointed and continued separately, only for the
+ * values that keep different voxels, so a sweep costs about one run instead
+ * of one per value, see @ref parallel_thinning_sweep.
+ * With the asymmetric engine each different value is a separate run of
+ * @ref asymmetric_thinning, to keep the persistence rule of DGtal.
+ *
+ * @param persistences persistence values, non-negative, in any order.
+ *
+ * @return thin images, one per value of persistences, in the same order.
+ */
+std::vector<BinaryImageType::Pointer> thin_function_sweep(
+    const BinaryImageType::Pointer & input_image,
+    const std::string & skel_type_str,
+    const std::string & skel_select_type_str,
+    const std::string & tables_folder,
+    const std::vector<int> & persistences,
+    const FloatImageType::Pointer & distance_map_image = nullptr,
+    const bool profile = false,
+    const bool verbose = false,
+    const bool visualize = false,
+    const std::string & engine_str = "asymmetric",
+    const size_t num_threads = 0
+    );
+
+/**
+ * Same than @ref thin_function_sweep, returning the foreground voxels of
+ * each thin image, see @ref thin_function_sparse.
+ */
+std::vector<SparseBinaryImage> thin_function_sparse_sweep(
+    const BinaryImageType::Pointer & input_image,
+    const std::string & skel_type_str,
+    const std::string & skel_select_type_str,
+    const std::string & tables_folder,
+    const std::vector<int> & persistences,
+    const FloatImageType::Pointer & distance_map_image = nullptr,
+    const bool profile = false,
+    const bool verbose = false,
+    const bool visualize = false,
+    const std::string & engine_str = "asymmetric",
+    const size_t num_threads = 0
     );
 
 /**
@@ -225,6 +343,12 @@ BinaryImageType::Pointer thin_function(
  * @param visualize visualize the end result.
  *      Only if compile definitions are enabled.
  *
+ * @param engine_str thinning engine: asymmetric or parallel, see
+ * @ref thin_function
+ *
+ * @param num_threads threads of the parallel engine,
+ *     0 to use all the hardware threads.
+ *
  * @return thin image
  */
 
@@ -242,7 +366,38 @@ BinaryImageType::Pointer thin_function_io(
         const std::string & out_sequence_discrete_points_foldername = "",
         const bool profile = false,
         const bool verbose = false,
-        const bool visualize = false
+        const bool visualize = false,
+        const std::string & engine_str = "asymmetric",
+        const size_t num_threads = 0
+        );
+
+/**
+ * Thin the image in filename for several persistence values in one run,
+ * see @ref thin_function_sweep. Writes one image per persistence value
+ * (and one .sdp file if out_sequence_discrete_points_foldername is not
+ * empty), with the same names than @ref thin_function_io.
+ *
+ * @param persistences persistence values, non-negative, in any order.
+ *
+ * @return thin images, one per value of persistences, in the same order.
+ */
+std::vector<BinaryImageType::Pointer> thin_function_sweep_io(
+        const std::string & filename,
+        const std::string & skel_type_str,
+        const std::string & skel_select_type_str,
+        const std::string & output_foldername,
+        const std::string & tables_folder,
+        const std::vector<int> & persistences,
+        const std::string & inputDistanceMapImageFilename = "",
+        // itk_filters
+        const std::string & foreground = "white", // or "black"
+        // export files
+        const std::string & out_sequence_discrete_points_foldername = "",
+        const bool profile = false,
+        const bool verbose = false,
+        const bool visualize = false,
+        const std::string & engine_str = "asymmetric",
+        const size_t num_threads = 0
         );
 
 } // end ns
@@ -0,0 +1,104 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef TILED_THIN_FUNCTION_HPP
+#define TILED_THIN_FUNCTION_HPP
+
+#include "spatial_graph.hpp"
+#include <string>
+
+namespace SG {
+
+/**
+ * Thin a binary image that doesn't fit in memory, and get the reduced graph
+ * of its skeleton, processing the image by tiles.
+ *
+ * The image is split in tiles of tile_size voxels. For each tile:
+ * - the tile and a margin of halo voxels around it are read from the file
+ *   with ITK streaming (only the region is read when the ImageIO supports
+ *   it, for example with .nrrd or .mha files without compression),
+ * - the region is thinned with @ref thin_function,
+ * - the reduced graph of the thin voxels inside the tile is traced with
+ *   @ref reduced_graph_from_image, with a node in each voxel in the faces of
+ *   the tile.
+ * The graphs of the tiles are joined with @ref TiledGraphStitcher, matching
+ * the nodes in the faces by their voxel coordinates.
+ *
+ * The memory is bounded by the size of a tile plus halo, and the reduced
+ * graph. The thinning is not local, the result matches the thinning of the
+ * whole image when the halo is larger than the region that decides the
+ * skeleton inside a tile, usually a few times the largest radius of the
+ * object. With smaller halos the skeleton might be shifted or broken near
+ * the faces of the tiles.
+ * When the image has more than one tile, a halo smaller than
+ * @ref tiled_thin_minimum_halo throws. When a distance map is given, a
+ * warning is printed for each tile where the largest distance is greater
+ * than the halo.
+ *
+ * The graph is the same than analyze_graph_function with traceReducedGraph
+ * and without removeExtraEdges (and without merging nodes), in index space.
+ *
+ * @param filename input filename holding a binary image
+ * @param skel_type_str type of skeletonization, see @ref thin_function
+ * @param skel_select_type_str type for choosing a voxel, see
+ * @ref thin_function
+ * @param tables_folder Path where to find look up tables from DGtal.
+ * @param tile_size size of the tiles, in voxels per dimension
+ * @param halo margin of voxels around each tile used to thin it
+ * @param persistence Integer to locally trim non-important branches.
+ * @param inputDistanceMapImageFilename filename holding a distance map
+ * image used when skel_select_type_str is dmax, it is also read by tiles.
+ * @param foreground "white" or "black", invert the image if black.
+ * @param engine_str thinning engine: asymmetric or parallel, see
+ * @ref thin_function
+ * @param num_threads threads used to thin (with the parallel engine) and to
+ * trace the graph of each tile, 0 to use all the hardware threads.
+ * @param verbose extra info
+ *
+ * @return reduced graph of the skeleton, in index space
+ */
+/**
+ * Smallest halo accepted by @ref tiled_thin_function_io.
+ * The simplicity of a voxel depends on its 26-neighbors, and the
+ * persistence keeps the branches born in the last persistence iterations,
+ * so a voxel in the faces of a tile needs at least persistence + 1 voxels
+ * around it.
+ * This is a lower bound, the halo has to cover the radius of the object
+ * for the skeleton to match the thinning of the whole image.
+ */
+size_t tiled_thin_minimum_halo(const int persistence);
+
+GraphType tiled_thin_function_io(
+        const std::string & filename,
+        const std::string & skel_type_str,
+        const std::string & skel_select_type_str,
+        const std::string & tables_folder,
+        const size_t tile_size = 256,
+        const size_t halo = 32,
+        const int & persistence = 0,
+        const std::string & inputDistanceMapImageFilename = "",
+        const std::string & foreground = "white",
+        const std::string & engine_str = "asymmetric",
+        const size_t num_threads = 0,
+        const bool verbose = false
+        );
+
+} // end ns
+#endif
@@ -28,26 +28,18 @@
 // Boost Filesystem
 #include <boost/filesystem.hpp>
 
-#include <DGtal/base/Common.h>
-#include <DGtal/helpers/StdDefs.h>
-#include <DGtal/images/ImageContainerByITKImage.h>
-#include <DGtal/images/imagesSetsUtils/ImageFromSet.h>
-#include <DGtal/images/imagesSetsUtils/SetFromImage.h>
-#include <DGtal/io/readers/GenericReader.h>
-#include <DGtal/io/readers/ITKReader.h>
 #include <chrono>
 #include <iostream>
 #include <unordered_map>
-// graph
-#include <DGtal/graph/ObjectBoostGraphInterface.h>
-#include <DGtal/topology/Object.h>
 
 // Reduce graph via dfs:
+#include "convert_spatial_graph.hpp"
 #include "merge_nodes.hpp"
 #include "reduce_spatial_graph_via_dfs.hpp"
+#include "reduced_graph_from_image.hpp"
 #include "remove_extra_edges.hpp"
 #include "spatial_graph.hpp"
-#include "spatial_graph_from_object.hpp"
+#include "spatial_graph_from_image.hpp"
 #include "spatial_graph_utilities.hpp"
 
 #ifdef SG_MODULE_VISUALIZE_ENABLED_WITH_QT
@@ -75,34 +67,7 @@ namespace SG {
 
 GraphType raw_graph_from_image(
         const SG::BinaryImageType::Pointer & thin_image) {
-
-    using PixelType = SG::BinaryImagePixelType; //uchar
-    using Domain = DGtal::Z3i::Domain;
-    using Image = DGtal::ImageContainerByITKImage<Domain, PixelType>;
-
-    // Convert to DGtal Container
-    Image image(thin_image);
-
-    using DigitalTopology = DGtal::Z3i::DT26_6;
-    using DigitalSet = DGtal::DigitalSetByAssociativeContainer<
-            Domain, std::unordered_set<typename Domain::Point> >;
-    using Object = DGtal::Object<DigitalTopology, DigitalSet>;
-
-    DigitalSet image_set(image.domain());
-    DGtal::SetFromImage<DGtal::Z3i::DigitalSet>::append<Image>(image_set, image, 0, 255);
-
-    DGtal::Z3i::KSpace ks;
-    // Domain of kspace must be padded.
-    ks.init(image.domain().lowerBound(), image.domain().upperBound(), true);
-    DigitalTopology::ForegroundAdjacency adjF;
-    DigitalTopology::BackgroundAdjacency adjB;
-    DigitalTopology topo(adjF, adjB,
-                         DGtal::DigitalTopologyProperties::JORDAN_DT);
-    Object obj(topo, image_set);
-
-    const GraphType sg =
-        SG::spatial_graph_from_object<Object, GraphType>(obj);
-    return sg;
+    return SG::spatial_graph_from_image<GraphType>(thin_image);
 }
 
 GraphType raw_graph_from_image(const std::string & filename) {
@@ -110,6 +75,20 @@ GraphType raw_graph_from_image(const std::string & filename) {
     return SG::raw_graph_from_image(SG::itk_image_from_file<SG::BinaryImageType>(filename));
 }
 
+GraphType raw_graph_from_image(const SG::SparseBinaryImage & thin_image) {
+    return SG::spatial_graph_from_image<GraphType>(thin_image);
+}
+
+GraphType2D raw_graph_from_image(
+        const SG::BinaryImageType2D::Pointer & thin_image) {
+    return SG::spatial_graph_from_image<GraphType2D>(thin_image);
+}
+
+GraphType2D raw_graph_from_image_2d(const std::string & filename) {
+    return SG::raw_graph_from_image(
+            SG::itk_image_from_file<SG::BinaryImageType2D>(filename));
+}
+
 void merge_nodes_interface(
         GraphType &reduced_g,
         bool mergeThreeConnectedNodes,
@@ -197,7 +176,8 @@ void export_graph_interface(GraphType & reduced_g,
         bool exportVtu,
         bool exportVtuWithEdgePoints,
         bool exportGraphviz,
-        const bool verbose
+        const bool verbose,
+        bool exportBinary
         ) {
     const fs::path output_folder_path{exportReducedGraph_foldername};
     if (!fs::exists(output_folder_path)) {
@@ -213,6 +193,15 @@ void export_graph_interface(GraphType & reduced_g,
                 << output_full_path.string() << std::endl;
         }
     }
+    if(exportBinary) {
+        fs::path output_full_path =
+            output_folder_path / fs::path(output_full_string + ".sgb");
+        SG::write_binary_sg(output_full_path.string(), reduced_g);
+        if (verbose) {
+            std::cout << "Output reduced graph (binary) to: "
+                << output_full_path.string() << std::endl;
+        }
+    }
     boost::dynamic_properties dp;
     dp.property("node_id", boost::get(boost::vertex_index, reduced_g));
     dp.property("spatial_node",
@@ -258,11 +247,11 @@ void export_graph_interface(GraphType & reduced_g,
     }
 #endif
 
-    if(!exportGraphviz && !exportSerialized && !exportVtu) {
+    if(!exportGraphviz && !exportSerialized && !exportBinary && !exportVtu) {
         if (verbose) {
             std::cout
                 << "export_reduced_graph is not exporting graphviz, "
-                "serialized graph, or vtu. Turn ON any of these options."
+                "serialized graph, binary graph, or vtu. Turn ON any of these options."
                 << std::endl;
         }
     }
@@ -421,13 +410,15 @@ GraphType analyze_graph_function(
         bool ignoreEdgesToEndNodes,
         size_t ignoreEdgesShorterThan,
         bool verbose,
-        bool visualize) {
+        bool visualize,
+        bool exportBinary,
+        bool traceReducedGraph) {
     (void)visualize; // hack to remove visualize warning
-    GraphType sg = raw_graph_from_image(thin_image);
-
-    // Remove extra edges where connectivity in DGtal generates too many edges
-    // in intersections
+    GraphType reduced_g;
     if (removeExtraEdges) {
+        GraphType sg = raw_graph_from_image(thin_image);
+        // Remove extra edges where the 26-connectivity generates too many
+        // edges in intersections.
         if (verbose) {
             std::cout << "Removing extra edges" << std::endl;
         }
@@ -444,9 +435,18 @@ GraphType analyze_graph_function(
             std::cout << "Removed extra edges iteratively " << iterations
                 << " times" << std::endl;
         }
+        // Reduce graph, removing nodes with degree 2
+        reduced_g = SG::reduce_spatial_graph_via_dfs(sg);
+    } else if (traceReducedGraph) {
+        reduced_g = SG::reduced_graph_from_image<GraphType>(thin_image);
+    } else {
+        // The graph with one node per voxel is kept in index space,
+        // only the reduced graph is converted to double coordinates.
+        const GraphTypeI32 sg =
+            SG::spatial_graph_from_image<GraphTypeI32>(thin_image);
+        reduced_g = SG::convert_spatial_graph<double>(
+                SG::reduce_spatial_graph_via_dfs(sg));
     }
-    // Reduce graph, removing nodes with degree 2
-    GraphType reduced_g = SG::reduce_spatial_graph_via_dfs(sg);
 
     const bool inPlace = true;
     SG::merge_nodes_interface(reduced_g,
@@ -503,7 +503,8 @@ GraphType analyze_graph_function(
                 exportVtu,
                 exportVtuWithEdgePoints,
                 exportGraphviz,
-                verbose);
+                verbose,
+                exportBinary);
     }
 
     if(!exportData_foldername.empty()) {
@@ -552,7 +553,9 @@ GraphType analyze_graph_function_io(
         bool ignoreEdgesToEndNodes,
         size_t ignoreEdgesShorterThan,
         bool verbose,
-        bool visualize) {
+        bool visualize,
+        bool exportBinary,
+        bool traceReducedGraph) {
     const auto itk_image =
         SG::itk_image_from_file<SG::BinaryImageType>(filename);
     const std::string output_base_name = fs::path(filename).stem().string();
@@ -577,7 +580,9 @@ GraphType analyze_graph_function_io(
             ignoreEdgesToEndNodes,
             ignoreEdgesShorterThan,
             verbose,
-            visualize);
+            visualize,
+            exportBinary,
+            traceReducedGraph);
 
 }
 } // end namespace SG
@@ -0,0 +1,248 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "lookup_tables.hpp"
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/filesystem.hpp>
+
+#include <DGtal/base/Common.h>
+#include <DGtal/base/CountedPtr.h>
+#include <DGtal/topology/NeighborhoodConfigurations.h>
+#include <DGtal/topology/tables/NeighborhoodTables.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace SG {
+
+namespace {
+using Block = boost::dynamic_bitset<>::block_type;
+
+struct LookupTableRegistry {
+  std::mutex mutex;
+  std::unordered_map<std::string, LookupTablePointer> tables;
+  std::string cache_folder;
+  LookupTableRegistry() {
+    const char * env_cache_folder = std::getenv("SGEXT_TABLES_CACHE_FOLDER");
+    if(env_cache_folder != nullptr) {
+      cache_folder = env_cache_folder;
+    }
+  }
+};
+
+LookupTableRegistry & registry() {
+  static LookupTableRegistry instance;
+  return instance;
+}
+
+std::string table_filename(const std::string & tables_folder,
+    const std::string & dgtal_table) {
+  // DGtal tables contain the full path where DGtal was built, keep the name.
+  const boost::filesystem::path maybe_wrong_table{dgtal_table};
+  return (boost::filesystem::path(tables_folder) /
+      maybe_wrong_table.filename()).string();
+}
+} // end namespace
+
+void write_lookup_table_binary(const boost::dynamic_bitset<> & table,
+    const std::string & output_filename) {
+  BinaryLookupTableHeader header{};
+  std::memcpy(header.magic, binary_lookup_table_magic, sizeof(header.magic));
+  header.version = binary_lookup_table_version;
+  header.bits_per_block = boost::dynamic_bitset<>::bits_per_block;
+  header.num_bits = table.size();
+  std::vector<Block> blocks;
+  blocks.reserve(table.num_blocks());
+  boost::to_block_range(table, std::back_inserter(blocks));
+
+  // Write to a temporary file and rename it, so other processes never read
+  // a partially written table. The name is unique, processes writing the
+  // same table at the same time don't write to the same file.
+  const boost::filesystem::path tmp_filename = boost::filesystem::unique_path(
+      output_filename + ".%%%%-%%%%-%%%%-%%%%.tmp");
+  bool written = false;
+  {
+    std::ofstream ofile(tmp_filename.string(), std::ios::binary);
+    if(ofile.is_open()) {
+      ofile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      ofile.write(reinterpret_cast<const char *>(blocks.data()),
+          blocks.size() * sizeof(Block));
+      written = static_cast<bool>(ofile);
+    }
+  }
+  if(!written) {
+    boost::system::error_code ec;
+    boost::filesystem::remove(tmp_filename, ec);
+    throw std::runtime_error("Failed to write output_filename: " +
+        tmp_filename.string() + ".");
+  }
+  try {
+    boost::filesystem::rename(tmp_filename, output_filename);
+  } catch(...) {
+    boost::system::error_code ec;
+    boost::filesystem::remove(tmp_filename, ec);
+    throw;
+  }
+}
+
+boost::dynamic_bitset<> read_lookup_table_binary(
+    const std::string & input_filename) {
+  std::ifstream ifile(input_filename, std::ios::binary | std::ios::ate);
+  if(!ifile.is_open()) {
+    throw std::runtime_error("Failed to read input_filename: " +
+        input_filename + ".");
+  }
+  const std::streamoff end = ifile.tellg();
+  if(end < 0) {
+    throw std::runtime_error("Failed to read input_filename: " +
+        input_filename + ".");
+  }
+  const size_t size = static_cast<size_t>(end);
+  ifile.seekg(0);
+  BinaryLookupTableHeader header;
+  if(size < sizeof(header) ||
+      !ifile.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    throw std::runtime_error("read_lookup_table_binary: input_filename: " +
+        input_filename + " is too small to be a .bin table.");
+  }
+  if(std::memcmp(header.magic, binary_lookup_table_magic,
+        sizeof(header.magic)) != 0) {
+    throw std::runtime_error("read_lookup_table_binary: input_filename: " +
+        input_filename + " is not a .bin table.");
+  }
+  if(header.version != binary_lookup_table_version ||
+      header.bits_per_block != boost::dynamic_bitset<>::bits_per_block) {
+    throw std::runtime_error("read_lookup_table_binary: input_filename: " +
+        input_filename + " was written with a different version or platform.");
+  }
+  // Number of blocks from the size of the file, num_bits of a corrupt
+  // header could overflow.
+  const size_t blocks_bytes = size - sizeof(header);
+  const size_t num_blocks = blocks_bytes / sizeof(Block);
+  const uint64_t bits_per_block = boost::dynamic_bitset<>::bits_per_block;
+  if(blocks_bytes % sizeof(Block) != 0 ||
+      header.num_bits / bits_per_block +
+      (header.num_bits % bits_per_block != 0) != num_blocks) {
+    throw std::runtime_error("read_lookup_table_binary: input_filename: " +
+        input_filename + " size doesn't match the size in its header.");
+  }
+  std::vector<Block> blocks(num_blocks);
+  if(!ifile.read(reinterpret_cast<char *>(blocks.data()),
+        static_cast<std::streamsize>(blocks_bytes))) {
+    throw std::runtime_error("Failed to read input_filename: " +
+        input_filename + ".");
+  }
+  boost::dynamic_bitset<> table(blocks.begin(), blocks.end());
+  table.resize(header.num_bits);
+  return table;
+}
+
+LookupTablePointer load_lookup_table(const std::string & table_filename) {
+  auto & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  const auto found = reg.tables.find(table_filename);
+  if(found != reg.tables.end()) {
+    return found->second;
+  }
+
+  boost::filesystem::path binary_filename;
+  if(!reg.cache_folder.empty()) {
+    binary_filename = boost::filesystem::path(reg.cache_folder) /
+      boost::filesystem::path(table_filename).filename()
+      .replace_extension(".bin");
+  }
+  LookupTablePointer table;
+  bool loaded_binary = false;
+  if(!binary_filename.empty() && boost::filesystem::exists(binary_filename)) {
+    // A corrupt or truncated .bin is replaced by the .zlib table.
+    try {
+      table = LookupTablePointer(new boost::dynamic_bitset<>(
+            read_lookup_table_binary(binary_filename.string())));
+      loaded_binary = true;
+    } catch(const std::exception & e) {
+      std::cerr << "Warning: load_lookup_table: " << e.what()
+        << " Loading " << table_filename << " instead." << std::endl;
+    }
+  }
+  if(!loaded_binary) {
+    if(!boost::filesystem::exists(table_filename)) {
+      throw std::runtime_error("load_lookup_table: table " + table_filename +
+          " doesn't exist.");
+    }
+    table = DGtal::functions::loadTable(table_filename);
+    // The .bin file is only a cache, the table is used even if it cannot
+    // be written (read-only or full cache folder).
+    if(!binary_filename.empty()) {
+      try {
+        boost::filesystem::create_directories(binary_filename.parent_path());
+        write_lookup_table_binary(*table, binary_filename.string());
+      } catch(const std::exception & e) {
+        std::cerr << "Warning: load_lookup_table: " << e.what()
+          << " The table is not cached in " << binary_filename.string()
+          << "." << std::endl;
+      }
+    }
+  }
+  reg.tables.emplace(table_filename, table);
+  return table;
+}
+
+void preload_lookup_tables(const std::string & tables_folder) {
+  load_lookup_table(table_filename(tables_folder,
+        DGtal::simplicity::tableSimple26_6));
+  load_lookup_table(table_filename(tables_folder,
+        DGtal::isthmusicity::tableIsthmus));
+  load_lookup_table(table_filename(tables_folder,
+        DGtal::isthmusicity::tableOneIsthmus));
+}
+
+void clear_lookup_tables() {
+  auto & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.tables.clear();
+}
+
+size_t num_loaded_lookup_tables() {
+  auto & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return reg.tables.size();
+}
+
+void set_lookup_tables_cache_folder(const std::string & cache_folder) {
+  auto & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.cache_folder = cache_folder;
+}
+
+std::string get_lookup_tables_cache_folder() {
+  auto & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return reg.cache_folder;
+}
+
+} // end namespace SG
@@ -19,10 +19,17 @@
  * *******************************************************************/
 
 #include "thin_function.hpp"
+#include "asymmetric_thinning_scheme.hpp"
+#include "lookup_tables.hpp"
+#include "parallel_thinning.hpp"
 
 // Boost Filesystem
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+
 #include <DGtal/base/Common.h>
 #include <DGtal/helpers/StdDefs.h>
 #include <DGtal/io/readers/GenericReader.h>
@@ -30,7 +37,6 @@
 #include <DGtal/io/writers/ITKWriter.h>
 #include <DGtal/images/ImageContainerByITKImage.h>
 #include <DGtal/images/imagesSetsUtils/SetFromImage.h>
-#include <DGtal/images/imagesSetsUtils/ImageFromSet.h>
 #include "DGtal/topology/KhalimskyCellHashFunctions.h"
 
 #include <DGtal/topology/VoxelComplex.h>
@@ -45,15 +51,12 @@
 // A runtime argument needs to point to the data folder where the look-up tables
 // were deployed.
 
-// Iterate for sequence discrete points
-#include <itkIndexRange.h>
 // Invert
 #include <itkInvertIntensityImageFilter.h>
 #include <itkNumericTraits.h>
 // ITKWriter
 #include <itkImageFileReader.h>
 #include <itkImageFileWriter.h>
-#include <itkChangeInformationImageFilter.h>
 
 #ifdef VISUALIZE
 // Viewer
@@ -65,6 +68,90 @@
 
 namespace SG {
 
+namespace {
+/**
+ * Thin with parallel_thinning, using the DGtal look-up tables for
+ * simplicity and isthmusicity.
+ */
+std::vector<SparseBinaryImage> thin_function_parallel(
+    const BinaryImageType::Pointer & input_image,
+    const SkelType & skel_type,
+    const boost::filesystem::path & tables_folder_path,
+    const std::vector<int> & persistences,
+    const size_t num_threads,
+    const bool profile,
+    const bool verbose
+    ) {
+  using Point = DGtal::Z3i::Point;
+  const boost::filesystem::path maybe_wrong_tableSimple26_6{
+    DGtal::simplicity::tableSimple26_6};
+  const auto simplicity_table = load_lookup_table(
+      (tables_folder_path / maybe_wrong_tableSimple26_6.filename()).string());
+  LookupTablePointer isthmus_table(new boost::dynamic_bitset<>());
+  if(skel_type == SkelType::isthmus) {
+    const boost::filesystem::path maybe_wrong_tableIsthmus{
+      DGtal::isthmusicity::tableIsthmus};
+    isthmus_table = load_lookup_table(
+        (tables_folder_path / maybe_wrong_tableIsthmus.filename()).string());
+  } else if(skel_type == SkelType::isthmus1) {
+    const boost::filesystem::path maybe_wrong_tableOneIsthmus{
+      DGtal::isthmusicity::tableOneIsthmus};
+    isthmus_table = load_lookup_table(
+        (tables_folder_path / maybe_wrong_tableOneIsthmus.filename()).string());
+  }
+
+  // Same configuration masks than the tables, see skelWithTable.
+  const auto pointMap =
+      *DGtal::functions::mapZeroPointNeighborhoodToConfigurationMask<Point>();
+  const auto offsets = neighbor26_offsets();
+  std::array<uint32_t, 26> neighbor_masks;
+  for(size_t i = 0; i < 26; ++i) {
+    neighbor_masks[i] = static_cast<uint32_t>(pointMap.at(
+          Point(offsets[i][0], offsets[i][1], offsets[i][2])));
+  }
+
+  const auto & simple_table = *simplicity_table;
+  const auto is_simple = [&simple_table](const uint32_t config) {
+    return static_cast<bool>(simple_table[config]);
+  };
+  const auto is_skel = [&skel_type, &isthmus_table](const uint32_t config) {
+    switch(skel_type) {
+      case SkelType::end:
+        return std::bitset<32>(config).count() == 1;
+      case SkelType::isthmus:
+      case SkelType::isthmus1:
+        return static_cast<bool>((*isthmus_table)[config]);
+      case SkelType::ultimate:
+      default:
+        return false;
+    }
+  };
+
+  auto start = std::chrono::system_clock::now();
+  auto thin_images = parallel_thinning_sparse_sweep(input_image.GetPointer(),
+      neighbor_masks, is_simple, is_skel, persistences, num_threads, verbose);
+  auto end = std::chrono::system_clock::now();
+  if(profile) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(end - start);
+    std::cout << "Time elapsed: " << elapsed.count() << std::endl;
+  }
+  return thin_images;
+}
+
+std::string output_file_string(const std::string & filename,
+    const SkelType & skel_type,
+    const SkelSelectType & skel_select_type,
+    const int & persistence) {
+  // Get filename without extension (and without folders).
+  const boost::filesystem::path input_stem =
+    boost::filesystem::path(filename).stem();
+  return input_stem.string() + "_SKEL" +
+      "_" + to_string(skel_select_type) +
+      "_" + to_string(skel_type) + "_p" +
+      std::to_string(persistence);
+}
+} // end namespace
+
 BinaryImageType::Pointer thin_function(
     const BinaryImageType::Pointer & input_image,
     const std::string & skel_type_str,
@@ -74,7 +161,71 @@ BinaryImageType::Pointer thin_function(
     const FloatImageType::Pointer & distance_map_image,
     const bool profile,
     const bool verbose,
-    const bool visualize
+    const bool visualize,
+    const std::string & engine_str,
+    const size_t num_threads
+    ) {
+  return image_from_sparse_binary_image(thin_function_sparse(input_image,
+        skel_type_str, skel_select_type_str, tables_folder, persistence,
+        distance_map_image, profile, verbose, visualize, engine_str,
+        num_threads));
+}
+
+SparseBinaryImage thin_function_sparse(
+    const BinaryImageType::Pointer & input_image,
+    const std::string & skel_type_str,
+    const std::string & skel_select_type_str,
+    const std::string & tables_folder,
+    const int & persistence,
+    const FloatImageType::Pointer & distance_map_image,
+    const bool profile,
+    const bool verbose,
+    const bool visualize,
+    const std::string & engine_str,
+    const size_t num_threads
+    ) {
+  return thin_function_sparse_sweep(input_image, skel_type_str,
+      skel_select_type_str, tables_folder, std::vector<int>{persistence},
+      distance_map_image, profile, verbose, visualize, engine_str,
+      num_threads).front();
+}
+
+std::vector<BinaryImageType::Pointer> thin_function_sweep(
+    const BinaryImageType::Pointer & input_image,
+    const std::string & skel_type_str,
+    const std::string & skel_select_type_str,
+    const std::string & tables_folder,
+    const std::vector<int> & persistences,
+    const FloatImageType::Pointer & distance_map_image,
+    const bool profile,
+    const bool verbose,
+    const bool visualize,
+    const std::string & engine_str,
+    const size_t num_threads
+    ) {
+  const auto sparse_images = thin_function_sparse_sweep(input_image,
+      skel_type_str, skel_select_type_str, tables_folder, persistences,
+      distance_map_image, profile, verbose, visualize, engine_str,
+      num_threads);
+  std::vector<BinaryImageType::Pointer> thin_images;
+  for(const auto & sparse_image : sparse_images) {
+    thin_images.push_back(image_from_sparse_binary_image(sparse_image));
+  }
+  return thin_images;
+}
+
+std::vector<SparseBinaryImage> thin_function_sparse_sweep(
+    const BinaryImageType::Pointer & input_image,
+    const std::string & skel_type_str,
+    const std::string & skel_select_type_str,
+    const std::string & tables_folder,
+    const std::vector<int> & persistences,
+    const FloatImageType::Pointer & distance_map_image,
+    const bool profile,
+    const bool verbose,
+    const bool visualize,
+    const std::string & engine_str,
+    const size_t num_threads
     ) {
   if(verbose) {
     using DGtal::trace;
@@ -84,10 +235,16 @@ BinaryImageType::Pointer thin_function(
     if(distance_map_image) {
       trace.info() << " -- provided distance_map_image." << std::endl;
     }
-    trace.info() << "persistence: " << persistence << std::endl;
+    trace.info() << "persistences:";
+    for(const auto & persistence : persistences) {
+      trace.info() << " " << persistence;
+    }
+    trace.info() << std::endl;
     trace.info() << "profile: " << profile << std::endl;
     trace.info() << "verbose: " << verbose << std::endl;
     trace.info() << "visualize: " << visualize << std::endl;
+    trace.info() << "engine_str: " << engine_str << std::endl;
+    trace.info() << "num_threads: " << num_threads << std::endl;
     trace.info() << "----------" << std::endl;
     trace.endBlock();
   }
@@ -96,6 +253,7 @@ BinaryImageType::Pointer thin_function(
   // Validate input skel method and skel_select
   auto skel_type = skel_string_to_enum(skel_type_str);
   auto skel_select_type = skel_select_string_to_enum(skel_select_type_str);
+  const auto engine = thin_engine_string_to_enum(engine_str);
   const fs::path tables_folder_path{tables_folder};
   if(!fs::exists(tables_folder_path)) {
     throw std::runtime_error("tables_folder " + tables_folder_path.string() +
@@ -103,11 +261,26 @@ BinaryImageType::Pointer thin_function(
         "tables_folder should point to the folder "
         "where DGtal tables are: i.e simplicity_table26_6.zlib");
   }
+  std::vector<uint32_t> unsigned_persistences;
+  for(const auto & persistence : persistences) {
+    if(persistence < 0) {
+      throw std::runtime_error("persistence must be non-negative, it is: " +
+          std::to_string(persistence));
+    }
+    unsigned_persistences.push_back(static_cast<uint32_t>(persistence));
+  }
+  if(persistences.empty()) {
+    return {};
+  }
+
+  if(engine == ThinEngineType::parallel) {
+    return thin_function_parallel(input_image, skel_type, tables_folder_path,
+        persistences, num_threads, profile, verbose);
+  }
 
   // Convert to DGtal Container
   using Domain = DGtal::Z3i::Domain;
   using Image = DGtal::ImageContainerByITKImage<Domain, unsigned char>;
-  using ItkImageType = BinaryImageType;
   Image image(input_image);
 
   // Create a VoxelComplex from the set
@@ -144,20 +317,20 @@ BinaryImageType::Pointer thin_function(
   }
   const fs::path maybe_wrong_tableSimple26_6{DGtal::simplicity::tableSimple26_6};
   const fs::path tableSimple26_6 = tables_folder_path / maybe_wrong_tableSimple26_6.filename();
-  vc.setSimplicityTable(DGtal::functions::loadTable(tableSimple26_6.string()));
+  vc.setSimplicityTable(load_lookup_table(tableSimple26_6.string()));
   if(verbose) { DGtal::trace.endBlock(); }
 
   if(verbose) { DGtal::trace.beginBlock("load isthmus table"); }
-  boost::dynamic_bitset<> isthmus_table;
+  LookupTablePointer isthmus_table(new boost::dynamic_bitset<>());
   auto &sk = skel_type;
   if(sk == SkelType::isthmus) {
     const fs::path maybe_wrong_tableIsthmus{DGtal::isthmusicity::tableIsthmus};
     const fs::path tableIsthmus = tables_folder_path / maybe_wrong_tableIsthmus.filename();
-    isthmus_table = *DGtal::functions::loadTable(tableIsthmus.string());
+    isthmus_table = load_lookup_table(tableIsthmus.string());
   } else if(sk == SkelType::isthmus1) {
     const fs::path maybe_wrong_tableOneIsthmus{DGtal::isthmusicity::tableOneIsthmus};
     const fs::path tableOneIsthmus = tables_folder_path / maybe_wrong_tableOneIsthmus.filename();
-    isthmus_table = *DGtal::functions::loadTable(tableOneIsthmus.string());
+    isthmus_table = load_lookup_table(tableOneIsthmus.string());
   }
   if(verbose) { DGtal::trace.endBlock(); }
 
@@ -176,12 +349,12 @@ BinaryImageType::Pointer thin_function(
   } else if(sk == SkelType::isthmus1) {
     Skel = [&isthmus_table, &pointMap](const Complex& fc,
                                        const Complex::Cell& c) {
-      return DGtal::functions::skelWithTable(isthmus_table, pointMap, fc, c);
+      return DGtal::functions::skelWithTable(*isthmus_table, pointMap, fc, c);
     };
   } else if(sk == SkelType::isthmus) {
     Skel = [&isthmus_table, &pointMap](const Complex& fc,
                                        const Complex::Cell& c) {
-      return DGtal::functions::skelWithTable(isthmus_table, pointMap, fc, c);
+      return DGtal::functions::skelWithTable(*isthmus_table, pointMap, fc, c);
     };
   } else {
     throw std::runtime_error("Invalid skel string");
@@ -210,12 +383,22 @@ BinaryImageType::Pointer thin_function(
   }
 
   // Perform the thin/skeletonization
-  Complex vc_new(ks);
-  if(persistence == 0) {
-    vc_new = DGtal::functions::asymetricThinningScheme<Complex>(vc, Select, Skel, verbose);
-  } else {
-    vc_new = DGtal::functions::persistenceAsymetricThinningScheme<Complex>(vc, Select, Skel,
-                                                         persistence, verbose);
+  // Without persistence, only the voxels whose neighborhood changed are
+  // evaluated in each pass. With persistence, DGtal's scheme is used, its
+  // persistence rule differs from asymmetric_thinning_scheme_sweep.
+  std::vector<Complex> thin_complexes;
+  thin_complexes.reserve(unsigned_persistences.size());
+  for(size_t i = 0; i < unsigned_persistences.size(); ++i) {
+    const auto persistence = unsigned_persistences[i];
+    const auto repeated = std::find(unsigned_persistences.begin(),
+        unsigned_persistences.begin() + i, persistence);
+    if(repeated != unsigned_persistences.begin() + i) {
+      thin_complexes.push_back(thin_complexes[static_cast<size_t>(
+            repeated - unsigned_persistences.begin())]);
+      continue;
+    }
+    thin_complexes.push_back(asymmetric_thinning<Complex>(
+          vc, Select, Skel, persistence, verbose));
   }
 
   // profile
@@ -226,48 +409,51 @@ BinaryImageType::Pointer thin_function(
   }
 
 
-  // Convert back to ITK Image
-  DigitalSet thin_set(image.domain());
-  vc_new.dumpVoxels(thin_set);
-
-  Image thin_image(image.domain());
-  unsigned int foreground_value = 255;
-  DGtal::ImageFromSet<Image>::append<DigitalSet>(thin_image, thin_set, foreground_value);
-  // Copy metadata information (spacing, origin, direction) from original
-  // image to the output.
-  using ChangeInformationFilter =
-    itk::ChangeInformationImageFilter<ItkImageType>;
-  auto changeInfo = ChangeInformationFilter::New();
-  changeInfo->ChangeAll();
-  changeInfo->UseReferenceImageOn();
-  changeInfo->SetReferenceImage(input_image);
-  changeInfo->SetInput(thin_image.getITKImagePointer());
-  changeInfo->Update();
+  // The voxels of the thin complexes, with the metadata of the input image.
+  // The dense image is only created when requested, see thin_function.
+  std::vector<SparseBinaryImage> thin_images;
+  for(const auto & vc_new : thin_complexes) {
+    SparseBinaryImage thin_image;
+    copy_image_information(input_image.GetPointer(), thin_image);
+    thin_image.indices.reserve(vc_new.nbCells(3));
+    for(auto it = vc_new.begin(3), itE = vc_new.end(3); it != itE; ++it) {
+      const auto point = ks.uCoords(it->first);
+      SparseBinaryImage::IndexType index;
+      for(unsigned int d = 0; d < SparseBinaryImage::ImageDimension; ++d) {
+        index[d] = point[d];
+      }
+      thin_image.indices.push_back(index);
+    }
+    sort_indices(thin_image);
+    thin_images.push_back(std::move(thin_image));
 
 #ifdef VISUALIZE
-  if(visualize) {
-    DigitalSet all_set(image.domain());
-    vc.dumpVoxels(all_set);
-    int argc(1);
-    char** argv(nullptr);
-    QApplication app(argc, argv);
-    DGtal::Viewer3D<> viewer(ks);
-    viewer.show();
-
-    viewer.setFillColor(DGtal::Color(255, 255, 255, 255));
-    viewer << thin_set;
-
-    // All kspace voxels
-    viewer.setFillColor(DGtal::Color(40, 200, 55, 10));
-    viewer << all_set;
-
-    viewer << DGtal::Viewer3D<>::updateDisplay;
-
-    app.exec();
-  }
+    if(visualize) {
+      DigitalSet thin_set(image.domain());
+      vc_new.dumpVoxels(thin_set);
+      DigitalSet all_set(image.domain());
+      vc.dumpVoxels(all_set);
+      int argc(1);
+      char** argv(nullptr);
+      QApplication app(argc, argv);
+      DGtal::Viewer3D<> viewer(ks);
+      viewer.show();
+
+      viewer.setFillColor(DGtal::Color(255, 255, 255, 255));
+      viewer << thin_set;
+
+      // All kspace voxels
+      viewer.setFillColor(DGtal::Color(40, 200, 55, 10));
+      viewer << all_set;
+
+      viewer << DGtal::Viewer3D<>::updateDisplay;
+
+      app.exec();
+    }
 #endif
+  }
 
-  return changeInfo->GetOutput();
+  return thin_images;
 
 }
 
@@ -282,7 +468,32 @@ BinaryImageType::Pointer thin_function_io(const std::string &filename,
         const std::string & out_sequence_discrete_points_foldername,
         const bool profile,
         const bool verbose,
-        const bool visualize
+        const bool visualize,
+        const std::string & engine_str,
+        const size_t num_threads
+        ) {
+  return thin_function_sweep_io(filename, skel_type_str, skel_select_type_str,
+      output_foldername, tables_folder, std::vector<int>{persistence},
+      inputDistanceMapImageFilename, foreground,
+      out_sequence_discrete_points_foldername, profile, verbose, visualize,
+      engine_str, num_threads).front();
+}
+
+std::vector<BinaryImageType::Pointer> thin_function_sweep_io(
+        const std::string &filename,
+        const std::string & skel_type_str,
+        const std::string & skel_select_type_str,
+        const std::string & output_foldername,
+        const std::string & tables_folder,
+        const std::vector<int> & persistences,
+        const std::string & inputDistanceMapImageFilename,
+        const std::string & foreground,
+        const std::string & out_sequence_discrete_points_foldername,
+        const bool profile,
+        const bool verbose,
+        const bool visualize,
+        const std::string & engine_str,
+        const size_t num_threads
         ) {
   if(verbose) {
     using DGtal::trace;
@@ -300,15 +511,24 @@ BinaryImageType::Pointer thin_function_io(const std::string &filename,
   auto skel_type = skel_string_to_enum(skel_type_str);
   auto skel_select_type = skel_select_string_to_enum(skel_select_type_str);
 
-  // Get filename without extension (and without folders).
   namespace fs = boost::filesystem;
-  const fs::path input_stem = fs::path(filename).stem();
-  std::string output_file_string = input_stem.string() + "_SKEL";
-  output_file_string += "_" + to_string(skel_select_type) +
-      "_" + to_string(skel_type) + "_p" +
-      std::to_string(persistence);
+  // Validate output folders before thinning.
+  if(output_foldername.empty()) {
+    throw std::runtime_error("provide output_foldername in thin_function");
+  }
+  const fs::path output_folder_path{output_foldername};
+  if(!fs::exists(output_folder_path)) {
+    throw std::runtime_error(
+        "output folder for output thin image doesn't exist : " +
+        output_folder_path.string());
+  }
+  if(!out_sequence_discrete_points_foldername.empty() &&
+      !fs::exists(fs::path(out_sequence_discrete_points_foldername))) {
+    throw std::runtime_error(
+        "output folder for discrete points file doesn't exist : " +
+        out_sequence_discrete_points_foldername);
+  }
 
-  const fs::path output_file_path = fs::path(output_file_string);
   using Domain = DGtal::Z3i::Domain;
   using Image = DGtal::ImageContainerByITKImage<Domain, unsigned char>;
   using ItkImageType = BinaryImageType;
@@ -347,62 +567,52 @@ BinaryImageType::Pointer thin_function_io(const std::string &filename,
       distance_map_itk_image = dmap_reader->GetOutput();
   }
 
-  auto thin_image = thin_function(
+  const auto sparse_images = thin_function_sparse_sweep(
       handle_out, skel_type_str, skel_select_type_str, tables_folder,
-      persistence, distance_map_itk_image, profile, verbose, visualize);
-
-  // Export
-  // Export sequence of discrete points
-  if(!out_sequence_discrete_points_foldername.empty()) {
-    const fs::path output_folder_path{out_sequence_discrete_points_foldername};
-    if(!fs::exists(output_folder_path)) {
-      throw std::runtime_error(
-          "output folder for discrete points file doesn't exist : " +
-          output_folder_path.string());
-    }
-    fs::path output_full_path =
-        output_folder_path / fs::path(output_file_path.string() + ".sdp");
-    std::ofstream out;
-    out.open(output_full_path.string().c_str());
-    const auto range =
-      itk::Experimental::IndexRange<BinaryImageDimension, false>(
-          thin_image->GetLargestPossibleRegion());
-    for(const auto& index : range) {
-      if (thin_image->GetPixel(index) > 0) {
+      persistences, distance_map_itk_image, profile, verbose, visualize,
+      engine_str, num_threads);
+
+  std::vector<BinaryImageType::Pointer> thin_images;
+  for(size_t i = 0; i < sparse_images.size(); ++i) {
+    const auto & sparse_image = sparse_images[i];
+    const fs::path output_file_path = fs::path(output_file_string(
+          filename, skel_type, skel_select_type, persistences[i]));
+    // Export
+    // Export sequence of discrete points
+    if(!out_sequence_discrete_points_foldername.empty()) {
+      const fs::path sdp_folder_path{out_sequence_discrete_points_foldername};
+      fs::path output_full_path =
+          sdp_folder_path / fs::path(output_file_path.string() + ".sdp");
+      std::ofstream out;
+      out.open(output_full_path.string().c_str());
+      for(const auto& index : sparse_image.indices) {
         out << index[0] << " " << index[1] << " " << index[2] << std::endl;
       }
     }
-  }
 
-  // Export thin image
-  if(output_foldername.empty()) {
-    throw std::runtime_error("provide output_foldername in thin_function");
-  }
-  const fs::path output_folder_path{output_foldername};
-  if(!fs::exists(output_folder_path)) {
-    throw std::runtime_error(
-        "output folder for output thin image doesn't exist : " +
-        output_folder_path.string());
-  }
-  fs::path output_full_path =
-    output_folder_path / fs::path(output_file_path.string() + ".nrrd");
-
-  // Write the image
-  using ITKImageWriter = itk::ImageFileWriter<ItkImageType>;
-  auto writer = ITKImageWriter::New();
-  writer->UseCompressionOn();
-  try {
-    writer->SetFileName(output_full_path.string().c_str());
-    writer->SetInput(thin_image);
-    writer->Update();
-  } catch(itk::ExceptionObject& e) {
-    std::cerr << "Failure writing file: " << output_full_path.string()
-      << std::endl;
-    DGtal::trace.error() << e;
-    throw DGtal::IOException();
+    // Export thin image
+    const auto thin_image = image_from_sparse_binary_image(sparse_image);
+    thin_images.push_back(thin_image);
+    fs::path output_full_path =
+      output_folder_path / fs::path(output_file_path.string() + ".nrrd");
+
+    // Write the image
+    using ITKImageWriter = itk::ImageFileWriter<ItkImageType>;
+    auto writer = ITKImageWriter::New();
+    writer->UseCompressionOn();
+    try {
+      writer->SetFileName(output_full_path.string().c_str());
+      writer->SetInput(thin_image);
+      writer->Update();
+    } catch(itk::ExceptionObject& e) {
+      std::cerr << "Failure writing file: " << output_full_path.string()
+        << std::endl;
+      DGtal::trace.error() << e;
+      throw DGtal::IOException();
+    }
   }
 
-  return thin_image;
+  return thin_images;
 
 }
 } // end namespace SG
@@ -0,0 +1,219 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "tiled_thin_function.hpp"
+#include "image_types.hpp"
+#include "reduced_graph_from_image.hpp"
+#include "stitch_tiled_graphs.hpp"
+#include "thin_function.hpp"
+
+#include <itkExtractImageFilter.h>
+#include <itkImageFileReader.h>
+#include <itkInvertIntensityImageFilter.h>
+#include <itkMinimumMaximumImageCalculator.h>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+
+namespace SG {
+
+namespace {
+/**
+ * Read the region of the image of the reader. Only the region is read if
+ * the ImageIO supports streaming.
+ */
+template <typename TImage>
+typename TImage::Pointer
+read_region(itk::ImageFileReader<TImage> *reader,
+            const typename TImage::RegionType &region) {
+    using ExtractFilterType = itk::ExtractImageFilter<TImage, TImage>;
+    auto extract_filter = ExtractFilterType::New();
+    extract_filter->SetInput(reader->GetOutput());
+    extract_filter->SetExtractionRegion(region);
+    extract_filter->SetDirectionCollapseToSubmatrix();
+    extract_filter->Update();
+    typename TImage::Pointer output = extract_filter->GetOutput();
+    output->DisconnectPipeline();
+    return output;
+}
+} // namespace
+
+size_t tiled_thin_minimum_halo(const int persistence) {
+    return static_cast<size_t>(std::max(persistence, 0)) + 1;
+}
+
+GraphType tiled_thin_function_io(
+        const std::string & filename,
+        const std::string & skel_type_str,
+        const std::string & skel_select_type_str,
+        const std::string & tables_folder,
+        const size_t tile_size,
+        const size_t halo,
+        const int & persistence,
+        const std::string & inputDistanceMapImageFilename,
+        const std::string & foreground,
+        const std::string & engine_str,
+        const size_t num_threads,
+        const bool verbose
+        ) {
+    if (tile_size == 0) {
+        throw std::runtime_error("tiled_thin_function_io: tile_size must be "
+                                 "greater than 0.");
+    }
+    // Validate input skel method and skel_select before reading.
+    skel_string_to_enum(skel_type_str);
+    skel_select_string_to_enum(skel_select_type_str);
+    thin_engine_string_to_enum(engine_str);
+
+    using ItkImageType = BinaryImageType;
+    using ReaderType = itk::ImageFileReader<ItkImageType>;
+    auto reader = ReaderType::New();
+    reader->SetFileName(filename);
+    reader->UpdateOutputInformation();
+    const auto largest_region =
+            reader->GetOutput()->GetLargestPossibleRegion();
+
+    using DistanceMapReaderType = itk::ImageFileReader<FloatImageType>;
+    auto dmap_reader = DistanceMapReaderType::New();
+    if (!inputDistanceMapImageFilename.empty()) {
+        dmap_reader->SetFileName(inputDistanceMapImageFilename);
+        dmap_reader->UpdateOutputInformation();
+    }
+    const bool invert_image = (foreground == "black");
+
+    const auto &start = largest_region.GetIndex();
+    const auto &size = largest_region.GetSize();
+    std::array<size_t, 3> num_tiles;
+    for (size_t d = 0; d < 3; ++d) {
+        num_tiles[d] = (static_cast<size_t>(size[d]) + tile_size - 1) /
+                       tile_size;
+    }
+    const size_t total_tiles = num_tiles[0] * num_tiles[1] * num_tiles[2];
+    if (total_tiles > 1 && halo < tiled_thin_minimum_halo(persistence)) {
+        throw std::runtime_error(
+                "tiled_thin_function_io: halo (" + std::to_string(halo) +
+                ") must be at least " +
+                std::to_string(tiled_thin_minimum_halo(persistence)) +
+                " with persistence " + std::to_string(persistence) +
+                ", and cover the radius of the object.");
+    }
+
+    TiledGraphStitcher stitcher;
+    for (size_t tile = 0; tile < total_tiles; ++tile) {
+        const std::array<size_t, 3> tile_coords = {
+                {tile % num_tiles[0], (tile / num_tiles[0]) % num_tiles[1],
+                 tile / (num_tiles[0] * num_tiles[1])}};
+        ItkImageType::RegionType tile_region;
+        TiledGraphStitcher::IndexType begin;
+        TiledGraphStitcher::IndexType end;
+        for (size_t d = 0; d < 3; ++d) {
+            const size_t offset = tile_coords[d] * tile_size;
+            const size_t tile_size_d = std::min(
+                    tile_size, static_cast<size_t>(size[d]) - offset);
+            begin[d] = start[d] + static_cast<long>(offset);
+            end[d] = begin[d] + static_cast<long>(tile_size_d);
+            tile_region.SetIndex(d, begin[d]);
+            tile_region.SetSize(d, tile_size_d);
+        }
+        auto halo_region = tile_region;
+        halo_region.PadByRadius(halo);
+        halo_region.Crop(largest_region);
+        if (verbose) {
+            std::cout << "Tile " << tile + 1 << "/" << total_tiles
+                      << ": index " << tile_region.GetIndex() << ", size "
+                      << tile_region.GetSize() << std::endl;
+        }
+
+        ItkImageType::Pointer input_tile = read_region(reader.GetPointer(),
+                                                      halo_region);
+        if (invert_image) {
+            using InverterType =
+                    itk::InvertIntensityImageFilter<ItkImageType,
+                                                    ItkImageType>;
+            auto inverter = InverterType::New();
+            inverter->SetInput(input_tile);
+            inverter->Update();
+            input_tile = inverter->GetOutput();
+        }
+        FloatImageType::Pointer distance_map_tile = nullptr;
+        if (!inputDistanceMapImageFilename.empty()) {
+            distance_map_tile = read_region(dmap_reader.GetPointer(),
+                                            halo_region);
+            if (total_tiles > 1) {
+                using CalculatorType =
+                        itk::MinimumMaximumImageCalculator<FloatImageType>;
+                auto calculator = CalculatorType::New();
+                calculator->SetImage(distance_map_tile);
+                calculator->ComputeMaximum();
+                if (calculator->GetMaximum() > static_cast<float>(halo)) {
+                    std::cerr << "Warning: tiled_thin_function_io: tile "
+                              << tile + 1 << " has distances up to "
+                              << calculator->GetMaximum()
+                              << ", greater than the halo (" << halo
+                              << "). The skeleton near its faces might "
+                                 "differ from thinning the whole image."
+                              << std::endl;
+                }
+            }
+        }
+
+        const bool profile = false;
+        const bool thin_verbose = false;
+        const bool visualize = false;
+        const auto thin_tile = thin_function_sparse(
+                input_tile, skel_type_str, skel_select_type_str,
+                tables_folder, persistence, distance_map_tile, profile,
+                thin_verbose, visualize, engine_str, num_threads);
+        input_tile = nullptr;
+
+        // Keep the thin voxels inside the tile, the halo is only used
+        // to thin it. The indices are sorted, the cropped ones too.
+        SparseBinaryImage tile_image;
+        tile_image.region = tile_region;
+        const auto &thin_start = thin_tile.region.GetIndex();
+        for (const auto &thin_index : thin_tile.indices) {
+            auto index = thin_index;
+            bool inside = true;
+            for (size_t d = 0; d < 3; ++d) {
+                index[d] += halo_region.GetIndex(d) - thin_start[d];
+                inside &= index[d] >= begin[d] && index[d] < end[d];
+            }
+            if (inside) {
+                tile_image.indices.push_back(index);
+            }
+        }
+
+        const bool boundary_nodes = true;
+        stitcher.add_tile(reduced_graph_from_image<GraphType>(
+                                  tile_image, num_threads, boundary_nodes),
+                          begin, end);
+    }
+    auto reduced_g = stitcher.stitch();
+    if (verbose) {
+        std::cout << "Stitched graph of " << total_tiles
+                  << " tiles: " << boost::num_vertices(reduced_g)
+                  << " nodes, " << boost::num_edges(reduced_g) << " edges."
+                  << std::endl;
+    }
+    return reduced_g;
+}
+
+} // end namespace SG
@@ -0,0 +1,186 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "asymmetric_thinning_scheme.hpp"
+
+#include <DGtal/helpers/StdDefs.h>
+#include <DGtal/topology/NeighborhoodConfigurations.h>
+#include <DGtal/topology/tables/NeighborhoodTables.h>
+
+#include "gmock/gmock.h"
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+using Domain = DGtal::Z3i::Domain;
+using KSpace = DGtal::Z3i::KSpace;
+using Cell = DGtal::Z3i::Cell;
+using Point = DGtal::Z3i::Point;
+using DigitalSet = DGtal::DigitalSetByAssociativeContainer<
+        Domain, std::unordered_set<Point>>;
+using ComplexMap = std::unordered_map<Cell, DGtal::CubicalCellData>;
+using Complex = DGtal::VoxelComplex<KSpace, ComplexMap>;
+using SelectFunction = std::function<std::pair<Complex::Cell, Complex::Data>(
+        const Complex::Clique &)>;
+using SkelFunction =
+        std::function<bool(const Complex &, const Complex::Cell &)>;
+
+/** Voxels of the complex, sorted. */
+std::set<Point> voxels(const Complex &vc) {
+    std::set<Point> points;
+    for (auto it = vc.begin(3), itE = vc.end(3); it != itE; ++it) {
+        points.insert(vc.space().uCoords(it->first));
+    }
+    return points;
+}
+
+/** Complex of the object, with the simplicity table. */
+Complex create_complex(const KSpace &ks, const DigitalSet &object) {
+    Complex vc(ks);
+    vc.construct(object);
+    vc.setSimplicityTable(DGtal::functions::loadTable(
+            DGtal::simplicity::tableSimple26_6));
+    return vc;
+}
+
+/**
+ * Objects with thick parts, branches and holes, where the critical cliques
+ * of all dimensions appear: a box with a tunnel and a branch, and random
+ * blobs.
+ */
+struct AsymmetricThinningFixture : public ::testing::Test {
+    const Domain domain{Point(0, 0, 0), Point(15, 15, 15)};
+    KSpace ks;
+    std::vector<DigitalSet> objects;
+    const std::vector<uint32_t> persistences = {0, 1, 2, 4};
+    void SetUp() override {
+        ks.init(domain.lowerBound(), domain.upperBound(), true);
+        DigitalSet box(domain);
+        for (auto &&p : domain) {
+            const bool in_box = p[0] >= 2 && p[0] <= 9 && p[1] >= 2 &&
+                                p[1] <= 9 && p[2] >= 2 && p[2] <= 7;
+            const bool in_tunnel = p[0] >= 5 && p[0] <= 6 && p[1] >= 5 &&
+                                   p[1] <= 6;
+            const bool in_branch = p[0] >= 10 && p[0] <= 14 && p[1] == 4 &&
+                                   p[2] == 4;
+            if ((in_box && !in_tunnel) || in_branch) {
+                box.insert(p);
+            }
+        }
+        objects.push_back(box);
+        std::mt19937 gen(13);
+        std::bernoulli_distribution foreground(0.55);
+        for (size_t i = 0; i < 3; ++i) {
+            DigitalSet blob(domain);
+            for (auto &&p : domain) {
+                if (p[0] > 0 && p[0] < 15 && p[1] > 0 && p[1] < 15 &&
+                    p[2] > 0 && p[2] < 15 && foreground(gen)) {
+                    blob.insert(p);
+                }
+            }
+            objects.push_back(blob);
+        }
+    }
+};
+} // namespace
+
+TEST_F(AsymmetricThinningFixture, equal_to_dgtal_without_persistence) {
+    const SelectFunction Select = DGtal::functions::selectFirst<Complex>;
+    for (const SkelFunction &Skel :
+         {SkelFunction(DGtal::functions::skelEnd<Complex>),
+          SkelFunction(DGtal::functions::skelUltimate<Complex>)}) {
+        for (const auto &object : objects) {
+            const auto vc = create_complex(ks, object);
+            const auto expected =
+                    DGtal::functions::asymetricThinningScheme<Complex>(
+                            vc, Select, Skel);
+            const auto thin =
+                    SG::asymmetric_thinning_scheme<Complex>(vc, Select, Skel);
+            EXPECT_EQ(voxels(thin), voxels(expected));
+            EXPECT_EQ(voxels(SG::asymmetric_thinning<Complex>(vc, Select,
+                                                              Skel, 0)),
+                      voxels(expected));
+        }
+    }
+}
+
+TEST_F(AsymmetricThinningFixture, equal_to_dgtal_with_persistence) {
+    const SelectFunction Select = DGtal::functions::selectFirst<Complex>;
+    const SkelFunction Skel = DGtal::functions::skelEnd<Complex>;
+    for (const auto &object : objects) {
+        const auto vc = create_complex(ks, object);
+        for (const auto persistence : persistences) {
+            const auto expected =
+                    persistence == 0
+                            ? DGtal::functions::asymetricThinningScheme<
+                                      Complex>(vc, Select, Skel)
+                            : DGtal::functions::
+                                      persistenceAsymetricThinningScheme<
+                                              Complex>(vc, Select, Skel,
+                                                       persistence);
+            const auto thin = SG::asymmetric_thinning<Complex>(
+                    vc, Select, Skel, persistence);
+            EXPECT_EQ(voxels(thin), voxels(expected))
+                    << "persistence: " << persistence;
+        }
+    }
+}
+
+TEST(asymmetric_thinning_scheme, persistence_sweep) {
+    // Thick bar with thick branches of different lengths.
+    const Domain domain(Point(0, 0, 0), Point(39, 29, 11));
+    KSpace ks;
+    ks.init(domain.lowerBound(), domain.upperBound(), true);
+    DigitalSet object(domain);
+    const auto set_box = [&](const int x0, const int x1, const int y0,
+                             const int y1, const int z0, const int z1) {
+        for (int z = z0; z < z1; ++z) {
+            for (int y = y0; y < y1; ++y) {
+                for (int x = x0; x < x1; ++x) {
+                    object.insert(Point(x, y, z));
+                }
+            }
+        }
+    };
+    set_box(2, 38, 4, 9, 3, 8);
+    for (int branch = 0; branch < 4; ++branch) {
+        const int x = 6 + 9 * branch;
+        set_box(x, x + 3, 9, 12 + 4 * branch, 4, 7);
+    }
+    const auto vc = create_complex(ks, object);
+    const SelectFunction Select = DGtal::functions::selectFirst<Complex>;
+    const SkelFunction Skel = DGtal::functions::skelEnd<Complex>;
+    const std::vector<uint32_t> persistences = {3, 0, 2, 2, 1, 6};
+    const auto thin_complexes = SG::asymmetric_thinning_scheme_sweep<Complex>(
+            vc, Select, Skel, persistences);
+    ASSERT_EQ(thin_complexes.size(), persistences.size());
+    std::set<std::set<Point>> different_skeletons;
+    for (size_t i = 0; i < persistences.size(); ++i) {
+        const auto thin = SG::asymmetric_thinning_scheme<Complex>(
+                vc, Select, Skel, persistences[i]);
+        EXPECT_EQ(voxels(thin_complexes[i]), voxels(thin))
+                << "persistence: " << persistences[i];
+        different_skeletons.insert(voxels(thin));
+    }
+    // The values do give different skeletons.
+    EXPECT_GT(different_skeletons.size(), 1u);
+}
@@ -0,0 +1,51 @@
+/* ********************************************************************
+ * Copyright (C) 2021 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "lookup_tables.hpp"
+
+#include <DGtal/base/CountedPtr.h>
+#include <DGtal/topology/NeighborhoodConfigurations.h>
+#include <DGtal/topology/tables/NeighborhoodTables.h>
+#include <boost/dynamic_bitset.hpp>
+
+#include "gmock/gmock.h"
+#include <fstream>
+
+TEST(lookup_tables, unwritable_cache_folder) {
+    // The cache folder is inside a regular file, it cannot be created.
+    const std::string not_a_folder = "lookup_tables_not_a_folder";
+    {
+        std::ofstream os(not_a_folder);
+        os << "not a folder";
+    }
+    const std::string table_filename = DGtal::simplicity::tableSimple26_6;
+    const auto expected = DGtal::functions::loadTable(table_filename);
+    SG::clear_lookup_tables();
+    SG::set_lookup_tables_cache_folder(not_a_folder + "/cache");
+    SG::LookupTablePointer table;
+    EXPECT_NO_THROW(table = SG::load_lookup_table(table_filename));
+    EXPECT_EQ(*table, *expected);
+    // The table is in the registry, even if it was not cached.
+    EXPECT_EQ(SG::num_loaded_lookup_tables(), 1);
+    EXPECT_EQ(*SG::load_lookup_table(table_filename), *expected);
+    EXPECT_EQ(SG::num_loaded_lookup_tables(), 1);
+    SG::set_lookup_tables_cache_folder("");
+    SG::clear_lookup_tables();
+}
@@ -22,6 +22,7 @@
 #define SG_TREE_GENERATION_VISITOR_HPP
 
 #include "array_utilities.hpp"
+#include "graph_attributes.hpp" // for VertexAttribute
 #include "rng.hpp"           // for RNG::pi
 #include "image_types.hpp" // for FloatImageType
 
@@ -81,14 +82,13 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
             typename boost::graph_traits<SpatialGraph>::vertex_descriptor;
     using edge_descriptor =
             typename boost::graph_traits<SpatialGraph>::edge_descriptor;
-    using VertexToGenerationMap = std::unordered_map<vertex_descriptor, size_t>;
-    using VertexToLocalRadiusMap =
-            std::unordered_map<vertex_descriptor, double>;
-    using VertexToDistanceFromRootMap =
-            std::unordered_map<vertex_descriptor, size_t>;
-    using VertexAnomalies = std::unordered_map<vertex_descriptor, double>;
-    using VertexAlreadyIncreasedMap =
-            std::unordered_map<vertex_descriptor, bool>;
+    // Columns indexed by vertex_descriptor, with the interface of
+    // std::unordered_map, see VertexAttribute.
+    using VertexToGenerationMap = VertexAttribute<size_t>;
+    using VertexToLocalRadiusMap = VertexAttribute<double>;
+    using VertexToDistanceFromRootMap = VertexAttribute<size_t>;
+    using VertexAnomalies = VertexAttribute<double>;
+    using VertexAlreadyIncreasedMap = VertexAttribute<uint8_t>;
 
     TreeGenerationVisitor(
             VertexToGenerationMap &vertex_to_generation_map,
@@ -318,7 +318,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
         const auto source = boost::source(input_edge, input_sg);
         const auto target = boost::target(input_edge, input_sg);
         using out_edge_iterator =
-                boost::graph_traits<GraphType>::out_edge_iterator;
+                typename boost::graph_traits<SpatialGraph>::out_edge_iterator;
         out_edge_iterator ei, ei_end;
         std::vector<edge_descriptor> edges_with_same_source_than_input_edge;
         for (std::tie(ei, ei_end) = boost::out_edges(source, input_sg);
@@ -22,27 +22,122 @@
 #include "create_vertex_to_radius_map.hpp"
 #include "tree_generation_visitor.hpp"
 #include "filter_spatial_graph.hpp"
+#include <boost/graph/connected_components.hpp>
 #include <fstream>
 #include <iostream>
 
 namespace SG {
 
-VertexGenerationMap
-tree_generation(const GraphType &graph,
-                const typename FloatImageType::Pointer &distance_map_image,
-                const bool spatial_nodes_position_are_in_physical_space,
-                const double &decrease_radius_ratio_to_increase_generation,
-                const double &keep_generation_if_angle_less_than,
-                const double &increase_generation_if_angle_greater_than,
-                const size_t &num_of_edge_points_to_compute_angle,
-                const std::vector<GraphType::vertex_descriptor> &input_roots,
-                const VertexGenerationMap &input_fixed_generation_map,
-                const bool verbose) {
-    using vertex_descriptor = GraphType::vertex_descriptor;
+namespace {
+/**
+ * Vertex with largest radius of each connected component of the graph,
+ * given the component of each vertex.
+ * Components where the largest radius is not greater than 1.0 are ignored.
+ * Ties are solved in favour of the vertex with lowest index.
+ */
+template <typename TVertexDescriptor>
+std::vector<TVertexDescriptor> vertices_with_largest_radius_per_component(
+        const std::vector<size_t> &components,
+        const size_t num_of_components,
+        const VertexAttribute<double> &vertex_radius,
+        const TVertexDescriptor null_vertex,
+        const bool verbose) {
+    if(verbose) {
+        std::cout << "vertices_with_largest_radius per graph component "
+            "(graph componentes where largest radius is 1 are ignored):" << std::endl;
+    }
+    std::vector<TVertexDescriptor> largest_radius_vertices(num_of_components,
+                                                           null_vertex);
+    std::vector<double> largest_radius(num_of_components, 0.0);
+    for (TVertexDescriptor v = 0; v < components.size(); ++v) {
+        const auto comp_index = components[v];
+        const auto radius = vertex_radius.at(v);
+        if (largest_radius_vertices[comp_index] == null_vertex ||
+            radius > largest_radius[comp_index]) {
+            largest_radius_vertices[comp_index] = v;
+            largest_radius[comp_index] = radius;
+        }
+    }
+    std::vector<TVertexDescriptor> final_root_nodes;
+    for (size_t comp_index = 0; comp_index < num_of_components; comp_index++) {
+        const auto vertex_with_largest_radius =
+                largest_radius_vertices[comp_index];
+        const auto &largest_radius_per_component = largest_radius[comp_index];
+        if(largest_radius_per_component > 1.0) {
+            final_root_nodes.push_back(vertex_with_largest_radius);
+            if (verbose) {
+                std::cout << " - component_index: " << comp_index
+                    << " -> vertex_with_largest_radius: "
+                    << vertex_with_largest_radius
+                    << " with radius: "
+                    << largest_radius_per_component
+                    << std::endl;
+            }
+        }
+    }
+    return final_root_nodes;
+}
+
+/**
+ * Label the components with @ref connected_components_union_find, the
+ * radius of each vertex is the same than in the whole graph, no need to
+ * compute it again per component.
+ */
+std::vector<GraphType::vertex_descriptor>
+vertices_with_largest_radius_per_component(
+        const GraphType &graph,
+        const typename FloatImageType::Pointer & /*distance_map_image*/,
+        const VertexAttribute<double> &vertex_radius,
+        const bool /*spatial_nodes_position_are_in_physical_space*/,
+        const bool verbose) {
+    const auto components = SG::connected_components_union_find(graph);
+    return vertices_with_largest_radius_per_component(
+            components.vertex_component, components.size(), vertex_radius,
+            GraphType::null_vertex(), verbose);
+}
+
+/**
+ * FrozenSpatialGraph cannot be filtered, label the components instead and
+ * reuse the radius of each vertex from the whole graph.
+ */
+std::vector<FrozenSpatialGraph::vertex_descriptor>
+vertices_with_largest_radius_per_component(
+        const FrozenSpatialGraph &graph,
+        const typename FloatImageType::Pointer & /*distance_map_image*/,
+        const VertexAttribute<double> &vertex_radius,
+        const bool /*spatial_nodes_position_are_in_physical_space*/,
+        const bool verbose) {
+    const auto num_vertices = boost::num_vertices(graph);
+    std::vector<size_t> components(num_vertices);
+    const size_t num_of_components = boost::connected_components(
+            graph, boost::make_iterator_property_map(
+                           components.begin(),
+                           boost::get(boost::vertex_index, graph)));
+    return vertices_with_largest_radius_per_component(
+            components, num_of_components, vertex_radius,
+            FrozenSpatialGraph::null_vertex(), verbose);
+}
+
+template <typename TGraph>
+VertexGenerationMap tree_generation_impl(
+        const TGraph &graph,
+        const typename FloatImageType::Pointer &distance_map_image,
+        const bool spatial_nodes_position_are_in_physical_space,
+        const double &decrease_radius_ratio_to_increase_generation,
+        const double &keep_generation_if_angle_less_than,
+        const double &increase_generation_if_angle_greater_than,
+        const size_t &num_of_edge_points_to_compute_angle,
+        const std::vector<
+                typename boost::graph_traits<TGraph>::vertex_descriptor>
+                &input_roots,
+        const VertexGenerationMap &input_fixed_generation_map,
+        const bool verbose) {
+    using vertex_descriptor =
+            typename boost::graph_traits<TGraph>::vertex_descriptor;
     // Start the visit at the root
     // As a first approximation, we select as root the vertex with largest
     // radius
-    const auto vertex_to_radius_map = create_vertex_to_radius_map(
+    const auto vertex_radius = create_vertex_radius_attribute(
             distance_map_image, graph,
             spatial_nodes_position_are_in_physical_space, verbose);
     // Manage roots
@@ -56,48 +151,20 @@ tree_generation(const GraphType &graph,
 
     std::vector<vertex_descriptor> final_root_nodes;
     if(input_roots.empty()) {
-        const auto component_graphs = SG::filter_component_graphs(graph);
-        const auto num_of_components = component_graphs.size();
-        if(verbose) {
-            std::cout << "vertices_with_largest_radius per graph component "
-                "(graph componentes where largest radius is 1 are ignored):" << std::endl;
-        }
-        for (size_t comp_index = 0; comp_index < num_of_components; comp_index++) {
-            const auto & comp_graph  = component_graphs[comp_index];
-            const auto comp_vertex_to_radius_map = create_vertex_to_radius_map(
-                    distance_map_image, comp_graph,
-                    spatial_nodes_position_are_in_physical_space, verbose);
-            using vertex_radius_pair = std::pair<GraphType::vertex_descriptor, double>;
-            const auto max_radius_element = std::max_element(
-                    std::cbegin(comp_vertex_to_radius_map), std::cend(comp_vertex_to_radius_map),
-                    [](const vertex_radius_pair &lhs, const vertex_radius_pair &rhs) {
-                        return lhs.second < rhs.second;
-                    });
-
-            const auto vertex_with_largest_radius = max_radius_element->first;
-            const auto & largest_radius_per_component = max_radius_element->second;
-            if(largest_radius_per_component > 1.0) {
-                final_root_nodes.push_back(vertex_with_largest_radius);
-                if (verbose) {
-                    std::cout << " - component_index: " << comp_index
-                        << " -> vertex_with_largest_radius: "
-                        << vertex_with_largest_radius
-                        << " with radius: "
-                        << largest_radius_per_component
-                        << std::endl;
-                }
-            }
-        }
+        final_root_nodes = vertices_with_largest_radius_per_component(
+                graph, distance_map_image, vertex_radius,
+                spatial_nodes_position_are_in_physical_space, verbose);
     } else {
         // TODO: If multiple roots, we should check that they belong to
-        // disconnected_components. See SG::filter_component_graph O(E+V)
+        // disconnected_components. See SG::connected_components_union_find
         final_root_nodes = input_roots;
     }
 
-    VertexGenerationMap vertex_to_generation_map;
-    std::unordered_map<vertex_descriptor, size_t>
-        vertex_to_distance_from_root_map;
     const auto total_vertices = boost::num_vertices(graph);
+    // Dense columns indexed by vertex, the visitor queries them for every
+    // edge.
+    VertexAttribute<size_t> vertex_to_generation_map(total_vertices);
+    VertexAttribute<size_t> vertex_to_distance_from_root_map(total_vertices);
     for(const auto & root : final_root_nodes) {
         // Check root exists in graph
         if(root > total_vertices - 1) {
@@ -125,10 +192,10 @@ tree_generation(const GraphType &graph,
         }
     }
     // Store anomalies, targets with bigger radius than its source.
-    TreeGenerationVisitor<GraphType>::VertexAnomalies vertex_anomalies;
+    typename TreeGenerationVisitor<TGraph>::VertexAnomalies vertex_anomalies;
     // Start the visit from root
-    TreeGenerationVisitor<GraphType> visitor(
-            vertex_to_generation_map, distance_map_image, vertex_to_radius_map,
+    TreeGenerationVisitor<TGraph> visitor(
+            vertex_to_generation_map, distance_map_image, vertex_radius,
             vertex_to_distance_from_root_map,
             decrease_radius_ratio_to_increase_generation,
             keep_generation_if_angle_less_than,
@@ -163,7 +230,50 @@ tree_generation(const GraphType &graph,
         }
         std::cout << std::endl;
     }
-    return vertex_to_generation_map;
+    return to_unordered_map(vertex_to_generation_map);
+}
+} // namespace
+
+VertexGenerationMap
+tree_generation(const GraphType &graph,
+                const typename FloatImageType::Pointer &distance_map_image,
+                const bool spatial_nodes_position_are_in_physical_space,
+                const double &decrease_radius_ratio_to_increase_generation,
+                const double &keep_generation_if_angle_less_than,
+                const double &increase_generation_if_angle_greater_than,
+                const size_t &num_of_edge_points_to_compute_angle,
+                const std::vector<GraphType::vertex_descriptor> &input_roots,
+                const VertexGenerationMap &input_fixed_generation_map,
+                const bool verbose) {
+    return tree_generation_impl(
+            graph, distance_map_image,
+            spatial_nodes_position_are_in_physical_space,
+            decrease_radius_ratio_to_increase_generation,
+            keep_generation_if_angle_less_than,
+            increase_generation_if_angle_greater_than,
+            num_of_edge_points_to_compute_angle, input_roots,
+            input_fixed_generation_map, verbose);
+}
+
+VertexGenerationMap tree_generation(
+        const FrozenSpatialGraph &graph,
+        const typename FloatImageType::Pointer &distance_map_image,
+        const bool spatial_nodes_position_are_in_physical_space,
+        const double &decrease_radius_ratio_to_increase_generation,
+        const double &keep_generation_if_angle_less_than,
+        const double &increase_generation_if_angle_greater_than,
+        const size_t &num_of_edge_points_to_compute_angle,
+        const std::vector<FrozenSpatialGraph::vertex_descriptor> &input_roots,
+        const VertexGenerationMap &input_fixed_generation_map,
+        const bool verbose) {
+    return tree_generation_impl(
+            graph, distance_map_image,
+            spatial_nodes_position_are_in_physical_space,
+            decrease_radius_ratio_to_increase_generation,
+            keep_generation_if_angle_less_than,
+            increase_generation_if_angle_greater_than,
+            num_of_edge_points_to_compute_angle, input_roots,
+            input_fixed_generation_map, verbose);
 }
 
 VertexGenerationMap read_vertex_to_generation_map(
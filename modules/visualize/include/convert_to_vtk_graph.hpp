@@ -35,6 +35,7 @@ struct GraphVTK {
 
 /**
  * Convert spatial graph to a vtk graph. Used for visualization.
+ * Graphs from 2D images (GraphType2D) are placed in the z = 0 plane.
  *
  * @param sg input spatial graph
  *
@@ -42,5 +43,7 @@ struct GraphVTK {
  */
 GraphVTK
 convert_to_vtk_graph(const GraphType &sg, const bool & with_edge_points = false);
+GraphVTK convert_to_vtk_graph(const GraphType2D &sg,
+                              const bool &with_edge_points = false);
 } // namespace SG
 #endif
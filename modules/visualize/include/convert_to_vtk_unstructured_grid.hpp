@@ -31,15 +31,21 @@ namespace SG {
  * Convert spatial graph to a vtk unstructured grid with vtkPolyLine cells
  * representing the bonds.
  *
+ * Graphs from 2D images (GraphType2D) are placed in the z = 0 plane.
+ *
  * @param sg input spatial graph
  *
  * @return vtkUnstructuredGrid
  */
 vtkSmartPointer<vtkUnstructuredGrid>
 convert_to_vtk_unstructured_grid(const GraphType &sg);
+vtkSmartPointer<vtkUnstructuredGrid>
+convert_to_vtk_unstructured_grid(const GraphType2D &sg);
 
 vtkSmartPointer<vtkUnstructuredGrid>
 convert_to_vtk_unstructured_grid_with_edge_points(const GraphType &sg);
+vtkSmartPointer<vtkUnstructuredGrid>
+convert_to_vtk_unstructured_grid_with_edge_points(const GraphType2D &sg);
 
 void write_vertices_to_vtk_unstructured_grid(
         const GraphType &sg,
@@ -47,14 +53,28 @@ void write_vertices_to_vtk_unstructured_grid(
         vtkPoints *vtk_points,
         std::unordered_map<boost::graph_traits<GraphType>::vertex_descriptor,
                            vtkIdType> &vertex_id_map);
+void write_vertices_to_vtk_unstructured_grid(
+        const GraphType2D &sg,
+        vtkUnstructuredGrid *ugrid,
+        vtkPoints *vtk_points,
+        std::unordered_map<boost::graph_traits<GraphType2D>::vertex_descriptor,
+                           vtkIdType> &vertex_id_map);
 void write_contour_lengths_to_vtk_unstructured_grid(const GraphType &sg,
                                                     vtkUnstructuredGrid *ugrid);
+void write_contour_lengths_to_vtk_unstructured_grid(const GraphType2D &sg,
+                                                    vtkUnstructuredGrid *ugrid);
 void write_ete_distances_to_vtk_unstructured_grid(const GraphType &sg,
                                                   vtkUnstructuredGrid *ugrid);
+void write_ete_distances_to_vtk_unstructured_grid(const GraphType2D &sg,
+                                                  vtkUnstructuredGrid *ugrid);
 void write_degrees_to_vtk_unstructured_grid(const GraphType &sg,
                                             vtkUnstructuredGrid *ugrid);
+void write_degrees_to_vtk_unstructured_grid(const GraphType2D &sg,
+                                            vtkUnstructuredGrid *ugrid);
 void write_vertex_descriptors_to_vtk_unstructured_grid(const GraphType &sg,
                                             vtkUnstructuredGrid *ugrid);
+void write_vertex_descriptors_to_vtk_unstructured_grid(const GraphType2D &sg,
+                                            vtkUnstructuredGrid *ugrid);
 
 /**
  * Write vtu file
@@ -19,6 +19,7 @@
  * *******************************************************************/
 
 #include "convert_to_vtk_graph.hpp"
+#include "convert_spatial_graph.hpp" // for embed_point_in_3d
 #include <unordered_map>
 
 #include <vtkMutableUndirectedGraph.h>
@@ -27,12 +28,16 @@
 
 namespace SG {
 
-GraphVTK convert_to_vtk_graph(const GraphType &sg, const bool & with_edge_points) {
+namespace {
+template <typename TGraph>
+GraphVTK convert_to_vtk_graph_impl(const TGraph &sg,
+                                   const bool &with_edge_points) {
     GraphVTK output;
     auto &vtk_graph = output.vtk_graph;
 
-    using vertex_iterator = boost::graph_traits<GraphType>::vertex_iterator;
-    using edge_iterator = boost::graph_traits<GraphType>::edge_iterator;
+    using vertex_iterator =
+            typename boost::graph_traits<TGraph>::vertex_iterator;
+    using edge_iterator = typename boost::graph_traits<TGraph>::edge_iterator;
 
     auto &vertex_map = output.vertex_map;
     // To put coordinates in nodes (the default is 0,0,0)
@@ -42,7 +47,7 @@ GraphVTK convert_to_vtk_graph(const GraphType &sg, const bool & with_edge_points
     std::tie(vi, vi_end) = boost::vertices(sg);
     for (; vi != vi_end; ++vi) {
         vertex_map[*vi] = vtk_graph->AddVertex();
-        points->InsertNextPoint(sg[*vi].pos[0], sg[*vi].pos[1], sg[*vi].pos[2]);
+        points->InsertNextPoint(embed_point_in_3d(sg[*vi].pos).data());
     }
     vtk_graph->SetPoints(points);
 
@@ -67,18 +72,29 @@ GraphVTK convert_to_vtk_graph(const GraphType &sg, const bool & with_edge_points
                         sg_edge_points[0]);
             if (source_is_closer_to_begin) {
                 for (const auto &p : sg_edge_points) {
-                    vtk_graph->AddEdgePoint(vtk_edge.Id, p[0], p[1], p[2]);
+                    vtk_graph->AddEdgePoint(vtk_edge.Id,
+                                            embed_point_in_3d(p).data());
                 }
             }
             else {
                 for (auto it = sg_edge_points.crbegin(); it != sg_edge_points.crend();
                         ++it) {
                     const auto &p = *it;
-                    vtk_graph->AddEdgePoint(vtk_edge.Id, p[0], p[1], p[2]);
+                    vtk_graph->AddEdgePoint(vtk_edge.Id,
+                                            embed_point_in_3d(p).data());
                 }
             }
         }
     }
     return output;
 }
+} // namespace
+
+GraphVTK convert_to_vtk_graph(const GraphType &sg, const bool & with_edge_points) {
+    return convert_to_vtk_graph_impl(sg, with_edge_points);
+}
+GraphVTK convert_to_vtk_graph(const GraphType2D &sg,
+                              const bool &with_edge_points) {
+    return convert_to_vtk_graph_impl(sg, with_edge_points);
+}
 } // namespace SG
@@ -19,6 +19,7 @@
  * *******************************************************************/
 
 #include "convert_to_vtk_unstructured_grid.hpp"
+#include "convert_spatial_graph.hpp" // for embed_point_in_3d
 #include "edge_points_utilities.hpp" // for contour_length
 #include <unordered_map>
 
@@ -34,23 +35,28 @@
 #include <vtkXMLUnstructuredGridWriter.h>
 
 namespace SG {
-void write_vertices_to_vtk_unstructured_grid(
-        const GraphType &sg,
+namespace {
+/* Implementations shared by GraphType and GraphType2D */
+template <typename TGraph>
+void write_vertices_to_vtk_unstructured_grid_impl(
+        const TGraph &sg,
         vtkUnstructuredGrid *ugrid,
         vtkPoints *vtk_points,
-        std::unordered_map<boost::graph_traits<GraphType>::vertex_descriptor,
-                           vtkIdType> &vertex_id_map) {
+        std::unordered_map<
+                typename boost::graph_traits<TGraph>::vertex_descriptor,
+                vtkIdType> &vertex_id_map) {
     // vertices are linked to geometric points
     auto [vi, vi_end] = boost::vertices(sg);
     for (; vi != vi_end; ++vi) {
         vertex_id_map[*vi] = vtk_points->InsertNextPoint(
-                sg[*vi].pos[0], sg[*vi].pos[1], sg[*vi].pos[2]);
+                embed_point_in_3d(sg[*vi].pos).data());
     }
     ugrid->SetPoints(vtk_points);
 }
 
-void write_vertex_descriptors_to_vtk_unstructured_grid(const GraphType &sg,
-                                            vtkUnstructuredGrid *ugrid) {
+template <typename TGraph>
+void write_vertex_descriptors_to_vtk_unstructured_grid_impl(const TGraph &sg,
+        vtkUnstructuredGrid *ugrid) {
     auto *point_data = ugrid->GetPointData();
     const auto number_of_points = ugrid->GetNumberOfPoints();
 
@@ -77,8 +83,9 @@ void write_vertex_descriptors_to_vtk_unstructured_grid(const GraphType &sg,
 
 }
 
-void write_degrees_to_vtk_unstructured_grid(const GraphType &sg,
-                                            vtkUnstructuredGrid *ugrid) {
+template <typename TGraph>
+void write_degrees_to_vtk_unstructured_grid_impl(const TGraph &sg,
+        vtkUnstructuredGrid *ugrid) {
     auto *point_data = ugrid->GetPointData();
     const auto number_of_points = ugrid->GetNumberOfPoints();
 
@@ -104,8 +111,8 @@ void write_degrees_to_vtk_unstructured_grid(const GraphType &sg,
     point_data->Update();
 }
 
-void write_spatial_node_ids_to_vtk_unstructured_grid(
-        const GraphType &sg,
+template <typename TGraph>
+void write_spatial_node_ids_to_vtk_unstructured_grid_impl(const TGraph &sg,
         vtkUnstructuredGrid *ugrid) {
     auto *point_data = ugrid->GetPointData();
     const auto number_of_points = ugrid->GetNumberOfPoints();
@@ -133,8 +140,9 @@ void write_spatial_node_ids_to_vtk_unstructured_grid(
 
 }
 
-void write_ete_distances_to_vtk_unstructured_grid(const GraphType &sg,
-                                                  vtkUnstructuredGrid *ugrid) {
+template <typename TGraph>
+void write_ete_distances_to_vtk_unstructured_grid_impl(const TGraph &sg,
+        vtkUnstructuredGrid *ugrid) {
     auto *cell_data = ugrid->GetCellData();
     const auto ncells = ugrid->GetNumberOfCells();
     const std::string array_name = "end_to_end_distance";
@@ -160,8 +168,9 @@ void write_ete_distances_to_vtk_unstructured_grid(const GraphType &sg,
     cell_data->Update();
 }
 
-void write_contour_lengths_to_vtk_unstructured_grid(
-        const GraphType &sg, vtkUnstructuredGrid *ugrid) {
+template <typename TGraph>
+void write_contour_lengths_to_vtk_unstructured_grid_impl(const TGraph &sg,
+        vtkUnstructuredGrid *ugrid) {
     auto *cell_data = ugrid->GetCellData();
     const auto ncells = ugrid->GetNumberOfCells();
     const std::string array_name = "contour_length";
@@ -181,15 +190,17 @@ void write_contour_lengths_to_vtk_unstructured_grid(
     cell_data->Update();
 }
 
+template <typename TGraph>
 vtkSmartPointer<vtkUnstructuredGrid>
-convert_to_vtk_unstructured_grid(const GraphType &sg) {
+convert_to_vtk_unstructured_grid_impl(const TGraph &sg) {
     auto ugrid = vtkSmartPointer<vtkUnstructuredGrid>::New();
-    using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
+    using vertex_descriptor =
+            typename boost::graph_traits<TGraph>::vertex_descriptor;
     using VertexIdMap = std::unordered_map<vertex_descriptor, vtkIdType>;
     VertexIdMap vertex_id_map;
     auto vtk_points = vtkSmartPointer<vtkPoints>::New();
 
-    write_vertices_to_vtk_unstructured_grid(sg, ugrid, vtk_points,
+    write_vertices_to_vtk_unstructured_grid_impl(sg, ugrid, vtk_points,
                                             vertex_id_map);
     // Add more properties of vertices to PointData, if any
 
@@ -216,25 +227,27 @@ convert_to_vtk_unstructured_grid(const GraphType &sg) {
     }
 
     // Append to PointData
-    write_vertex_descriptors_to_vtk_unstructured_grid(sg, ugrid);
-    write_degrees_to_vtk_unstructured_grid(sg, ugrid);
-    write_spatial_node_ids_to_vtk_unstructured_grid(sg, ugrid);
+    write_vertex_descriptors_to_vtk_unstructured_grid_impl(sg, ugrid);
+    write_degrees_to_vtk_unstructured_grid_impl(sg, ugrid);
+    write_spatial_node_ids_to_vtk_unstructured_grid_impl(sg, ugrid);
 
     // Append to CellData
-    write_ete_distances_to_vtk_unstructured_grid(sg, ugrid);
-    write_contour_lengths_to_vtk_unstructured_grid(sg, ugrid);
+    write_ete_distances_to_vtk_unstructured_grid_impl(sg, ugrid);
+    write_contour_lengths_to_vtk_unstructured_grid_impl(sg, ugrid);
     return ugrid;
 }
 
+template <typename TGraph>
 vtkSmartPointer<vtkUnstructuredGrid>
-convert_to_vtk_unstructured_grid_with_edge_points(const GraphType &sg) {
+convert_to_vtk_unstructured_grid_with_edge_points_impl(const TGraph &sg) {
     auto ugrid = vtkSmartPointer<vtkUnstructuredGrid>::New();
-    using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
+    using vertex_descriptor =
+            typename boost::graph_traits<TGraph>::vertex_descriptor;
     using VertexIdMap = std::unordered_map<vertex_descriptor, vtkIdType>;
     VertexIdMap vertex_id_map;
     auto vtk_points = vtkSmartPointer<vtkPoints>::New();
 
-    write_vertices_to_vtk_unstructured_grid(sg, ugrid, vtk_points,
+    write_vertices_to_vtk_unstructured_grid_impl(sg, ugrid, vtk_points,
                                             vertex_id_map);
 
     auto [ei, ei_end] = boost::edges(sg);
@@ -263,8 +276,8 @@ convert_to_vtk_unstructured_grid_with_edge_points(const GraphType &sg) {
 
             // Insert edge_points first
             for (const auto &p : sg_edge_points) {
-                vtk_id_list->InsertNextId(
-                        vtk_points->InsertNextPoint(p[0], p[1], p[2]));
+                vtk_id_list->InsertNextId(vtk_points->InsertNextPoint(
+                        embed_point_in_3d(p).data()));
             }
             if (source_is_closer_to_begin) {
                 vtk_id_list->InsertNextId(vertex_id_map.at(target));
@@ -277,16 +290,89 @@ convert_to_vtk_unstructured_grid_with_edge_points(const GraphType &sg) {
         }
     }
     // Append to PointData
-    write_vertex_descriptors_to_vtk_unstructured_grid(sg, ugrid);
-    write_degrees_to_vtk_unstructured_grid(sg, ugrid);
-    write_spatial_node_ids_to_vtk_unstructured_grid(sg, ugrid);
+    write_vertex_descriptors_to_vtk_unstructured_grid_impl(sg, ugrid);
+    write_degrees_to_vtk_unstructured_grid_impl(sg, ugrid);
+    write_spatial_node_ids_to_vtk_unstructured_grid_impl(sg, ugrid);
 
     // Append to CellData
-    write_ete_distances_to_vtk_unstructured_grid(sg, ugrid);
-    write_contour_lengths_to_vtk_unstructured_grid(sg, ugrid);
+    write_ete_distances_to_vtk_unstructured_grid_impl(sg, ugrid);
+    write_contour_lengths_to_vtk_unstructured_grid_impl(sg, ugrid);
     return ugrid;
 }
 
+} // namespace
+
+void write_vertices_to_vtk_unstructured_grid(
+        const GraphType &sg,
+        vtkUnstructuredGrid *ugrid,
+        vtkPoints *vtk_points,
+        std::unordered_map<boost::graph_traits<GraphType>::vertex_descriptor,
+                           vtkIdType> &vertex_id_map) {
+    write_vertices_to_vtk_unstructured_grid_impl(sg, ugrid, vtk_points,
+                                                 vertex_id_map);
+}
+void write_vertices_to_vtk_unstructured_grid(
+        const GraphType2D &sg,
+        vtkUnstructuredGrid *ugrid,
+        vtkPoints *vtk_points,
+        std::unordered_map<boost::graph_traits<GraphType2D>::vertex_descriptor,
+                           vtkIdType> &vertex_id_map) {
+    write_vertices_to_vtk_unstructured_grid_impl(sg, ugrid, vtk_points,
+                                                 vertex_id_map);
+}
+void write_vertex_descriptors_to_vtk_unstructured_grid(const GraphType &sg,
+        vtkUnstructuredGrid *ugrid) {
+    write_vertex_descriptors_to_vtk_unstructured_grid_impl(sg, ugrid);
+}
+void write_vertex_descriptors_to_vtk_unstructured_grid(const GraphType2D &sg,
+        vtkUnstructuredGrid *ugrid) {
+    write_vertex_descriptors_to_vtk_unstructured_grid_impl(sg, ugrid);
+}
+void write_degrees_to_vtk_unstructured_grid(const GraphType &sg,
+        vtkUnstructuredGrid *ugrid) {
+    write_degrees_to_vtk_unstructured_grid_impl(sg, ugrid);
+}
+void write_degrees_to_vtk_unstructured_grid(const GraphType2D &sg,
+        vtkUnstructuredGrid *ugrid) {
+    write_degrees_to_vtk_unstructured_grid_impl(sg, ugrid);
+}
+void write_ete_distances_to_vtk_unstructured_grid(const GraphType &sg,
+        vtkUnstructuredGrid *ugrid) {
+    write_ete_distances_to_vtk_unstructured_grid_impl(sg, ugrid);
+}
+void write_ete_distances_to_vtk_unstructured_grid(const GraphType2D &sg,
+        vtkUnstructuredGrid *ugrid) {
+    write_ete_distances_to_vtk_unstructured_grid_impl(sg, ugrid);
+}
+void write_contour_lengths_to_vtk_unstructured_grid(const GraphType &sg,
+        vtkUnstructuredGrid *ugrid) {
+    write_contour_lengths_to_vtk_unstructured_grid_impl(sg, ugrid);
+}
+void write_contour_lengths_to_vtk_unstructured_grid(const GraphType2D &sg,
+        vtkUnstructuredGrid *ugrid) {
+    write_contour_lengths_to_vtk_unstructured_grid_impl(sg, ugrid);
+}
+
+vtkSmartPointer<vtkUnstructuredGrid>
+convert_to_vtk_unstructured_grid(const GraphType &sg) {
+    return convert_to_vtk_unstructured_grid_impl(sg);
+}
+
+vtkSmartPointer<vtkUnstructuredGrid>
+convert_to_vtk_unstructured_grid(const GraphType2D &sg) {
+    return convert_to_vtk_unstructured_grid_impl(sg);
+}
+
+vtkSmartPointer<vtkUnstructuredGrid>
+convert_to_vtk_unstructured_grid_with_edge_points(const GraphType &sg) {
+    return convert_to_vtk_unstructured_grid_with_edge_points_impl(sg);
+}
+
+vtkSmartPointer<vtkUnstructuredGrid>
+convert_to_vtk_unstructured_grid_with_edge_points(const GraphType2D &sg) {
+    return convert_to_vtk_unstructured_grid_with_edge_points_impl(sg);
+}
+
 void write_vtk_unstructured_grid(vtkUnstructuredGrid *ugrid,
                                  const std::string &file_name) {
     vtkNew<vtkXMLUnstructuredGridWriter> ugrid_writer;
@@ -26,7 +26,11 @@ namespace py = pybind11;
 using namespace SG;
 
 void init_voxelize_graph(py::module &m) {
-    m.def("voxelize_graph", &voxelize_graph,
+    m.def("voxelize_graph",
+          py::overload_cast<const GraphType &, const BinaryImageType::Pointer &,
+                            const vertex_to_label_map_t &,
+                            const edge_to_label_map_t &, const bool &>(
+                  &voxelize_graph),
           R"delimiter(
 Create an image from the input graph.
 Uses a reference_image (for example, the thin image used to create the graph)
@@ -28,18 +28,25 @@ using namespace SG;
 
 void init_compute_graph_properties(py::module &m) {
     m.def("compute_cosines", &compute_cosines);
-    m.def("compute_degrees", &compute_degrees);
-    m.def("compute_ete_distances", &compute_ete_distances,
+    m.def("compute_degrees",
+            py::overload_cast<const GraphType &>(&compute_degrees));
+    m.def("compute_ete_distances",
+            py::overload_cast<const GraphType &, const size_t, bool>(
+                    &compute_ete_distances),
             py::arg("graph"),
             py::arg("min_edge_points") = 0,
             py::arg("ignore_end_nodes") = false
             );
-    m.def("compute_contour_lengths", &compute_contour_lengths,
+    m.def("compute_contour_lengths",
+            py::overload_cast<const GraphType &, const size_t, bool>(
+                    &compute_contour_lengths),
             py::arg("graph"),
             py::arg("min_edge_points") = 0,
             py::arg("ignore_end_nodes") = false
             );
-    m.def("compute_angles", &compute_angles,
+    m.def("compute_angles",
+            py::overload_cast<const GraphType &, const size_t, const bool,
+                              const bool>(&compute_angles),
             py::arg("graph"),
             py::arg("min_edge_points") = 0,
             py::arg("ignore_parallel_edges") = false,
@@ -27,15 +27,23 @@ namespace py = pybind11;
 using namespace SG;
 
 void init_edge_points_utilities(py::module &m) {
-    m.def("ete_distance", &ete_distance, R"(
+    m.def("ete_distance",
+          py::overload_cast<const GraphType::edge_descriptor &,
+                            const GraphType &>(&ete_distance),
+          R"(
 Computes the distance between the source and target nodes of the edge.
 Ignores edge_points.
     )");
-    m.def("edge_points_length", &edge_points_length, R"(
+    m.def("edge_points_length",
+          py::overload_cast<const SpatialEdge &>(&edge_points_length),
+          R"(
 Computes the length of the edge without taking into account the node points.
 It requires the edge_points to be contiguous/ordered.
     )");
-    m.def("contour_length", &contour_length, R"(
+    m.def("contour_length",
+          py::overload_cast<const GraphType::edge_descriptor &,
+                            const GraphType &>(&contour_length),
+          R"(
 Computes the contour_length of an edge between two nodes.
 It takes into account the nodes positions.
 It requires the edge_points to be contiguous/ordered.
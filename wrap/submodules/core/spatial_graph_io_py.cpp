@@ -26,6 +26,15 @@ void init_spatial_graph_io(py::module &m) {
                 return SG::write_serialized_sg(output_file, graph);
     }, py::arg("filename"), py::arg("graph"));
 
+    mio.def("read_binary_sg", [](const std::string &input_file) {
+        return SG::read_binary_sg(input_file);
+    }, py::arg("filename"));
+
+    mio.def("write_binary_sg",
+            [](const std::string &output_file, GraphType &graph) {
+                return SG::write_binary_sg(output_file, graph);
+    }, py::arg("filename"), py::arg("graph"));
+
     /*******************************************/
 
     const std::string read_write_vertex_to_label_map_common_docs =
@@ -57,4 +57,21 @@ Apply an ITK-style TransformIndexToPhysicalPoint to all the points of the input
             )",
             py::arg("graph"), py::arg("origin"), py::arg("spacing"),
             py::arg("direction"));
+
+    m.def(
+            "transform_graph_to_index_space",
+            [](const SG::GraphType &sg, const SG::PointType &origin,
+               const SG::PointType &spacing,
+               const SG::DirectionMatrixType &direction) {
+                GraphType output_graph = sg;
+                transform_graph_to_index_space(output_graph, origin, spacing,
+                                               direction);
+                return output_graph;
+            },
+            R"(
+Apply an ITK-style TransformPhysicalPointToIndex to all the points of the input graph.
+Positions are rounded to the nearest index.
+            )",
+            py::arg("graph"), py::arg("origin"), py::arg("spacing"),
+            py::arg("direction"));
 }
@@ -45,12 +45,15 @@ use_cluster_centroid: Bool
  If False, the node is the one with the smalled vertex_descriptor.
 verbose: Bool
  Print extra info to console.
+num_threads: int
+ 0 to use all the hardware threads.
 
 )",
           py::arg("graph"),
           py::arg("radius"),
           py::arg("use_cluster_centroid") = true,
-          py::arg("verbose") = false);
+          py::arg("verbose") = false,
+          py::arg("num_threads") = 0);
 
 /* *********************************************************************/
 
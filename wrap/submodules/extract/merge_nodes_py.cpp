@@ -26,9 +26,15 @@ namespace py = pybind11;
 using namespace SG;
 
 void init_merge_nodes(py::module &m) {
-    m.def("merge_three_connected_nodes", &merge_three_connected_nodes);
-    m.def("merge_four_connected_nodes", &merge_four_connected_nodes);
-    m.def("merge_two_three_connected_nodes", &merge_two_three_connected_nodes);
+    m.def("merge_three_connected_nodes", &merge_three_connected_nodes,
+          py::arg("graph"), py::arg("inPlace") = true,
+          py::arg("num_threads") = 0);
+    m.def("merge_four_connected_nodes", &merge_four_connected_nodes,
+          py::arg("graph"), py::arg("inPlace") = true,
+          py::arg("num_threads") = 0);
+    m.def("merge_two_three_connected_nodes", &merge_two_three_connected_nodes,
+          py::arg("graph"), py::arg("inPlace") = true,
+          py::arg("num_threads") = 0);
     m.def("remove_parallel_edges", &remove_parallel_edges,
           R"(
 Use @ref get_parallel_edges to remove the edges of the input graph.
@@ -41,6 +47,9 @@ graph: GraphType
 keep_larger_spatial_edge: Bool [false by default]
  keep the parallel edge with largest contour length,
  if false, keep shorter parallel edges.
+num_threads: int
+ 0 to use all the hardware threads.
 )",
-          py::arg("graph"), py::arg("keep_larger_spatial_edge") = false);
+          py::arg("graph"), py::arg("keep_larger_spatial_edge") = false,
+          py::arg("num_threads") = 0);
 }
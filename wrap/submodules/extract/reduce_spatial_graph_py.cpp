@@ -26,6 +26,26 @@ namespace py = pybind11;
 using namespace SG;
 
 void init_reduce_spatial_graph(py::module &m) {
-    m.def("reduce_spatial_graph_via_dfs", &reduce_spatial_graph_via_dfs);
-    m.def("reduce_spatial_graph", &reduce_spatial_graph_via_dfs);
+    m.def("reduce_spatial_graph_via_dfs",
+          py::overload_cast<const GraphType &, bool>(
+                  &reduce_spatial_graph_via_dfs));
+    m.def("reduce_spatial_graph",
+          py::overload_cast<const GraphType &, bool>(
+                  &reduce_spatial_graph_via_dfs));
+    m.def("reduce_spatial_graph_parallel",
+          py::overload_cast<const GraphType &, const size_t>(
+                  &reduce_spatial_graph_parallel),
+          R"(
+Parallel alternative to reduce_spatial_graph_via_dfs.
+The chains of degree 2 vertices are walked from the nodes in parallel,
+the result does not depend on the number of threads.
+
+Parameters:
+----------
+graph: GraphType
+    input spatial graph
+num_threads: int
+    0 to use all the hardware threads.
+)",
+          py::arg("graph"), py::arg("num_threads") = 0);
 }
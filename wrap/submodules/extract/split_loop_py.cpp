@@ -26,5 +26,8 @@ namespace py = pybind11;
 using namespace SG;
 
 void init_split_loop(py::module &m) {
-    m.def("split_loop", &split_loop);
+    m.def("split_loop",
+          py::overload_cast<GraphType::vertex_descriptor,
+                            const boost::edge_bundle_type<GraphType>::type &,
+                            GraphType &>(&split_loop));
 }
@@ -129,6 +129,17 @@ verbose: bool
 visualize: bool
     default: False
     visualize outputs during the run
+
+exportBinary: bool
+    default: False
+    Write binary graph (.sgb) representing the reduced graph.
+    Requires exportReducedGraph_foldername.
+
+traceReducedGraph: bool
+    default: False
+    Trace the reduced graph directly from the image, without creating
+    a node per voxel. Uses less memory, but clusters of adjacent junctions
+    might keep extra edges or loops. Ignored if removeExtraEdges is True.
 )delimiter";
 
     m.def("extract_graph_io", &analyze_graph_function_io,
@@ -152,7 +163,9 @@ visualize: bool
         py::arg("ignoreEdgesToEndNodes") = false,
         py::arg("ignoreEdgesShorterThan") = 0,
         py::arg("verbose") = false,
-        py::arg("visualize") = false
+        py::arg("visualize") = false,
+        py::arg("exportBinary") = false,
+        py::arg("traceReducedGraph") = false
             );
 
     m.def("extract_graph", &analyze_graph_function,
@@ -177,7 +190,9 @@ visualize: bool
         py::arg("ignoreEdgesToEndNodes") = false,
         py::arg("ignoreEdgesShorterThan") = 0,
         py::arg("verbose") = false,
-        py::arg("visualize") = false
+        py::arg("visualize") = false,
+        py::arg("exportBinary") = false,
+        py::arg("traceReducedGraph") = false
             );
 
 
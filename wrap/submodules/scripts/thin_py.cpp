@@ -20,7 +20,9 @@
 
 #include "pybind11_common.h"
 
+#include "lookup_tables.hpp"
 #include "thin_function.hpp"
+#include "tiled_thin_function.hpp"
 
 namespace py = pybind11;
 using namespace SG;
@@ -73,6 +75,18 @@ verbose: bool
 
 visualize: bool
     visualize results when finished.
+
+engine: str
+    [asymmetric, parallel]
+    - asymmetric: asymmetric thinning of DGtal, sequential. The voxel
+      complex is a hash map of cells, tens of bytes per voxel.
+    - parallel: remove simple voxels in parallel by subfields.
+      Topologically equivalent and deterministic, select_type and the
+      distance map are not used. It stores one bit per voxel of the
+      bounding box of the object, use it to thin large volumes.
+
+num_threads: int
+    threads of the parallel engine, 0 to use all the hardware threads.
             )delimiter",
             py::arg("input"),
             py::arg("skel_type"),
@@ -83,7 +97,9 @@ visualize: bool
             py::arg("input_distance_map_image") = FloatImageType::New(),
             py::arg("profile") = false,
             py::arg("verbose") = false,
-            py::arg("visualize") = false
+            py::arg("visualize") = false,
+            py::arg("engine") = "asymmetric",
+            py::arg("num_threads") = 0
          );
 
     m.def("thin_io", &thin_function_io,
@@ -145,6 +161,18 @@ verbose: bool
 visualize: bool
     visualize results when finished.
 
+engine: str
+    [asymmetric, parallel]
+    - asymmetric: asymmetric thinning of DGtal, sequential. The voxel
+      complex is a hash map of cells, tens of bytes per voxel.
+    - parallel: remove simple voxels in parallel by subfields.
+      Topologically equivalent and deterministic, select_type and the
+      distance map are not used. It stores one bit per voxel of the
+      bounding box of the object, use it to thin large volumes.
+
+num_threads: int
+    threads of the parallel engine, 0 to use all the hardware threads.
+
             )delimiter",
             py::arg("input_file"),
             py::arg("skel_type"),
@@ -157,6 +185,251 @@ visualize: bool
             py::arg("out_discrete_points_folder") = "",
             py::arg("profile") = false,
             py::arg("verbose") = false,
-            py::arg("visualize") = false
+            py::arg("visualize") = false,
+            py::arg("engine") = "asymmetric",
+            py::arg("num_threads") = 0
+         );
+
+    m.def("thin", &thin_function_sweep,
+            R"delimiter(
+Get the thinned images of a binary image for several persistence values in
+one run. The passes shared by the persistence values are performed once.
+
+Parameters:
+----------
+input: BinaryImageType
+    input binary image.
+
+skel_type: str
+    [end, ulti, isthmus], see thin with a single persistence.
+
+select_type: str
+    [first, random, dmax], see thin with a single persistence.
+
+table_folder: str
+    Location of the DGtal look-up-tables for simplicity and isthmusicity.
+    Use the variable 'sgext.tables_folder'.
+
+persistence: List[int]
+    persistence values, in any order.
+
+input_distance_map_image: FloatImageType
+    distance map required for select_type dmax option.
+
+profile: bool
+    time the algorithm
+
+verbose: bool
+    extra information displayed during the algorithm.
+
+visualize: bool
+    visualize results when finished.
+
+engine: str
+    [asymmetric, parallel], see thin with a single persistence.
+
+num_threads: int
+    threads of the parallel engine, 0 to use all the hardware threads.
+
+Returns:
+--------
+list with a thin image per persistence value, in the same order.
+            )delimiter",
+            py::arg("input"),
+            py::arg("skel_type"),
+            py::arg("select_type"),
+            py::arg("tables_folder"),
+            py::arg("persistence"),
+            py::arg("input_distance_map_image") = FloatImageType::New(),
+            py::arg("profile") = false,
+            py::arg("verbose") = false,
+            py::arg("visualize") = false,
+            py::arg("engine") = "asymmetric",
+            py::arg("num_threads") = 0
+         );
+
+    m.def("thin_io", &thin_function_sweep_io,
+            R"delimiter(
+Thin the binary image of input_file for several persistence values in one
+run, and write one image per value to out_folder.
+The passes shared by the persistence values are performed once.
+
+Parameters:
+----------
+input_file: str
+    input filename holding a binary image.
+
+skel_type: str
+    [end, ulti, isthmus], see thin_io with a single persistence.
+
+select_type: str
+    [first, random, dmax], see thin_io with a single persistence.
+
+out_folder: str
+    output folder to store the results.
+
+table_folder: str
+    Location of the DGtal look-up-tables for simplicity and isthmusicity.
+    Use the variable 'sgext.tables_folder'.
+
+persistence: List[int]
+    persistence values, in any order.
+
+input_distance_map_file: str
+    file holding a distance map. Required for select_type dmax option.
+
+foreground: str
+    [white, black]
+    Invert image if foreground voxels are black.
+
+out_discrete_points_folder: str
+    output skeleton points in a simple file
+
+profile: bool
+    time the algorithm
+
+verbose: bool
+    extra information displayed during the algorithm.
+
+visualize: bool
+    visualize results when finished.
+
+engine: str
+    [asymmetric, parallel], see thin_io with a single persistence.
+
+num_threads: int
+    threads of the parallel engine, 0 to use all the hardware threads.
+
+Returns:
+--------
+list with a thin image per persistence value, in the same order.
+            )delimiter",
+            py::arg("input_file"),
+            py::arg("skel_type"),
+            py::arg("select_type"),
+            py::arg("out_folder"),
+            py::arg("tables_folder"),
+            py::arg("persistence"),
+            py::arg("input_distance_map_file") = "",
+            py::arg("foreground") = "white",
+            py::arg("out_discrete_points_folder") = "",
+            py::arg("profile") = false,
+            py::arg("verbose") = false,
+            py::arg("visualize") = false,
+            py::arg("engine") = "asymmetric",
+            py::arg("num_threads") = 0
          );
+
+    m.def("thin_tiled_io", &tiled_thin_function_io,
+            R"delimiter(
+Thin a binary image that doesn't fit in memory by tiles, and get the
+reduced graph of its skeleton.
+
+Each tile, plus a halo around it, is read from the file (only that region
+is read if the format supports streaming), thinned, and its graph traced.
+The graphs of the tiles are stitched along their faces.
+The result matches the thinning of the whole image when the halo is large
+enough, a few times the largest radius of the object.
+
+Parameters:
+----------
+input_file: str
+    input filename holding a binary image.
+
+skel_type: str
+    Voxels to keep in the skeletonization process.
+    [end, ulti, isthmus], see thin.
+
+select_type: str
+    [first, random, dmax], see thin.
+
+table_folder: str
+    Location of the DGtal look-up-tables for simplicity and isthmusicity.
+    Use the variable 'sgext.tables_folder'.
+
+tile_size: int
+    size of the tiles, in voxels per dimension.
+
+halo: int
+    margin of voxels around each tile used to thin it.
+    With more than one tile it must be at least persistence + 1, and a
+    warning is printed when it is smaller than the distance map of a tile.
+
+persistence: int
+    if >0, performs a persistence algorithm that prunes
+    branches that are not persistant (less important).
+
+input_distance_map_file: str
+    file holding a distance map. Required for select_type dmax option.
+    It is also read by tiles.
+
+foreground: str
+    [white, black]
+    Invert image if foreground voxels are black.
+
+engine: str
+    [asymmetric, parallel], see thin.
+
+num_threads: int
+    threads used to thin (with the parallel engine) and to trace the
+    graph of each tile, 0 to use all the hardware threads.
+
+verbose: bool
+    extra information displayed during the algorithm.
+
+Returns:
+--------
+reduced graph of the skeleton, in index space.
+            )delimiter",
+            py::arg("input_file"),
+            py::arg("skel_type"),
+            py::arg("select_type"),
+            py::arg("tables_folder"),
+            py::arg("tile_size") = 256,
+            py::arg("halo") = 32,
+            py::arg("persistence") = 0,
+            py::arg("input_distance_map_file") = "",
+            py::arg("foreground") = "white",
+            py::arg("engine") = "asymmetric",
+            py::arg("num_threads") = 0,
+            py::arg("verbose") = false
+         );
+
+    m.def("preload_lookup_tables", &preload_lookup_tables,
+            R"delimiter(
+Load the simplicity and isthmus look-up tables used by thin in memory.
+Tables are loaded only once per process, and shared by all the calls to
+thin, thin_io and thin_tiled_io.
+
+Parameters:
+----------
+tables_folder: str
+    folder with the DGtal look-up tables.
+            )delimiter",
+            py::arg("tables_folder"));
+    m.def("clear_lookup_tables", &clear_lookup_tables,
+            R"delimiter(
+Release the look-up tables loaded in memory.
+The .bin files in the cache folder are not removed.
+            )delimiter");
+    m.def("num_loaded_lookup_tables", &num_loaded_lookup_tables,
+            R"delimiter(
+Number of look-up tables loaded in memory.
+            )delimiter");
+    m.def("set_lookup_tables_cache_folder", &set_lookup_tables_cache_folder,
+            R"delimiter(
+Folder to store the decompressed look-up tables as .bin files, that are
+read instead of decompressed in following processes.
+Defaults to the environment variable SGEXT_TABLES_CACHE_FOLDER.
+
+Parameters:
+----------
+cache_folder: str
+    folder for the .bin tables, empty to disable.
+            )delimiter",
+            py::arg("cache_folder"));
+    m.def("get_lookup_tables_cache_folder", &get_lookup_tables_cache_folder,
+            R"delimiter(
+Folder where the decompressed look-up tables are stored, empty if disabled.
+            )delimiter");
 }
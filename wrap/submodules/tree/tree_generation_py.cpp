@@ -27,7 +27,14 @@ using namespace SG;
 
 void init_tree_generation(py::module &m) {
 
-    m.def("tree_generation", &tree_generation,
+    m.def("tree_generation",
+          py::overload_cast<const GraphType &,
+                            const typename FloatImageType::Pointer &,
+                            const bool, const double &, const double &,
+                            const double &, const size_t &,
+                            const std::vector<GraphType::vertex_descriptor> &,
+                            const VertexGenerationMap &, const bool>(
+                  &tree_generation),
           R"(
 Associate to each node of the graph a generation based on the branching of
 the tree. Generation = 0 is associated to the root node. An end node of the
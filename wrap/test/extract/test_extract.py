@@ -100,6 +100,10 @@ class TestReduceSpatialGraph(unittest.TestCase):
         reduced_graph = extract.reduce_spatial_graph_via_dfs(self.graph, verbose)
         self.assertEqual(reduced_graph.num_vertices(), self.graph.num_vertices())
         self.assertEqual(reduced_graph.num_edges(), self.graph.num_edges())
+    def test_reduce_spatial_graph_parallel_to_same_graph(self):
+        reduced_graph = extract.reduce_spatial_graph_parallel(self.graph, num_threads=2)
+        self.assertEqual(reduced_graph.num_vertices(), self.graph.num_vertices())
+        self.assertEqual(reduced_graph.num_edges(), self.graph.num_edges())
 
 class TestDetectAndCollapseClusters(unittest.TestCase):
     def setUp(self):
@@ -39,3 +39,107 @@ class TestThin(unittest.TestCase):
                      persistence=2,
                      visualize=False,
                      verbose=True)
+
+    def test_thin_parallel(self):
+        scripts.thin_io(input_file=self.input,
+                     out_folder=self.test_dir,
+                     foreground="black",
+                     skel_type="end", select_type="first",
+                     tables_folder=tables_folder,
+                     persistence=2,
+                     engine="parallel",
+                     num_threads=2)
+
+    def test_thin_persistence_sweep(self):
+        persistences = [2, 0, 1]
+        for engine in ["asymmetric", "parallel"]:
+            thin_images = scripts.thin_io(input_file=self.input,
+                                          out_folder=self.test_dir,
+                                          foreground="black",
+                                          skel_type="end", select_type="first",
+                                          tables_folder=tables_folder,
+                                          persistence=persistences,
+                                          engine=engine)
+            self.assertEqual(len(thin_images), len(persistences))
+            for persistence in persistences:
+                self.assertTrue(any(
+                    f.endswith("_p" + str(persistence) + ".nrrd")
+                    for f in os.listdir(self.test_dir)))
+
+    def test_lookup_tables(self):
+        scripts.clear_lookup_tables()
+        self.assertEqual(scripts.num_loaded_lookup_tables(), 0)
+        scripts.set_lookup_tables_cache_folder(self.test_dir)
+        scripts.preload_lookup_tables(tables_folder)
+        self.assertEqual(scripts.num_loaded_lookup_tables(), 3)
+        self.assertTrue(os.path.exists(
+            os.path.join(self.test_dir, "simplicity_table26_6.bin")))
+        # Reload from the .bin files.
+        scripts.clear_lookup_tables()
+        scripts.thin_io(input_file=self.input,
+                     out_folder=self.test_dir,
+                     foreground="black",
+                     skel_type="end", select_type="first",
+                     tables_folder=tables_folder)
+        self.assertEqual(scripts.num_loaded_lookup_tables(), 1)
+        # A corrupt .bin file is replaced by the .zlib table.
+        binary_table = os.path.join(self.test_dir, "simplicity_table26_6.bin")
+        binary_size = os.path.getsize(binary_table)
+        with open(binary_table, "r+b") as f:
+            f.truncate(binary_size // 2)
+        scripts.clear_lookup_tables()
+        scripts.preload_lookup_tables(tables_folder)
+        self.assertEqual(scripts.num_loaded_lookup_tables(), 3)
+        self.assertEqual(os.path.getsize(binary_table), binary_size)
+        scripts.set_lookup_tables_cache_folder("")
+        scripts.clear_lookup_tables()
+
+    def test_thin_tiled(self):
+        # A single tile is the thin of the whole image.
+        whole = scripts.thin_tiled_io(input_file=self.input,
+                                      foreground="black",
+                                      skel_type="end", select_type="first",
+                                      tables_folder=tables_folder,
+                                      tile_size=1000, halo=0)
+        self.assertGreater(whole.num_vertices(), 0)
+        # The halo covers the whole image (50x50x7), each tile is thinned
+        # as the whole image.
+        tiled = scripts.thin_tiled_io(input_file=self.input,
+                                      foreground="black",
+                                      skel_type="end", select_type="first",
+                                      tables_folder=tables_folder,
+                                      tile_size=16, halo=50,
+                                      verbose=True)
+        # Monolithic thin and extract, with the same reduction than the
+        # tiles: traced, without removing extra edges or merging nodes.
+        thin_image = scripts.thin_io(input_file=self.input,
+                                     out_folder=self.test_dir,
+                                     foreground="black",
+                                     skel_type="end", select_type="first",
+                                     tables_folder=tables_folder)
+        monolithic = scripts.extract_graph(input=thin_image,
+                                           removeExtraEdges=False,
+                                           traceReducedGraph=True,
+                                           mergeThreeConnectedNodes=False,
+                                           mergeFourConnectedNodes=False,
+                                           mergeTwoThreeConnectedNodes=False,
+                                           checkParallelEdges=False)
+        self.assertEqual(tiled.num_vertices(), monolithic.num_vertices())
+        self.assertEqual(tiled.num_edges(), monolithic.num_edges())
+        self.assertEqual(tiled.num_edge_points(),
+                         monolithic.num_edge_points())
+        # Same nodes, up to their order (nodes splitting cycles without
+        # other nodes, of degree 2, might be in other voxel of the cycle).
+        def node_positions(graph):
+            return sorted(tuple(graph.spatial_node(v).pos)
+                          for v in graph.vertices()
+                          if len(graph.out_edges(v)) != 2)
+        self.assertEqual(node_positions(tiled), node_positions(monolithic))
+
+    def test_thin_tiled_small_halo(self):
+        with self.assertRaises(RuntimeError):
+            scripts.thin_tiled_io(input_file=self.input,
+                                  foreground="black",
+                                  skel_type="end", select_type="first",
+                                  tables_folder=tables_folder,
+                                  tile_size=16, halo=2, persistence=2)